@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Se/String.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Se
+{
+
+class Serializer;
+
+/// Return number of characters in padded base64 text of given number of bytes.
+inline std::size_t GetBase64EncodedSize(std::size_t size) { return (size + 2) / 3 * 4; }
+/// Return number of bytes encoded by base64 text, with or without padding.
+std::size_t GetBase64DecodedSize(const char* text, std::size_t length);
+
+/// Encode bytes as padded base64. Destination must hold GetBase64EncodedSize(size) characters.
+/// Uses AVX2 or SSSE3 if supported by the CPU.
+void EncodeBase64(char* dest, const void* data, std::size_t size);
+/// Decode base64 text, with or without padding. Destination must hold GetBase64DecodedSize() bytes.
+/// Return false if the text contains anything but base64 characters and trailing padding.
+bool DecodeBase64(void* dest, const char* text, std::size_t length);
+
+/// Encode bytes as padded base64 and write the text to the stream in chunks. Return true if successful.
+bool EncodeBase64(Serializer& dest, const void* data, std::size_t size);
+/// Decode base64 text and write the bytes to the stream in chunks. Return true if successful.
+bool DecodeBase64(Serializer& dest, const char* text, std::size_t length);
+
+/// Encode bytes as padded base64 string.
+void BufferToBase64String(String& dest, const void* data, std::size_t size);
+/// Decode base64 string to bytes. Return true if successful.
+bool Base64StringToBuffer(std::vector<unsigned char>& dest, const String& source);
+
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace Se
+{
+
+/// Return worst case LZ4 compressed size in bytes for given input size.
+unsigned EstimateCompressBound(unsigned srcSize);
+/// Compress data with LZ4. Destination must hold EstimateCompressBound(srcSize) bytes. Return compressed size, or 0 if
+/// compression is not available.
+unsigned CompressData(void* dest, const void* src, unsigned srcSize);
+/// Decompress LZ4 data of known uncompressed size. Return true if exactly destSize bytes were decompressed.
+bool DecompressData(void* dest, unsigned destSize, const void* src, unsigned srcSize);
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Se/NonCopyable.hpp>
+#include <Se/String.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace Se
+{
+
+/// Read-only view of a whole file, memory-mapped where possible so that only the touched pages are read from disk.
+/// Falls back to reading the file into memory if the file cannot be mapped.
+class MappedFile : public NonCopyable
+{
+public:
+    /// Construct.
+    MappedFile() = default;
+    /// Construct and open.
+    explicit MappedFile(const String& fileName) { Open(fileName); }
+    /// Destruct. Unmap the file.
+    ~MappedFile() { Close(); }
+
+    /// Open file. Return true if successful.
+    bool Open(const String& fileName);
+    /// Open file only if it can be memory-mapped, without falling back to reading it. Return true if successful.
+    bool OpenMapped(const String& fileName);
+    /// Unmap the file and free memory.
+    void Close();
+
+    /// Return whether a file is open.
+    bool IsOpen() const { return isOpen_; }
+    /// Return whether the file is memory-mapped rather than read into memory.
+    bool IsMapped() const { return mapping_ != nullptr; }
+    /// Return file data.
+    const unsigned char* GetData() const { return data_; }
+    /// Return file size.
+    std::size_t GetSize() const { return size_; }
+    /// Return file name.
+    const String& GetName() const { return fileName_; }
+
+private:
+    /// Map the file. Return false if mapping is not available.
+    bool Map(const String& fileName);
+
+    /// File name.
+    String fileName_;
+    /// File data.
+    const unsigned char* data_{};
+    /// File size.
+    std::size_t size_{};
+    /// Mapped view, if mapped.
+    void* mapping_{};
+#ifdef _WIN32
+    /// File handle.
+    void* fileHandle_{};
+    /// File mapping handle.
+    void* mappingHandle_{};
+#endif
+    /// File content if the file could not be mapped.
+    std::vector<unsigned char> buffer_;
+    /// Whether a file is open.
+    bool isOpen_{};
+};
+
+}
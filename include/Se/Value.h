@@ -4,6 +4,7 @@
 #include <unordered_map>
 #include <utility>
 #include <functional>
+#include <cstring>
 
 #include <Se/String.hpp>
 #include <Se/Console.hpp>
@@ -116,10 +117,13 @@ public:
     {
         *this = value;
     }
-    /// Move-construct from another Value value.
-    Value(Value && value)
+    /// Move-construct from another Value value. Takes over the string, array or object and leaves the source null.
+    Value(Value && value) noexcept
+        : type_(value.type_)
     {
-        *this = std::move(value);
+        // The number member spans the whole union
+        memcpy(&numberValue_, &value.numberValue_, sizeof numberValue_);
+        value.type_ = VALUE_NULL;
     }
     /// Destruct.
     ~Value()
@@ -147,8 +151,10 @@ public:
     Value& operator =(const Object& rhs);
     /// Assign from another Value value.
     Value& operator =(const Value& rhs);
-    /// Move-assign from another Value value.
-    Value& operator =(Value && rhs);
+    /// Assign from a string, taking over its storage.
+    Value& operator =(String&& rhs);
+    /// Move-assign from another Value value. Takes over the string, array or object and leaves the source null.
+    Value& operator =(Value && rhs) noexcept;
     /// Value equality operator.
     bool operator ==(const Value& rhs) const;
     /// Value inequality operator.
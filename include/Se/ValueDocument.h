@@ -0,0 +1,227 @@
+#pragma once
+
+#include <Se/NonCopyable.hpp>
+#include <Se/Value.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace Se
+{
+
+/// Bump allocator that frees all of its blocks at once.
+class ValueArena : public MovableNonCopyable
+{
+public:
+    /// Construct.
+    ValueArena() = default;
+    /// Move-construct.
+    ValueArena(ValueArena&& other) = default;
+    /// Move-assign.
+    ValueArena& operator =(ValueArena&& other) = default;
+
+    /// Allocate uninitialized memory. The memory stays valid until Clear() or destruction.
+    void* Allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+    /// Copy a string and null-terminate it.
+    const char* AllocateString(const char* str, std::size_t length);
+    /// Free all blocks.
+    void Clear();
+
+    /// Return number of bytes reserved in blocks.
+    std::size_t GetMemoryUse() const { return memoryUse_; }
+
+private:
+    /// Allocated blocks.
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    /// Free space in the current block.
+    char* current_{};
+    /// Bytes left in the current block.
+    std::size_t remaining_{};
+    /// Size of the next block.
+    std::size_t nextBlockSize_{};
+    /// Total size of the blocks.
+    std::size_t memoryUse_{};
+};
+
+struct ValueMember;
+
+/// Compact read-only value stored in the arena of a ValueDocument. 16 bytes regardless of the value type.
+class ValueNode
+{
+public:
+    /// Construct null value.
+    ValueNode() = default;
+
+    /// Return value type.
+    ValueType GetValueType() const { return static_cast<ValueType>(valueType_); }
+    /// Return number type.
+    ValueNumberType GetNumberType() const { return static_cast<ValueNumberType>(numberType_); }
+
+    /// Check is null.
+    bool IsNull() const { return valueType_ == VALUE_NULL; }
+    /// Check is boolean.
+    bool IsBool() const { return valueType_ == VALUE_BOOL; }
+    /// Check is number.
+    bool IsNumber() const { return valueType_ == VALUE_NUMBER; }
+    /// Check is string.
+    bool IsString() const { return valueType_ == VALUE_STRING; }
+    /// Check is array.
+    bool IsArray() const { return valueType_ == VALUE_ARRAY; }
+    /// Check is object.
+    bool IsObject() const { return valueType_ == VALUE_OBJECT; }
+
+    /// Return boolean value.
+    bool GetBool(bool defaultValue = false) const { return IsBool() ? boolValue_ : defaultValue; }
+    /// Return integer value.
+    int GetInt(int defaultValue = 0) const { return IsNumber() ? (int)numberValue_ : defaultValue; }
+    /// Return unsigned integer value.
+    unsigned GetUInt(unsigned defaultValue = 0) const { return IsNumber() ? (unsigned)numberValue_ : defaultValue; }
+    /// Return float value.
+    float GetFloat(float defaultValue = 0.0f) const { return IsNumber() ? (float)numberValue_ : defaultValue; }
+    /// Return double value.
+    double GetDouble(double defaultValue = 0.0) const { return IsNumber() ? numberValue_ : defaultValue; }
+    /// Return string value without copying.
+    std::string_view GetStringView(std::string_view defaultValue = {}) const { return IsString() ? std::string_view(stringValue_, size_) : defaultValue; }
+    /// Return null-terminated string value. Default to empty string literal.
+    const char* GetCString(const char* defaultValue = "") const { return IsString() ? stringValue_ : defaultValue; }
+    /// Return string value as a copy.
+    String GetString(const String& defaultValue = "") const { return IsString() ? String(stringValue_, size_) : defaultValue; }
+
+    /// Return size of array or number of keys in object.
+    unsigned Size() const { return IsArray() || IsObject() ? size_ : 0; }
+    /// Return array element at index, or null value if out of range.
+    const ValueNode& operator [](unsigned index) const;
+    /// Return object member value with key, or null value if not found. Keys are kept sorted, so lookup is a binary search.
+    const ValueNode& operator [](std::string_view key) const { return Get(key); }
+    /// Return object member value with key, or null value if not found.
+    const ValueNode& Get(std::string_view key) const;
+    /// Return whether object contains key.
+    bool Contains(std::string_view key) const;
+    /// Return first object member, sorted by key. Empty range if not an object.
+    const ValueMember* begin() const;
+    /// Return end of object members.
+    const ValueMember* end() const;
+
+    /// Convert to a heap-allocated Value tree.
+    Value ToValue() const;
+
+    /// Null value.
+    static const ValueNode EMPTY;
+
+private:
+    friend class ValueDocument;
+
+    /// Value type.
+    uint8_t valueType_{VALUE_NULL};
+    /// Number type.
+    uint8_t numberType_{VALUE_NT_NAN};
+    /// String length, array size or number of object members.
+    unsigned size_{};
+    union
+    {
+        /// Boolean value.
+        bool boolValue_;
+        /// Number value.
+        double numberValue_;
+        /// Null-terminated string value.
+        const char* stringValue_;
+        /// Array elements.
+        const ValueNode* elements_;
+        /// Object members sorted by key.
+        const ValueMember* members_{nullptr};
+    };
+};
+
+/// Object member of a ValueNode.
+struct ValueMember
+{
+    /// Interned key, shared by all members with the same key in the document.
+    std::string_view key_;
+    /// Member value.
+    ValueNode value_;
+};
+
+/// Read-only value tree allocated from a single arena. Keys are interned, objects store their members as flat arrays
+/// sorted by key and everything is freed at once on Clear() or destruction. Much cheaper to build and walk than a Value
+/// tree for large configs; convert with ToValue() where a mutable tree is needed.
+///
+/// The document is built with SAX-style calls in document order, which also matches the handler interface of JSON
+/// readers such as rapidjson::Reader.
+class ValueDocument : public MovableNonCopyable
+{
+public:
+    /// Construct empty document.
+    ValueDocument() = default;
+    /// Move-construct.
+    ValueDocument(ValueDocument&& other) = default;
+    /// Move-assign.
+    ValueDocument& operator =(ValueDocument&& other) = default;
+
+    /// Return root value.
+    const ValueNode& GetRoot() const { return root_; }
+    /// Free all values and start a new document.
+    void Clear();
+    /// Replace content with a copy of a Value tree.
+    void FromValue(const Value& value);
+    /// Convert to a heap-allocated Value tree.
+    Value ToValue() const { return root_.ToValue(); }
+
+    /// Return the arena, for example to keep source text that string values view into.
+    ValueArena& GetArena() { return arena_; }
+    /// Return number of bytes reserved by the arena.
+    std::size_t GetMemoryUse() const { return arena_.GetMemoryUse(); }
+    /// Return number of distinct object keys.
+    unsigned GetNumKeys() const { return static_cast<unsigned>(keys_.size()); }
+    /// Return whether a complete root value has been built.
+    bool IsComplete() const { return containers_.empty() && complete_; }
+
+    /// Builder interface. Each call returns false if it does not fit the document structure.
+    /// @{
+    bool Null();
+    bool Bool(bool value);
+    bool Int(int value);
+    bool Uint(unsigned value);
+    bool Int64(int64_t value);
+    bool Uint64(uint64_t value);
+    bool Double(double value);
+    /// Add string value. Without copy the characters must be null-terminated and outlive the document.
+    bool String(const char* str, unsigned length, bool copy = true);
+    bool StartObject();
+    /// Set the key of the next object member. Keys are always interned.
+    bool Key(const char* str, unsigned length, bool copy = true);
+    bool EndObject(unsigned memberCount = 0);
+    bool StartArray();
+    bool EndArray(unsigned elementCount = 0);
+    /// @}
+
+private:
+    /// Add a finished value to the open container, or make it the root.
+    bool AddValue(const ValueNode& node);
+    /// Return the interned copy of a key.
+    std::string_view InternKey(std::string_view key);
+    /// Emit builder calls for a Value tree.
+    void BuildValue(const Value& value);
+
+    /// Arena holding strings, keys, elements and members.
+    ValueArena arena_;
+    /// Interned keys.
+    std::unordered_set<std::string_view> keys_;
+    /// Root value.
+    ValueNode root_;
+    /// Values of open containers. Array elements have empty keys.
+    std::vector<ValueMember> stack_;
+    /// Stack offset and type of each open container.
+    std::vector<std::pair<unsigned, ValueType>> containers_;
+    /// Key for the next object member.
+    std::string_view pendingKey_;
+    /// Whether a pending key was set.
+    bool hasPendingKey_{};
+    /// Whether the root value was completed.
+    bool complete_{};
+};
+
+}
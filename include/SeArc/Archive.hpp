@@ -11,6 +11,8 @@ namespace Se
 {
 
 class Archive;
+class Deserializer;
+class Serializer;
 //class Context;
 
 /// Type of archive block.
@@ -162,6 +164,13 @@ public:
     /// Serialize version number. 0 is invalid version.
     virtual unsigned SerializeVersion(unsigned version) = 0;
 
+    /// Return the stream that elements of the current block are written to, if the archive writes them as plain
+    /// binary without names or per-element framing. Null otherwise. Used by compiled serializers to skip per-element calls.
+    virtual Serializer* GetBinarySerializer(const char* name) = 0;
+    /// Return the stream that elements of the current block are read from, if the archive reads them as plain binary.
+    /// Null otherwise.
+    virtual Deserializer* GetBinaryDeserializer(const char* name) = 0;
+
     /// Validate element or block name.
     static bool ValidateName(std::string_view name);
 
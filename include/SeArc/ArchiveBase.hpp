@@ -39,6 +39,10 @@ public:
         SerializeVLE(versionElementName, version);
         return version;
     }
+
+    Serializer* GetBinarySerializer(const char* name) override { return nullptr; }
+
+    Deserializer* GetBinaryDeserializer(const char* name) override { return nullptr; }
 /// @}
 
 /// @name Common exception factories
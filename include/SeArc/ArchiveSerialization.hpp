@@ -7,6 +7,7 @@
 //#include "ArchiveSerialization.h"
 #include <SeArc/ArchiveSerializationBasic.hpp>
 #include <SeArc/ArchiveSerializationContainerSTD.hpp>
+#include <SeArc/ArchiveSerializationSchema.hpp>
 
 #include <string>
 #include <vector>
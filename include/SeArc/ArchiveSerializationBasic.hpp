@@ -259,6 +259,8 @@ struct EnumStringSafeCaster<unsigned>
 /// Check whether the object can be serialized from/to Archive block.
 SEARC_TYPE_TRAIT(IsObjectSerializableInBlock, std::declval<T&>().SerializeInBlock(std::declval<Archive&>()));
 SEARC_TYPE_TRAIT(IsObjectSerializableInBlockPtr, std::declval<T&>()->SerializeInBlock(std::declval<Archive&>()));
+/// Check whether the object has a compiled field list, see ArchiveSerializationSchema.hpp.
+SEARC_TYPE_TRAIT(HasArchiveFields, T::GetArchiveFields());
 
 /// Check whether the object has "empty" method.
 SEARC_TYPE_TRAIT(IsObjectEmptyCheckableSTD, std::declval<T&>().empty());
@@ -349,8 +351,9 @@ inline void SerializeAsString(Archive& archive, const char* name, T& variant)
 
 }
 
-/// Serialize object with standard interface as value.
-template <class T, std::enable_if_t<IsObjectSerializableInBlock<T>::value, int> = 0>
+/// Serialize object with standard interface as value. Objects with a compiled field list take the overload from
+/// ArchiveSerializationSchema.hpp instead.
+template <class T, std::enable_if_t<IsObjectSerializableInBlock<T>::value && !HasArchiveFields<T>::value, int> = 0>
 inline void SerializeValue(Archive& archive, const char* name, T& value)
 {
     ArchiveBlock block = archive.OpenUnorderedBlock(name);
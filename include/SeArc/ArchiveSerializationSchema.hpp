@@ -0,0 +1,401 @@
+#pragma once
+
+#include <SeArc/ArchiveBase.hpp>
+#include <SeArc/ArchiveSerializationBasic.hpp>
+#include <SeArc/ArchiveSerializationContainerSTD.hpp>
+#include <Se/Base64.h>
+#include <Se/IO/Compression.h>
+#include <Se/IO/Deserializer.hpp>
+#include <Se/IO/Serializer.hpp>
+
+#include <cstring>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace Se
+{
+
+// Compiled field lists.
+//
+// A type registers its fields with a static function instead of writing SerializeInBlock:
+//
+//     static constexpr auto GetArchiveFields()
+//     {
+//         return std::make_tuple(MakeArchiveField("id", &Item::id_), MakeArchiveField("name", &Item::name_));
+//     }
+//
+// Supported field types are arithmetic types, String, std::vector of supported types and other types with field
+// lists. Binary archives read and write such objects straight from the underlying stream without per-element archive
+// calls: runs of fixed-size fields are packed into a single write or read, and vectors of trivially copyable elements
+// are copied as bytes. The bytes are the same as SerializeInBlock with the same fields would produce, so both paths
+// can read each other's output. Other archives serialize each field as a named element of an Unordered block.
+
+/// Named data member in a compiled field list.
+template <class T, class M>
+struct ArchiveField
+{
+    using MemberType = M;
+
+    /// Element name.
+    const char* name_;
+    /// Pointer to member.
+    M T::* member_;
+};
+
+/// Make an entry of the field list.
+template <class T, class M>
+constexpr ArchiveField<T, M> MakeArchiveField(const char* name, M T::* member) { return { name, member }; }
+
+namespace Detail
+{
+
+template <class T> struct IsArchiveFieldVector : std::false_type {};
+template <class T, class A> struct IsArchiveFieldVector<std::vector<T, A>> : std::true_type {};
+
+/// Size of the value in binary archives, or zero if the size is not fixed.
+template <class T, class Enabled = void>
+struct ArchiveFixedSize : std::integral_constant<unsigned, 0> {};
+
+template <class Fields> struct ArchiveFieldsFixedSize;
+
+template <class... Fields>
+struct ArchiveFieldsFixedSize<std::tuple<Fields...>>
+{
+    static constexpr bool fixed_ = ((ArchiveFixedSize<typename Fields::MemberType>::value != 0) && ...);
+    static constexpr unsigned value = fixed_ ? (ArchiveFixedSize<typename Fields::MemberType>::value + ... + 0u) : 0u;
+};
+
+template <class T>
+struct ArchiveFixedSize<T, std::enable_if_t<std::is_arithmetic_v<T>>> : std::integral_constant<unsigned, sizeof(T)> {};
+
+template <class T>
+struct ArchiveFixedSize<T, std::enable_if_t<HasArchiveFields<T>::value>>
+    : std::integral_constant<unsigned, ArchiveFieldsFixedSize<decltype(T::GetArchiveFields())>::value> {};
+
+/// Encode fixed-size value into memory.
+template <class T>
+inline void EncodeArchiveFixed(unsigned char*& dest, const T& value)
+{
+    if constexpr (std::is_same_v<T, bool>)
+        *dest++ = value ? 1 : 0;
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        std::memcpy(dest, &value, sizeof(T));
+        dest += sizeof(T);
+    }
+    else
+    {
+        std::apply([&](const auto&... fields) { (EncodeArchiveFixed(dest, value.*(fields.member_)), ...); },
+            T::GetArchiveFields());
+    }
+}
+
+/// Decode fixed-size value from memory.
+template <class T>
+inline void DecodeArchiveFixed(const unsigned char*& source, T& value)
+{
+    if constexpr (std::is_same_v<T, bool>)
+        value = *source++ != 0;
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        std::memcpy(&value, source, sizeof(T));
+        source += sizeof(T);
+    }
+    else
+    {
+        std::apply([&](const auto&... fields) { (DecodeArchiveFixed(source, value.*(fields.member_)), ...); },
+            T::GetArchiveFields());
+    }
+}
+
+template <class T> bool WriteArchiveField(Serializer& dest, const T& value);
+template <class T> bool ReadArchiveField(Deserializer& source, T& value);
+
+/// Write vector in the format of SerializeVector.
+template <class T, class A>
+inline bool WriteArchiveVector(Serializer& dest, const std::vector<T, A>& vector)
+{
+    if constexpr (std::is_standard_layout_v<T> && std::is_trivially_copyable_v<T>)
+    {
+        const unsigned sizeInBytes = vector.size() * sizeof(T);
+        return dest.WriteVLE(sizeInBytes) && dest.Write(vector.data(), sizeInBytes) == sizeInBytes;
+    }
+    else
+    {
+        if (!dest.WriteVLE(vector.size()))
+            return false;
+        for (const T& element : vector)
+        {
+            if (!WriteArchiveField(dest, element))
+                return false;
+        }
+        return true;
+    }
+}
+
+/// Read vector in the format of SerializeVector.
+template <class T, class A>
+inline bool ReadArchiveVector(Deserializer& source, std::vector<T, A>& vector)
+{
+    if constexpr (std::is_standard_layout_v<T> && std::is_trivially_copyable_v<T>)
+    {
+        const unsigned sizeInBytes = source.ReadVLE();
+        if (sizeInBytes % sizeof(T) != 0 || sizeInBytes > source.GetSize() - source.GetPosition())
+            return false;
+        vector.resize(sizeInBytes / sizeof(T));
+        return source.Read(vector.data(), sizeInBytes) == sizeInBytes;
+    }
+    else
+    {
+        const unsigned numElements = source.ReadVLE();
+        if (source.IsEof() && numElements != 0)
+            return false;
+        vector.clear();
+        vector.resize(numElements);
+        for (T& element : vector)
+        {
+            if (!ReadArchiveField(source, element))
+                return false;
+        }
+        return true;
+    }
+}
+
+/// Write field value as the binary archive would.
+template <class T>
+inline bool WriteArchiveField(Serializer& dest, const T& value)
+{
+    constexpr unsigned fixedSize = ArchiveFixedSize<T>::value;
+    if constexpr (fixedSize != 0)
+    {
+        unsigned char buffer[fixedSize];
+        unsigned char* ptr = buffer;
+        EncodeArchiveFixed(ptr, value);
+        return dest.Write(buffer, fixedSize) == fixedSize;
+    }
+    else if constexpr (std::is_same_v<T, String>)
+        return dest.WriteString(value);
+    else if constexpr (IsArchiveFieldVector<T>::value)
+        return WriteArchiveVector(dest, value);
+    else
+    {
+        static_assert(HasArchiveFields<T>::value, "Type is not supported in compiled field lists");
+        return std::apply([&](const auto&... fields) { return (WriteArchiveField(dest, value.*(fields.member_)) && ...); },
+            T::GetArchiveFields());
+    }
+}
+
+/// Read field value as the binary archive would.
+template <class T>
+inline bool ReadArchiveField(Deserializer& source, T& value)
+{
+    constexpr unsigned fixedSize = ArchiveFixedSize<T>::value;
+    if constexpr (fixedSize != 0)
+    {
+        unsigned char buffer[fixedSize];
+        if (source.Read(buffer, fixedSize) != fixedSize)
+            return false;
+        const unsigned char* ptr = buffer;
+        DecodeArchiveFixed(ptr, value);
+        return true;
+    }
+    else if constexpr (std::is_same_v<T, String>)
+    {
+        value = source.ReadString();
+        return true;
+    }
+    else if constexpr (IsArchiveFieldVector<T>::value)
+        return ReadArchiveVector(source, value);
+    else
+    {
+        static_assert(HasArchiveFields<T>::value, "Type is not supported in compiled field lists");
+        return std::apply([&](const auto&... fields) { return (ReadArchiveField(source, value.*(fields.member_)) && ...); },
+            T::GetArchiveFields());
+    }
+}
+
+/// Whether field values are stored as packed columns by SerializeVectorAsColumns: fixed-size values, packed without
+/// padding as the binary archive would, and trivially copyable values without padding bits, copied as bytes.
+template <class T>
+constexpr bool IsArchiveColumnType = ArchiveFixedSize<T>::value != 0
+    || (std::is_trivially_copyable_v<T> && std::has_unique_object_representations_v<T>);
+
+/// Size of the value in a packed column.
+template <class T>
+constexpr unsigned ArchiveColumnValueSize = ArchiveFixedSize<T>::value != 0 ? ArchiveFixedSize<T>::value : sizeof(T);
+
+/// Buffers shared by all columns of one SerializeVectorAsColumns call and freed after it.
+struct ArchiveColumnScratch
+{
+    /// Packed column.
+    std::vector<unsigned char> column_;
+    /// Base64 text of the column.
+    String text_;
+    /// Compressed column.
+    std::vector<unsigned char> packed_;
+};
+
+/// Serialize one field of all vector elements as a column.
+template <class T, class TField>
+inline void SerializeArchiveColumn(Archive& archive, T& vector, const TField& field, bool compress, ArchiveColumnScratch& scratch)
+{
+    using MemberType = typename TField::MemberType;
+
+    const bool loading = archive.IsInput();
+    const char* name = field.name_;
+    const unsigned numElements = vector.size();
+
+    if constexpr (!IsArchiveColumnType<MemberType>)
+    {
+        auto block = archive.OpenArrayBlock(name, numElements);
+        if (loading && block.GetSizeHint() != numElements)
+            throw ArchiveException("'{}/{}' has unexpected array size", archive.GetCurrentBlockPath().c_str(), name);
+
+        for (auto& element : vector)
+            SerializeValue(archive, "element", element.*(field.member_));
+    }
+    else
+    {
+        constexpr unsigned valueSize = ArchiveColumnValueSize<MemberType>;
+        std::vector<unsigned char>& column = scratch.column_;
+        const unsigned columnSize = numElements * valueSize;
+        column.resize(columnSize);
+
+        if (!loading)
+        {
+            unsigned char* ptr = column.data();
+            for (const auto& element : vector)
+            {
+                if constexpr (ArchiveFixedSize<MemberType>::value != 0)
+                    EncodeArchiveFixed(ptr, element.*(field.member_));
+                else
+                {
+                    std::memcpy(ptr, &(element.*(field.member_)), valueSize);
+                    ptr += valueSize;
+                }
+            }
+        }
+
+        if (archive.IsHumanReadable())
+        {
+            String& text = scratch.text_;
+            if (!loading)
+                BufferToBase64String(text, column.data(), columnSize);
+            archive.Serialize(name, text);
+            if (loading && (!Base64StringToBuffer(column, text) || column.size() != columnSize))
+                throw ArchiveException("'{}/{}' has unexpected column data", archive.GetCurrentBlockPath().c_str(), name);
+        }
+        else
+        {
+            // Packed size is zero for uncompressed columns
+            std::vector<unsigned char>& packed = scratch.packed_;
+            unsigned packedSize = 0;
+            if (!loading && compress)
+            {
+                packed.resize(EstimateCompressBound(columnSize));
+                packedSize = CompressData(packed.data(), column.data(), columnSize);
+                if (packedSize >= columnSize)
+                    packedSize = 0;
+            }
+
+            archive.SerializeVLE(name, packedSize);
+            if (packedSize == 0)
+                archive.SerializeBytes(name, column.data(), columnSize);
+            else
+            {
+                if (loading)
+                {
+                    if (packedSize > EstimateCompressBound(columnSize))
+                        throw ArchiveException("'{}/{}' has unexpected column size", archive.GetCurrentBlockPath().c_str(), name);
+                    packed.resize(packedSize);
+                }
+                archive.SerializeBytes(name, packed.data(), packedSize);
+                if (loading && !DecompressData(column.data(), columnSize, packed.data(), packedSize))
+                    throw ArchiveException("'{}/{}' has unexpected column data", archive.GetCurrentBlockPath().c_str(), name);
+            }
+        }
+
+        if (loading)
+        {
+            const unsigned char* ptr = column.data();
+            for (auto& element : vector)
+            {
+                if constexpr (ArchiveFixedSize<MemberType>::value != 0)
+                    DecodeArchiveFixed(ptr, element.*(field.member_));
+                else
+                {
+                    std::memcpy(&(element.*(field.member_)), ptr, valueSize);
+                    ptr += valueSize;
+                }
+            }
+        }
+    }
+}
+
+}
+
+namespace LibSTD
+{
+
+/// Serialize vector of objects with a compiled field list as columns: the number of elements, then each field of all
+/// elements as one contiguous array. Fixed-size fields and trivially copyable fields without padding are packed, as
+/// base64 strings in human-readable archives and as raw bytes in binary archives, LZ4-compressed if requested and
+/// smaller. Other fields are serialized as arrays of values. Field names must not be "size".
+template <class T>
+void SerializeVectorAsColumns(Archive& archive, const char* name, T& vector, bool compress = false)
+{
+    using ValueType = typename T::value_type;
+    static_assert(HasArchiveFields<ValueType>::value, "Type should have a compiled field list to use column serialization");
+
+    ArchiveBlock block = archive.OpenUnorderedBlock(name);
+
+    unsigned numElements = vector.size();
+    archive.SerializeVLE("size", numElements);
+    if (archive.IsInput())
+    {
+        vector.clear();
+        vector.resize(numElements);
+    }
+
+    Detail::ArchiveColumnScratch scratch;
+    std::apply([&](const auto&... fields) { (Detail::SerializeArchiveColumn(archive, vector, fields, compress, scratch), ...); },
+        ValueType::GetArchiveFields());
+}
+
+}
+
+/// Serialize each field of the compiled field list as a named element of the current block.
+template <class T>
+inline void SerializeArchiveFields(Archive& archive, T& value)
+{
+    std::apply([&](const auto&... fields) { (SerializeValue(archive, fields.name_, value.*(fields.member_)), ...); },
+        T::GetArchiveFields());
+}
+
+/// Serialize object with a compiled field list.
+template <class T, std::enable_if_t<HasArchiveFields<T>::value, int> = 0>
+inline void SerializeValue(Archive& archive, const char* name, T& value)
+{
+    ArchiveBlock block = archive.OpenUnorderedBlock(name);
+
+    if (archive.IsInput())
+    {
+        if (Deserializer* source = archive.GetBinaryDeserializer(name))
+        {
+            if (!Detail::ReadArchiveField(*source, value))
+                throw ArchiveException("Unspecified I/O failure before '{}/{}'", archive.GetCurrentBlockPath().c_str(), name);
+            return;
+        }
+    }
+    else if (Serializer* dest = archive.GetBinarySerializer(name))
+    {
+        if (!Detail::WriteArchiveField(*dest, value))
+            throw ArchiveException("Unspecified I/O failure before '{}/{}'", archive.GetCurrentBlockPath().c_str(), name);
+        return;
+    }
+
+    SerializeArchiveFields(archive, value);
+}
+
+}
@@ -73,6 +73,8 @@ public:
     
     void SerializeBytes(const char* name, void* bytes, unsigned size) final;
     void SerializeVLE(const char* name, unsigned& value) final;
+
+    Serializer* GetBinarySerializer(const char* name) final;
     /// @}
 
 private:
@@ -149,6 +151,8 @@ public:
     void SerializeBytes(const char *name, void *bytes, unsigned size) final;
 
     void SerializeVLE(const char *name, unsigned &value) final;
+
+    Deserializer* GetBinaryDeserializer(const char* name) final;
     /// @}
 
 private:
@@ -4,7 +4,10 @@
 #include <SeMath/Rect.hpp>
 #include <SeResource/Resource.h>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace Se
 {
@@ -26,6 +29,48 @@ enum CompressedFormat
     CF_PVRTC_RGBA_2BPP,
     CF_PVRTC_RGB_4BPP,
     CF_PVRTC_RGBA_4BPP,
+    CF_BC4,
+    CF_BC5,
+    CF_BC7,
+};
+
+/// Downsampling filter for mip level generation.
+enum class MipFilter
+{
+    /// 2x2 box filter.
+    Box,
+    /// Kaiser-windowed sinc. Sharper than box, at a higher cost.
+    Kaiser
+};
+
+/// Resampling filter for Image::Resize().
+enum class ResizeFilter
+{
+    /// Catmull-Rom when upsampling, Mitchell when downsampling.
+    Default,
+    /// Box filter.
+    Box,
+    /// Triangle filter. Same as bilinear when upsampling.
+    Triangle,
+    /// Cubic B-spline.
+    CubicBSpline,
+    /// Catmull-Rom spline.
+    CatmullRom,
+    /// Mitchell-Netravali filter.
+    Mitchell,
+    /// Nearest neighbour.
+    Point
+};
+
+/// Storage format of the channels of uncompressed image data.
+enum class ChannelFormat
+{
+    /// 8-bit unsigned normalized.
+    UNorm8,
+    /// 16-bit half float.
+    Float16,
+    /// 32-bit float.
+    Float32
 };
 
 /// Compressed image mip level.
@@ -54,6 +99,31 @@ struct SE_API CompressedLevel
     unsigned rows_{};
 };
 
+/// %Image properties read from a file header without decoding the pixels.
+struct SE_API ImageInfo
+{
+    /// Width.
+    int width_{};
+    /// Height.
+    int height_{};
+    /// Depth.
+    int depth_{1};
+    /// Number of color components after loading.
+    unsigned components_{};
+    /// Channel format of uncompressed data after loading.
+    ChannelFormat channelFormat_{ChannelFormat::UNorm8};
+    /// Compressed format.
+    CompressedFormat compressedFormat_{CF_NONE};
+    /// Number of mip levels stored in the file.
+    unsigned numLevels_{1};
+    /// Cubemap status if DDS.
+    bool cubemap_{};
+    /// Texture array status if DDS.
+    bool array_{};
+    /// Data is sRGB.
+    bool sRGB_{};
+};
+
 /// %Image resource.
 class SE_API Image : public Resource
 {
@@ -67,17 +137,37 @@ public:
 
     inline static String GetTypeStatic() { return "Image"; }
 
-    /// Load resource from stream. May be called from a worker thread. Return true if successful.
+    /// Load resource from stream. May be called from a worker thread. With lazy decoding only the header is parsed and the file is kept encoded. Return true if successful.
     bool BeginLoad(Deserializer& source) override;
+    /// Read image properties from the header of an image file at the start of the stream without decoding pixels. The stream position is left undefined. Return true if the format is recognized.
+    static bool ReadInfo(Deserializer& source, ImageInfo& info);
+    /// Set whether to keep loaded files encoded until the pixels are accessed through GetData(), GetCompressedLevel() or any other operation on them. Memory use reports the encoded size until then. For images loaded by ResourceCache, register Image with a factory that enables it.
+    void SetLazyDecode(bool enable) { lazyDecode_ = enable; }
+    /// Return whether lazy decoding is enabled.
+    bool GetLazyDecode() const { return lazyDecode_; }
+    /// Return whether a lazily loaded file has not been decoded yet.
+    bool IsDecodePending() const { return decodePending_; }
+    /// Decode a lazily loaded file now. Safe to call from several threads at once, the first one decodes and the others wait for it. Return true if successful or if nothing was pending.
+    bool DecodePending() const { return !decodePending_.load(std::memory_order_acquire) || DecodeEncodedData(); }
     /// Save the image to a stream. Regardless of original format, the image is saved as png. Compressed image data is not supported. Return true if successful.
     bool Save(Serializer& dest) const override;
     /// Save the image to a file. Format of the image is determined by file extension. JPG is saved with maximum quality.
     bool SaveFile(const FileIdentifier& fileName) const override;
+    /// Return version of the cooked binary form, or 0 for compressed, cubemap and array images which are not cooked.
+    unsigned GetCookVersion() const override;
+    /// Save decoded pixel data as cooked binary form. Return false for compressed, cubemap or array images.
+    bool SaveCooked(Serializer& dest) const override;
+    /// Load decoded pixel data from cooked binary form. Return true if successful.
+    bool LoadCooked(Deserializer& source) override;
 
     /// Set 2D size and number of color components. Old image data will be destroyed and new data is undefined. Return true if successful.
     bool SetSize(int width, int height, unsigned components);
     /// Set 3D size and number of color components. Old image data will be destroyed and new data is undefined. Return true if successful.
     bool SetSize(int width, int height, int depth, unsigned components);
+    /// Set 2D size, number of color components and channel format. Old image data will be destroyed and new data is undefined. Return true if successful.
+    bool SetSize(int width, int height, unsigned components, ChannelFormat format);
+    /// Set 3D size, number of color components and channel format. Old image data will be destroyed and new data is undefined. Return true if successful.
+    bool SetSize(int width, int height, int depth, unsigned components, ChannelFormat format);
     /// Set new image data.
     void SetData(const unsigned char* pixelData);
     /// Set a 2D pixel.
@@ -94,8 +184,12 @@ public:
     bool FlipHorizontal();
     /// Flip image vertically. Return true if successful.
     bool FlipVertical();
-    /// Resize image by bilinear resampling. Return true if successful.
+    /// Resize image with the default filter. Array siblings are resized too. Return true if successful.
     bool Resize(int width, int height);
+    /// Resize image with the specified filter, optionally treating color channels as sRGB. Array siblings are resized too. Return true if successful.
+    bool Resize(int width, int height, ResizeFilter filter, bool sRGB = false);
+    /// Resize 3D image with the specified filter, optionally treating color channels as sRGB. Array siblings are resized too; if any of them fails, none are changed. Uncompressed DDS images lose their mip levels. Return true if successful.
+    bool Resize(int width, int height, int depth, ResizeFilter filter, bool sRGB = false);
     /// Clear the image with a color.
     void Clear(const Color& color);
     /// Clear the image with an integer color. R component is in the 8 lowest bits.
@@ -110,6 +204,10 @@ public:
     bool SaveJPG(const String& fileName, int quality) const;
     /// Save in DDS format. Only uncompressed RGBA images are supported. Return true if successful.
     bool SaveDDS(const String& fileName) const;
+    /// Save in DDS format compressed to CF_DXT1, CF_DXT5, CF_BC4, CF_BC5 or CF_BC7 with a full mip chain. Existing mip levels are used and missing ones generated. Only uncompressed 8-bit 2D images are supported. Return true if successful.
+    bool SaveDDS(const String& fileName, CompressedFormat format) const;
+    /// Save in Radiance HDR format. Color channels are written as linear values, alpha is dropped. Return true if successful.
+    bool SaveHDR(const String& fileName) const;
     /// Save in WebP format with minimum (fastest) or specified compression. Return true if successful. Fails always if WebP support is not compiled in.
     bool SaveWEBP(const String& fileName, float compression = 0.0f) const;
     /// Whether this texture is detected as a cubemap, only relevant for DDS.
@@ -147,8 +245,17 @@ public:
     /// Return number of color components.
     unsigned GetComponents() const { return components_; }
 
-    /// Return pixel data.
-    unsigned char* GetData() const { return data_.get(); }
+    /// Return channel format of uncompressed pixel data.
+    ChannelFormat GetChannelFormat() const { return channelFormat_; }
+
+    /// Return size of one channel in bytes.
+    unsigned GetChannelSize() const { return channelFormat_ == ChannelFormat::Float32 ? 4 : (channelFormat_ == ChannelFormat::Float16 ? 2 : 1); }
+
+    /// Return size of one pixel in bytes.
+    unsigned GetPixelSize() const { return components_ * GetChannelSize(); }
+
+    /// Return pixel data. Float16 and Float32 images store uint16_t and float channels.
+    unsigned char* GetData() const { DecodePending(); return data_.get(); }
 
     /// Return whether is compressed.
     bool IsCompressed() const { return compressedFormat_ != CF_NONE; }
@@ -162,9 +269,11 @@ public:
     /// Return next mip level by bilinear filtering. Note that if the image is already 1x1x1, will keep returning an image of that size.
     std::shared_ptr<Image> GetNextLevel() const;
     /// Return the next sibling image of an array or cubemap.
-    std::shared_ptr<Image> GetNextSibling() const { return nextSibling_;  }
+    std::shared_ptr<Image> GetNextSibling() const { DecodePending(); return nextSibling_;  }
     /// Return image converted to 4-component (RGBA) to circumvent modern rendering API's not supporting e.g. the luminance-alpha format.
     std::shared_ptr<Image> ConvertToRGBA() const;
+    /// Return uncompressed image converted to another channel format. Converting between 8-bit and float optionally decodes or encodes sRGB color channels. Float values are clamped to 0-1 when converting to 8-bit.
+    std::shared_ptr<Image> ConvertToChannelFormat(ChannelFormat format, bool sRGB = false) const;
     /// Return a compressed mip level.
     CompressedLevel GetCompressedLevel(unsigned index) const;
     ///
@@ -175,6 +284,8 @@ public:
     std::shared_ptr<Image> GetSubimage(const IntRect& rect) const;
     /// Precalculate the mip levels. Used by asynchronous texture loading.
     void PrecalculateLevels();
+    /// Generate the whole mip chain of a 2D image at once, replacing precalculated levels. Rows are processed in parallel on the WorkQueue when called from the main thread. Gamma-correct filtering averages color channels in linear space; float images are always filtered as they are. Return true if successful.
+    bool GenerateLevels(MipFilter filter = MipFilter::Box, bool gammaCorrect = false);
     /// Whether this texture has an alpha channel
     bool HasAlphaChannel() const;
     /// Copy contents of the image into the defined rect, scaling if necessary. This image should already be large enough to include the rect. Compressed and 3D images are not supported.
@@ -185,16 +296,24 @@ public:
     void GetLevels(std::vector<Image*>& levels);
     /// Get all stored mip levels starting from this.
     void GetLevels(std::vector<const Image*>& levels) const;
-    ///
-    int GetBits() { return bits_; }
-
-    bool IsHDR() {return isHDR_; }
+    /// Return number of bits per pixel of uncompressed data.
+    int GetBits() const { return GetPixelSize() * 8; }
+    /// Return whether pixel data is stored as half or full floats.
+    bool IsHDR() const { return channelFormat_ != ChannelFormat::UNorm8; }
 
 private:
-    /// Decode an image using stb_image.
-    static unsigned char* GetImageData(Deserializer& source, int& width, int& height, int& bits, unsigned& components, bool& isHDR);
+    /// Decode pixels from stream. Return true if successful.
+    bool LoadPixels(Deserializer& source);
+    /// Decode the kept file under the decode mutex. Return true if successful.
+    bool DecodeEncodedData() const;
+    /// Decode an image using stb_image. HDR images are decoded to float channels.
+    static unsigned char* GetImageData(Deserializer& source, int& width, int& height, unsigned& components, bool& isHDR);
     /// Free an image file's pixel data.
     static void FreeImageData(unsigned char* pixelData);
+    /// Take ownership of decoded 2D pixel data as the image data without copying it. The data is released with FreeImageData(), also on failure.
+    bool AdoptImageData(unsigned char* pixelData, int width, int height, unsigned components);
+    /// Resample the pixels of this image only to a new size without changing the image. Leave newData null if the size is unchanged. Return true if successful.
+    bool ResampleData(std::shared_ptr<unsigned char>& newData, int width, int height, int depth, ResizeFilter filter, bool sRGB);
 
     /// Width.
     int width_{};
@@ -214,18 +333,22 @@ private:
     bool sRGB_{};
     /// Compressed format.
     CompressedFormat compressedFormat_{CF_NONE};
-    /// Pixel data.
-    std::shared_ptr<unsigned char> data_;
-    /// Precalculated mip level image.
-    std::shared_ptr<Image> nextLevel_;
-    /// Next texture array or cube map image.
-    std::shared_ptr<Image> nextSibling_;
-
-    int sizeOfChannel_{0};
-
-    int bits_{32};
-
-    bool isHDR_{false};
+    /// Channel format of uncompressed data.
+    ChannelFormat channelFormat_{ChannelFormat::UNorm8};
+    /// Pixel data. Mutable to be filled in by lazy decoding.
+    mutable std::shared_ptr<unsigned char> data_;
+    /// Precalculated mip level image. Mutable to be filled in by lazy decoding.
+    mutable std::shared_ptr<Image> nextLevel_;
+    /// Next texture array or cube map image. Mutable to be filled in by lazy decoding.
+    mutable std::shared_ptr<Image> nextSibling_;
+    /// Lazy decoding flag.
+    bool lazyDecode_{};
+    /// File data kept until the pixels are accessed.
+    mutable std::vector<unsigned char> encodedData_;
+    /// Whether the kept file has not been decoded yet. Set after the decoded pixels are stored.
+    mutable std::atomic<bool> decodePending_{};
+    /// Serializes lazy decoding between threads.
+    mutable std::mutex decodeMutex_;
 };
 
 }
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <SeResource/Image.h>
+
+#include <SeArc/ArchiveSerialization.hpp>
+#include <SeMath/ArchiveMath.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+namespace Se
+{
+
+/// Placement of a single image inside an atlas.
+struct SE_API ImageAtlasEntry
+{
+    /// Image name used for lookup.
+    String name_;
+    /// Index of the atlas page.
+    unsigned page_{};
+    /// Pixel rectangle of the image on the page, without padding and extrusion.
+    IntRect rect_{IntRect::ZERO};
+    /// Texture coordinates of the image on the page. Derived from the rectangle and the page size, not serialized.
+    Rect uv_{Rect::ZERO};
+
+    /// Serialize content from/to archive.
+    void SerializeInBlock(Archive& archive);
+};
+
+/// Packs many images into power-of-two atlas pages with stb_rect_pack and keeps a UV lookup table for them.
+class SE_API ImageAtlas
+{
+public:
+    /// Construct.
+    ImageAtlas() = default;
+
+    /// Set maximum page width and height. Rounded up to a power of two.
+    void SetMaxPageSize(int size);
+    /// Set empty pixels left between neighbouring images. Negative values are clamped to zero.
+    void SetPadding(int padding) { padding_ = Max(padding, 0); }
+    /// Set number of pixels the edges of each image are repeated outwards to avoid bleeding when filtering. Negative
+    /// values are clamped to zero.
+    void SetExtrude(int extrude) { extrude_ = Max(extrude, 0); }
+    /// Add image to be packed. Images with different channel formats can not share an atlas; 8-bit images with
+    /// differing component counts are expanded to RGBA and compressed images are decompressed. Return false if the name
+    /// is already used.
+    bool AddImage(const String& name, std::shared_ptr<Image> image);
+    /// Remove all added images, pages and entries.
+    void Clear();
+
+    /// Pack all added images into pages and blit them. Images are blitted in parallel on the WorkQueue when called
+    /// from the main thread. Return true if successful.
+    bool Build();
+
+    /// Return maximum page size.
+    int GetMaxPageSize() const { return maxPageSize_; }
+    /// Return padding between images.
+    int GetPadding() const { return padding_; }
+    /// Return edge extrusion.
+    int GetExtrude() const { return extrude_; }
+    /// Return page images. Empty when the lookup table was loaded from an archive.
+    const std::vector<std::shared_ptr<Image>>& GetPages() const { return pages_; }
+    /// Return page sizes.
+    const std::vector<IntVector2>& GetPageSizes() const { return pageSizes_; }
+    /// Return all entries in the order the images were added.
+    const std::vector<ImageAtlasEntry>& GetEntries() const { return entries_; }
+    /// Return entry by image name, or null if not found.
+    const ImageAtlasEntry* GetEntry(const String& name) const;
+
+    /// Serialize the lookup table (page sizes and entries) from/to archive. Page images are not serialized.
+    void SerializeInBlock(Archive& archive);
+
+private:
+    /// Recalculate texture coordinates and the name index from entry rectangles.
+    void UpdateLookup();
+
+    /// Input images.
+    std::vector<std::shared_ptr<Image>> images_;
+    /// Packed pages.
+    std::vector<std::shared_ptr<Image>> pages_;
+    /// Page sizes.
+    std::vector<IntVector2> pageSizes_;
+    /// Entries in input order.
+    std::vector<ImageAtlasEntry> entries_;
+    /// Entry index by name.
+    std::unordered_map<String, unsigned> entryIndices_;
+    /// Maximum page size.
+    int maxPageSize_{2048};
+    /// Padding between images.
+    int padding_{1};
+    /// Edge extrusion.
+    int extrude_{1};
+};
+
+}
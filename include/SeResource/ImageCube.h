@@ -9,6 +9,7 @@
 #endif
 
 
+#include <array>
 #include <vector>
 
 namespace Se
@@ -55,12 +56,20 @@ public:
     /// Load resource from stream. May be called from a worker thread. Return true if successful.
     bool BeginLoad(Deserializer& source) override;
 
+    /// Set face images. Faces must be square and of the same size. Return true if successful.
+    bool SetFaceImages(const std::vector<std::shared_ptr<Image>>& faces);
+    /// Set faces from an equirectangular (latitude-longitude) panorama by bilinear sampling. Faces are RGBA in given
+    /// channel format. 8-bit images are treated as sRGB. Return true if successful.
+    bool SetEquirectangular(const Image* image, int width, ChannelFormat format = ChannelFormat::Float16);
+
     /// Return face images.
     const std::vector<std::shared_ptr<Image>>& GetImages() const { return faceImages_; }
     /// Return parameters XML.
     XMLFile* GetParametersXML() const { return parametersXml_.get(); }
     /// Return image data from a face's zero mip level.
     Image* GetImage(CubeMapFace face) const { return faceImages_[face].get(); }
+    /// Return face width.
+    int GetWidth() const { return width_; }
     /// Return mip level used for SH calculation.
     unsigned GetSphericalHarmonicsMipLevel() const;
     /// Return decompressed cube image mip level.
@@ -68,6 +77,19 @@ public:
     /// Return decompressed cube image.
     std::shared_ptr<ImageCube> GetDecompressedImage() const;
 
+    /// Return an equirectangular panorama of width x width / 2 pixels sampled bilinearly from the faces. 8-bit images are
+    /// treated as sRGB.
+    std::shared_ptr<Image> GetEquirectangular(int width, ChannelFormat format = ChannelFormat::Float16) const;
+    /// Project the cube map onto the 9 real spherical harmonics of bands 0-2, weighting each texel by its solid angle.
+    /// Coefficients are ordered as L00, L1-1, L10, L11, L2-2, L2-1, L20, L21, L22.
+    std::array<Vector3, 9> ProjectSphericalHarmonics9() const;
+    /// Generate GGX prefiltered levels for image based specular lighting. Level i is width >> i texels wide with
+    /// roughness i / (numLevels - 1); level 0 is a copy of the faces. Other levels convolve a box-filtered copy of the
+    /// cube that is at most maxSourceWidth texels wide. Rows are processed in parallel on the WorkQueue when called from
+    /// the main thread. Return empty if failed.
+    std::vector<std::shared_ptr<ImageCube>> GeneratePrefilteredGGX(unsigned numLevels,
+        ChannelFormat format = ChannelFormat::Float16, int maxSourceWidth = 64) const;
+
     /// Return nearest pixel color at given direction.
     Color SampleNearest(const Vector3& direction) const;
     /// Return offset from the center of the unit cube for given texel (assuming zero mip level).
@@ -87,6 +109,11 @@ public:
     static std::pair<CubeMapFace, Vector2> ProjectDirectionOnFace(const Vector3& direction);
 
 private:
+    /// Recalculate width and memory use from the face images. Return false if the faces are not square and of the same size.
+    bool UpdateFaceSize();
+    /// Return the faces converted to linear float RGBA. Return false if any face is missing.
+    bool GetFloatFaces(std::vector<std::shared_ptr<Image>>& faces) const;
+
     /// Face images.
     std::vector<std::shared_ptr<Image>> faceImages_;
     /// Parameter file.
@@ -2,13 +2,19 @@
 
 #include <SeResource/Image.h>
 
+#include <mutex>
+#include <unordered_map>
+
+struct NSVGimage;
+
 namespace Se
 {
 
 class Deserializer;
 
 
-/// SVG Image resource.
+/// SVG Image resource. The parsed document is kept after loading so that other sizes can be rasterized without parsing
+/// again.
 class ImageSVG : public Image
 {
 public:
@@ -23,9 +29,79 @@ public:
 
     float GetDPI() const { return dpi_; }
 
+    /// Return the document rasterized into given size at given DPI, or at the current DPI if zero. The document is
+    /// scaled to the width, like when loading, and cropped or left empty below if the aspect ratios differ. Results are
+    /// cached per size and DPI, evicting the least recently used ones over the cache size limit. Large outputs are
+    /// rasterized in parallel row bands on the WorkQueue when called from the main thread. Return null if the document
+    /// is not loaded.
+    std::shared_ptr<Image> GetRaster(int width, int height, float dpi = 0.0f);
+    /// Set maximum memory use of cached rasters in bytes. Least recently used rasters are evicted to fit.
+    void SetMaxRasterCacheSize(unsigned size);
+    /// Drop all cached rasters.
+    void ClearRasterCache();
+    /// Return maximum memory use of cached rasters in bytes.
+    unsigned GetMaxRasterCacheSize() const { return maxRasterCacheSize_; }
+    /// Return memory use of cached rasters in bytes.
+    unsigned GetRasterCacheSize() const;
+    /// Return number of cached rasters.
+    unsigned GetNumCachedRasters() const;
+
 private:
+    /// Raster cache key.
+    struct RasterKey
+    {
+        /// Test for equality.
+        bool operator ==(const RasterKey& rhs) const { return width_ == rhs.width_ && height_ == rhs.height_ && dpi_ == rhs.dpi_; }
+
+        /// Width.
+        int width_;
+        /// Height.
+        int height_;
+        /// DPI.
+        float dpi_;
+    };
+
+    /// Raster cache key hasher.
+    struct RasterKeyHash
+    {
+        std::size_t operator ()(const RasterKey& key) const
+        {
+            return std::hash<int>()(key.width_) ^ (std::hash<int>()(key.height_) << 1) ^ (std::hash<float>()(key.dpi_) << 2);
+        }
+    };
+
+    /// Cached raster.
+    struct CachedRaster
+    {
+        /// Raster image.
+        std::shared_ptr<Image> image_;
+        /// Value of the use counter when last returned.
+        unsigned long long lastUse_;
+    };
+
+    /// Parse the document text at given DPI, replacing the parsed document. Return true if successful.
+    bool ParseDocument(float dpi);
+    /// Evict least recently used rasters until the cache uses at most given bytes. Called with the raster mutex held.
+    void EvictRasters(unsigned size);
+
     float dpi_{96.0f};
+    /// Document text kept for parsing at another DPI.
+    String svgData_;
+    /// Parsed document.
+    std::shared_ptr<NSVGimage> document_;
+    /// DPI the document was parsed with.
+    float documentDPI_{};
+    /// Cached rasters.
+    std::unordered_map<RasterKey, CachedRaster, RasterKeyHash> rasters_;
+    /// Memory use of cached rasters in bytes.
+    unsigned rasterCacheSize_{};
+    /// Maximum memory use of cached rasters in bytes.
+    unsigned maxRasterCacheSize_{16 * 1024 * 1024};
+    /// Raster use counter for least recently used eviction.
+    unsigned long long rasterUseCount_{};
+    /// Guards the parsed document and the raster cache.
+    mutable std::mutex rasterMutex_;
 
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <SeResource/BinaryArchive.h>
+#include <Se/IO/MappedFile.h>
+#include <Se/IO/VectorBuffer.h>
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Se
+{
+
+/// Block entry in the table of contents of an indexed archive.
+struct IndexedArchiveEntry
+{
+    /// Offset from the beginning of the file.
+    unsigned offset_{};
+    /// Block size.
+    unsigned size_{};
+};
+
+/// Writes a container of named, independently loadable binary archive blocks.
+///
+/// Layout: file ID, blocks in the order of saving, table of contents with the name, offset and size of each block, and
+/// a footer with the offset of the table of contents. Each block is a complete BinaryOutputArchive stream.
+class IndexedArchiveWriter
+{
+public:
+    /// Construct empty.
+    IndexedArchiveWriter();
+
+    /// Save object as a new block, or replace the block with the same name. Return true if successful.
+    /// @{
+    bool SaveObjectCallback(const String& name, const std::function<void(Archive&)>& serializeValue);
+    template <class T, class ... Args> bool SaveObject(const String& name, const T& object, Args &&... args);
+    /// @}
+
+    /// Write the container to a stream. Return true if successful.
+    bool Save(Serializer& dest) const;
+    /// Write the container to a file. Return true if successful.
+    bool SaveFile(const String& fileName) const;
+
+    /// Return number of blocks.
+    unsigned GetNumBlocks() const { return static_cast<unsigned>(names_.size()); }
+
+private:
+    /// Block data.
+    VectorBuffer data_;
+    /// Block names in the order of saving.
+    std::vector<String> names_;
+    /// Blocks by name.
+    std::unordered_map<String, IndexedArchiveEntry> entries_;
+};
+
+/// Reads blocks of a container written by IndexedArchiveWriter. Files are memory-mapped, so opening reads only the table
+/// of contents and loading an object touches only the pages of its block.
+class IndexedArchiveReader
+{
+public:
+    /// Open file. Return true if successful.
+    bool Open(const String& fileName);
+    /// Read the container from a stream into memory. Return true if successful.
+    bool Load(Deserializer& source);
+    /// Close the file and forget the blocks.
+    void Close();
+
+    /// Return whether the block exists.
+    bool HasObject(const String& name) const { return entries_.find(name) != entries_.end(); }
+    /// Return block entry, or null if not found.
+    const IndexedArchiveEntry* GetEntry(const String& name) const;
+    /// Return all block entries.
+    const std::unordered_map<String, IndexedArchiveEntry>& GetEntries() const { return entries_; }
+
+    /// Load object from the block with the given name. Return true if successful.
+    /// @{
+    bool LoadObjectCallback(const String& name, const std::function<void(Archive&)>& serializeValue) const;
+    template <class T, class ... Args> bool LoadObject(const String& name, T& object, Args &&... args) const;
+    /// @}
+
+private:
+    /// Read the table of contents of the container data. Return true if successful.
+    bool ReadIndex(const String& sourceName);
+    /// Return container data.
+    const unsigned char* GetData() const { return file_.IsOpen() ? file_.GetData() : buffer_.data(); }
+    /// Return container size.
+    std::size_t GetSize() const { return file_.IsOpen() ? file_.GetSize() : buffer_.size(); }
+
+    /// Mapped file.
+    MappedFile file_;
+    /// Container data read from a stream.
+    std::vector<unsigned char> buffer_;
+    /// Blocks by name.
+    std::unordered_map<String, IndexedArchiveEntry> entries_;
+};
+
+template <class T, class ... Args>
+bool IndexedArchiveWriter::SaveObject(const String& name, const T& object, Args &&... args)
+{
+    return SaveObjectCallback(name, [&](Archive& archive) {
+                                  SerializeValue(archive, name.c_str(), const_cast<T&>(object), std::forward<Args>(args)...);
+                              });
+}
+
+template <class T, class ... Args>
+bool IndexedArchiveReader::LoadObject(const String& name, T& object, Args &&... args) const
+{
+    return LoadObjectCallback(name, [&](Archive& archive) {
+                                  SerializeValue(archive, name.c_str(), object, std::forward<Args>(args)...);
+                              });
+}
+
+}
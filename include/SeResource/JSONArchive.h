@@ -7,9 +7,16 @@
 #include <SeResource/JSONValue.h>
 #include <Se/Math.hpp>
 
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+
 namespace Se
 {
 
+class Deserializer;
+class JSONStreamReader;
+
 /// Base archive for JSON serialization.
 template <class BlockType, bool IsInputBool>
 class JSONArchiveBase : public ArchiveBaseT<BlockType, IsInputBool, true>
@@ -173,4 +180,123 @@ private:
     const Value& rootValue_;
 };
 
+/// Token read from a JSON stream. Internal.
+struct JSONStreamToken
+{
+    /// Token type. Keys and container ends are separate tokens.
+    enum Type
+    {
+        Null,
+        Bool,
+        Number,
+        String,
+        Key,
+        StartObject,
+        EndObject,
+        StartArray,
+        EndArray,
+        End
+    };
+
+    /// Type.
+    Type type_{End};
+    /// Boolean value.
+    bool boolValue_{};
+    /// Number value.
+    double numberValue_{};
+    /// Number type.
+    ValueNumberType numberType_{VALUE_NT_NAN};
+    /// String value or key. Null-terminated.
+    std::string_view stringValue_;
+};
+
+/// Streaming JSON input archive block. Internal.
+struct JSONStreamInputArchiveBlock : public ArchiveBlockBase
+{
+public:
+    /// Construct block that reads its items from the stream.
+    JSONStreamInputArchiveBlock(const char* name, ArchiveBlockType type, JSONStreamReader* reader, unsigned sizeHint);
+    /// Construct block over a buffered value.
+    JSONStreamInputArchiveBlock(const char* name, ArchiveBlockType type, const Value* value);
+    /// Move-construct. Blocks are never copied, so buffered members keep their addresses.
+    JSONStreamInputArchiveBlock(JSONStreamInputArchiveBlock&& other) = default;
+    /// Return size hint.
+    unsigned GetSizeHint() const { return value_ ? value_->Size() : sizeHint_; }
+    /// Read current child and move to the next one. Return its value if it was buffered, otherwise return null and
+    /// store its first token.
+    const Value* ReadElement(ArchiveBase& archive, const char* elementName, JSONStreamToken& token);
+
+    bool IsUnorderedAccessSupported() const { return type_ == ArchiveBlockType::Unordered; }
+    bool HasElementOrBlock(const char* name) const;
+    void Close(ArchiveBase& archive);
+
+private:
+    /// Read members until the one with given key. Members before it are buffered. Return false if the object ends.
+    bool SeekMember(const char* name) const;
+    /// Read the value of the current member into the buffer.
+    void BufferMember(const String& key) const;
+
+    /// Reader of the stream. Null for buffered blocks.
+    JSONStreamReader* reader_{};
+    /// Buffered block value.
+    const Value* value_{};
+    /// Number of array elements in the stream.
+    unsigned sizeHint_{};
+    /// Next array index.
+    unsigned nextElementIndex_{};
+    /// Object members that were read from the stream before they were asked for. Child blocks may point into them.
+    mutable std::unordered_map<String, Value> bufferedMembers_;
+    /// Key whose value is next in the stream.
+    mutable String pendingKey_;
+    /// Whether a key was read and its value was not.
+    mutable bool hasPendingKey_{};
+    /// Whether the end of the container was read.
+    mutable bool ended_{};
+};
+
+/// JSON input archive that drives serialization straight from a pull parser instead of a loaded Value tree. Items of
+/// Unordered blocks are read in file order; only members that precede the requested one are buffered.
+class JSONStreamInputArchive : public ArchiveBaseT<JSONStreamInputArchiveBlock, true, true>
+{
+public:
+    /// Construct from the rest of the stream. The text is parsed during serialization.
+    explicit JSONStreamInputArchive(Deserializer& source);
+    /// Destruct.
+    ~JSONStreamInputArchive() override;
+
+    /// @name Archive implementation
+    /// @{
+    String GetName() const override { return name_; }
+
+    void BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type) final;
+
+    void Serialize(const char* name, bool& value) final;
+    void Serialize(const char* name, signed char& value) final;
+    void Serialize(const char* name, unsigned char& value) final;
+    void Serialize(const char* name, short& value) final;
+    void Serialize(const char* name, unsigned short& value) final;
+    void Serialize(const char* name, int& value) final;
+    void Serialize(const char* name, unsigned int& value) final;
+    void Serialize(const char* name, long long& value) final;
+    void Serialize(const char* name, unsigned long long& value) final;
+    void Serialize(const char* name, float& value) final;
+    void Serialize(const char* name, double& value) final;
+    void Serialize(const char* name, String& value) final;
+
+    void SerializeBytes(const char* name, void* bytes, unsigned size) final;
+    void SerializeVLE(const char* name, unsigned& value) final;
+    /// @}
+
+private:
+    /// Read a scalar element and check its type.
+    const JSONStreamToken& ReadElement(const char* name, JSONStreamToken::Type type);
+
+    /// Source name.
+    String name_;
+    /// Pull parser over the source text.
+    std::unique_ptr<JSONStreamReader> reader_;
+    /// Last read element.
+    JSONStreamToken token_;
+};
+
 }
@@ -11,6 +11,7 @@ namespace Se
 {
 
 class Archive;
+class ValueDocument;
 
 /// JSON document resource.
 class JSONFile : public Resource
@@ -24,12 +25,18 @@ public:
 
     inline static String GetTypeStatic() { return "JSONFile"; }
 
-    /// Load resource from stream. May be called from a worker thread. Return true if successful.
+    /// Load resource from stream. The value tree is filled directly from the parser events. May be called from a worker thread. Return true if successful.
     bool BeginLoad(Deserializer& source) override;
     /// Save resource with default indentation (one tab). Return true if successful.
     bool Save(Serializer& dest) const override;
     /// Save resource with user-defined indentation, only the first character (if any) of the string is used and the length of the string defines the character count. Return true if successful.
     bool Save(Serializer& dest, const String& indendation) const;
+    /// Return version of the cooked binary form.
+    unsigned GetCookVersion() const override { return 1; }
+    /// Save parsed value tree as cooked binary form. Return true if successful.
+    bool SaveCooked(Serializer& dest) const override;
+    /// Load parsed value tree from cooked binary form. Return true if successful.
+    bool LoadCooked(Deserializer& source) override;
 
     /// Save/load objects using Archive serialization.
     /// @{
@@ -41,6 +48,11 @@ public:
     // bool LoadObject(Object& object) const { return LoadObject(object.GetTypeName().c_str(), object); }
     /// @}
 
+    /// Parse JSON from stream straight into a compact read-only document, without building a Value tree. In-situ
+    /// parsing reads the text into the document's arena and lets string values view into it instead of copying them.
+    /// Return true if successful.
+    static bool ParseDocument(Deserializer& source, ValueDocument& document, bool inSitu = true);
+
     /// Deserialize from a string. Return true if successful.
     bool FromString(const String& source);
     /// Save to a string.
@@ -5,6 +5,7 @@
 #include <Se/StringHash.hpp>
 #include <Se/Timer.h>
 #include <Se/Hash.hpp>
+#include <SeResource/ResourceHandle.h>
 #include <SeResource/ResourceRef.hpp>
 // #include <SeArc/Archive.hpp>
 // #include <SeArc/ArchiveSerialization.hpp>
@@ -12,6 +13,7 @@
 // #include <SeArcJson/JSONValue.h>
 
 #include <array>
+#include <atomic>
 #include <unordered_map>
 
 #include <optional>
@@ -98,7 +100,14 @@ public:
     /// Construct.
     explicit Resource(const String& typeName);
 
-    virtual ~Resource() = default;
+    /// Destruct. Invalidate handles to the resource.
+    virtual ~Resource();
+
+    /// Disable copy and assignment, a resource owns its slot table handle.
+    /// @{
+    Resource(const Resource& other) = delete;
+    Resource& operator=(const Resource& other) = delete;
+    /// @}
 
     /// Load resource by reference.
      static Resource* LoadFromCache(String type, const String& name);
@@ -109,9 +118,20 @@ public:
     virtual bool BeginLoad(Deserializer& source);
     /// Finish resource loading. Always called from the main thread. Return true if successful.
     virtual bool EndLoad();
+    /// Perform the next slice of EndLoad() work for a background loaded resource. Always called from the main thread. Set finished to true when no more steps remain. Return true if successful. By default calls EndLoad() at once. Resources that override this must still finish fully in EndLoad() for synchronous loads.
+    virtual bool EndLoadStep(bool& finished);
+    /// Return estimated main thread cost of the next EndLoadStep() in microseconds, or zero if unknown. Used to pack background resource finalization into the per-frame budget.
+    virtual long long GetEndLoadCostEstimate() const { return 0; }
     /// Save resource. Return true if successful.
     virtual bool Save(Serializer& dest) const;
 
+    /// Return version of the cooked binary form. Zero means the resource type does not support cooking. Bump when the cooked layout or loader output changes.
+    virtual unsigned GetCookVersion() const { return 0; }
+    /// Save cooked binary form of the loaded resource, as produced by BeginLoad(). Return true if successful.
+    virtual bool SaveCooked(Serializer& dest) const { return false; }
+    /// Load cooked binary form in place of BeginLoad(). May be called from a worker thread. Return true if successful.
+    virtual bool LoadCooked(Deserializer& source) { return false; }
+
     /// Load resource from file.
     [[nodiscard]]
     bool LoadFile(const FileIdentifier& fileName) ;
@@ -139,6 +159,9 @@ public:
     /// Return name hash.
     StringHash GetNameHash() const { return nameHash_; }
 
+    /// Return generational handle of the resource.
+    const ResourceHandle& GetHandle() const { return handle_; }
+
     /// Return memory use in bytes, possibly approximate.
     unsigned GetMemoryUse() const { return memoryUse_; }
 
@@ -151,6 +174,10 @@ public:
     /// Return absolute file name.
     const String& GetAbsoluteFileName() const { return absoluteFileName_; }
 
+protected:
+    /// Update memory use from const accessors that finish deferred loading, possibly in another thread.
+    void UpdateMemoryUse(unsigned size) const { memoryUse_ = size; }
+
 private:
     /// Name.
     String name_;
@@ -161,11 +188,13 @@ private:
     /// Last used timer.
     Timer useTimer_;
     /// Memory use in bytes.
-    unsigned memoryUse_;
+    mutable std::atomic<unsigned> memoryUse_;
     /// Asynchronous loading state.
     AsyncLoadState asyncLoadState_;
     /// Resource type name.
     String type_;
+    /// Slot table handle.
+    ResourceHandle handle_;
 };
 
 #ifdef DISABLED
@@ -7,7 +7,10 @@
 #include <SeVFS/FileWatcher.h>
 #include <Se/IO/ScanFlags.hpp>
 #include <SeResource/Resource.h>
+#include <SeResource/ResourceCookCache.h>
+#include <SeResource/ResourceLoadStats.h>
 
+#include <functional>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -39,6 +42,25 @@ struct ResourceGroup
     std::unordered_map<String, std::shared_ptr<Resource>> resources_;
 };
 
+/// Progress of a batched resource prefetch.
+struct ResourcePrefetchProgress
+{
+    /// Number of resources requested.
+    unsigned numTotal_{};
+    /// Number of resources loaded successfully, including ones that were already loaded.
+    unsigned numLoaded_{};
+    /// Number of resources that failed to load.
+    unsigned numFailed_{};
+
+    /// Return number of finished resources.
+    unsigned GetNumFinished() const { return numLoaded_ + numFailed_; }
+    /// Return whether all resources have finished loading.
+    bool IsComplete() const { return GetNumFinished() >= numTotal_; }
+};
+
+/// Prefetch progress callback. Called on the main thread each time a resource finishes, the last call has IsComplete() set.
+using ResourcePrefetchCallback = std::function<void(const ResourcePrefetchProgress& progress)>;
+
 /// Optional resource request processor. Can deny requests, re-route resource file names, or perform other processing per request.
 class ResourceRouter
 {
@@ -106,6 +128,18 @@ public:
     /// Set how many milliseconds maximum per frame to spend on finishing background loaded resources.
     void SetFinishBackgroundResourcesMs(int ms) { finishBackgroundResourcesMs_ = std::max(ms, 1); }
 
+    /// Set directory of the persistent cooked resource cache. Empty string disables the cache (default).
+    void SetCookedCacheDir(const String& pathName) { cookCache_.SetCacheDir(pathName); }
+    /// Return the persistent cooked resource cache.
+    ResourceCookCache& GetCookCache() { return cookCache_; }
+    /// Return the persistent cooked resource cache.
+    const ResourceCookCache& GetCookCache() const { return cookCache_; }
+
+    /// Return resource load telemetry.
+    ResourceLoadStats& GetLoadStats() { return loadStats_; }
+    /// Return resource load telemetry.
+    const ResourceLoadStats& GetLoadStats() const { return loadStats_; }
+
     /// Add a resource router object. By default there is none, so the routing process is skipped.
     void AddResourceRouter(std::shared_ptr<ResourceRouter> router, bool addAsFirst = false);
     /// Remove a resource router object.
@@ -117,8 +151,20 @@ public:
     std::shared_ptr<Resource> GetResource(String type, const String& name, bool sendEventOnFailure = true);
     /// Load a resource without storing it in the resource cache. Return null if not found or if fails. Can be called from outside the main thread if the resource itself is safe to load completely (it does not possess for example GPU data.)
     std::shared_ptr<Resource> GetTempResource(String type, const String& name, bool sendEventOnFailure = true);
+    /// Call BeginLoad() on a resource, or restore it from the cooked resource cache if the source is unchanged. Can be called from outside the main thread.
+    bool BeginLoadResource(Resource& resource, Deserializer& source);
     /// Background load a resource. An event will be sent when complete. Return true if successfully stored to the load queue, false if eg. already exists. Can be called from outside the main thread.
     bool BackgroundLoadResource(String type, const String& name, bool sendEventOnFailure = true, Resource* caller = nullptr);
+    /// Background load a batch of resources in one queue operation. Reads are ordered by package offset for sequential I/O. Progress and completion are reported through the callback. Return number of newly queued resources. Can be called only from the main thread.
+    unsigned PrefetchResources(const std::vector<ResourceRef>& resources, ResourcePrefetchCallback callback = nullptr, bool sendEventOnFailure = true);
+    /// Background load all resources listed in a manifest file. Return number of newly queued resources. Can be called only from the main thread.
+    unsigned PrefetchResources(const String& manifestFileName, ResourcePrefetchCallback callback = nullptr, bool sendEventOnFailure = true);
+    /// Load a batch of resources and store them to the cache before returning. All files are read in one pass ordered by package offset, BeginLoad() runs in parallel on WorkQueue threads, and EndLoad() runs on the main thread. Meant for many small text documents such as JSON, YAML and XML files. Return number of loaded resources, including ones that were already loaded. Can be called only from the main thread.
+    unsigned LoadResources(const std::vector<ResourceRef>& resources, bool sendEventOnFailure = true);
+    /// Save the list of all loaded resources to a manifest file for prefetching in a later run. Return true if successful.
+    bool SaveResourceManifest(const String& fileName) const;
+    /// Read resource list from a manifest file. Return true if successful.
+    static bool LoadResourceManifest(const String& fileName, std::vector<ResourceRef>& result);
     /// Return number of pending background-loaded resources.
     unsigned GetNumBackgroundLoadResources() const;
     /// Return all loaded resources of a specific type.
@@ -133,6 +179,16 @@ public:
     template <class T> T* GetResource(const String& name, bool sendEventOnFailure = true);
     /// Template version of returning an existing resource by name.
     template <class T> T* GetExistingResource(const String& name);
+    /// Return handle of a resource by type and name, loading it if not loaded yet. Return invalid handle if not found.
+    ResourceHandle GetResourceHandle(String type, const String& name, bool sendEventOnFailure = true);
+    /// Return handle of a resource by reference, loading it if not loaded yet. Return invalid handle if not found.
+    ResourceHandle GetResourceHandle(const ResourceRef& ref, bool sendEventOnFailure = true) { return GetResourceHandle(ref.type_, ref.name_, sendEventOnFailure); }
+    /// Template version of returning a resource handle by name.
+    template <class T> ResourceHandle GetResourceHandle(const String& name, bool sendEventOnFailure = true);
+    /// Resolve resource handle. Return null if the resource has been destroyed. Does not touch reference counts or perform name lookups.
+    static Resource* GetResource(const ResourceHandle& handle) { return ResourceSlotTable::Get().Get(handle); }
+    /// Template version of resolving a resource handle. The handle must refer to a resource of type T.
+    template <class T> static T* GetResource(const ResourceHandle& handle);
     /// Template version of loading a resource without storing it to the cache.
     template <class T> std::shared_ptr<T> GetTempResource(const String& name, bool sendEventOnFailure = true);
     /// Template version of releasing a resource by name.
@@ -237,6 +293,8 @@ private:
     const std::shared_ptr<Resource>& FindResource(String type, String nameHash);
     /// Find a resource by name only. Searches all type groups.
     const std::shared_ptr<Resource>& FindResource(String nameHash);
+    /// Load resource synchronously through the cooked resource cache and record load telemetry.
+    bool LoadResource(Resource& resource, Deserializer& source, long long ioWaitUs);
     /// Release resources loaded from a package file.
     void ReleasePackageResources(PackageFile* package, bool force = false);
     /// Update a resource group. Recalculate memory use and release resources if over memory budget.
@@ -269,6 +327,10 @@ private:
     int finishBackgroundResourcesMs_;
     /// List of resources that will not be auto-reloaded if reloading event triggers.
     std::vector<String> ignoreResourceAutoReload_;
+    /// Persistent cooked resource cache.
+    ResourceCookCache cookCache_;
+    /// Resource load telemetry.
+    ResourceLoadStats loadStats_;
 
 
 
@@ -288,6 +350,19 @@ template <class T> T* ResourceCache::GetResource(const String& name, bool sendEv
     return dynamic_cast<T*>(GetResource(type, name, sendEventOnFailure).get());
 }
 
+template <class T> ResourceHandle ResourceCache::GetResourceHandle(const String& name, bool sendEventOnFailure)
+{
+    String type = T::GetTypeStatic();
+    return GetResourceHandle(type, name, sendEventOnFailure);
+}
+
+template <class T> T* ResourceCache::GetResource(const ResourceHandle& handle)
+{
+    Resource* resource = GetResource(handle);
+    assert(!resource || dynamic_cast<T*>(resource));
+    return static_cast<T*>(resource);
+}
+
 template <class T> void ResourceCache::ReleaseResource(const String& name, bool force)
 {
     String type = T::GetTypeStatic();
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Se/Export.hpp>
+#include <Se/Mutex.hpp>
+#include <Se/String.hpp>
+#include <Se/Value.h>
+#include <Se/IO/ScanFlags.hpp>
+
+#include <atomic>
+#include <unordered_map>
+
+namespace Se
+{
+
+class Deserializer;
+class Resource;
+class Serializer;
+
+/// Identity of the source data a cooked blob was made from.
+struct ResourceCookKey
+{
+    /// Return whether the key identifies any source data.
+    bool IsValid() const { return size_ != 0; }
+    /// Test for equality with another key.
+    bool operator ==(const ResourceCookKey& rhs) const { return hash_ == rhs.hash_ && size_ == rhs.size_; }
+    /// Test for inequality with another key.
+    bool operator !=(const ResourceCookKey& rhs) const { return !(*this == rhs); }
+
+    /// 64-bit hash of the source content.
+    unsigned long long hash_{};
+    /// Source size in bytes.
+    unsigned long long size_{};
+};
+
+/// On-disk cache of cooked (post-BeginLoad) resource data, keyed by resource type, source content hash and size and loader version.
+class SE_API ResourceCookCache
+{
+public:
+    /// Construct. Cache is disabled until a directory is set.
+    ResourceCookCache();
+
+    /// Set directory used to store cooked blobs. Empty string disables the cache.
+    void SetCacheDir(const String& pathName);
+    /// Return cache directory. Always ends with a forward slash if not empty.
+    const String& GetCacheDir() const { return cacheDir_; }
+    /// Return whether the cache is enabled.
+    bool IsEnabled() const { return !cacheDir_.empty(); }
+
+    /// Return key of the source data from its current position to the end. The stream position is left unchanged.
+    /// Plain files are hashed through a memory mapping and remembered until their size or modification time changes. May be called from a worker thread.
+    ResourceCookKey GetSourceKey(Deserializer& source);
+    /// Load resource from cooked blob matching the source key. Return true on cache hit. May be called from a worker thread.
+    bool LoadCooked(Resource& resource, const ResourceCookKey& key);
+    /// Store cooked blob of a successfully loaded resource. Return true if written. May be called from a worker thread.
+    bool StoreCooked(const Resource& resource, const ResourceCookKey& key);
+    /// Return cooked blob file name for resource type, source key and loader version.
+    String GetCookedFileName(const String& type, const ResourceCookKey& key, unsigned version) const;
+
+    /// Return number of cache hits.
+    unsigned GetNumHits() const { return hits_; }
+    /// Return number of cache misses.
+    unsigned GetNumMisses() const { return misses_; }
+    /// Return number of stored blobs.
+    unsigned GetNumStores() const { return stores_; }
+    /// Return hit rate in range 0-1.
+    float GetHitRate() const;
+    /// Reset hit/miss counters.
+    void ResetStats();
+    /// Returns a formatted string containing the hit rate statistics.
+    String PrintStats() const;
+
+private:
+    /// Remembered key of a plain source file.
+    struct SourceFileKey
+    {
+        /// Modification time of the file when it was hashed.
+        FileTime modifiedTime_{};
+        /// Key of the file content.
+        ResourceCookKey key_;
+    };
+
+    /// Cache directory.
+    String cacheDir_;
+    /// Keys of plain source files by file name.
+    std::unordered_map<String, SourceFileKey> sourceFileKeys_;
+    /// Mutex for the source file keys.
+    Mutex sourceFileKeysMutex_;
+    /// Number of cache hits.
+    std::atomic<unsigned> hits_{};
+    /// Number of cache misses.
+    std::atomic<unsigned> misses_{};
+    /// Number of stored blobs.
+    std::atomic<unsigned> stores_{};
+};
+
+/// Continue a 64-bit hash over a block of data. Blocks other than the last must be multiples of 8 bytes in size for the result to not depend on how the data was split.
+SE_API unsigned long long HashCookSource(unsigned long long hash, const unsigned char* data, std::size_t size);
+/// Write Value tree in compact binary form used by cooked resources. Return true if successful.
+SE_API bool WriteCookedValue(Serializer& dest, const Value& value);
+/// Read Value tree written by WriteCookedValue. Return true if successful.
+SE_API bool ReadCookedValue(Deserializer& source, Value& value);
+
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <Se/Export.hpp>
+#include <Se/Hash.hpp>
+#include <Se/Mutex.hpp>
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Se
+{
+
+class Resource;
+
+/// Compact generational handle of a resource. Resolving it is a single indexed load without reference counting
+/// or name lookups. The handle does not keep the resource alive; it resolves to null once the resource is destroyed.
+struct ResourceHandle
+{
+    /// Slot index.
+    unsigned index_{};
+    /// Slot generation at the time the handle was created. Zero is never a valid generation.
+    unsigned generation_{};
+
+    /// Return whether the handle has been assigned. Does not check whether the resource is still alive.
+    bool IsValid() const { return generation_ != 0; }
+
+    /// Return hash value for HashSet & HashMap.
+    Hash ToHash() const
+    {
+        Hash result = 0;
+        hash_combine(result, index_);
+        hash_combine(result, generation_);
+        return result;
+    }
+
+    /// Test for equality with another handle.
+    bool operator ==(const ResourceHandle& rhs) const { return index_ == rhs.index_ && generation_ == rhs.generation_; }
+    /// Test for inequality with another handle.
+    bool operator !=(const ResourceHandle& rhs) const { return !(*this == rhs); }
+};
+
+/// Slot table backing resource handles. Slots are stored in fixed pages that are never reallocated, so resolving
+/// is lock-free. Allocation and release are thread-safe.
+class SE_API ResourceSlotTable
+{
+public:
+    /// Number of slots per page.
+    static constexpr unsigned PageSize = 1024;
+    /// Maximum number of pages.
+    static constexpr unsigned MaxPages = 4096;
+
+    /// Allocate a slot for a resource. Return invalid handle if the table is full.
+    ResourceHandle Acquire(Resource* resource);
+    /// Release a slot. Handles pointing to it resolve to null afterwards.
+    void Release(const ResourceHandle& handle);
+
+    /// Resolve handle. Return null if the handle is stale or invalid.
+    Resource* Get(const ResourceHandle& handle) const
+    {
+        const Slot* page = handle.index_ / PageSize < MaxPages ? pages_[handle.index_ / PageSize].load(std::memory_order_acquire) : nullptr;
+        if (!page)
+            return nullptr;
+        const Slot& slot = page[handle.index_ % PageSize];
+        if (slot.generation_.load(std::memory_order_acquire) != handle.generation_)
+            return nullptr;
+        // The slot may be released and acquired again between the loads. The resource is published after the
+        // generation changed, so reading the generation again catches a pointer that belongs to a new occupant
+        Resource* resource = slot.resource_.load(std::memory_order_acquire);
+        return slot.generation_.load(std::memory_order_relaxed) == handle.generation_ ? resource : nullptr;
+    }
+
+    /// Return number of slots in use.
+    unsigned GetNumUsed() const;
+
+    /// Return the process-wide slot table.
+    static ResourceSlotTable& Get();
+
+private:
+    /// Slot of the table.
+    struct Slot
+    {
+        /// Current generation. Incremented on release.
+        std::atomic<unsigned> generation_{1};
+        /// Resource occupying the slot.
+        std::atomic<Resource*> resource_{};
+    };
+
+    /// Mutex for allocation and release.
+    mutable Mutex mutex_;
+    /// Slot pages.
+    std::array<std::atomic<Slot*>, MaxPages> pages_{};
+    /// Page storage.
+    std::vector<std::unique_ptr<Slot[]>> pageStorage_;
+    /// Released slot indices.
+    std::vector<unsigned> freeSlots_;
+    /// Number of slots handed out so far, including released ones.
+    unsigned numSlots_{};
+};
+
+}
+
+namespace std
+{
+
+template <>
+struct hash<Se::ResourceHandle>
+{
+    size_t operator()(const Se::ResourceHandle& handle) const { return handle.ToHash(); }
+};
+
+}
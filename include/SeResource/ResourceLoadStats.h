@@ -0,0 +1,144 @@
+#pragma once
+
+#include <Se/Export.hpp>
+#include <Se/Mutex.hpp>
+#include <Se/String.hpp>
+#include <SeResource/JSONValue.h>
+
+#include <array>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+namespace Se
+{
+
+/// Timing and size of a single resource load.
+struct ResourceLoadRecord
+{
+    /// Resource type.
+    String type_;
+    /// Resource name.
+    String name_;
+    /// Time spent in the background load queue in microseconds. Zero for synchronous loads.
+    long long queueWaitUs_{};
+    /// Time spent locating and opening the source file in microseconds.
+    long long ioWaitUs_{};
+    /// Time spent in BeginLoad() in microseconds.
+    long long beginLoadUs_{};
+    /// Time spent in EndLoad() in microseconds.
+    long long endLoadUs_{};
+    /// Size of the source data in bytes.
+    unsigned long long bytes_{};
+    /// Whether the load was done by the background loader.
+    bool background_{};
+    /// Whether the load succeeded.
+    bool success_{};
+};
+
+/// Histogram of durations with power-of-two buckets.
+struct SE_API ResourceLoadHistogram
+{
+    /// Number of buckets. The last bucket collects everything above the previous bound.
+    static constexpr unsigned NumBuckets = 16;
+    /// Upper bound of the first bucket in microseconds. Each following bucket doubles it.
+    static constexpr long long FirstBucketUs = 100;
+
+    /// Add a sample.
+    void Add(long long us);
+    /// Return average duration in microseconds.
+    long long GetAverageUs() const { return count_ ? totalUs_ / count_ : 0; }
+    /// Return upper bound of bucket in microseconds, or -1 for the unbounded last bucket.
+    static long long GetBucketUpperBoundUs(unsigned index);
+    /// Return histogram as JSON value.
+    JSONValue ToJSON() const;
+
+    /// Sample counts per bucket.
+    std::array<unsigned, NumBuckets> buckets_{};
+    /// Number of samples.
+    unsigned count_{};
+    /// Sum of samples in microseconds.
+    long long totalUs_{};
+    /// Largest sample in microseconds.
+    long long maxUs_{};
+};
+
+/// Aggregated load statistics of one resource type.
+struct ResourceLoadTypeStats
+{
+    /// Number of loads.
+    unsigned count_{};
+    /// Number of failed loads.
+    unsigned failed_{};
+    /// Total source bytes.
+    unsigned long long bytes_{};
+    /// Background queue wait.
+    ResourceLoadHistogram queueWait_;
+    /// File open time.
+    ResourceLoadHistogram ioWait_;
+    /// BeginLoad() time.
+    ResourceLoadHistogram beginLoad_;
+    /// EndLoad() time.
+    ResourceLoadHistogram endLoad_;
+};
+
+/// Collects resource load telemetry of the ResourceCache. Thread-safe.
+class SE_API ResourceLoadStats
+{
+public:
+    /// Default number of individual records kept.
+    static constexpr unsigned DefaultMaxRecords = 1024;
+
+    /// Enable or disable recording. Enabled by default.
+    void SetEnabled(bool enable) { enabled_ = enable; }
+    /// Set whether to keep individual records in addition to the per-type aggregates. Enabled by default.
+    void SetKeepRecords(bool enable) { keepRecords_ = enable; }
+    /// Set maximum number of individual records kept. When full, the oldest record is dropped.
+    void SetMaxRecords(unsigned count);
+    /// Return whether recording is enabled.
+    bool IsEnabled() const { return enabled_; }
+    /// Return whether individual records are kept.
+    bool GetKeepRecords() const { return keepRecords_; }
+    /// Return maximum number of individual records kept.
+    unsigned GetMaxRecords() const;
+
+    /// Add a finished load.
+    void AddRecord(const ResourceLoadRecord& record);
+    /// Clear all collected data.
+    void Clear();
+
+    /// Return copy of individual records, oldest first.
+    std::vector<ResourceLoadRecord> GetRecords() const;
+    /// Return copy of per-type aggregates.
+    std::unordered_map<String, ResourceLoadTypeStats> GetTypeStats() const;
+    /// Return average EndLoad() time of a resource type in microseconds, or zero if not recorded yet.
+    long long GetAverageEndLoadUs(const String& type) const;
+
+    /// Return all statistics as JSON value.
+    JSONValue ToJSON() const;
+    /// Save all statistics to a JSON file. Return true if successful.
+    bool SaveJSON(const String& fileName) const;
+    /// Returns a formatted string containing per-type timing summary.
+    String PrintStats() const;
+
+private:
+    /// Return individual records oldest first. Mutex must be held.
+    std::vector<ResourceLoadRecord> GetRecordsLocked() const;
+
+    /// Mutex for thread-safe access.
+    mutable Mutex mutex_;
+    /// Individual records as a ring buffer.
+    std::vector<ResourceLoadRecord> records_;
+    /// Index of the oldest record once the ring buffer is full.
+    unsigned firstRecord_{};
+    /// Maximum number of individual records.
+    unsigned maxRecords_{DefaultMaxRecords};
+    /// Aggregates by resource type.
+    std::unordered_map<String, ResourceLoadTypeStats> typeStats_;
+    /// Recording flag.
+    std::atomic<bool> enabled_{true};
+    /// Keep individual records flag.
+    std::atomic<bool> keepRecords_{true};
+};
+
+}
@@ -14,6 +14,8 @@
 #endif
 
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 
 
@@ -411,6 +413,11 @@ public:
     /// Return pugixml xpath_variable_set.
     pugi::xpath_variable_set* GetXPathVariableSet() const { return variables_.get(); }
 
+    /// Return shared compiled query for a query string without variables. Safe to call and evaluate from multiple threads.
+    static std::shared_ptr<const XPathQuery> GetCached(const String& queryString);
+    /// Release all shared compiled queries.
+    static void ClearCache();
+
 private:
     /// XPath query string.
     String queryString_;
@@ -418,6 +425,11 @@ private:
     std::unique_ptr<pugi::xpath_query> query_;
     /// Pugixml xpath_variable_set.
     std::unique_ptr<pugi::xpath_variable_set> variables_;
+
+    /// Shared compiled queries by query string.
+    static std::unordered_map<String, std::shared_ptr<const XPathQuery>> cache_;
+    /// Shared compiled queries mutex.
+    static std::mutex cacheMutex_;
 };
 
 } // namespace Se
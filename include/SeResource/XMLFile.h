@@ -26,8 +26,17 @@ public:
 
     inline static String GetTypeStatic() { return "XMLFile"; }
 
-    /// Load resource from stream. May be called from a worker thread. Return true if successful.
+    /// Main thread time spent applying an inherited patch per EndLoadStep() in microseconds.
+    static constexpr long long PatchStepUs = 1000;
+
+    /// Load resource from stream. May be called from a worker thread. Patch files load the inherited document here and leave the patch to EndLoad(). Return true if successful.
     bool BeginLoad(Deserializer& source) override;
+    /// Apply the inherited patch at once. Return true if successful.
+    bool EndLoad() override;
+    /// Apply the next slice of patch nodes, stopping once PatchStepUs has passed. Return true if successful.
+    bool EndLoadStep(bool& finished) override;
+    /// Return estimated cost of the next patch slice in microseconds.
+    long long GetEndLoadCostEstimate() const override;
     /// Save resource with default indentation (one tab). Return true if successful.
     bool Save(Serializer& dest) const override;
     /// Save resource with user-defined indentation. Return true if successful.
@@ -66,6 +75,10 @@ public:
     void Patch(const XMLElement& patchElement);
 
 private:
+    /// Apply one patch node.
+    void ApplyPatch(const pugi::xml_node& patch) const;
+    /// Apply the next pending patch node of the inherited patch.
+    void ApplyNextPatch();
     /// Add an node in the Patch.
     void PatchAdd(const pugi::xml_node& patch, pugi::xpath_node& original) const;
     /// Replace a node or attribute in the Patch.
@@ -82,6 +95,14 @@ private:
 
     /// Pugixml document.
     std::unique_ptr<pugi::xml_document> document_;
+    /// Patch document waiting to be applied over the inherited document.
+    std::unique_ptr<pugi::xml_document> patchDocument_;
+    /// Next patch node to apply, null when none is pending.
+    pugi::xml_node_struct* nextPatch_{};
+    /// Number of patch nodes applied by EndLoadStep().
+    unsigned numPatchesApplied_{};
+    /// Time spent applying them in microseconds.
+    long long patchUs_{};
 };
 
 // template <class T, class ... Args>
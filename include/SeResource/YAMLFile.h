@@ -3,13 +3,37 @@
 #include <SeResource/Resource.h>
 #include <SeResource/JSONValue.h>
 
+#include <string_view>
+
 // namespace ryml {
 //     class Tree;
 // }
 
 namespace Se
 {
-    
+    class ValueDocument;
+
+    /// Receives the content of a YAML document in document order. Plain scalars arrive converted to the type they read
+    /// as; quoted and block scalars are always strings. Return false from any callback to stop.
+    class YAMLEventHandler
+    {
+    public:
+        virtual ~YAMLEventHandler() = default;
+
+        virtual bool Null() = 0;
+        virtual bool Bool(bool value) = 0;
+        virtual bool Int(int value) = 0;
+        virtual bool Double(double value) = 0;
+        /// String value. The characters are only valid during the call.
+        virtual bool String(std::string_view value) = 0;
+        virtual bool StartMap() = 0;
+        /// Key of the next map member. The characters are only valid during the call.
+        virtual bool Key(std::string_view key) = 0;
+        virtual bool EndMap() = 0;
+        virtual bool StartSeq() = 0;
+        virtual bool EndSeq() = 0;
+    };
+
     /// YAML document resource.
     class YAMLFile : public Resource
     {
@@ -23,6 +47,18 @@ namespace Se
         bool BeginLoad(Deserializer& source) override;
         /// Save resource with default indentation (one tab). Return true if successful.
         bool Save(Serializer& dest) const override;
+        /// Return version of the cooked binary form.
+        unsigned GetCookVersion() const override { return 1; }
+        /// Save parsed value tree as cooked binary form. Return true if successful.
+        bool SaveCooked(Serializer& dest) const override;
+        /// Load parsed value tree from cooked binary form. Return true if successful.
+        bool LoadCooked(Deserializer& source) override;
+
+        /// Parse YAML from stream and report its content to the handler without building a Value tree. Return true if
+        /// the handler accepted the whole content.
+        static bool Parse(Deserializer& source, YAMLEventHandler& handler);
+        /// Parse YAML from stream straight into a compact read-only document. Return true if successful.
+        static bool ParseDocument(Deserializer& source, ValueDocument& document);
 
         // ryml::Tree& GetTree()
         // {
@@ -87,7 +87,7 @@ std::tuple<MountPointPtr, String, String> MountedAliasRoot::FindMountPoint(Strin
 
 bool MountedAliasRoot::AcceptsScheme(const String& scheme) const
 {
-    return scheme.comparei("alias") == 0;
+    return scheme.comparei("alias");
 }
 
 bool MountedAliasRoot::Exists(const FileIdentifier& fileName) const
@@ -45,7 +45,7 @@ public:
 /// Checks if mount point accepts scheme.
 inline bool MountedPackageFile::AcceptsScheme(const String& scheme) const
 {
-    return scheme.empty() || scheme.comparei(GetName()) == 0;
+    return scheme.empty() || scheme.comparei(GetName());
 }
 
 /// Check if a file exists within the mount point.
@@ -15,7 +15,7 @@ MountedRoot::MountedRoot()
 
 bool MountedRoot::AcceptsScheme(const String& scheme) const
 {
-    return scheme.comparei("file") == 0;
+    return scheme.comparei("file");
 }
 
 bool MountedRoot::Exists(const FileIdentifier& fileName) const
@@ -0,0 +1,380 @@
+#include <Se/Base64.h>
+
+#include <Se/IO/Serializer.hpp>
+
+#include <algorithm>
+#include <array>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SE_BASE64_X86
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SE_BASE64_TARGET(features)
+#else
+#define SE_BASE64_TARGET(features) __attribute__((target(features)))
+#endif
+#endif
+
+namespace Se
+{
+
+namespace
+{
+
+constexpr char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+constexpr std::array<unsigned char, 256> MakeDecodeTable()
+{
+    std::array<unsigned char, 256> table{};
+    for (unsigned i = 0; i < 256; ++i)
+        table[i] = 0xff;
+    for (unsigned i = 0; i < 64; ++i)
+        table[static_cast<unsigned char>(base64Alphabet[i])] = static_cast<unsigned char>(i);
+    return table;
+}
+
+/// Value of each character, 0xff for characters outside of the alphabet.
+constexpr std::array<unsigned char, 256> base64DecodeTable = MakeDecodeTable();
+
+/// Return text length without trailing padding.
+std::size_t StripPadding(const char* text, std::size_t length)
+{
+    if (length % 4 == 0)
+    {
+        for (unsigned i = 0; i < 2 && length > 0 && text[length - 1] == '='; ++i)
+            --length;
+    }
+    return length;
+}
+
+void EncodeScalar(char* dest, const unsigned char* src, std::size_t size)
+{
+    std::size_t i = 0;
+    for (; i + 3 <= size; i += 3, dest += 4)
+    {
+        const unsigned triple = src[i] << 16u | src[i + 1] << 8u | src[i + 2];
+        dest[0] = base64Alphabet[triple >> 18u];
+        dest[1] = base64Alphabet[triple >> 12u & 0x3fu];
+        dest[2] = base64Alphabet[triple >> 6u & 0x3fu];
+        dest[3] = base64Alphabet[triple & 0x3fu];
+    }
+
+    if (i < size)
+    {
+        const bool hasSecond = i + 1 < size;
+        const unsigned triple = src[i] << 16u | (hasSecond ? src[i + 1] << 8u : 0u);
+        dest[0] = base64Alphabet[triple >> 18u];
+        dest[1] = base64Alphabet[triple >> 12u & 0x3fu];
+        dest[2] = hasSecond ? base64Alphabet[triple >> 6u & 0x3fu] : '=';
+        dest[3] = '=';
+    }
+}
+
+bool DecodeScalar(unsigned char* dest, const unsigned char* src, std::size_t length)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= length; i += 4, dest += 3)
+    {
+        const unsigned a = base64DecodeTable[src[i]];
+        const unsigned b = base64DecodeTable[src[i + 1]];
+        const unsigned c = base64DecodeTable[src[i + 2]];
+        const unsigned d = base64DecodeTable[src[i + 3]];
+        if ((a | b | c | d) & 0x80u)
+            return false;
+
+        const unsigned triple = a << 18u | b << 12u | c << 6u | d;
+        dest[0] = static_cast<unsigned char>(triple >> 16u);
+        dest[1] = static_cast<unsigned char>(triple >> 8u);
+        dest[2] = static_cast<unsigned char>(triple);
+    }
+
+    const std::size_t tail = length - i;
+    if (tail == 1)
+        return false;
+    if (tail > 1)
+    {
+        const unsigned a = base64DecodeTable[src[i]];
+        const unsigned b = base64DecodeTable[src[i + 1]];
+        const unsigned c = tail > 2 ? base64DecodeTable[src[i + 2]] : 0u;
+        if ((a | b | c) & 0x80u)
+            return false;
+
+        const unsigned triple = a << 18u | b << 12u | c << 6u;
+        dest[0] = static_cast<unsigned char>(triple >> 16u);
+        if (tail > 2)
+            dest[1] = static_cast<unsigned char>(triple >> 8u);
+    }
+    return true;
+}
+
+#ifdef SE_BASE64_X86
+
+struct CPUFeatures
+{
+    bool ssse3_{};
+    bool avx2_{};
+};
+
+CPUFeatures DetectCPUFeatures()
+{
+    CPUFeatures features;
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4]{};
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    features.ssse3_ = (info[2] & (1 << 9)) != 0;
+    const bool avxEnabled = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+    if (maxLeaf >= 7 && avxEnabled)
+    {
+        __cpuidex(info, 7, 0);
+        features.avx2_ = (info[1] & (1 << 5)) != 0;
+    }
+#else
+    __builtin_cpu_init();
+    features.ssse3_ = __builtin_cpu_supports("ssse3");
+    features.avx2_ = __builtin_cpu_supports("avx2");
+#endif
+    return features;
+}
+
+const CPUFeatures& GetCPUFeatures()
+{
+    static const CPUFeatures features = DetectCPUFeatures();
+    return features;
+}
+
+// Vector code follows the approach of Wojciech Muła and Alfred Klomp: bytes are regrouped into 6-bit indices with
+// shuffles and multiplies, and characters are translated with small nibble-indexed lookup tables.
+
+SE_BASE64_TARGET("ssse3") inline __m128i EncodeReshuffle(__m128i in)
+{
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+SE_BASE64_TARGET("ssse3") inline __m128i EncodeTranslate(__m128i in)
+{
+    const __m128i offsets = _mm_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    __m128i indices = _mm_subs_epu8(in, _mm_set1_epi8(51));
+    indices = _mm_sub_epi8(indices, _mm_cmpgt_epi8(in, _mm_set1_epi8(25)));
+    return _mm_add_epi8(in, _mm_shuffle_epi8(offsets, indices));
+}
+
+/// Encode 12-byte groups while 16 bytes can be loaded. Return number of bytes encoded.
+SE_BASE64_TARGET("ssse3") std::size_t EncodeSSSE3(char* dest, const unsigned char* src, std::size_t size)
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 12, dest += 16)
+    {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), EncodeTranslate(EncodeReshuffle(in)));
+    }
+    return i;
+}
+
+SE_BASE64_TARGET("ssse3") inline __m128i DecodeReshuffle(__m128i in)
+{
+    const __m128i merged = _mm_maddubs_epi16(in, _mm_set1_epi32(0x01400140));
+    const __m128i packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    return _mm_shuffle_epi8(packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+/// Decode 16-character groups while at least 24 characters are left, so the 16-byte stores stay within the output.
+/// Stop at the first group with invalid characters. Return number of characters decoded.
+SE_BASE64_TARGET("ssse3") std::size_t DecodeSSSE3(unsigned char* dest, const unsigned char* src, std::size_t length)
+{
+    const __m128i lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask2F = _mm_set1_epi8(0x2f);
+
+    std::size_t i = 0;
+    for (; i + 24 <= length; i += 16, dest += 12)
+    {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i hiNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask2F);
+        const __m128i loNibbles = _mm_and_si128(in, mask2F);
+        const __m128i hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+        const __m128i lo = _mm_shuffle_epi8(lutLo, loNibbles);
+        if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0)
+            break;
+
+        const __m128i eq2F = _mm_cmpeq_epi8(in, mask2F);
+        in = _mm_add_epi8(in, _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), DecodeReshuffle(in));
+    }
+    return i;
+}
+
+SE_BASE64_TARGET("avx2") inline __m256i EncodeReshuffleAVX2(__m256i in)
+{
+    in = _mm256_shuffle_epi8(in, _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+        10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    const __m256i t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+    const __m256i t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+    const __m256i t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+    const __m256i t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+    return _mm256_or_si256(t1, t3);
+}
+
+SE_BASE64_TARGET("avx2") inline __m256i EncodeTranslateAVX2(__m256i in)
+{
+    const __m256i offsets = _mm256_setr_epi8(65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0,
+        65, 71, -4, -4, -4, -4, -4, -4, -4, -4, -4, -4, -19, -16, 0, 0);
+    __m256i indices = _mm256_subs_epu8(in, _mm256_set1_epi8(51));
+    indices = _mm256_sub_epi8(indices, _mm256_cmpgt_epi8(in, _mm256_set1_epi8(25)));
+    return _mm256_add_epi8(in, _mm256_shuffle_epi8(offsets, indices));
+}
+
+/// Encode 24-byte groups while 32 bytes can be loaded. Return number of bytes encoded.
+SE_BASE64_TARGET("avx2") std::size_t EncodeAVX2(char* dest, const unsigned char* src, std::size_t size)
+{
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 24, dest += 32)
+    {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 12));
+        const __m256i in = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), EncodeTranslateAVX2(EncodeReshuffleAVX2(in)));
+    }
+    return i;
+}
+
+/// Decode 32-character groups while at least 48 characters are left, so the 32-byte stores stay within the output.
+/// Stop at the first group with invalid characters. Return number of characters decoded.
+SE_BASE64_TARGET("avx2") std::size_t DecodeAVX2(unsigned char* dest, const unsigned char* src, std::size_t length)
+{
+    const __m256i lutLo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+        0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m256i lutHi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+        0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+        0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lutRoll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask2F = _mm256_set1_epi8(0x2f);
+    const __m256i packBytes = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+        2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i packLanes = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+    std::size_t i = 0;
+    for (; i + 48 <= length; i += 32, dest += 24)
+    {
+        __m256i in = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        const __m256i hiNibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask2F);
+        const __m256i loNibbles = _mm256_and_si256(in, mask2F);
+        const __m256i hi = _mm256_shuffle_epi8(lutHi, hiNibbles);
+        const __m256i lo = _mm256_shuffle_epi8(lutLo, loNibbles);
+        if (!_mm256_testz_si256(lo, hi))
+            break;
+
+        const __m256i eq2F = _mm256_cmpeq_epi8(in, mask2F);
+        in = _mm256_add_epi8(in, _mm256_shuffle_epi8(lutRoll, _mm256_add_epi8(eq2F, hiNibbles)));
+        const __m256i merged = _mm256_maddubs_epi16(in, _mm256_set1_epi32(0x01400140));
+        const __m256i packed = _mm256_shuffle_epi8(_mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000)), packBytes);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), _mm256_permutevar8x32_epi32(packed, packLanes));
+    }
+    return i;
+}
+
+#endif
+
+/// Decode text without padding.
+bool DecodeUnpadded(unsigned char* dest, const unsigned char* src, std::size_t length)
+{
+    std::size_t done = 0;
+#ifdef SE_BASE64_X86
+    const CPUFeatures& features = GetCPUFeatures();
+    if (features.avx2_)
+        done = DecodeAVX2(dest, src, length);
+    if (features.ssse3_)
+        done += DecodeSSSE3(dest + done / 4 * 3, src + done, length - done);
+#endif
+    return DecodeScalar(dest + done / 4 * 3, src + done, length - done);
+}
+
+}
+
+std::size_t GetBase64DecodedSize(const char* text, std::size_t length)
+{
+    length = StripPadding(text, length);
+    return length / 4 * 3 + (length % 4 > 1 ? length % 4 - 1 : 0);
+}
+
+void EncodeBase64(char* dest, const void* data, std::size_t size)
+{
+    const auto* src = static_cast<const unsigned char*>(data);
+    std::size_t done = 0;
+#ifdef SE_BASE64_X86
+    const CPUFeatures& features = GetCPUFeatures();
+    if (features.avx2_)
+        done = EncodeAVX2(dest, src, size);
+    if (features.ssse3_)
+        done += EncodeSSSE3(dest + done / 3 * 4, src + done, size - done);
+#endif
+    EncodeScalar(dest + done / 3 * 4, src + done, size - done);
+}
+
+bool DecodeBase64(void* dest, const char* text, std::size_t length)
+{
+    return DecodeUnpadded(static_cast<unsigned char*>(dest), reinterpret_cast<const unsigned char*>(text),
+        StripPadding(text, length));
+}
+
+bool EncodeBase64(Serializer& dest, const void* data, std::size_t size)
+{
+    static constexpr std::size_t chunkSize = 3 * 1024;
+    char buffer[chunkSize / 3 * 4];
+
+    const auto* src = static_cast<const unsigned char*>(data);
+    for (std::size_t offset = 0; offset < size; offset += chunkSize)
+    {
+        const std::size_t count = std::min(chunkSize, size - offset);
+        const std::size_t encodedSize = GetBase64EncodedSize(count);
+        EncodeBase64(buffer, src + offset, count);
+        if (dest.Write(buffer, encodedSize) != encodedSize)
+            return false;
+    }
+    return true;
+}
+
+bool DecodeBase64(Serializer& dest, const char* text, std::size_t length)
+{
+    static constexpr std::size_t chunkLength = 4 * 1024;
+    unsigned char buffer[chunkLength / 4 * 3];
+
+    length = StripPadding(text, length);
+    const auto* src = reinterpret_cast<const unsigned char*>(text);
+    for (std::size_t offset = 0; offset < length; offset += chunkLength)
+    {
+        const std::size_t count = std::min(chunkLength, length - offset);
+        const std::size_t decodedSize = count / 4 * 3 + (count % 4 > 1 ? count % 4 - 1 : 0);
+        if (!DecodeUnpadded(buffer, src + offset, count) || dest.Write(buffer, decodedSize) != decodedSize)
+            return false;
+    }
+    return true;
+}
+
+void BufferToBase64String(String& dest, const void* data, std::size_t size)
+{
+    dest.resize(GetBase64EncodedSize(size));
+    EncodeBase64(dest.data(), data, size);
+}
+
+bool Base64StringToBuffer(std::vector<unsigned char>& dest, const String& source)
+{
+    dest.resize(GetBase64DecodedSize(source.data(), source.length()));
+    return DecodeBase64(dest.data(), source.data(), source.length());
+}
+
+}
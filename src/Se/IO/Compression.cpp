@@ -0,0 +1,46 @@
+#include <Se/IO/Compression.h>
+
+#ifdef HAVE_LZ4
+#include <LZ4/lz4.h>
+#endif
+
+namespace Se
+{
+
+unsigned EstimateCompressBound(unsigned srcSize)
+{
+#ifdef HAVE_LZ4
+    return static_cast<unsigned>(LZ4_compressBound(static_cast<int>(srcSize)));
+#else
+    return srcSize;
+#endif
+}
+
+unsigned CompressData(void* dest, const void* src, unsigned srcSize)
+{
+#ifdef HAVE_LZ4
+    if (!dest || !src || !srcSize)
+        return 0;
+    const int bound = LZ4_compressBound(static_cast<int>(srcSize));
+    const int packedSize = LZ4_compress_default(static_cast<const char*>(src), static_cast<char*>(dest),
+        static_cast<int>(srcSize), bound);
+    return packedSize > 0 ? static_cast<unsigned>(packedSize) : 0;
+#else
+    return 0;
+#endif
+}
+
+bool DecompressData(void* dest, unsigned destSize, const void* src, unsigned srcSize)
+{
+#ifdef HAVE_LZ4
+    if (!dest || !src)
+        return false;
+    const int size = LZ4_decompress_safe(static_cast<const char*>(src), static_cast<char*>(dest),
+        static_cast<int>(srcSize), static_cast<int>(destSize));
+    return size >= 0 && static_cast<unsigned>(size) == destSize;
+#else
+    return false;
+#endif
+}
+
+}
@@ -0,0 +1,137 @@
+#include <Se/IO/MappedFile.h>
+
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Se
+{
+
+bool MappedFile::Open(const String& fileName)
+{
+    Close();
+
+    if (!Map(fileName))
+    {
+        File file;
+        if (!file.Open(fileName, FILE_READ))
+            return false;
+
+        buffer_.resize(file.GetSize());
+        if (file.Read(buffer_.data(), buffer_.size()) != buffer_.size())
+        {
+            SE_LOG_ERROR("Could not read file {}", fileName);
+            buffer_.clear();
+            return false;
+        }
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+
+    fileName_ = fileName;
+    isOpen_ = true;
+    return true;
+}
+
+bool MappedFile::OpenMapped(const String& fileName)
+{
+    Close();
+
+    if (!Map(fileName))
+        return false;
+
+    fileName_ = fileName;
+    isOpen_ = true;
+    return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+    if (mapping_)
+        UnmapViewOfFile(mapping_);
+    if (mappingHandle_)
+        CloseHandle(mappingHandle_);
+    if (fileHandle_)
+        CloseHandle(fileHandle_);
+    mappingHandle_ = nullptr;
+    fileHandle_ = nullptr;
+#else
+    if (mapping_)
+        munmap(mapping_, size_);
+#endif
+
+    mapping_ = nullptr;
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+    fileName_.clear();
+    isOpen_ = false;
+}
+
+bool MappedFile::Map(const String& fileName)
+{
+#ifdef _WIN32
+    HANDLE fileHandle = CreateFileW(GetWideNativePath(fileName).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(fileHandle, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* mapping = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!mapping)
+    {
+        if (mappingHandle)
+            CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    fileHandle_ = fileHandle;
+    mappingHandle_ = mappingHandle;
+    size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+    const int fd = open(GetNativePath(fileName).c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat status{};
+    if (fstat(fd, &status) != 0 || status.st_size <= 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    const std::size_t size = static_cast<std::size_t>(status.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return false;
+
+    size_ = size;
+#endif
+
+    mapping_ = mapping;
+    data_ = static_cast<const unsigned char*>(mapping);
+    return true;
+}
+
+}
@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <cmath>
+#include <cstring>
 //#include <GFrost/Resource/Serializable.h>
 
 namespace Se
@@ -80,6 +81,14 @@ Value& Value::operator =(const String& rhs)
     return *this;
 }
 
+Value& Value::operator =(String&& rhs)
+{
+    SetType(VALUE_STRING);
+    *stringValue_ = std::move(rhs);
+
+    return *this;
+}
+
 Value& Value::operator =(const char* rhs)
 {
     SetType(VALUE_STRING);
@@ -139,36 +148,15 @@ Value& Value::operator =(const Value& rhs)
     return *this;
 }
 
-Value& Value::operator=(Value && rhs)
+Value& Value::operator =(Value && rhs) noexcept
 {
     assert(this != &rhs);
 
-    SetType(rhs.GetValueType(), rhs.GetNumberType());
-
-    switch (GetValueType())
-    {
-    case VALUE_BOOL:
-        boolValue_ = rhs.boolValue_;
-        break;
-
-    case VALUE_NUMBER:
-        numberValue_ = rhs.numberValue_;
-        break;
-
-    case VALUE_STRING:
-        *stringValue_ = std::move(*rhs.stringValue_);
-        break;
-
-    case VALUE_ARRAY:
-        *arrayValue_ = std::move(*rhs.arrayValue_);
-        break;
-
-    case VALUE_OBJECT:
-        *objectValue_ = std::move(*rhs.objectValue_);
-
-    default:
-        break;
-    }
+    SetType(VALUE_NULL);
+    // The number member spans the whole union
+    type_ = rhs.type_;
+    memcpy(&numberValue_, &rhs.numberValue_, sizeof numberValue_);
+    rhs.type_ = VALUE_NULL;
 
     return *this;
 }
@@ -183,6 +171,9 @@ bool Value::operator ==(const Value& rhs) const
 
     switch (GetValueType())
     {
+    case VALUE_NULL:
+        return true;
+
     case VALUE_BOOL:
         return boolValue_ == rhs.boolValue_;
 
@@ -0,0 +1,421 @@
+#include "ValueDocument.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <new>
+
+namespace Se
+{
+
+/// Size of the first arena block.
+static const std::size_t MIN_ARENA_BLOCK_SIZE = 16 * 1024;
+/// Block size stops doubling here. Larger allocations get a block of their own.
+static const std::size_t MAX_ARENA_BLOCK_SIZE = 1024 * 1024;
+/// Objects up to this many members are sorted in place.
+static const std::ptrdiff_t SMALL_OBJECT_SIZE = 16;
+
+const ValueNode ValueNode::EMPTY;
+
+void* ValueArena::Allocate(std::size_t size, std::size_t alignment)
+{
+    std::size_t padding = (alignment - reinterpret_cast<std::uintptr_t>(current_) % alignment) % alignment;
+    if (padding + size > remaining_)
+    {
+        const std::size_t blockSize = std::max(size + alignment, std::max(nextBlockSize_, MIN_ARENA_BLOCK_SIZE));
+        blocks_.emplace_back(new char[blockSize]);
+        current_ = blocks_.back().get();
+        remaining_ = blockSize;
+        memoryUse_ += blockSize;
+        nextBlockSize_ = std::min(std::max(nextBlockSize_, MIN_ARENA_BLOCK_SIZE) * 2, MAX_ARENA_BLOCK_SIZE);
+        padding = (alignment - reinterpret_cast<std::uintptr_t>(current_) % alignment) % alignment;
+    }
+
+    void* ptr = current_ + padding;
+    current_ += padding + size;
+    remaining_ -= padding + size;
+    return ptr;
+}
+
+const char* ValueArena::AllocateString(const char* str, std::size_t length)
+{
+    auto* dest = static_cast<char*>(Allocate(length + 1, 1));
+    memcpy(dest, str, length);
+    dest[length] = '\0';
+    return dest;
+}
+
+void ValueArena::Clear()
+{
+    blocks_.clear();
+    current_ = nullptr;
+    remaining_ = 0;
+    nextBlockSize_ = 0;
+    memoryUse_ = 0;
+}
+
+const ValueNode& ValueNode::operator [](unsigned index) const
+{
+    if (!IsArray() || index >= size_)
+        return EMPTY;
+
+    return elements_[index];
+}
+
+const ValueNode& ValueNode::Get(std::string_view key) const
+{
+    if (!IsObject())
+        return EMPTY;
+
+    const ValueMember* member = std::lower_bound(members_, members_ + size_, key,
+        [](const ValueMember& lhs, std::string_view rhs) { return lhs.key_ < rhs; });
+    return member != members_ + size_ && member->key_ == key ? member->value_ : EMPTY;
+}
+
+bool ValueNode::Contains(std::string_view key) const
+{
+    return &Get(key) != &EMPTY;
+}
+
+const ValueMember* ValueNode::begin() const
+{
+    return IsObject() ? members_ : nullptr;
+}
+
+const ValueMember* ValueNode::end() const
+{
+    return IsObject() ? members_ + size_ : nullptr;
+}
+
+Value ValueNode::ToValue() const
+{
+    Value value;
+    switch (GetValueType())
+    {
+    case VALUE_BOOL:
+        value = boolValue_;
+        break;
+
+    case VALUE_NUMBER:
+        switch (GetNumberType())
+        {
+        case VALUE_NT_INT:
+            value = static_cast<int>(numberValue_);
+            break;
+
+        case VALUE_NT_UINT:
+            value = static_cast<unsigned>(numberValue_);
+            break;
+
+        default:
+            value = numberValue_;
+            break;
+        }
+        break;
+
+    case VALUE_STRING:
+        value = String(stringValue_, size_);
+        break;
+
+    case VALUE_ARRAY:
+        value.Resize(size_);
+        for (unsigned i = 0; i < size_; ++i)
+            value[i] = elements_[i].ToValue();
+        break;
+
+    case VALUE_OBJECT:
+        value.SetType(VALUE_OBJECT);
+        for (unsigned i = 0; i < size_; ++i)
+            value[String(members_[i].key_.data(), members_[i].key_.length())] = members_[i].value_.ToValue();
+        break;
+
+    default:
+        break;
+    }
+    return value;
+}
+
+void ValueDocument::Clear()
+{
+    arena_.Clear();
+    keys_.clear();
+    root_ = ValueNode();
+    stack_.clear();
+    containers_.clear();
+    pendingKey_ = {};
+    hasPendingKey_ = false;
+    complete_ = false;
+}
+
+void ValueDocument::FromValue(const Value& value)
+{
+    Clear();
+    BuildValue(value);
+}
+
+bool ValueDocument::Null()
+{
+    return AddValue(ValueNode());
+}
+
+bool ValueDocument::Bool(bool value)
+{
+    ValueNode node;
+    node.valueType_ = VALUE_BOOL;
+    node.boolValue_ = value;
+    return AddValue(node);
+}
+
+bool ValueDocument::Int(int value)
+{
+    ValueNode node;
+    node.valueType_ = VALUE_NUMBER;
+    node.numberType_ = VALUE_NT_INT;
+    node.numberValue_ = value;
+    return AddValue(node);
+}
+
+bool ValueDocument::Uint(unsigned value)
+{
+    // Same number type a Value gets when loaded from JSON
+    if (value <= INT_MAX)
+        return Int(static_cast<int>(value));
+
+    ValueNode node;
+    node.valueType_ = VALUE_NUMBER;
+    node.numberType_ = VALUE_NT_UINT;
+    node.numberValue_ = value;
+    return AddValue(node);
+}
+
+bool ValueDocument::Int64(int64_t value)
+{
+    if (value >= INT_MIN && value <= INT_MAX)
+        return Int(static_cast<int>(value));
+    if (value >= 0 && value <= UINT_MAX)
+        return Uint(static_cast<unsigned>(value));
+    return Double(static_cast<double>(value));
+}
+
+bool ValueDocument::Uint64(uint64_t value)
+{
+    if (value <= UINT_MAX)
+        return Uint(static_cast<unsigned>(value));
+    return Double(static_cast<double>(value));
+}
+
+bool ValueDocument::Double(double value)
+{
+    ValueNode node;
+    node.valueType_ = VALUE_NUMBER;
+    node.numberType_ = VALUE_NT_FLOAT_DOUBLE;
+    node.numberValue_ = value;
+    return AddValue(node);
+}
+
+bool ValueDocument::String(const char* str, unsigned length, bool copy)
+{
+    ValueNode node;
+    node.valueType_ = VALUE_STRING;
+    node.size_ = length;
+    node.stringValue_ = copy ? arena_.AllocateString(str, length) : str;
+    return AddValue(node);
+}
+
+bool ValueDocument::StartObject()
+{
+    if (complete_ || (!containers_.empty() && containers_.back().second == VALUE_OBJECT && !hasPendingKey_))
+        return false;
+
+    containers_.emplace_back(static_cast<unsigned>(stack_.size()), VALUE_OBJECT);
+    stack_.push_back(ValueMember{pendingKey_, ValueNode()});
+    hasPendingKey_ = false;
+    return true;
+}
+
+bool ValueDocument::Key(const char* str, unsigned length, bool /*copy*/)
+{
+    if (containers_.empty() || containers_.back().second != VALUE_OBJECT || hasPendingKey_)
+        return false;
+
+    pendingKey_ = InternKey(std::string_view(str, length));
+    hasPendingKey_ = true;
+    return true;
+}
+
+bool ValueDocument::EndObject(unsigned /*memberCount*/)
+{
+    if (containers_.empty() || containers_.back().second != VALUE_OBJECT || hasPendingKey_)
+        return false;
+
+    // The container's own slot holds the key it was opened with
+    const unsigned start = containers_.back().first;
+    containers_.pop_back();
+    ValueMember* first = stack_.data() + start + 1;
+    ValueMember* last = stack_.data() + stack_.size();
+
+    // Sort stably so that later duplicates win, like assigning into a Value object. Most objects are small, where
+    // insertion sort avoids the temporary buffer of std::stable_sort
+    auto keyLess = [](const ValueMember& lhs, const ValueMember& rhs) { return lhs.key_ < rhs.key_; };
+    if (last - first <= SMALL_OBJECT_SIZE)
+    {
+        for (ValueMember* member = first + 1; member < last; ++member)
+        {
+            const ValueMember value = *member;
+            ValueMember* dest = member;
+            for (; dest != first && keyLess(value, *(dest - 1)); --dest)
+                *dest = *(dest - 1);
+            *dest = value;
+        }
+    }
+    else
+        std::stable_sort(first, last, keyLess);
+    ValueMember* uniqueEnd = first;
+    for (ValueMember* member = first; member != last; ++member)
+    {
+        if (uniqueEnd != first && (uniqueEnd - 1)->key_ == member->key_)
+            *(uniqueEnd - 1) = *member;
+        else
+            *uniqueEnd++ = *member;
+    }
+
+    ValueMember& slot = stack_[start];
+    ValueNode node;
+    node.valueType_ = VALUE_OBJECT;
+    node.size_ = static_cast<unsigned>(uniqueEnd - first);
+    if (node.size_)
+    {
+        auto* members = static_cast<ValueMember*>(arena_.Allocate(node.size_ * sizeof(ValueMember), alignof(ValueMember)));
+        std::uninitialized_copy(first, uniqueEnd, members);
+        node.members_ = members;
+    }
+
+    pendingKey_ = slot.key_;
+    hasPendingKey_ = !containers_.empty() && containers_.back().second == VALUE_OBJECT;
+    stack_.resize(start);
+    return AddValue(node);
+}
+
+bool ValueDocument::StartArray()
+{
+    if (complete_ || (!containers_.empty() && containers_.back().second == VALUE_OBJECT && !hasPendingKey_))
+        return false;
+
+    containers_.emplace_back(static_cast<unsigned>(stack_.size()), VALUE_ARRAY);
+    stack_.push_back(ValueMember{pendingKey_, ValueNode()});
+    hasPendingKey_ = false;
+    return true;
+}
+
+bool ValueDocument::EndArray(unsigned /*elementCount*/)
+{
+    if (containers_.empty() || containers_.back().second != VALUE_ARRAY)
+        return false;
+
+    const unsigned start = containers_.back().first;
+    containers_.pop_back();
+
+    ValueNode node;
+    node.valueType_ = VALUE_ARRAY;
+    node.size_ = static_cast<unsigned>(stack_.size() - start - 1);
+    if (node.size_)
+    {
+        auto* elements = static_cast<ValueNode*>(arena_.Allocate(node.size_ * sizeof(ValueNode), alignof(ValueNode)));
+        for (unsigned i = 0; i < node.size_; ++i)
+            new (elements + i) ValueNode(stack_[start + 1 + i].value_);
+        node.elements_ = elements;
+    }
+
+    pendingKey_ = stack_[start].key_;
+    hasPendingKey_ = !containers_.empty() && containers_.back().second == VALUE_OBJECT;
+    stack_.resize(start);
+    return AddValue(node);
+}
+
+bool ValueDocument::AddValue(const ValueNode& node)
+{
+    if (containers_.empty())
+    {
+        if (complete_)
+            return false;
+        root_ = node;
+        complete_ = true;
+        return true;
+    }
+
+    if (containers_.back().second == VALUE_OBJECT)
+    {
+        if (!hasPendingKey_)
+            return false;
+        stack_.push_back(ValueMember{pendingKey_, node});
+        hasPendingKey_ = false;
+    }
+    else
+        stack_.push_back(ValueMember{std::string_view(), node});
+    return true;
+}
+
+std::string_view ValueDocument::InternKey(std::string_view key)
+{
+    auto it = keys_.find(key);
+    if (it != keys_.end())
+        return *it;
+
+    const std::string_view interned(arena_.AllocateString(key.data(), key.length()), key.length());
+    keys_.insert(interned);
+    return interned;
+}
+
+void ValueDocument::BuildValue(const Value& value)
+{
+    switch (value.GetValueType())
+    {
+    case VALUE_BOOL:
+        Bool(value.GetBool());
+        break;
+
+    case VALUE_NUMBER:
+        switch (value.GetNumberType())
+        {
+        case VALUE_NT_INT:
+            Int(value.GetInt());
+            break;
+
+        case VALUE_NT_UINT:
+            Uint(value.GetUInt());
+            break;
+
+        default:
+            Double(value.GetDouble());
+            break;
+        }
+        break;
+
+    case VALUE_STRING:
+        String(value.GetString().c_str(), static_cast<unsigned>(value.GetString().length()));
+        break;
+
+    case VALUE_ARRAY:
+        StartArray();
+        for (const Value& element : value.GetArray())
+            BuildValue(element);
+        EndArray();
+        break;
+
+    case VALUE_OBJECT:
+        StartObject();
+        for (const auto& member : value.GetObject())
+        {
+            Key(member.first.c_str(), static_cast<unsigned>(member.first.length()));
+            BuildValue(member.second);
+        }
+        EndObject();
+        break;
+
+    default:
+        Null();
+        break;
+    }
+}
+
+}
@@ -38,14 +38,18 @@ void BackgroundLoader::ThreadFunction()
     {
         backgroundLoadMutex_.Acquire();
 
-        // Search for a queued resource that has not been loaded yet
-        auto i = backgroundLoadQueue_.begin();
-        while (i != backgroundLoadQueue_.end())
+        // Take the oldest queued resource that has not been loaded yet. Entries may have been finished
+        // already by WaitForResource(), skip those
+        auto i = backgroundLoadQueue_.end();
+        while (!loadOrder_.empty())
         {
-            if (i->second.resource_->GetAsyncLoadState() == ASYNC_QUEUED)
+            auto j = backgroundLoadQueue_.find(loadOrder_.front());
+            loadOrder_.pop_front();
+            if (j != backgroundLoadQueue_.end() && j->second.resource_->GetAsyncLoadState() == ASYNC_QUEUED)
+            {
+                i = j;
                 break;
-            else
-                ++i;
+            }
         }
 
         if (i == backgroundLoadQueue_.end())
@@ -62,12 +66,19 @@ void BackgroundLoader::ThreadFunction()
             // "queued" or "loading" state
             backgroundLoadMutex_.Release();
 
+            ResourceLoadRecord& record = item.record_;
+            record.queueWaitUs_ = item.queueTimer_.GetUSec(false);
+
             bool success = false;
+            HiresTimer timer;
             AbstractFilePtr file = owner_->GetFile(resource->GetName(), item.sendEventOnFailure_);
+            record.ioWaitUs_ = timer.GetUSec(true);
             if (file)
             {
+                record.bytes_ = file->GetSize();
                 resource->SetAsyncLoadState(ASYNC_LOADING);
-                success = resource->BeginLoad(*file);
+                success = owner_->BeginLoadResource(*resource, *file);
+                record.beginLoadUs_ = timer.GetUSec(false);
             }
 
             // Process dependencies now
@@ -104,16 +115,52 @@ void BackgroundLoader::ThreadFunction()
 
 bool BackgroundLoader::QueueResource(String type, const String& name, bool sendEventOnFailure, Resource* caller)
 {
-    String nameHash(name);
-    auto key = std::make_pair(type, nameHash);
+    MutexLock lock(backgroundLoadMutex_);
+
+    if (!QueueResourceLocked(type, name, sendEventOnFailure, caller, nullptr))
+        return false;
+
+    // Start the background loader thread now
+    if (!IsStarted())
+        Run();
+
+    return true;
+}
 
+unsigned BackgroundLoader::QueueResources(const std::vector<ResourceRef>& resources, bool sendEventOnFailure,
+    const std::shared_ptr<BackgroundLoadBatch>& batch)
+{
     MutexLock lock(backgroundLoadMutex_);
 
+    unsigned numQueued = 0;
+    for (const ResourceRef& ref : resources)
+    {
+        if (QueueResourceLocked(ref.type_, ref.name_, sendEventOnFailure, nullptr, batch))
+            ++numQueued;
+    }
+
+    if (numQueued && !IsStarted())
+        Run();
+
+    return numQueued;
+}
+
+bool BackgroundLoader::QueueResourceLocked(String type, const String& name, bool sendEventOnFailure, Resource* caller,
+    const std::shared_ptr<BackgroundLoadBatch>& batch)
+{
+    String nameHash(name);
+    auto key = std::make_pair(type, nameHash);
+
     // Check if already exists in the queue
 //    auto it = FindPairString(backgroundLoadQueue_, key);
     auto it = backgroundLoadQueue_.find(key);
     if (it != backgroundLoadQueue_.end())
+    {
+        // Let the batch wait for the load that is already in flight
+        if (batch)
+            it->second.batches_.push_back(batch);
         return false;
+    }
 
     // auto item = std::find(backgroundLoadQueue_.begin(), backgroundLoadQueue_.end(), [key](const std::pair<String, String>& param) {
     //         return key.first == param.first && key.second == param.second;
@@ -140,6 +187,8 @@ bool BackgroundLoader::QueueResource(String type, const String& name, bool sendE
         auto itErase = backgroundLoadQueue_.find(key);
         //auto itErase = FindPairString(backgroundLoadQueue_, key);
         backgroundLoadQueue_.erase(itErase);
+        if (batch)
+            ++batch->progress_.numFailed_;
         return false;
     }
 
@@ -147,6 +196,10 @@ bool BackgroundLoader::QueueResource(String type, const String& name, bool sendE
 
     item.resource_->SetName(name);
     item.resource_->SetAsyncLoadState(ASYNC_QUEUED);
+    item.queueTimer_.Reset();
+    if (batch)
+        item.batches_.push_back(batch);
+    loadOrder_.push_back(key);
 
     // If this is a resource calling for the background load of more resources, mark the dependency as necessary
     if (caller)
@@ -165,10 +218,6 @@ bool BackgroundLoader::QueueResource(String type, const String& name, bool sendE
                     caller->GetName());
     }
 
-    // Start the background loader thread now
-    if (!IsStarted())
-        Run();
-
     return true;
 }
 
@@ -209,7 +258,7 @@ void BackgroundLoader::WaitForResource(String type, String nameHash)
         }
 
         // This may take a long time and may potentially wait on other resources, so it is important we do not hold the mutex during this
-        FinishBackgroundLoading(i->second);
+        FinishBackgroundLoading(i->second, true);
 
         backgroundLoadMutex_.Acquire();
         backgroundLoadQueue_.erase(i);
@@ -224,6 +273,8 @@ void BackgroundLoader::FinishResources(int maxMs)
     if (IsStarted())
     {
         HiresTimer timer;
+        const long long budgetUs = maxMs * 1000LL;
+        bool didWork = false;
 
         backgroundLoadMutex_.Acquire();
 
@@ -234,20 +285,44 @@ void BackgroundLoader::FinishResources(int maxMs)
             unsigned numDeps = i->second.dependencies_.size();
             AsyncLoadState state = resource->GetAsyncLoadState();
             if (numDeps > 0 || state == ASYNC_QUEUED || state == ASYNC_LOADING)
-                ++i;
-            else
             {
-                // Finishing a resource may need it to wait for other resources to load, in which case we can not
-                // hold on to the mutex
-                backgroundLoadMutex_.Release();
-                FinishBackgroundLoading(i->second);
-                backgroundLoadMutex_.Acquire();
-                backgroundLoadQueue_.erase(key);
+                ++i;
+                continue;
             }
 
             // Break when the time limit passed so that we keep sufficient FPS
-            if (timer.GetUSec(false) >= maxMs * 1000LL)
+            const long long elapsedUs = timer.GetUSec(false);
+            if (elapsedUs >= budgetUs)
+                break;
+
+            // Skip resources that are estimated not to fit the remaining budget, a cheaper one may still fit.
+            // Always do at least one step per frame so that expensive resources cannot stall forever
+            if (didWork && elapsedUs + EstimateEndLoadUs(*resource) > budgetUs)
+            {
+                ++i;
+                continue;
+            }
+
+            // Finishing a resource may need it to wait for other resources to load, in which case we can not
+            // hold on to the mutex
+            backgroundLoadMutex_.Release();
+            bool finished = false;
+            do
+            {
+                finished = FinishBackgroundLoading(i->second, false);
+                didWork = true;
+            } while (!finished && timer.GetUSec(false) + EstimateEndLoadUs(*resource) <= budgetUs);
+            backgroundLoadMutex_.Acquire();
+
+            // The queue may have been modified while not holding the mutex, so look the item up again.
+            // If WaitForResource() already finished and removed it, resume on the next frame
+            i = backgroundLoadQueue_.find(key);
+            if (i == backgroundLoadQueue_.end())
                 break;
+            if (finished)
+                i = backgroundLoadQueue_.erase(i);
+            else
+                ++i;
         }
 
         backgroundLoadMutex_.Release();
@@ -260,7 +335,14 @@ unsigned BackgroundLoader::GetNumQueuedResources() const
     return backgroundLoadQueue_.size();
 }
 
-void BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item)
+long long BackgroundLoader::EstimateEndLoadUs(const Resource& resource) const
+{
+    // Prefer the resource's own estimate, fall back to what this resource type took on average so far
+    const long long estimateUs = resource.GetEndLoadCostEstimate();
+    return estimateUs > 0 ? estimateUs : owner_->GetLoadStats().GetAverageEndLoadUs(resource.GetType());
+}
+
+bool BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item, bool complete)
 {
     auto resource = item.resource_;
 
@@ -270,11 +352,31 @@ void BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item)
     {
         SE_PROFILE("FinishBackgroundLoading");
 //        SE_PROFILE_ZONENAME(resource->GetTypeName().c_str()(), resource->GetTypeName().length());
-        SE_LOG_DEBUG("Finishing background loaded resource " + resource->GetName());
-        success = resource->EndLoad();
+        if (!item.finalizing_)
+        {
+            SE_LOG_DEBUG("Finishing background loaded resource " + resource->GetName());
+            item.finalizing_ = true;
+        }
+
+        HiresTimer timer;
+        bool finished = false;
+        do
+            success = resource->EndLoadStep(finished);
+        while (success && !finished && complete);
+        item.record_.endLoadUs_ += timer.GetUSec(false);
+
+        // Resume on a later frame
+        if (success && !finished)
+            return false;
     }
     resource->SetAsyncLoadState(ASYNC_DONE);
 
+    item.record_.type_ = resource->GetType();
+    item.record_.name_ = resource->GetName();
+    item.record_.background_ = true;
+    item.record_.success_ = success;
+    owner_->GetLoadStats().AddRecord(item.record_);
+
     if (!success && item.sendEventOnFailure_)
     {
         //E_LOADFAILED
@@ -287,6 +389,19 @@ void BackgroundLoader::FinishBackgroundLoading(BackgroundLoadItem& item)
 
     //E_RESOURCEBACKGROUNDLOADED
     owner_->onResourceBackgroundLoaded(resource->GetName(), resource, success);
+
+    for (const auto& batch : item.batches_)
+    {
+        if (success)
+            ++batch->progress_.numLoaded_;
+        else
+            ++batch->progress_.numFailed_;
+
+        if (batch->callback_)
+            batch->callback_(batch->progress_);
+    }
+    item.batches_.clear();
+    return true;
 }
 
 }
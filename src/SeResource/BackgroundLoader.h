@@ -3,9 +3,12 @@
 #include <Se/Algorithms.hpp>
 #include <Se/Mutex.hpp>
 #include <Se/Thread.h>
+#include <Se/Timer.h>
 #include <Se/String.hpp>
 #include <Se/Hash.hpp>
+#include <SeResource/ResourceCache.h>
 
+#include <deque>
 #include <memory>
 #include <unordered_map>
 #include <unordered_set>
@@ -29,6 +32,15 @@ namespace Se
 class Resource;
 class ResourceCache;
 
+/// Shared state of a batched prefetch.
+struct BackgroundLoadBatch
+{
+    /// Current progress.
+    ResourcePrefetchProgress progress_;
+    /// Progress callback.
+    ResourcePrefetchCallback callback_;
+};
+
 /// Queue item for background loading of a resource.
 struct BackgroundLoadItem
 {
@@ -40,6 +52,14 @@ struct BackgroundLoadItem
     std::unordered_set<std::pair<String, String> > dependents_;
     /// Whether to send failure event.
     bool sendEventOnFailure_;
+    /// Prefetch batches waiting for this resource.
+    std::vector<std::shared_ptr<BackgroundLoadBatch>> batches_;
+    /// Timer started when the resource was queued.
+    HiresTimer queueTimer_;
+    /// Load telemetry collected across the worker and main thread phases.
+    ResourceLoadRecord record_;
+    /// Whether EndLoad() steps have started.
+    bool finalizing_{};
 };
 
 /// Background loader of resources. Owned by the ResourceCache.
@@ -57,17 +77,24 @@ public:
 
     /// Queue loading of a resource. The name must be sanitated to ensure consistent format. Return true if queued (not a duplicate and resource was a known type).
     bool QueueResource(String type, const String& name, bool sendEventOnFailure, Resource* caller);
+    /// Queue loading of multiple resources under one lock, in the given read order. The names must be sanitated. Resources already in the queue are attached to the batch. Return number of newly queued resources.
+    unsigned QueueResources(const std::vector<ResourceRef>& resources, bool sendEventOnFailure, const std::shared_ptr<BackgroundLoadBatch>& batch);
     /// Wait and finish possible loading of a resource when being requested from the cache.
     void WaitForResource(String type, String nameHash);
-    /// Process resources that are ready to finish.
+    /// Process resources that are ready to finish. Finalization work is packed into the time budget by estimated cost, splitting resumable EndLoad() into steps.
     void FinishResources(int maxMs);
 
     /// Return amount of resources in the load queue.
     unsigned GetNumQueuedResources() const;
 
 private:
-    /// Finish one background loaded resource.
-    void FinishBackgroundLoading(BackgroundLoadItem& item);
+    /// Queue loading of a resource. Background load mutex must be held.
+    bool QueueResourceLocked(String type, const String& name, bool sendEventOnFailure, Resource* caller,
+        const std::shared_ptr<BackgroundLoadBatch>& batch);
+    /// Finish one background loaded resource. If not complete, perform only one EndLoad() step. Return true when the resource is finished.
+    bool FinishBackgroundLoading(BackgroundLoadItem& item, bool complete);
+    /// Return estimated cost of the next EndLoad() step of a resource in microseconds.
+    long long EstimateEndLoadUs(const Resource& resource) const;
 
     /// Resource cache.
     ResourceCache* owner_;
@@ -75,6 +102,8 @@ private:
     mutable Mutex backgroundLoadMutex_;
     /// Resources that are queued for background loading.
     std::unordered_map<std::pair<String, String>, BackgroundLoadItem> backgroundLoadQueue_;
+    /// Queued resources in the order they should be read.
+    std::deque<std::pair<String, String>> loadOrder_;
 };
 
 }
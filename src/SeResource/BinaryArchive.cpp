@@ -118,6 +118,12 @@ namespace Se
         CheckResult(currentBlockSerializer_->WriteVLE(value), name);
     }
 
+    Serializer* BinaryOutputArchive::GetBinarySerializer(const char* name)
+    {
+        CheckBeforeElement(name);
+        return currentBlockSerializer_;
+    }
+
 // Generate serialization implementation (binary output)
 #define SE_BINARY_OUT_IMPL(type, function) \
     void BinaryOutputArchive::Serialize(const char* name, type& value) \
@@ -219,6 +225,12 @@ namespace Se
         CheckResult(true, name);
     }
 
+    Deserializer* BinaryInputArchive::GetBinaryDeserializer(const char* name)
+    {
+        CheckBeforeElement(name);
+        return deserializer_;
+    }
+
 // Generate serialization implementation (binary input)
 #define SE_BINARY_IN_IMPL(type, function) \
     void BinaryInputArchive::Serialize(const char* name, type& value) \
@@ -0,0 +1,1159 @@
+#include "Compress.h"
+#include "Decompress.h"
+
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace Se
+{
+
+/// Fetch a 4x4 block as RGBA, replicating the last row and column at image edges.
+static void LoadBlock(unsigned char* block, const unsigned char* pixels, unsigned pitch, unsigned components,
+    int numColumns, int numRows)
+{
+    for (int y = 0; y < 4; ++y)
+    {
+        const unsigned char* row = pixels + std::min(y, numRows - 1) * pitch;
+        for (int x = 0; x < 4; ++x)
+        {
+            const unsigned char* src = row + std::min(x, numColumns - 1) * components;
+            unsigned char* dest = block + 4 * (4 * y + x);
+            switch (components)
+            {
+            case 1:
+                dest[0] = dest[1] = dest[2] = src[0];
+                dest[3] = 255;
+                break;
+
+            case 2:
+                dest[0] = dest[1] = dest[2] = src[0];
+                dest[3] = src[1];
+                break;
+
+            case 3:
+                memcpy(dest, src, 3);
+                dest[3] = 255;
+                break;
+
+            default:
+                memcpy(dest, src, 4);
+                break;
+            }
+        }
+    }
+}
+
+/// Find the mean and the principal axis of points with power iteration. The axis is zero if all points are equal.
+static void ComputePrincipalAxis(float* mean, float* axis, const float (*points)[4], int numPoints, int numChannels)
+{
+    for (int c = 0; c < numChannels; ++c)
+    {
+        mean[c] = 0.0f;
+        for (int i = 0; i < numPoints; ++i)
+            mean[c] += points[i][c];
+        mean[c] /= numPoints;
+    }
+
+    float covariance[4][4] = {};
+    for (int i = 0; i < numPoints; ++i)
+    {
+        for (int a = 0; a < numChannels; ++a)
+        {
+            for (int b = 0; b < numChannels; ++b)
+                covariance[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+        }
+    }
+
+    // Start from the row of the channel with the largest variance
+    int largest = 0;
+    for (int c = 1; c < numChannels; ++c)
+    {
+        if (covariance[c][c] > covariance[largest][largest])
+            largest = c;
+    }
+    for (int c = 0; c < numChannels; ++c)
+        axis[c] = covariance[largest][c];
+
+    float length = 0.0f;
+    for (int iteration = 0; iteration < 8; ++iteration)
+    {
+        float next[4] = {};
+        for (int a = 0; a < numChannels; ++a)
+        {
+            for (int b = 0; b < numChannels; ++b)
+                next[a] += covariance[a][b] * axis[b];
+        }
+
+        length = 0.0f;
+        for (int c = 0; c < numChannels; ++c)
+            length = std::max(length, std::fabs(next[c]));
+        if (length == 0.0f)
+            break;
+        for (int c = 0; c < numChannels; ++c)
+            axis[c] = next[c] / length;
+    }
+
+    length = 0.0f;
+    for (int c = 0; c < numChannels; ++c)
+        length += axis[c] * axis[c];
+    length = std::sqrt(length);
+    for (int c = 0; c < numChannels; ++c)
+        axis[c] = length > 0.0f ? axis[c] / length : 0.0f;
+}
+
+/// Find the endpoints spanning the points along their principal axis.
+static void ComputeAxisEndpoints(float* endpoint0, float* endpoint1, const float (*points)[4], int numPoints, int numChannels)
+{
+    float mean[4];
+    float axis[4];
+    ComputePrincipalAxis(mean, axis, points, numPoints, numChannels);
+
+    float minProjection = 0.0f;
+    float maxProjection = 0.0f;
+    for (int i = 0; i < numPoints; ++i)
+    {
+        float projection = 0.0f;
+        for (int c = 0; c < numChannels; ++c)
+            projection += (points[i][c] - mean[c]) * axis[c];
+        minProjection = std::min(minProjection, projection);
+        maxProjection = std::max(maxProjection, projection);
+    }
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+        endpoint0[c] = Clamp(mean[c] + axis[c] * minProjection, 0.0f, 255.0f);
+        endpoint1[c] = Clamp(mean[c] + axis[c] * maxProjection, 0.0f, 255.0f);
+    }
+}
+
+/// Least squares fit of two endpoints to points, given the interpolation weight of the second endpoint for each point.
+/// Return false if the system is degenerate.
+static bool FitEndpoints(float* endpoint0, float* endpoint1, const float (*points)[4], const float* weights, int numPoints,
+    int numChannels)
+{
+    float aa = 0.0f;
+    float bb = 0.0f;
+    float ab = 0.0f;
+    float ax[4] = {};
+    float bx[4] = {};
+    for (int i = 0; i < numPoints; ++i)
+    {
+        const float b = weights[i];
+        const float a = 1.0f - b;
+        aa += a * a;
+        bb += b * b;
+        ab += a * b;
+        for (int c = 0; c < numChannels; ++c)
+        {
+            ax[c] += a * points[i][c];
+            bx[c] += b * points[i][c];
+        }
+    }
+
+    const float determinant = aa * bb - ab * ab;
+    if (std::fabs(determinant) < 1e-6f)
+        return false;
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+        endpoint0[c] = Clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+        endpoint1[c] = Clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+static int Pack565(const float* colour)
+{
+    const int red = Clamp((int)(colour[0] * (31.0f / 255.0f) + 0.5f), 0, 31);
+    const int green = Clamp((int)(colour[1] * (63.0f / 255.0f) + 0.5f), 0, 63);
+    const int blue = Clamp((int)(colour[2] * (31.0f / 255.0f) + 0.5f), 0, 31);
+    return (red << 11) | (green << 5) | blue;
+}
+
+/// Build the palette of a DXT colour block the same way DXT decompression does.
+static void BuildPalette565(int (*palette)[3], int colour0, int colour1, bool threeColour)
+{
+    const int red0 = (colour0 >> 11) & 0x1f;
+    const int green0 = (colour0 >> 5) & 0x3f;
+    const int blue0 = colour0 & 0x1f;
+    const int red1 = (colour1 >> 11) & 0x1f;
+    const int green1 = (colour1 >> 5) & 0x3f;
+    const int blue1 = colour1 & 0x1f;
+
+    palette[0][0] = (red0 << 3) | (red0 >> 2);
+    palette[0][1] = (green0 << 2) | (green0 >> 4);
+    palette[0][2] = (blue0 << 3) | (blue0 >> 2);
+    palette[1][0] = (red1 << 3) | (red1 >> 2);
+    palette[1][1] = (green1 << 2) | (green1 >> 4);
+    palette[1][2] = (blue1 << 3) | (blue1 >> 2);
+
+    for (int c = 0; c < 3; ++c)
+    {
+        if (threeColour)
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+        else
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+    }
+}
+
+/// Choose the nearest palette colour for each pixel. Transparent pixels use index 3. Return the total squared error.
+static int MatchColours(unsigned char* indices, const unsigned char* block, unsigned transparentMask,
+    const int (*palette)[3], int numColours)
+{
+    int error = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        if (transparentMask & (1u << i))
+        {
+            indices[i] = 3;
+            continue;
+        }
+
+        const unsigned char* pixel = block + 4 * i;
+        int bestError = INT_MAX;
+        for (int j = 0; j < numColours; ++j)
+        {
+            const int dr = pixel[0] - palette[j][0];
+            const int dg = pixel[1] - palette[j][1];
+            const int db = pixel[2] - palette[j][2];
+            const int pixelError = dr * dr + dg * dg + db * db;
+            if (pixelError < bestError)
+            {
+                bestError = pixelError;
+                indices[i] = (unsigned char)j;
+            }
+        }
+        error += bestError;
+    }
+    return error;
+}
+
+/// Endpoint pairs whose 1/3 interpolant best reproduces each 8-bit value, for 5- and 6-bit endpoints.
+struct SingleColourTables
+{
+    SingleColourTables()
+    {
+        Build(match5_, 5);
+        Build(match6_, 6);
+    }
+
+    static void Build(unsigned char (*table)[2], int numBits)
+    {
+        const int size = 1 << numBits;
+        for (int value = 0; value < 256; ++value)
+        {
+            int bestError = INT_MAX;
+            for (int a = 0; a < size; ++a)
+            {
+                for (int b = 0; b < size; ++b)
+                {
+                    const int expandedA = (a << (8 - numBits)) | (a >> (2 * numBits - 8));
+                    const int expandedB = (b << (8 - numBits)) | (b >> (2 * numBits - 8));
+                    // Prefer close endpoints, as GPUs round the interpolant differently
+                    const int error = std::abs((2 * expandedA + expandedB) / 3 - value) * 100 + std::abs(expandedA - expandedB) * 3;
+                    if (error < bestError)
+                    {
+                        bestError = error;
+                        table[value][0] = (unsigned char)a;
+                        table[value][1] = (unsigned char)b;
+                    }
+                }
+            }
+        }
+    }
+
+    unsigned char match5_[256][2];
+    unsigned char match6_[256][2];
+};
+
+static const SingleColourTables& GetSingleColourTables()
+{
+    static const SingleColourTables tables;
+    return tables;
+}
+
+/// Compress the colour of a 4x4 RGBA block to a DXT colour block. With allowTransparent, pixels with alpha below 128
+/// select the transparent index of the 3-colour mode, as in DXT1.
+static void CompressColourBlock(unsigned char* dest, const unsigned char* block, bool allowTransparent)
+{
+    unsigned transparentMask = 0;
+    float points[16][4];
+    int numPoints = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        const unsigned char* pixel = block + 4 * i;
+        if (allowTransparent && pixel[3] < 128)
+            transparentMask |= 1u << i;
+        else
+        {
+            for (int c = 0; c < 3; ++c)
+                points[numPoints][c] = pixel[c];
+            ++numPoints;
+        }
+    }
+
+    const bool threeColour = transparentMask != 0;
+    const int numColours = threeColour ? 3 : 4;
+    unsigned char indices[16];
+    int colour0 = 0;
+    int colour1 = 0;
+
+    bool solid = numPoints > 0;
+    for (int i = 1; i < numPoints && solid; ++i)
+        solid = points[i][0] == points[0][0] && points[i][1] == points[0][1] && points[i][2] == points[0][2];
+
+    if (!numPoints)
+        memset(indices, 3, sizeof indices);
+    else if (solid && !threeColour)
+    {
+        // Reproduce a single colour with the 1/3 interpolant of the best endpoint pair
+        const SingleColourTables& tables = GetSingleColourTables();
+        const unsigned char* red = tables.match5_[block[0]];
+        const unsigned char* green = tables.match6_[block[1]];
+        const unsigned char* blue = tables.match5_[block[2]];
+        colour0 = (red[0] << 11) | (green[0] << 5) | blue[0];
+        colour1 = (red[1] << 11) | (green[1] << 5) | blue[1];
+        memset(indices, 2, sizeof indices);
+    }
+    else
+    {
+        float endpoint0[4];
+        float endpoint1[4];
+        ComputeAxisEndpoints(endpoint0, endpoint1, points, numPoints, 3);
+        colour0 = Pack565(endpoint0);
+        colour1 = Pack565(endpoint1);
+
+        int palette[4][3];
+        BuildPalette565(palette, colour0, colour1, threeColour);
+        int error = MatchColours(indices, block, transparentMask, palette, numColours);
+
+        // Refine the endpoints with a least squares fit to the chosen indices while the error decreases
+        static const float fourColourWeights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+        static const float threeColourWeights[4] = {0.0f, 1.0f, 0.5f, 0.0f};
+        const float* indexWeights = threeColour ? threeColourWeights : fourColourWeights;
+        for (int iteration = 0; iteration < 2 && error > 0; ++iteration)
+        {
+            float weights[16];
+            for (int i = 0, j = 0; i < 16; ++i)
+            {
+                if (!(transparentMask & (1u << i)))
+                    weights[j++] = indexWeights[indices[i]];
+            }
+            if (!FitEndpoints(endpoint0, endpoint1, points, weights, numPoints, 3))
+                break;
+
+            const int newColour0 = Pack565(endpoint0);
+            const int newColour1 = Pack565(endpoint1);
+            unsigned char newIndices[16];
+            BuildPalette565(palette, newColour0, newColour1, threeColour);
+            const int newError = MatchColours(newIndices, block, transparentMask, palette, numColours);
+            if (newError >= error)
+                break;
+
+            colour0 = newColour0;
+            colour1 = newColour1;
+            memcpy(indices, newIndices, sizeof indices);
+            error = newError;
+        }
+    }
+
+    // The endpoint order selects the palette mode in DXT1
+    if (threeColour)
+    {
+        if (colour0 > colour1)
+        {
+            std::swap(colour0, colour1);
+            for (unsigned char& index : indices)
+            {
+                if (index < 2)
+                    index ^= 1;
+            }
+        }
+    }
+    else if (colour0 < colour1)
+    {
+        std::swap(colour0, colour1);
+        for (unsigned char& index : indices)
+            index ^= 1;
+    }
+    else if (colour0 == colour1)
+        memset(indices, 0, sizeof indices);
+
+    dest[0] = (unsigned char)(colour0 & 0xff);
+    dest[1] = (unsigned char)(colour0 >> 8);
+    dest[2] = (unsigned char)(colour1 & 0xff);
+    dest[3] = (unsigned char)(colour1 >> 8);
+    for (int i = 0; i < 4; ++i)
+        dest[4 + i] = (unsigned char)(indices[4 * i] | (indices[4 * i + 1] << 2) | (indices[4 * i + 2] << 4) | (indices[4 * i + 3] << 6));
+}
+
+/// Choose the nearest DXT5 alpha codebook entry for each value. Return the total squared error.
+static int MatchChannel(unsigned char* indices, const int* values, int alpha0, int alpha1)
+{
+    // Same codebook as DXT5 alpha decompression
+    int codes[8];
+    codes[0] = alpha0;
+    codes[1] = alpha1;
+    if (alpha0 <= alpha1)
+    {
+        for (int i = 1; i < 5; ++i)
+            codes[1 + i] = ((5 - i) * alpha0 + i * alpha1) / 5;
+        codes[6] = 0;
+        codes[7] = 255;
+    }
+    else
+    {
+        for (int i = 1; i < 7; ++i)
+            codes[1 + i] = ((7 - i) * alpha0 + i * alpha1) / 7;
+    }
+
+    int error = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        int bestError = INT_MAX;
+        for (int j = 0; j < 8; ++j)
+        {
+            const int valueError = (values[i] - codes[j]) * (values[i] - codes[j]);
+            if (valueError < bestError)
+            {
+                bestError = valueError;
+                indices[i] = (unsigned char)j;
+            }
+        }
+        error += bestError;
+    }
+    return error;
+}
+
+/// Compress one channel of a 4x4 RGBA block to a BC4 block, which is the same as DXT5 alpha.
+static void CompressChannelBlock(unsigned char* dest, const unsigned char* block, int channel)
+{
+    int values[16];
+    int minValue = 255;
+    int maxValue = 0;
+    // Range of the values that the 6-value codebook can not represent exactly with its 0 and 255 entries
+    int minInner = 255;
+    int maxInner = 0;
+    bool hasExtremes = false;
+    for (int i = 0; i < 16; ++i)
+    {
+        values[i] = block[4 * i + channel];
+        minValue = std::min(minValue, values[i]);
+        maxValue = std::max(maxValue, values[i]);
+        if (values[i] == 0 || values[i] == 255)
+            hasExtremes = true;
+        else
+        {
+            minInner = std::min(minInner, values[i]);
+            maxInner = std::max(maxInner, values[i]);
+        }
+    }
+
+    unsigned char indices[16] = {};
+    int alpha0 = maxValue;
+    int alpha1 = minValue;
+    if (minValue != maxValue)
+    {
+        int error = MatchChannel(indices, values, alpha0, alpha1);
+
+        if (hasExtremes && error > 0)
+        {
+            if (minInner > maxInner)
+                minInner = maxInner = 0;
+
+            unsigned char innerIndices[16];
+            const int innerError = MatchChannel(innerIndices, values, minInner, maxInner);
+            if (innerError < error)
+            {
+                alpha0 = minInner;
+                alpha1 = maxInner;
+                memcpy(indices, innerIndices, sizeof indices);
+            }
+        }
+    }
+
+    dest[0] = (unsigned char)alpha0;
+    dest[1] = (unsigned char)alpha1;
+    for (int i = 0; i < 2; ++i)
+    {
+        unsigned value = 0;
+        for (int j = 0; j < 8; ++j)
+            value |= (unsigned)indices[8 * i + j] << (3 * j);
+        dest[2 + 3 * i] = (unsigned char)(value & 0xff);
+        dest[3 + 3 * i] = (unsigned char)((value >> 8) & 0xff);
+        dest[4 + 3 * i] = (unsigned char)((value >> 16) & 0xff);
+    }
+}
+
+/// Writes little-endian bit fields to a zeroed BC7 block.
+struct BC7BitWriter
+{
+    unsigned char* data_;
+    unsigned position_;
+
+    void Write(unsigned value, unsigned numBits)
+    {
+        for (unsigned i = 0; i < numBits; ++i, ++position_)
+            data_[position_ >> 3] |= (unsigned char)(((value >> i) & 1) << (position_ & 7));
+    }
+};
+
+/// Candidate encoding of a block in BC7 mode 6.
+struct BC7Mode6Block
+{
+    /// 7-bit endpoints.
+    int endpoints_[2][4];
+    /// Endpoint P-bits.
+    int pBits_[2];
+    /// Pixel indices.
+    unsigned char indices_[16];
+    /// Total squared error.
+    int error_;
+};
+
+/// Choose the nearest of the 16 interpolated colours for each pixel of a mode 6 block and update its error.
+static void MatchBC7Mode6(BC7Mode6Block& candidate, const unsigned char* block)
+{
+    int endpoints[2][4];
+    for (int e = 0; e < 2; ++e)
+    {
+        for (int c = 0; c < 4; ++c)
+            endpoints[e][c] = (candidate.endpoints_[e][c] << 1) | candidate.pBits_[e];
+    }
+
+    int palette[16][4];
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+            palette[i][c] = ((64 - BC7_WEIGHTS4[i]) * endpoints[0][c] + BC7_WEIGHTS4[i] * endpoints[1][c] + 32) >> 6;
+    }
+
+    int axis[4];
+    int axisLengthSquared = 0;
+    for (int c = 0; c < 4; ++c)
+    {
+        axis[c] = endpoints[1][c] - endpoints[0][c];
+        axisLengthSquared += axis[c] * axis[c];
+    }
+
+    candidate.error_ = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        const unsigned char* pixel = block + 4 * i;
+
+        // The palette lies on a line, so project onto it and check the neighbours of the nearest step exactly
+        int nearest = 0;
+        if (axisLengthSquared)
+        {
+            int projection = 0;
+            for (int c = 0; c < 4; ++c)
+                projection += (pixel[c] - endpoints[0][c]) * axis[c];
+            nearest = Clamp((projection * 15 + axisLengthSquared / 2) / axisLengthSquared, 0, 15);
+        }
+
+        int bestError = INT_MAX;
+        for (int j = std::max(nearest - 1, 0); j <= std::min(nearest + 1, 15); ++j)
+        {
+            int pixelError = 0;
+            for (int c = 0; c < 4; ++c)
+                pixelError += (pixel[c] - palette[j][c]) * (pixel[c] - palette[j][c]);
+            if (pixelError < bestError)
+            {
+                bestError = pixelError;
+                candidate.indices_[i] = (unsigned char)j;
+            }
+        }
+        candidate.error_ += bestError;
+    }
+}
+
+/// Choose the nearest BC7 2-bit interpolant for each pixel over a range of channels. Endpoints are 8-bit. Return the
+/// total squared error.
+static int MatchBC7Indices2(unsigned char* indices, const unsigned char* block, const int (*endpoints)[4],
+    int firstChannel, int numChannels)
+{
+    int palette[4][4];
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int c = firstChannel; c < firstChannel + numChannels; ++c)
+            palette[i][c] = ((64 - BC7_WEIGHTS2[i]) * endpoints[0][c] + BC7_WEIGHTS2[i] * endpoints[1][c] + 32) >> 6;
+    }
+
+    int error = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        const unsigned char* pixel = block + 4 * i;
+        int bestError = INT_MAX;
+        for (int j = 0; j < 4; ++j)
+        {
+            int pixelError = 0;
+            for (int c = firstChannel; c < firstChannel + numChannels; ++c)
+                pixelError += (pixel[c] - palette[j][c]) * (pixel[c] - palette[j][c]);
+            if (pixelError < bestError)
+            {
+                bestError = pixelError;
+                indices[i] = (unsigned char)j;
+            }
+        }
+        error += bestError;
+    }
+    return error;
+}
+
+/// Compress a 4x4 RGBA block to BC7 mode 5: 7-bit colour and 8-bit alpha endpoints with separate 2-bit indices, so
+/// alpha does not compete with colour for index precision. Return the total squared error.
+static int CompressBlockBC7Mode5(unsigned char* dest, const unsigned char* block)
+{
+    float points[16][4];
+    int minAlpha = 255;
+    int maxAlpha = 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 3; ++c)
+            points[i][c] = block[4 * i + c];
+        minAlpha = std::min(minAlpha, (int)block[4 * i + 3]);
+        maxAlpha = std::max(maxAlpha, (int)block[4 * i + 3]);
+    }
+
+    // Colour endpoints with least squares refinement
+    float colourEndpoints[2][4];
+    ComputeAxisEndpoints(colourEndpoints[0], colourEndpoints[1], points, 16, 3);
+    int quantized[2][3];
+    int endpoints[2][4];
+    unsigned char colourIndices[16];
+    int colourError = INT_MAX;
+    for (int iteration = 0; iteration < 3; ++iteration)
+    {
+        int candidate[2][3];
+        int candidateEndpoints[2][4];
+        for (int e = 0; e < 2; ++e)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                candidate[e][c] = Clamp((int)(colourEndpoints[e][c] * (127.0f / 255.0f) + 0.5f), 0, 127);
+                candidateEndpoints[e][c] = (candidate[e][c] << 1) | (candidate[e][c] >> 6);
+            }
+        }
+
+        unsigned char indices[16];
+        const int error = MatchBC7Indices2(indices, block, candidateEndpoints, 0, 3);
+        if (error >= colourError)
+            break;
+
+        memcpy(quantized, candidate, sizeof quantized);
+        memcpy(endpoints, candidateEndpoints, sizeof endpoints);
+        memcpy(colourIndices, indices, sizeof colourIndices);
+        colourError = error;
+        if (!colourError)
+            break;
+
+        float weights[16];
+        for (int i = 0; i < 16; ++i)
+            weights[i] = BC7_WEIGHTS2[colourIndices[i]] / 64.0f;
+        if (!FitEndpoints(colourEndpoints[0], colourEndpoints[1], points, weights, 16, 3))
+            break;
+    }
+
+    // Alpha endpoints span the alpha range exactly
+    endpoints[0][3] = minAlpha;
+    endpoints[1][3] = maxAlpha;
+    unsigned char alphaIndices[16];
+    const int alphaError = MatchBC7Indices2(alphaIndices, block, endpoints, 3, 1);
+
+    // The index of the first pixel is stored without its high bit, so swap the endpoints if it is set
+    if (colourIndices[0] >= 2)
+    {
+        for (int c = 0; c < 3; ++c)
+            std::swap(quantized[0][c], quantized[1][c]);
+        for (unsigned char& index : colourIndices)
+            index = (unsigned char)(3 - index);
+    }
+    if (alphaIndices[0] >= 2)
+    {
+        std::swap(endpoints[0][3], endpoints[1][3]);
+        for (unsigned char& index : alphaIndices)
+            index = (unsigned char)(3 - index);
+    }
+
+    memset(dest, 0, 16);
+    BC7BitWriter bits{dest, 0};
+    bits.Write(1 << 5, 6);
+    // No channel rotation
+    bits.Write(0, 2);
+    for (int c = 0; c < 3; ++c)
+    {
+        bits.Write(quantized[0][c], 7);
+        bits.Write(quantized[1][c], 7);
+    }
+    bits.Write(endpoints[0][3], 8);
+    bits.Write(endpoints[1][3], 8);
+    bits.Write(colourIndices[0], 1);
+    for (int i = 1; i < 16; ++i)
+        bits.Write(colourIndices[i], 2);
+    bits.Write(alphaIndices[0], 1);
+    for (int i = 1; i < 16; ++i)
+        bits.Write(alphaIndices[i], 2);
+
+    return colourError + alphaError;
+}
+
+/// Layout of a BC7 mode with two subsets.
+struct BC7PartitionedMode
+{
+    /// Mode number.
+    int mode_;
+    /// Stored bits of each endpoint channel, excluding the P-bit.
+    int endpointBits_;
+    /// Number of stored channels. Alpha decodes as 255 if it is not stored.
+    int numChannels_;
+    /// Whether the two endpoints of a subset share one P-bit.
+    bool sharedPBit_;
+    /// Bits of each pixel index.
+    int indexBits_;
+};
+
+/// Modes 1 and 3 store opaque colour, trading index precision for endpoint precision. Mode 7 also stores alpha.
+static const BC7PartitionedMode BC7_PARTITIONED_MODES[3] =
+{
+    {1, 6, 3, true, 3},
+    {3, 7, 3, false, 2},
+    {7, 5, 4, false, 2}
+};
+
+/// Number of partitions with the best estimated fit that are fully encoded.
+static const int BC7_PARTITION_CANDIDATES = 2;
+
+/// Candidate encoding of one subset of a two subset BC7 block.
+struct BC7SubsetBlock
+{
+    /// Stored endpoints without P-bits.
+    int endpoints_[2][4];
+    /// Endpoint P-bits.
+    int pBits_[2];
+    /// Indices of the subset pixels in pixel order.
+    unsigned char indices_[16];
+    /// Total squared error.
+    int error_;
+};
+
+/// Expand an endpoint channel including its P-bit to 8 bits by replicating the high bits.
+static int ExpandBC7Endpoint(int value, int numBits)
+{
+    return (value << (8 - numBits)) | (value >> (2 * numBits - 8));
+}
+
+/// Encode the points of one subset in a two subset BC7 mode. Endpoints start from the principal axis and are refined
+/// with least squares fits, trying all P-bit combinations.
+static void CompressBC7Subset(BC7SubsetBlock& best, const BC7PartitionedMode& mode, const float (*points)[4], int numPoints)
+{
+    const int numChannels = mode.numChannels_;
+    const int maxEndpoint = (1 << mode.endpointBits_) - 1;
+    // Scale from 8 bits to the stored bits including the P-bit
+    const float scale = ((2 << mode.endpointBits_) - 1) / 255.0f;
+    const int numIndices = 1 << mode.indexBits_;
+    const int* weights = mode.indexBits_ == 3 ? BC7_WEIGHTS3 : BC7_WEIGHTS2;
+
+    float endpoints[2][4];
+    ComputeAxisEndpoints(endpoints[0], endpoints[1], points, numPoints, numChannels);
+
+    best.error_ = INT_MAX;
+    for (int iteration = 0; iteration < 3; ++iteration)
+    {
+        bool improved = false;
+        for (int pBits = 0; pBits < (mode.sharedPBit_ ? 2 : 4); ++pBits)
+        {
+            BC7SubsetBlock candidate;
+            int expanded[2][4];
+            for (int e = 0; e < 2; ++e)
+            {
+                candidate.pBits_[e] = mode.sharedPBit_ ? pBits : (pBits >> e) & 1;
+                for (int c = 0; c < numChannels; ++c)
+                {
+                    candidate.endpoints_[e][c] = Clamp((int)((endpoints[e][c] * scale - candidate.pBits_[e]) * 0.5f + 0.5f), 0,
+                        maxEndpoint);
+                    expanded[e][c] = ExpandBC7Endpoint((candidate.endpoints_[e][c] << 1) | candidate.pBits_[e],
+                        mode.endpointBits_ + 1);
+                }
+            }
+
+            int palette[8][4];
+            for (int j = 0; j < numIndices; ++j)
+            {
+                for (int c = 0; c < numChannels; ++c)
+                    palette[j][c] = ((64 - weights[j]) * expanded[0][c] + weights[j] * expanded[1][c] + 32) >> 6;
+            }
+
+            candidate.error_ = 0;
+            for (int i = 0; i < numPoints && candidate.error_ < best.error_; ++i)
+            {
+                int bestError = INT_MAX;
+                for (int j = 0; j < numIndices; ++j)
+                {
+                    int pixelError = 0;
+                    for (int c = 0; c < numChannels; ++c)
+                    {
+                        const int difference = (int)points[i][c] - palette[j][c];
+                        pixelError += difference * difference;
+                    }
+                    if (pixelError < bestError)
+                    {
+                        bestError = pixelError;
+                        candidate.indices_[i] = (unsigned char)j;
+                    }
+                }
+                candidate.error_ += bestError;
+            }
+
+            if (candidate.error_ < best.error_)
+            {
+                best = candidate;
+                improved = true;
+            }
+        }
+
+        if (!improved || !best.error_)
+            break;
+
+        float fitWeights[16];
+        for (int i = 0; i < numPoints; ++i)
+            fitWeights[i] = weights[best.indices_[i]] / 64.0f;
+        if (!FitEndpoints(endpoints[0], endpoints[1], points, fitWeights, numPoints, numChannels))
+            break;
+    }
+}
+
+/// Estimate how well a two subset partition fits a block by the squared distances of the points from the principal
+/// axis of their subset.
+static float EstimateBC7Partition(const float (*points)[4], int partition, int numChannels)
+{
+    float subsetPoints[2][16][4];
+    int numPoints[2] = {};
+    for (int i = 0; i < 16; ++i)
+    {
+        const int subset = (BC7_PARTITIONS2[partition] >> i) & 1;
+        memcpy(subsetPoints[subset][numPoints[subset]++], points[i], sizeof points[i]);
+    }
+
+    float error = 0.0f;
+    for (int subset = 0; subset < 2; ++subset)
+    {
+        float mean[4];
+        float axis[4];
+        ComputePrincipalAxis(mean, axis, subsetPoints[subset], numPoints[subset], numChannels);
+        for (int i = 0; i < numPoints[subset]; ++i)
+        {
+            float distanceSquared = 0.0f;
+            float projection = 0.0f;
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const float difference = subsetPoints[subset][i][c] - mean[c];
+                distanceSquared += difference * difference;
+                projection += difference * axis[c];
+            }
+            error += distanceSquared - projection * projection;
+        }
+    }
+    return error;
+}
+
+/// Compress a 4x4 RGBA block to the two subset BC7 mode 1, 3 or 7 with the least error. Opaque blocks try modes 1 and
+/// 3, others mode 7. Only the partitions with the best estimated fit are encoded. Return the total squared error.
+static int CompressBlockBC7Partitioned(unsigned char* dest, const unsigned char* block, bool opaque)
+{
+    const int numChannels = opaque ? 3 : 4;
+    float points[16][4];
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+            points[i][c] = block[4 * i + c];
+    }
+
+    int candidates[BC7_PARTITION_CANDIDATES];
+    float candidateErrors[BC7_PARTITION_CANDIDATES];
+    for (int i = 0; i < BC7_PARTITION_CANDIDATES; ++i)
+    {
+        candidates[i] = 0;
+        candidateErrors[i] = FLT_MAX;
+    }
+    for (int partition = 0; partition < 64; ++partition)
+    {
+        const float error = EstimateBC7Partition(points, partition, numChannels);
+        for (int i = 0; i < BC7_PARTITION_CANDIDATES; ++i)
+        {
+            if (error < candidateErrors[i])
+            {
+                for (int j = BC7_PARTITION_CANDIDATES - 1; j > i; --j)
+                {
+                    candidates[j] = candidates[j - 1];
+                    candidateErrors[j] = candidateErrors[j - 1];
+                }
+                candidates[i] = partition;
+                candidateErrors[i] = error;
+                break;
+            }
+        }
+    }
+
+    int bestError = INT_MAX;
+    for (const BC7PartitionedMode& mode : BC7_PARTITIONED_MODES)
+    {
+        if (mode.numChannels_ != numChannels)
+            continue;
+
+        const int numIndices = 1 << mode.indexBits_;
+        for (const int partition : candidates)
+        {
+            float subsetPoints[2][16][4];
+            int numPoints[2] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                const int subset = (BC7_PARTITIONS2[partition] >> i) & 1;
+                memcpy(subsetPoints[subset][numPoints[subset]++], points[i], sizeof points[i]);
+            }
+
+            BC7SubsetBlock subsets[2];
+            CompressBC7Subset(subsets[0], mode, subsetPoints[0], numPoints[0]);
+            CompressBC7Subset(subsets[1], mode, subsetPoints[1], numPoints[1]);
+            const int error = subsets[0].error_ + subsets[1].error_;
+            if (error >= bestError)
+                continue;
+
+            unsigned char indices[16];
+            int subsetPixels[2] = {};
+            for (int i = 0; i < 16; ++i)
+            {
+                const int subset = (BC7_PARTITIONS2[partition] >> i) & 1;
+                indices[i] = subsets[subset].indices_[subsetPixels[subset]++];
+            }
+
+            // The index of the anchor pixel of each subset is stored without its high bit, so swap the endpoints if it is set
+            const int anchors[2] = {0, BC7_ANCHORS2[partition]};
+            for (int subset = 0; subset < 2; ++subset)
+            {
+                if (indices[anchors[subset]] < numIndices / 2)
+                    continue;
+                BC7SubsetBlock& encoding = subsets[subset];
+                for (int c = 0; c < 4; ++c)
+                    std::swap(encoding.endpoints_[0][c], encoding.endpoints_[1][c]);
+                std::swap(encoding.pBits_[0], encoding.pBits_[1]);
+                for (int i = 0; i < 16; ++i)
+                {
+                    if (((BC7_PARTITIONS2[partition] >> i) & 1) == subset)
+                        indices[i] = (unsigned char)(numIndices - 1 - indices[i]);
+                }
+            }
+
+            memset(dest, 0, 16);
+            BC7BitWriter bits{dest, 0};
+            bits.Write(1 << mode.mode_, mode.mode_ + 1);
+            bits.Write(partition, 6);
+            for (int c = 0; c < numChannels; ++c)
+            {
+                for (const BC7SubsetBlock& encoding : subsets)
+                {
+                    bits.Write(encoding.endpoints_[0][c], mode.endpointBits_);
+                    bits.Write(encoding.endpoints_[1][c], mode.endpointBits_);
+                }
+            }
+            for (const BC7SubsetBlock& encoding : subsets)
+            {
+                bits.Write(encoding.pBits_[0], 1);
+                if (!mode.sharedPBit_)
+                    bits.Write(encoding.pBits_[1], 1);
+            }
+            for (int i = 0; i < 16; ++i)
+                bits.Write(indices[i], mode.indexBits_ - (i == anchors[0] || i == anchors[1]));
+
+            bestError = error;
+        }
+    }
+
+    return bestError;
+}
+
+/// Compress a 4x4 RGBA block to BC7 mode 6: a single subset with 7-bit RGBA endpoints, P-bits and 4-bit indices.
+/// Endpoints start from the principal axis and are refined with least squares fits, trying all P-bit combinations.
+/// Blocks that mode 6 does not encode exactly also try mode 5 if their alpha varies and the two subset modes 1, 3 or 7,
+/// keeping the result with the least error.
+static void CompressBlockBC7(unsigned char* dest, const unsigned char* block)
+{
+    float points[16][4];
+    for (int i = 0; i < 16; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+            points[i][c] = block[4 * i + c];
+    }
+
+    float endpoints[2][4];
+    ComputeAxisEndpoints(endpoints[0], endpoints[1], points, 16, 4);
+
+    BC7Mode6Block best;
+    best.error_ = INT_MAX;
+    for (int iteration = 0; iteration < 3; ++iteration)
+    {
+        bool improved = false;
+        for (int pBits = 0; pBits < 4; ++pBits)
+        {
+            BC7Mode6Block candidate;
+            for (int e = 0; e < 2; ++e)
+            {
+                candidate.pBits_[e] = (pBits >> e) & 1;
+                for (int c = 0; c < 4; ++c)
+                    candidate.endpoints_[e][c] = Clamp((int)((endpoints[e][c] - candidate.pBits_[e]) * 0.5f + 0.5f), 0, 127);
+            }
+
+            MatchBC7Mode6(candidate, block);
+            if (candidate.error_ < best.error_)
+            {
+                best = candidate;
+                improved = true;
+            }
+        }
+
+        if (!improved || !best.error_)
+            break;
+
+        float weights[16];
+        for (int i = 0; i < 16; ++i)
+            weights[i] = BC7_WEIGHTS4[best.indices_[i]] / 64.0f;
+        if (!FitEndpoints(endpoints[0], endpoints[1], points, weights, 16, 4))
+            break;
+    }
+
+    // The index of the first pixel is stored without its high bit, so swap the endpoints if it is set
+    if (best.indices_[0] >= 8)
+    {
+        for (int c = 0; c < 4; ++c)
+            std::swap(best.endpoints_[0][c], best.endpoints_[1][c]);
+        std::swap(best.pBits_[0], best.pBits_[1]);
+        for (unsigned char& index : best.indices_)
+            index = (unsigned char)(15 - index);
+    }
+
+    memset(dest, 0, 16);
+    BC7BitWriter bits{dest, 0};
+    bits.Write(1 << 6, 7);
+    for (int c = 0; c < 4; ++c)
+    {
+        bits.Write(best.endpoints_[0][c], 7);
+        bits.Write(best.endpoints_[1][c], 7);
+    }
+    bits.Write(best.pBits_[0], 1);
+    bits.Write(best.pBits_[1], 1);
+    bits.Write(best.indices_[0], 3);
+    for (int i = 1; i < 16; ++i)
+        bits.Write(best.indices_[i], 4);
+
+    int bestError = best.error_;
+    if (!bestError)
+        return;
+
+    bool varyingAlpha = false;
+    bool opaque = block[3] == 255;
+    for (int i = 1; i < 16; ++i)
+    {
+        varyingAlpha |= block[4 * i + 3] != block[3];
+        opaque &= block[4 * i + 3] == 255;
+    }
+
+    unsigned char candidate[16];
+    if (varyingAlpha)
+    {
+        const int error = CompressBlockBC7Mode5(candidate, block);
+        if (error < bestError)
+        {
+            memcpy(dest, candidate, sizeof candidate);
+            bestError = error;
+        }
+    }
+
+    if (CompressBlockBC7Partitioned(candidate, block, opaque) < bestError)
+        memcpy(dest, candidate, sizeof candidate);
+}
+
+unsigned GetCompressedBlockSize(CompressedFormat format)
+{
+    switch (format)
+    {
+    case CF_DXT1:
+    case CF_BC4:
+        return 8;
+
+    case CF_DXT5:
+    case CF_BC5:
+    case CF_BC7:
+        return 16;
+
+    default:
+        return 0;
+    }
+}
+
+bool CompressImage(unsigned char* blocks, const unsigned char* pixels, int width, int height, unsigned components,
+    CompressedFormat format)
+{
+    const unsigned blockSize = GetCompressedBlockSize(format);
+    if (!blockSize || components < 1 || components > 4)
+        return false;
+
+    const int blocksPerRow = (width + 3) / 4;
+    const unsigned pitch = static_cast<unsigned>(width) * components;
+    // A 2-component image keeps its second channel in alpha after expansion to RGBA
+    const int secondChannel = components == 2 ? 3 : 1;
+
+    ForEachBlockRow((height + 3) / 4, static_cast<unsigned>(width) * 16, [&](int beginRow, int endRow)
+    {
+        for (int row = beginRow; row < endRow; ++row)
+        {
+            const int y = row * 4;
+            const int numRows = std::min(height - y, 4);
+            const unsigned char* sourceRow = pixels + static_cast<size_t>(y) * pitch;
+            unsigned char* targetBlock = blocks + static_cast<size_t>(row) * blocksPerRow * blockSize;
+
+            for (int x = 0; x < width; x += 4)
+            {
+                unsigned char block[4 * 16];
+                LoadBlock(block, sourceRow + x * components, pitch, components, std::min(width - x, 4), numRows);
+
+                switch (format)
+                {
+                case CF_DXT1:
+                    CompressColourBlock(targetBlock, block, true);
+                    break;
+
+                case CF_DXT5:
+                    CompressChannelBlock(targetBlock, block, 3);
+                    CompressColourBlock(targetBlock + 8, block, false);
+                    break;
+
+                case CF_BC4:
+                    CompressChannelBlock(targetBlock, block, 0);
+                    break;
+
+                case CF_BC5:
+                    CompressChannelBlock(targetBlock, block, 0);
+                    CompressChannelBlock(targetBlock + 8, block, secondChannel);
+                    break;
+
+                default:
+                    CompressBlockBC7(targetBlock, block);
+                    break;
+                }
+
+                targetBlock += blockSize;
+            }
+        }
+    });
+
+    return true;
+}
+
+}
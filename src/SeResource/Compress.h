@@ -0,0 +1,17 @@
+#pragma once
+
+#include <SeResource/Image.h>
+
+namespace Se
+{
+
+/// Return the size of a compressed block in bytes for formats supported by CompressImage(), or 0 if not supported.
+unsigned GetCompressedBlockSize(CompressedFormat format);
+/// Compress an 8-bit image with 1-4 components to BC1 (CF_DXT1), BC3 (CF_DXT5), BC4, BC5 or BC7 blocks. Images with
+/// fewer than 4 components are expanded like Image::ConvertToRGBA(), except that BC5 takes the second channel of a
+/// 2-component image from its alpha. The block encoders are scalar; rows of blocks are compressed in parallel on the
+/// WorkQueue instead. Return false if the format is not supported.
+bool CompressImage(unsigned char* blocks, const unsigned char* pixels, int width, int height, unsigned components,
+    CompressedFormat format);
+
+}
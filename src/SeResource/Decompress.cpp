@@ -1,12 +1,14 @@
 #include "Decompress.h"
 
+#include <algorithm>
+#include <cstring>
+
 // ETC2 decompress`
 typedef unsigned char uint8;
 typedef unsigned short uint16;
 typedef short int16;
 
 // Implemented by ETCPACK
-extern void decompressBlockAlphaC(uint8* data, uint8* img, int width, int height, int ix, int iy, int channels);
 extern void decompressBlockETC2c(unsigned int block_part1, unsigned int block_part2, uint8 *img, int width, int height, int startx, int starty, int channels);
 
 // DXT decompression based on the Squish library, modified for GFrost
@@ -91,26 +93,19 @@ static void DecompressColourDXT(unsigned char* rgba, void const* block, bool isD
     codes[8 + 3] = 255;
     codes[12 + 3] = (unsigned char)((isDxt1 && a <= b) ? 0 : 255);
 
-    // unpack the indices
-    unsigned char indices[16];
+    // store out the colours a whole pixel at a time, using the codes as a palette of 4 words
+    unsigned palette[4];
+    memcpy(palette, codes, sizeof palette);
+    unsigned pixels[16];
     for (int i = 0; i < 4; ++i)
     {
-        unsigned char* ind = indices + 4 * i;
-        unsigned char packed = bytes[4 + i];
-
-        ind[0] = (unsigned char)(packed & 0x3);
-        ind[1] = (unsigned char)((packed >> 2) & 0x3);
-        ind[2] = (unsigned char)((packed >> 4) & 0x3);
-        ind[3] = (unsigned char)((packed >> 6) & 0x3);
-    }
-
-    // store out the colours
-    for (int i = 0; i < 16; ++i)
-    {
-        auto offset = (unsigned char)(4 * indices[i]);
-        for (int j = 0; j < 4; ++j)
-            rgba[4 * i + j] = codes[offset + j];
+        unsigned packed = bytes[4 + i];
+        pixels[4 * i + 0] = palette[packed & 0x3];
+        pixels[4 * i + 1] = palette[(packed >> 2) & 0x3];
+        pixels[4 * i + 2] = palette[(packed >> 4) & 0x3];
+        pixels[4 * i + 3] = palette[packed >> 6];
     }
+    memcpy(rgba, pixels, sizeof pixels);
 }
 
 static void DecompressAlphaDXT3(unsigned char* rgba, void const* block)
@@ -133,7 +128,7 @@ static void DecompressAlphaDXT3(unsigned char* rgba, void const* block)
     }
 }
 
-static void DecompressAlphaDXT5(unsigned char* rgba, void const* block)
+static void DecompressAlphaDXT5(unsigned char* rgba, void const* block, int channel = 3)
 {
     // get the two alpha values
     auto const* bytes = reinterpret_cast< unsigned char const* >( block );
@@ -159,35 +154,30 @@ static void DecompressAlphaDXT5(unsigned char* rgba, void const* block)
             codes[1 + i] = (unsigned char)(((7 - i) * alpha0 + i * alpha1) / 7);
     }
 
-    // decode the indices
-    unsigned char indices[16];
-    unsigned char const* src = bytes + 2;
-    unsigned char* dest = indices;
-    for (int i = 0; i < 2; ++i)
-    {
-        // grab 3 bytes
-        int value = 0;
-        for (int j = 0; j < 3; ++j)
-        {
-            int byte = *src++;
-            value |= (byte << 8 * j);
-        }
-
-        // unpack 8 3-bit values from it
-        for (int j = 0; j < 8; ++j)
-        {
-            int index = (value >> 3 * j) & 0x7;
-            *dest++ = (unsigned char)index;
-        }
-    }
+    // all 16 3-bit indices fit in one 48-bit value
+    unsigned long long indices = 0;
+    for (int i = 0; i < 6; ++i)
+        indices |= (unsigned long long)bytes[2 + i] << (8 * i);
 
     // write out the indexed codebook values
     for (int i = 0; i < 16; ++i)
-        rgba[4 * i + 3] = codes[indices[i]];
+        rgba[4 * i + channel] = codes[(indices >> (3 * i)) & 0x7];
 }
 
 static void DecompressDXT(unsigned char* rgba, const void* block, CompressedFormat format)
 {
+    // BC4 and BC5 store one or two channels like DXT5 alpha
+    if (format == CF_BC4 || format == CF_BC5)
+    {
+        static const unsigned char opaqueBlack[4] = {0, 0, 0, 255};
+        for (int i = 0; i < 16; ++i)
+            memcpy(rgba + 4 * i, opaqueBlack, 4);
+        DecompressAlphaDXT5(rgba, block, 0);
+        if (format == CF_BC5)
+            DecompressAlphaDXT5(rgba, reinterpret_cast< unsigned char const* >( block ) + 8, 1);
+        return;
+    }
+
     // get the block locations
     void const* colourBlock = block;
     void const* alphaBock = block;
@@ -204,56 +194,297 @@ static void DecompressDXT(unsigned char* rgba, const void* block, CompressedForm
         DecompressAlphaDXT5(rgba, alphaBock);
 }
 
-void DecompressImageDXT(unsigned char* rgba, const void* blocks, int width, int height, int depth, CompressedFormat format)
+/// Copy a decompressed 4x4 RGBA block to the image, skipping pixels outside it.
+static void StoreBlock(unsigned char* dest, unsigned pitch, const unsigned char* block, int numColumns, int numRows)
 {
-    // initialise the block input
-    auto const* sourceBlock = reinterpret_cast< unsigned char const* >( blocks );
-    int bytesPerBlock = format == CF_DXT1 ? 8 : 16;
+    if (numColumns == 4)
+    {
+        for (int y = 0; y < numRows; ++y)
+            memcpy(dest + y * pitch, block + 16 * y, 16);
+    }
+    else
+    {
+        for (int y = 0; y < numRows; ++y)
+            memcpy(dest + y * pitch, block + 16 * y, 4 * numColumns);
+    }
+}
 
-    // loop over blocks
-    for (int z = 0; z < depth; ++z)
+void DecompressImageDXT(unsigned char* rgba, const void* blocks, int width, int height, int depth, CompressedFormat format)
+{
+    auto const* sourceBlocks = reinterpret_cast< unsigned char const* >( blocks );
+    const int bytesPerBlock = format == CF_DXT1 || format == CF_BC4 ? 8 : 16;
+    const int blocksPerRow = (width + 3) / 4;
+    const int blockRowsPerSlice = (height + 3) / 4;
+    const unsigned pitch = static_cast<unsigned>(width) * 4;
+
+    // Slices are stacked, so rows of all slices can be split between threads alike
+    ForEachBlockRow(blockRowsPerSlice * depth, pitch * 4, [&](int beginRow, int endRow)
     {
-        int sz = width * height * 4 * z;
-        for (int y = 0; y < height; y += 4)
+        for (int row = beginRow; row < endRow; ++row)
         {
+            const int z = row / blockRowsPerSlice;
+            const int y = (row % blockRowsPerSlice) * 4;
+            const int numRows = std::min(height - y, 4);
+            unsigned char* targetRow = rgba + (static_cast<size_t>(z) * height + y) * pitch;
+            unsigned char const* sourceBlock = sourceBlocks + static_cast<size_t>(row) * blocksPerRow * bytesPerBlock;
+
             for (int x = 0; x < width; x += 4)
             {
-                // decompress the block
                 unsigned char targetRgba[4 * 16];
                 DecompressDXT(targetRgba, sourceBlock, format);
-
-                // write the decompressed pixels to the correct image locations
-                unsigned char const* sourcePixel = targetRgba;
-                for (int py = 0; py < 4; ++py)
-                {
-                    for (int px = 0; px < 4; ++px)
-                    {
-                        // get the target location
-                        int sx = x + px;
-                        int sy = y + py;
-                        if (sx < width && sy < height)
-                        {
-                            unsigned char* targetPixel = rgba + sz + 4 * (width * sy + sx);
-
-                            // copy the rgba value
-                            for (int i = 0; i < 4; ++i)
-                                *targetPixel++ = *sourcePixel++;
-                        }
-                        else
-                        {
-                            // skip this pixel as its outside the image
-                            sourcePixel += 4;
-                        }
-                    }
-                }
-
-                // advance
+                StoreBlock(targetRow + 4 * x, pitch, targetRgba, std::min(width - x, 4), numRows);
                 sourceBlock += bytesPerBlock;
             }
         }
+    });
+}
+
+const int BC7_WEIGHTS2[4] = {0, 21, 43, 64};
+const int BC7_WEIGHTS3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+const int BC7_WEIGHTS4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/// Field sizes of a BC7 mode in bits.
+struct BC7ModeInfo
+{
+    int numSubsets_;
+    unsigned partitionBits_;
+    unsigned rotationBits_;
+    unsigned indexSelectionBits_;
+    unsigned colourBits_;
+    unsigned alphaBits_;
+    /// One P-bit per endpoint.
+    bool endpointPBits_;
+    /// One P-bit per subset, shared by its two endpoints.
+    bool sharedPBits_;
+    unsigned indexBits_;
+    unsigned secondaryIndexBits_;
+};
+
+static const BC7ModeInfo BC7_MODES[8] =
+{
+    {3, 4, 0, 0, 4, 0, true, false, 3, 0},
+    {2, 6, 0, 0, 6, 0, false, true, 3, 0},
+    {3, 6, 0, 0, 5, 0, false, false, 2, 0},
+    {2, 6, 0, 0, 7, 0, true, false, 2, 0},
+    {1, 0, 2, 1, 5, 6, false, false, 2, 3},
+    {1, 0, 2, 0, 7, 8, false, false, 2, 2},
+    {1, 0, 0, 0, 7, 7, true, false, 4, 0},
+    {2, 6, 0, 0, 5, 5, true, false, 2, 0}
+};
+
+const unsigned short BC7_PARTITIONS2[64] =
+{
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80, 0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+    0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce, 0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+    0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a, 0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+    0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c, 0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22
+};
+
+/// Three subset partitions, subset of each pixel.
+static const unsigned char BC7_PARTITIONS3[64][16] =
+{
+    {0,0,1,1,0,0,1,1,0,2,2,1,2,2,2,2}, {0,0,0,1,0,0,1,1,2,2,1,1,2,2,2,1}, {0,0,0,0,2,0,0,1,2,2,1,1,2,2,1,1}, {0,2,2,2,0,0,2,2,0,0,1,1,0,1,1,1},
+    {0,0,0,0,0,0,0,0,1,1,2,2,1,1,2,2}, {0,0,1,1,0,0,1,1,0,0,2,2,0,0,2,2}, {0,0,2,2,0,0,2,2,1,1,1,1,1,1,1,1}, {0,0,1,1,0,0,1,1,2,2,1,1,2,2,1,1},
+    {0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2}, {0,0,0,0,1,1,1,1,1,1,1,1,2,2,2,2}, {0,0,0,0,1,1,1,1,2,2,2,2,2,2,2,2}, {0,0,1,2,0,0,1,2,0,0,1,2,0,0,1,2},
+    {0,1,1,2,0,1,1,2,0,1,1,2,0,1,1,2}, {0,1,2,2,0,1,2,2,0,1,2,2,0,1,2,2}, {0,0,1,1,0,1,1,2,1,1,2,2,1,2,2,2}, {0,0,1,1,2,0,0,1,2,2,0,0,2,2,2,0},
+    {0,0,0,1,0,0,1,1,0,1,1,2,1,1,2,2}, {0,1,1,1,0,0,1,1,2,0,0,1,2,2,0,0}, {0,0,0,0,1,1,2,2,1,1,2,2,1,1,2,2}, {0,0,2,2,0,0,2,2,0,0,2,2,1,1,1,1},
+    {0,1,1,1,0,1,1,1,0,2,2,2,0,2,2,2}, {0,0,0,1,0,0,0,1,2,2,2,1,2,2,2,1}, {0,0,0,0,0,0,1,1,0,1,2,2,0,1,2,2}, {0,0,0,0,1,1,0,0,2,2,1,0,2,2,1,0},
+    {0,1,2,2,0,1,2,2,0,0,1,1,0,0,0,0}, {0,0,1,2,0,0,1,2,1,1,2,2,2,2,2,2}, {0,1,1,0,1,2,2,1,1,2,2,1,0,1,1,0}, {0,0,0,0,0,1,1,0,1,2,2,1,1,2,2,1},
+    {0,0,2,2,1,1,0,2,1,1,0,2,0,0,2,2}, {0,1,1,0,0,1,1,0,2,0,0,2,2,2,2,2}, {0,0,1,1,0,1,2,2,0,1,2,2,0,0,1,1}, {0,0,0,0,2,0,0,0,2,2,1,1,2,2,2,1},
+    {0,0,0,0,0,0,0,2,1,1,2,2,1,2,2,2}, {0,2,2,2,0,0,2,2,0,0,1,2,0,0,1,1}, {0,0,1,1,0,0,1,2,0,0,2,2,0,2,2,2}, {0,1,2,0,0,1,2,0,0,1,2,0,0,1,2,0},
+    {0,0,0,0,1,1,1,1,2,2,2,2,0,0,0,0}, {0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0}, {0,1,2,0,2,0,1,2,1,2,0,1,0,1,2,0}, {0,0,1,1,2,2,0,0,1,1,2,2,0,0,1,1},
+    {0,0,1,1,1,1,2,2,2,2,0,0,0,0,1,1}, {0,1,0,1,0,1,0,1,2,2,2,2,2,2,2,2}, {0,0,0,0,0,0,0,0,2,1,2,1,2,1,2,1}, {0,0,2,2,1,1,2,2,0,0,2,2,1,1,2,2},
+    {0,0,2,2,0,0,1,1,0,0,2,2,0,0,1,1}, {0,2,2,0,1,2,2,1,0,2,2,0,1,2,2,1}, {0,1,0,1,2,2,2,2,2,2,2,2,0,1,0,1}, {0,0,0,0,2,1,2,1,2,1,2,1,2,1,2,1},
+    {0,1,0,1,0,1,0,1,0,1,0,1,2,2,2,2}, {0,2,2,2,0,1,1,1,0,2,2,2,0,1,1,1}, {0,0,0,2,1,1,1,2,0,0,0,2,1,1,1,2}, {0,0,0,0,2,1,1,2,2,1,1,2,2,1,1,2},
+    {0,2,2,2,0,1,1,1,0,1,1,1,0,2,2,2}, {0,0,0,2,1,1,1,2,1,1,1,2,0,0,0,2}, {0,1,1,0,0,1,1,0,0,1,1,0,2,2,2,2}, {0,0,0,0,0,0,0,0,2,1,1,2,2,1,1,2},
+    {0,1,1,0,0,1,1,0,2,2,2,2,2,2,2,2}, {0,0,2,2,0,0,1,1,0,0,1,1,0,0,2,2}, {0,0,2,2,1,1,2,2,1,1,2,2,0,0,2,2}, {0,0,0,0,0,0,0,0,0,0,0,0,2,1,1,2},
+    {0,0,0,2,0,0,0,1,0,0,0,2,0,0,0,1}, {0,2,2,2,1,2,2,2,0,2,2,2,1,2,2,2}, {0,1,0,1,2,2,2,2,2,2,2,2,2,2,2,2}, {0,1,1,1,2,0,1,1,2,2,0,1,2,2,2,0}
+};
+
+const unsigned char BC7_ANCHORS2[64] =
+{
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+    15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6, 6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15
+};
+
+/// Anchor pixels of the second and third subsets of three subset partitions.
+static const unsigned char BC7_ANCHORS3[2][64] =
+{
+    {3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3, 3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+     8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15, 3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3},
+    {15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8, 15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+     15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8, 15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8}
+};
+
+/// Reads little-endian bit fields from a BC7 block.
+struct BC7BitReader
+{
+    const unsigned char* data_;
+    unsigned position_;
+
+    int Read(unsigned numBits)
+    {
+        int value = 0;
+        for (unsigned i = 0; i < numBits; ++i, ++position_)
+            value |= ((data_[position_ >> 3] >> (position_ & 7)) & 1) << i;
+        return value;
+    }
+};
+
+static void DecompressBlockBC7(unsigned char* rgba, const unsigned char* block)
+{
+    BC7BitReader bits{block, 0};
+
+    // The mode is the number of zero bits before the first set bit
+    int mode = 0;
+    while (mode < 8 && !bits.Read(1))
+        ++mode;
+
+    // Reserved mode decodes to transparent black
+    if (mode == 8)
+    {
+        memset(rgba, 0, 64);
+        return;
+    }
+
+    const BC7ModeInfo& info = BC7_MODES[mode];
+    const int partition = bits.Read(info.partitionBits_);
+    const int rotation = bits.Read(info.rotationBits_);
+    const int indexSelection = bits.Read(info.indexSelectionBits_);
+    const int numEndpoints = 2 * info.numSubsets_;
+
+    // Endpoints are stored channel by channel, two per subset
+    int endpoints[6][4];
+    for (int c = 0; c < 4; ++c)
+    {
+        const unsigned numBits = c < 3 ? info.colourBits_ : info.alphaBits_;
+        for (int e = 0; e < numEndpoints; ++e)
+            endpoints[e][c] = numBits ? bits.Read(numBits) : 255;
+    }
+
+    // P-bits extend the stored channels by one bit
+    unsigned colourBits = info.colourBits_;
+    unsigned alphaBits = info.alphaBits_;
+    if (info.endpointPBits_ || info.sharedPBits_)
+    {
+        int pBits[6];
+        for (int e = 0; e < numEndpoints; ++e)
+            pBits[e] = info.sharedPBits_ && (e & 1) ? pBits[e - 1] : bits.Read(1);
+        for (int e = 0; e < numEndpoints; ++e)
+        {
+            for (int c = 0; c < (alphaBits ? 4 : 3); ++c)
+                endpoints[e][c] = (endpoints[e][c] << 1) | pBits[e];
+        }
+        ++colourBits;
+        if (alphaBits)
+            ++alphaBits;
+    }
+
+    // Expand to 8 bits by replicating the high bits
+    for (int e = 0; e < numEndpoints; ++e)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            const unsigned numBits = c < 3 ? colourBits : alphaBits;
+            if (numBits && numBits < 8)
+                endpoints[e][c] = (endpoints[e][c] << (8 - numBits)) | (endpoints[e][c] >> (2 * numBits - 8));
+        }
+    }
+
+    int subsets[16];
+    for (int i = 0; i < 16; ++i)
+    {
+        if (info.numSubsets_ == 1)
+            subsets[i] = 0;
+        else if (info.numSubsets_ == 2)
+            subsets[i] = (BC7_PARTITIONS2[partition] >> i) & 1;
+        else
+            subsets[i] = BC7_PARTITIONS3[partition][i];
+    }
+
+    // The anchor pixel of each subset has an implicit zero high index bit
+    auto isAnchor = [&](int i)
+    {
+        if (i == 0)
+            return true;
+        if (info.numSubsets_ == 2)
+            return i == BC7_ANCHORS2[partition];
+        if (info.numSubsets_ == 3)
+            return i == BC7_ANCHORS3[0][partition] || i == BC7_ANCHORS3[1][partition];
+        return false;
+    };
+
+    int colourIndices[16];
+    int alphaIndices[16];
+    const int* colourWeights;
+    const int* alphaWeights;
+    if (!info.secondaryIndexBits_)
+    {
+        for (int i = 0; i < 16; ++i)
+            colourIndices[i] = bits.Read(info.indexBits_ - isAnchor(i));
+        memcpy(alphaIndices, colourIndices, sizeof alphaIndices);
+        colourWeights = alphaWeights = info.indexBits_ == 2 ? BC7_WEIGHTS2 : (info.indexBits_ == 3 ? BC7_WEIGHTS3 : BC7_WEIGHTS4);
+    }
+    else
+    {
+        // Mode 4 and 5 have separate colour and alpha indices. The index selection bit of mode 4 swaps which of the
+        // 2-bit and 3-bit index sets is used for colour
+        int* primaryIndices = indexSelection ? alphaIndices : colourIndices;
+        int* secondaryIndices = indexSelection ? colourIndices : alphaIndices;
+        for (int i = 0; i < 16; ++i)
+            primaryIndices[i] = bits.Read(info.indexBits_ - (i == 0));
+        for (int i = 0; i < 16; ++i)
+            secondaryIndices[i] = bits.Read(info.secondaryIndexBits_ - (i == 0));
+        const int* secondaryWeights = info.secondaryIndexBits_ == 3 ? BC7_WEIGHTS3 : BC7_WEIGHTS2;
+        colourWeights = indexSelection ? secondaryWeights : BC7_WEIGHTS2;
+        alphaWeights = indexSelection ? BC7_WEIGHTS2 : secondaryWeights;
+    }
+
+    for (int i = 0; i < 16; ++i)
+    {
+        unsigned char* pixel = rgba + 4 * i;
+        const int* endpoint0 = endpoints[2 * subsets[i]];
+        const int* endpoint1 = endpoints[2 * subsets[i] + 1];
+        const int colourWeight = colourWeights[colourIndices[i]];
+        const int alphaWeight = alphaWeights[alphaIndices[i]];
+        for (int c = 0; c < 3; ++c)
+            pixel[c] = (unsigned char)(((64 - colourWeight) * endpoint0[c] + colourWeight * endpoint1[c] + 32) >> 6);
+        pixel[3] = (unsigned char)(((64 - alphaWeight) * endpoint0[3] + alphaWeight * endpoint1[3] + 32) >> 6);
+
+        // Rotation swaps alpha with one of the colour channels
+        if (rotation)
+            std::swap(pixel[3], pixel[rotation - 1]);
     }
 }
 
+void DecompressImageBC7(unsigned char* rgba, const void* blocks, int width, int height, int depth)
+{
+    auto const* sourceBlocks = reinterpret_cast< unsigned char const* >( blocks );
+    const int blocksPerRow = (width + 3) / 4;
+    const int blockRowsPerSlice = (height + 3) / 4;
+    const unsigned pitch = static_cast<unsigned>(width) * 4;
+
+    ForEachBlockRow(blockRowsPerSlice * depth, pitch * 4, [&](int beginRow, int endRow)
+    {
+        for (int row = beginRow; row < endRow; ++row)
+        {
+            const int z = row / blockRowsPerSlice;
+            const int y = (row % blockRowsPerSlice) * 4;
+            const int numRows = std::min(height - y, 4);
+            unsigned char* targetRow = rgba + (static_cast<size_t>(z) * height + y) * pitch;
+            unsigned char const* sourceBlock = sourceBlocks + static_cast<size_t>(row) * blocksPerRow * 16;
+
+            for (int x = 0; x < width; x += 4)
+            {
+                unsigned char targetRgba[4 * 16];
+                DecompressBlockBC7(targetRgba, sourceBlock);
+                StoreBlock(targetRow + 4 * x, pitch, targetRgba, std::min(width - x, 4), numRows);
+                sourceBlock += 16;
+            }
+        }
+    });
+}
+
 // PVRTC decompression based on the Oolong Engine, modified for GFrost
 
 #define PT_INDEX    (2) /*The Punch-through index*/
@@ -607,7 +838,9 @@ static unsigned TwiddleUV(unsigned YSize, unsigned XSize, unsigned YPos, unsigne
     return Twiddled;
 }
 
-void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, int height, CompressedFormat format)
+/// Decompress pixel rows [beginRow, endRow) of a PVRTC image. Each pixel only depends on the compressed data, so row ranges can be decoded independently.
+static void DecompressRowsPVRTC(unsigned char* rgba, const void* blocks, int width, int height, CompressedFormat format,
+    int beginRow, int endRow)
 {
     auto* pCompressedData = (AMTC_BLOCK_STRUCT*)blocks;
     int AssumeImageTiles = 1;
@@ -662,7 +895,7 @@ void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, in
     // Step through the pixels of the image decompressing each one in turn
     //
     // Note that this is a hideously inefficient way to do this!
-    for (y = 0; y < height; y++)
+    for (y = beginRow; y < endRow; y++)
     {
         for (x = 0; x < width; x++)
         {
@@ -753,6 +986,14 @@ void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, in
     }
 }
 
+void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, int width, int height, CompressedFormat format)
+{
+    ForEachBlockRow((height + BLK_Y_SIZE - 1) / BLK_Y_SIZE, static_cast<unsigned>(width) * 4 * BLK_Y_SIZE, [&](int beginRow, int endRow)
+    {
+        DecompressRowsPVRTC(rgba, blocks, width, height, format, beginRow * BLK_Y_SIZE, std::min(endRow * BLK_Y_SIZE, height));
+    });
+}
+
 void FlipBlockVertical(unsigned char* dest, const unsigned char* src, CompressedFormat format)
 {
     switch (format)
@@ -881,32 +1122,167 @@ static void ReadBigEndian4byteWord(uint32_t* pBlock, const unsigned char *s)
     *pBlock = (s[0] << 24) | (s[1] << 16) | (s[2] << 8) | s[3];
 }
 
-// Use ETCPACK to decompress ETC texture.
-void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha)
+/// ETC1 intensity modifiers per table codeword, in pixel index order.
+static const int ETC1_MODIFIERS[8][4] =
 {
-    const int channelCount = hasAlpha ? 4 : 3;
-    unsigned char* src = (unsigned char*)blocks;
-    unsigned int blockPart1, blockPart2;
+    {2, 8, -2, -8},
+    {5, 17, -5, -17},
+    {9, 29, -9, -29},
+    {13, 42, -13, -42},
+    {18, 60, -18, -60},
+    {24, 80, -24, -80},
+    {33, 106, -33, -106},
+    {47, 183, -47, -183}
+};
 
-    memset(dstImage, 0xFF, width * height * 4);
+/// EAC alpha modifiers per table index, in pixel index order.
+static const int EAC_MODIFIERS[16][8] =
+{
+    {-3, -6, -9, -15, 2, 5, 8, 14},
+    {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},
+    {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},
+    {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},
+    {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},
+    {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},
+    {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},
+    {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},
+    {-3, -5, -7, -9, 2, 4, 6, 8}
+};
+
+static unsigned char ClampByte(int value)
+{
+    return (unsigned char)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
 
-    for (int y = 0; y < height / 4; ++y) 
+/// Decompress an ETC1 compatible individual or differential mode block to opaque RGBA. Return false if the block uses
+/// one of the T, H or planar modes added by ETC2.
+static bool DecompressBlockETC1(unsigned char* rgba, unsigned blockPart1, unsigned blockPart2)
+{
+    int base[2][3];
+    if (blockPart1 & 0x2)
     {
-        for (int x = 0; x < width / 4; ++x) 
+        for (int i = 0; i < 3; ++i)
         {
-            if (hasAlpha)
-            {
-                decompressBlockAlphaC(src, dstImage + 3, width, height, 4 * x, 4 * y, channelCount);
-                src += 8;
-            }
+            const int shift = 27 - 8 * i;
+            const int colour = (blockPart1 >> shift) & 0x1f;
+            int delta = (blockPart1 >> (shift - 3)) & 0x7;
+            // Sign-extend the 3-bit delta
+            if (delta & 0x4)
+                delta -= 8;
+            const int colour2 = colour + delta;
+            if (colour2 < 0 || colour2 > 31)
+                return false;
+            base[0][i] = (colour << 3) | (colour >> 2);
+            base[1][i] = (colour2 << 3) | (colour2 >> 2);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            const int shift = 28 - 8 * i;
+            base[0][i] = ((blockPart1 >> shift) & 0xf) * 17;
+            base[1][i] = ((blockPart1 >> (shift - 4)) & 0xf) * 17;
+        }
+    }
 
-            ReadBigEndian4byteWord(&blockPart1, src);
-            src += 4;
-            ReadBigEndian4byteWord(&blockPart2, src);
-            src += 4;
-            decompressBlockETC2c(blockPart1, blockPart2, dstImage, width, height, 4 * x, 4 * y, 4);
+    // Each subblock has a palette of 4 colours
+    unsigned palette[2][4];
+    for (int sub = 0; sub < 2; ++sub)
+    {
+        const int* modifiers = ETC1_MODIFIERS[(blockPart1 >> (5 - 3 * sub)) & 0x7];
+        for (int i = 0; i < 4; ++i)
+        {
+            const unsigned char colour[4] = {ClampByte(base[sub][0] + modifiers[i]), ClampByte(base[sub][1] + modifiers[i]),
+                ClampByte(base[sub][2] + modifiers[i]), 255};
+            memcpy(&palette[sub][i], colour, sizeof colour);
         }
     }
+
+    // Pixel indices are stored column by column; the flip bit selects horizontal instead of vertical subblocks
+    const bool flip = (blockPart1 & 0x1) != 0;
+    unsigned pixels[16];
+    for (int x = 0; x < 4; ++x)
+    {
+        for (int y = 0; y < 4; ++y)
+        {
+            const int bit = x * 4 + y;
+            const unsigned index = (((blockPart2 >> (bit + 16)) & 1) << 1) | ((blockPart2 >> bit) & 1);
+            pixels[y * 4 + x] = palette[flip ? y >> 1 : x >> 1][index];
+        }
+    }
+    memcpy(rgba, pixels, sizeof pixels);
+    return true;
+}
+
+/// Decompress an EAC alpha block into the alpha channel of RGBA pixels.
+static void DecompressAlphaEAC(unsigned char* rgba, const unsigned char* block)
+{
+    const int base = block[0];
+    const int multiplier = block[1] >> 4;
+    const int* modifiers = EAC_MODIFIERS[block[1] & 0xf];
+
+    unsigned char codes[8];
+    for (int i = 0; i < 8; ++i)
+        codes[i] = ClampByte(base + modifiers[i] * multiplier);
+
+    // 16 3-bit indices in big-endian order, stored column by column
+    unsigned long long indices = 0;
+    for (int i = 0; i < 6; ++i)
+        indices = (indices << 8) | block[2 + i];
+
+    for (int x = 0; x < 4; ++x)
+    {
+        for (int y = 0; y < 4; ++y)
+            rgba[4 * (y * 4 + x) + 3] = codes[(indices >> (45 - 3 * (x * 4 + y))) & 0x7];
+    }
+}
+
+// Decode ETC1 compatible blocks natively and use ETCPACK for the ETC2 specific modes.
+void DecompressImageETC(unsigned char* dstImage, const void* blocks, int width, int height, bool hasAlpha)
+{
+    auto const* sourceBlocks = reinterpret_cast< unsigned char const* >( blocks );
+    const int bytesPerBlock = hasAlpha ? 16 : 8;
+    const int blocksPerRow = (width + 3) / 4;
+    const unsigned pitch = static_cast<unsigned>(width) * 4;
+
+    ForEachBlockRow((height + 3) / 4, pitch * 4, [&](int beginRow, int endRow)
+    {
+        for (int row = beginRow; row < endRow; ++row)
+        {
+            const int y = row * 4;
+            const int numRows = std::min(height - y, 4);
+            unsigned char* targetRow = dstImage + static_cast<size_t>(y) * pitch;
+            unsigned char const* sourceBlock = sourceBlocks + static_cast<size_t>(row) * blocksPerRow * bytesPerBlock;
+
+            for (int x = 0; x < width; x += 4)
+            {
+                unsigned char const* colourBlock = hasAlpha ? sourceBlock + 8 : sourceBlock;
+                unsigned int blockPart1, blockPart2;
+                ReadBigEndian4byteWord(&blockPart1, colourBlock);
+                ReadBigEndian4byteWord(&blockPart2, colourBlock + 4);
+
+                unsigned char targetRgba[4 * 16];
+                if (!DecompressBlockETC1(targetRgba, blockPart1, blockPart2))
+                {
+                    memset(targetRgba, 0xFF, sizeof targetRgba);
+                    decompressBlockETC2c(blockPart1, blockPart2, targetRgba, 4, 4, 0, 0, 4);
+                }
+                if (hasAlpha)
+                    DecompressAlphaEAC(targetRgba, sourceBlock);
+
+                StoreBlock(targetRow + 4 * x, pitch, targetRgba, std::min(width - x, 4), numRows);
+                sourceBlock += bytesPerBlock;
+            }
+        }
+    });
 }
 
 }
@@ -1,18 +1,60 @@
 #pragma once
 
 #include <SeResource/Image.h>
+#include <Se/Thread.h>
+#include <Se/WorkQueue.h>
+
+#include <algorithm>
 
 namespace Se
 {
 
-/// Decompress a DXT compressed image to RGBA.
-void DecompressImageDXT(unsigned char* rgba, const void* blocks, 
+/// Minimum uncompressed image size in bytes for splitting block rows between worker threads.
+static const unsigned MIN_PARALLEL_BLOCK_BYTES = 256 * 1024;
+/// Target uncompressed size of a band of block rows in bytes.
+static const unsigned BLOCK_BAND_BYTES = 64 * 1024;
+
+/// Run callback(beginRow, endRow) over rows of blocks in bands, in parallel if worthwhile. Bands must write disjoint
+/// destination rows. rowBytes is the uncompressed size of one row of blocks.
+template <class Callback> void ForEachBlockRow(int numRows, unsigned rowBytes, Callback callback)
+{
+    const int band = static_cast<int>(std::max(BLOCK_BAND_BYTES / std::max(rowBytes, 1u), 1u));
+
+    WorkQueue* workQueue = WorkQueue::Get();
+    // Worker threads may only be waited on from the main thread
+    if (Thread::IsMainThread() && workQueue->GetNumThreads() && numRows * rowBytes >= MIN_PARALLEL_BLOCK_BYTES)
+    {
+        ForEachParallel(workQueue, band, static_cast<unsigned>(numRows), [&](unsigned beginRow, unsigned endRow)
+        {
+            callback(static_cast<int>(beginRow), static_cast<int>(endRow));
+        });
+    }
+    else
+    {
+        for (int beginRow = 0; beginRow < numRows; beginRow += band)
+            callback(beginRow, std::min(beginRow + band, numRows));
+    }
+}
+
+/// Interpolation weights of BC7 2-, 3- and 4-bit indices.
+extern const int BC7_WEIGHTS2[4];
+extern const int BC7_WEIGHTS3[8];
+extern const int BC7_WEIGHTS4[16];
+/// BC7 two subset partitions, one bit per pixel selects the second subset.
+extern const unsigned short BC7_PARTITIONS2[64];
+/// Anchor pixel of the second subset of BC7 two subset partitions.
+extern const unsigned char BC7_ANCHORS2[64];
+
+/// Decompress a DXT, BC4 or BC5 compressed image to RGBA. BC4 and BC5 decode to red and red-green like on the GPU.
+void DecompressImageDXT(unsigned char* rgba, const void* blocks,
         int width, int height, int depth, CompressedFormat format);
+/// Decompress a BC7 compressed image to RGBA.
+void DecompressImageBC7(unsigned char* rgba, const void* blocks, int width, int height, int depth);
 /// Decompress an ETC1/ETC2 compressed image to RGBA.
-void DecompressImageETC(unsigned char* dstImage, const void* blocks, 
+void DecompressImageETC(unsigned char* dstImage, const void* blocks,
         int width, int height, bool hasAlpha);
 /// Decompress a PVRTC compressed image to RGBA.
-void DecompressImagePVRTC(unsigned char* rgba, const void* blocks, 
+void DecompressImagePVRTC(unsigned char* rgba, const void* blocks,
         int width, int height, CompressedFormat format);
 /// Flip a compressed block vertically.
 void FlipBlockVertical(unsigned char* dest, const unsigned char* src, CompressedFormat format);
@@ -1,9 +1,17 @@
 //#include <Se/Profiler.h>
 #include <Se/IO/File.h>
 #include <Se/IO/FileSystem.h>
+#include <Se/IO/MappedFile.h>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <Se/IO/VectorBuffer.h>
 #include <Se/Console.hpp>
 #include <Se/Profiler.hpp>
+#include <Se/Thread.h>
+#include <Se/WorkQueue.h>
+#include "Compress.h"
 #include "Decompress.h"
+#include "ImageConvert.h"
+#include "ImageMip.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_RESIZE_IMPLEMENTATION
@@ -19,6 +27,7 @@
 #include <webp/mux.h>
 #endif
 
+#include <atomic>
 #include <memory>
 
 
@@ -32,6 +41,12 @@
 #define FOURCC_DXT4 (MAKEFOURCC('D','X','T','4'))
 #define FOURCC_DXT5 (MAKEFOURCC('D','X','T','5'))
 #define FOURCC_DX10 (MAKEFOURCC('D','X','1','0'))
+#define FOURCC_ATI1 (MAKEFOURCC('A','T','I','1'))
+#define FOURCC_BC4U (MAKEFOURCC('B','C','4','U'))
+#define FOURCC_ATI2 (MAKEFOURCC('A','T','I','2'))
+#define FOURCC_BC5U (MAKEFOURCC('B','C','5','U'))
+// BC7 has no legacy FourCC, this one only maps the DXGI format internally
+#define FOURCC_BC7 (MAKEFOURCC('B','C','7',' '))
 
 #define FOURCC_ETC1 (MAKEFOURCC('E','T','C','1'))
 #define FOURCC_ETC2 (MAKEFOURCC('E','T','C','2'))
@@ -66,6 +81,10 @@ static const unsigned DDS_DXGI_FORMAT_BC2_UNORM = 74;
 static const unsigned DDS_DXGI_FORMAT_BC2_UNORM_SRGB = 75;
 static const unsigned DDS_DXGI_FORMAT_BC3_UNORM = 77;
 static const unsigned DDS_DXGI_FORMAT_BC3_UNORM_SRGB = 78;
+static const unsigned DDS_DXGI_FORMAT_BC4_UNORM = 80;
+static const unsigned DDS_DXGI_FORMAT_BC5_UNORM = 83;
+static const unsigned DDS_DXGI_FORMAT_BC7_UNORM = 98;
+static const unsigned DDS_DXGI_FORMAT_BC7_UNORM_SRGB = 99;
 
 namespace Se
 {
@@ -206,9 +225,15 @@ bool CompressedLevel::Decompress(unsigned char* dest) const
     case CF_DXT1:
     case CF_DXT3:
     case CF_DXT5:
+    case CF_BC4:
+    case CF_BC5:
         DecompressImageDXT(dest, data_, width_, height_, depth_, format_);
         return true;
-	
+
+    case CF_BC7:
+        DecompressImageBC7(dest, data_, width_, height_, depth_);
+        return true;
+
     // ETC2 format is compatible with ETC1, so we just use the same function.
     case CF_ETC1:
     case CF_ETC2_RGB:
@@ -231,6 +256,240 @@ bool CompressedLevel::Decompress(unsigned char* dest) const
     }
 }
 
+/// Map a DDS header to compressed format and components. Return false if the format is not supported.
+static bool GetDDSFormat(const DDSurfaceDesc2& ddsd, const DDSHeader10* dxgiHeader, CompressedFormat& format,
+    unsigned& components, bool& sRGB)
+{
+    unsigned fourCC = ddsd.ddpfPixelFormat_.dwFourCC_;
+
+    // If the DXGI header is available then remap formats and check sRGB
+    if (dxgiHeader)
+    {
+        switch (dxgiHeader->dxgiFormat)
+        {
+        case DDS_DXGI_FORMAT_BC1_UNORM:
+        case DDS_DXGI_FORMAT_BC1_UNORM_SRGB:
+            fourCC = FOURCC_DXT1;
+            break;
+        case DDS_DXGI_FORMAT_BC2_UNORM:
+        case DDS_DXGI_FORMAT_BC2_UNORM_SRGB:
+            fourCC = FOURCC_DXT3;
+            break;
+        case DDS_DXGI_FORMAT_BC3_UNORM:
+        case DDS_DXGI_FORMAT_BC3_UNORM_SRGB:
+            fourCC = FOURCC_DXT5;
+            break;
+        case DDS_DXGI_FORMAT_BC4_UNORM:
+            fourCC = FOURCC_BC4U;
+            break;
+        case DDS_DXGI_FORMAT_BC5_UNORM:
+            fourCC = FOURCC_BC5U;
+            break;
+        case DDS_DXGI_FORMAT_BC7_UNORM:
+        case DDS_DXGI_FORMAT_BC7_UNORM_SRGB:
+            fourCC = FOURCC_BC7;
+            break;
+        case DDS_DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DDS_DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+            fourCC = 0;
+            break;
+        default:
+            SE_LOG_ERROR("Unrecognized DDS DXGI image format");
+            return false;
+        }
+
+        // Check the internal sRGB formats
+        if (dxgiHeader->dxgiFormat == DDS_DXGI_FORMAT_BC1_UNORM_SRGB ||
+            dxgiHeader->dxgiFormat == DDS_DXGI_FORMAT_BC2_UNORM_SRGB ||
+            dxgiHeader->dxgiFormat == DDS_DXGI_FORMAT_BC3_UNORM_SRGB ||
+            dxgiHeader->dxgiFormat == DDS_DXGI_FORMAT_BC7_UNORM_SRGB ||
+            dxgiHeader->dxgiFormat == DDS_DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
+        {
+            sRGB = true;
+        }
+    }
+    switch (fourCC)
+    {
+    case FOURCC_DXT1:
+        format = CF_DXT1;
+        components = 3;
+        break;
+
+    case FOURCC_DXT3:
+        format = CF_DXT3;
+        components = 4;
+        break;
+
+    case FOURCC_DXT5:
+        format = CF_DXT5;
+        components = 4;
+        break;
+
+    case FOURCC_ATI1:
+    case FOURCC_BC4U:
+        format = CF_BC4;
+        components = 1;
+        break;
+
+    case FOURCC_ATI2:
+    case FOURCC_BC5U:
+        format = CF_BC5;
+        components = 2;
+        break;
+
+    case FOURCC_BC7:
+        format = CF_BC7;
+        components = 4;
+        break;
+
+    case 0:
+        if (ddsd.ddpfPixelFormat_.dwRGBBitCount_ != 32 && ddsd.ddpfPixelFormat_.dwRGBBitCount_ != 24 &&
+            ddsd.ddpfPixelFormat_.dwRGBBitCount_ != 16)
+        {
+            SE_LOG_ERROR("Unsupported DDS pixel byte size");
+            return false;
+        }
+        format = CF_RGBA;
+        components = 4;
+        break;
+
+    default:
+        SE_LOG_ERROR("Unrecognized DDS image format");
+        return false;
+    }
+
+    return true;
+}
+
+/// Map a KTX internal format to compressed format and components. Return CF_NONE if not supported.
+static CompressedFormat GetKTXFormat(unsigned internalFormat, unsigned& components)
+{
+    CompressedFormat format;
+    switch (internalFormat)
+    {
+    case 0x83f1:
+        format = CF_DXT1;
+        components = 4;
+        break;
+
+    case 0x83f2:
+        format = CF_DXT3;
+        components = 4;
+        break;
+
+    case 0x83f3:
+        format = CF_DXT5;
+        components = 4;
+        break;
+
+    case 0x8d64:
+        format = CF_ETC1;
+        components = 3;
+        break;
+
+    case 0x9274:
+        format = CF_ETC2_RGB;
+        components = 3;
+        break;
+
+    case 0x9278:
+        format = CF_ETC2_RGBA;
+        components = 4;
+        break;
+
+    case 0x8c00:
+        format = CF_PVRTC_RGB_4BPP;
+        components = 3;
+        break;
+
+    case 0x8c01:
+        format = CF_PVRTC_RGB_2BPP;
+        components = 3;
+        break;
+
+    case 0x8c02:
+        format = CF_PVRTC_RGBA_4BPP;
+        components = 4;
+        break;
+
+    case 0x8c03:
+        format = CF_PVRTC_RGBA_2BPP;
+        components = 4;
+        break;
+
+    default:
+        format = CF_NONE;
+        break;
+    }
+
+    return format;
+}
+
+/// Map a PVR pixel format to compressed format and components. Return CF_NONE if not supported.
+static CompressedFormat GetPVRFormat(unsigned pixelFormat, unsigned& components)
+{
+    CompressedFormat format;
+    switch (pixelFormat)
+    {
+    case 0:
+        format = CF_PVRTC_RGB_2BPP;
+        components = 3;
+        break;
+
+    case 1:
+        format = CF_PVRTC_RGBA_2BPP;
+        components = 4;
+        break;
+
+    case 2:
+        format = CF_PVRTC_RGB_4BPP;
+        components = 3;
+        break;
+
+    case 3:
+        format = CF_PVRTC_RGBA_4BPP;
+        components = 4;
+        break;
+
+    case 6:
+        format = CF_ETC1;
+        components = 3;
+        break;
+
+    case 7:
+        format = CF_DXT1;
+        components = 4;
+        break;
+
+    case 9:
+        format = CF_DXT3;
+        components = 4;
+        break;
+
+    case 11:
+        format = CF_DXT5;
+        components = 4;
+        break;
+
+    // .pvr files also support ETC2 texture format.
+    case 22:
+        format = CF_ETC2_RGB;
+        components = 3;
+        break;
+
+    case 23:
+        format = CF_ETC2_RGBA;
+        components = 4;
+        break;
+
+    default:
+        format = CF_NONE;
+        break;
+    }
+
+    return format;
+}
+
 Image::Image() 
     : Resource("Image")
 {
@@ -243,10 +502,258 @@ Image::~Image()
 }
 
 
+/// Return the bytes of a source that already holds its whole contents in memory, or null if it has to be read.
+static const unsigned char* GetMappedData(Deserializer& source)
+{
+    if (auto* memoryBuffer = dynamic_cast<MemoryBuffer*>(&source))
+        return memoryBuffer->GetData();
+    if (auto* vectorBuffer = dynamic_cast<VectorBuffer*>(&source))
+        return vectorBuffer->GetData();
+    return nullptr;
+}
+
+/// Memory-map a source that is a plain file on disk and return its whole contents, or null if it has to be streamed.
+/// Packaged, possibly compressed files and files that can not be mapped are streamed.
+static const unsigned char* MapFileSource(Deserializer& source, MappedFile& mappedFile)
+{
+    auto* file = dynamic_cast<File*>(&source);
+    if (!file || file->IsPackaged() || file->GetMode() != FILE_READ || file->GetAbsoluteName().empty())
+        return nullptr;
+
+    if (!mappedFile.OpenMapped(file->GetAbsoluteName()) || mappedFile.GetSize() != file->GetSize())
+    {
+        mappedFile.Close();
+        return nullptr;
+    }
+    return mappedFile.GetData();
+}
+
+/// stb_image read callback, pulling from a Deserializer.
+static int ReadImageSource(void* user, char* data, int size)
+{
+    return static_cast<int>(static_cast<Deserializer*>(user)->Read(data, static_cast<std::size_t>(size)));
+}
+
+/// stb_image skip callback. The offset may be negative.
+static void SkipImageSource(void* user, int offset)
+{
+    auto* source = static_cast<Deserializer*>(user);
+    source->Seek(static_cast<std::size_t>(static_cast<long long>(source->GetPosition()) + offset));
+}
+
+/// stb_image end of stream callback.
+static int IsImageSourceEof(void* user)
+{
+    return static_cast<Deserializer*>(user)->IsEof() ? 1 : 0;
+}
+
 bool Image::BeginLoad(Deserializer& source)
+{
+    encodedData_.clear();
+    decodePending_ = false;
+    if (!lazyDecode_)
+        return LoadPixels(source);
+
+    // Keep the file encoded and only take the properties from its header
+    const std::size_t position = source.GetPosition();
+    ImageInfo info;
+    if (!ReadInfo(source, info))
+    {
+        SE_LOG_ERROR("Could not read image header " + source.GetName());
+        return false;
+    }
+    source.Seek(position);
+
+    std::vector<unsigned char> encodedData(source.GetSize() - position);
+    if (source.Read(encodedData.data(), encodedData.size()) != encodedData.size())
+    {
+        SE_LOG_ERROR("Could not read image " + source.GetName());
+        return false;
+    }
+
+    data_.reset();
+    nextLevel_.reset();
+    nextSibling_.reset();
+    width_ = info.width_;
+    height_ = info.height_;
+    depth_ = info.depth_;
+    components_ = info.components_;
+    channelFormat_ = info.channelFormat_;
+    compressedFormat_ = info.compressedFormat_;
+    numCompressedLevels_ = info.compressedFormat_ != CF_NONE ? info.numLevels_ : 0;
+    cubemap_ = info.cubemap_;
+    array_ = info.array_;
+    if (info.sRGB_)
+        sRGB_ = true;
+
+    encodedData_.swap(encodedData);
+    decodePending_ = true;
+    SetMemoryUse(encodedData_.size());
+    return true;
+}
+
+bool Image::ReadInfo(Deserializer& source, ImageInfo& info)
+{
+    const std::size_t position = source.GetPosition();
+    info = ImageInfo();
+
+    const String fileID = source.ReadFileID();
+    if (fileID == "DDS ")
+    {
+        DDSurfaceDesc2 ddsd;        // NOLINT(hicpp-member-init)
+        if (source.Read(&ddsd, sizeof(ddsd)) != sizeof(ddsd))
+            return false;
+
+        const bool hasDXGI = ddsd.ddpfPixelFormat_.dwFourCC_ == FOURCC_DX10;
+        DDSHeader10 dxgiHeader;     // NOLINT(hicpp-member-init)
+        if (hasDXGI && source.Read(&dxgiHeader, sizeof(dxgiHeader)) != sizeof(dxgiHeader))
+            return false;
+
+        if (!GetDDSFormat(ddsd, hasDXGI ? &dxgiHeader : nullptr, info.compressedFormat_, info.components_, info.sRGB_))
+            return false;
+
+        info.width_ = ddsd.dwWidth_;
+        info.height_ = ddsd.dwHeight_;
+        info.depth_ = ddsd.dwDepth_;
+        info.numLevels_ = Max(ddsd.dwMipMapCount_, 1U);
+        info.cubemap_ = (ddsd.ddsCaps_.dwCaps2_ & DDSCAPS2_CUBEMAP_ALL_FACES) != 0 || (hasDXGI && (dxgiHeader.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE) != 0);
+        info.array_ = !info.cubemap_ && hasDXGI && dxgiHeader.arraySize > 1;
+        return true;
+    }
+    else if (fileID == "\253KTX")
+    {
+        source.Seek(position + 12);
+        const unsigned endianness = source.ReadUInt();
+        /* unsigned type = */ source.ReadUInt();
+        /* unsigned typeSize = */ source.ReadUInt();
+        /* unsigned format = */ source.ReadUInt();
+        const unsigned internalFormat = source.ReadUInt();
+        /* unsigned baseInternalFormat = */ source.ReadUInt();
+        info.width_ = source.ReadUInt();
+        info.height_ = source.ReadUInt();
+        /* unsigned depth = */ source.ReadUInt();
+        /* unsigned arrayElements = */ source.ReadUInt();
+        /* unsigned faces = */ source.ReadUInt();
+        info.numLevels_ = source.ReadUInt();
+
+        info.compressedFormat_ = GetKTXFormat(internalFormat, info.components_);
+        return endianness == 0x04030201 && info.compressedFormat_ != CF_NONE;
+    }
+    else if (fileID == "PVR\3")
+    {
+        /* unsigned flags = */ source.ReadUInt();
+        const unsigned pixelFormatLo = source.ReadUInt();
+        /* unsigned pixelFormatHi = */ source.ReadUInt();
+        /* unsigned colourSpace = */ source.ReadUInt();
+        /* unsigned channelType = */ source.ReadUInt();
+        info.height_ = source.ReadUInt();
+        info.width_ = source.ReadUInt();
+        /* unsigned depth = */ source.ReadUInt();
+        /* unsigned numSurfaces = */ source.ReadUInt();
+        /* unsigned numFaces = */ source.ReadUInt();
+        info.numLevels_ = source.ReadUInt();
+
+        info.compressedFormat_ = GetPVRFormat(pixelFormatLo, info.components_);
+        return info.compressedFormat_ != CF_NONE;
+    }
+#ifdef SE_WEBP
+    else if (fileID == "RIFF")
+    {
+        // The features of a WebP file are in its first chunks
+        unsigned char header[64];
+        source.Seek(position);
+        const unsigned headerSize = source.Read(header, sizeof header);
+        WebPBitstreamFeatures features;
+        if (WebPGetFeatures(header, headerSize, &features) != VP8_STATUS_OK)
+            return false;
+
+        info.width_ = features.width;
+        info.height_ = features.height;
+        info.components_ = features.has_alpha ? 4 : 3;
+        return true;
+    }
+#endif
+
+    // Other formats go through stb_image, which only parses the header here
+    source.Seek(position);
+    int width = 0, height = 0, channels = 0;
+    bool isHDR = false;
+    bool success = false;
+    if (const unsigned char* mapped = GetMappedData(source))
+    {
+        const auto* fileData = reinterpret_cast<const stbi_uc*>(mapped + position);
+        const int dataSize = static_cast<int>(source.GetSize() - position);
+        isHDR = stbi_is_hdr_from_memory(fileData, dataSize) != 0;
+        success = stbi_info_from_memory(fileData, dataSize, &width, &height, &channels) != 0;
+    }
+    else
+    {
+        const stbi_io_callbacks callbacks{ReadImageSource, SkipImageSource, IsImageSourceEof};
+        isHDR = stbi_is_hdr_from_callbacks(&callbacks, &source) != 0;
+        source.Seek(position);
+        success = stbi_info_from_callbacks(&callbacks, &source, &width, &height, &channels) != 0;
+    }
+    if (!success)
+        return false;
+
+    info.width_ = width;
+    info.height_ = height;
+    // HDR files are loaded as RGBA half floats
+    info.components_ = isHDR ? 4 : static_cast<unsigned>(channels);
+    info.channelFormat_ = isHDR ? ChannelFormat::Float16 : ChannelFormat::UNorm8;
+    return true;
+}
+
+bool Image::DecodeEncodedData() const
+{
+    // Threads sharing the image wait for the first one to decode
+    std::lock_guard<std::mutex> lock(decodeMutex_);
+    if (!decodePending_)
+        return true;
+
+    SE_PROFILE("DecodeImage");
+
+    std::vector<unsigned char> encodedData;
+    encodedData.swap(encodedData_);
+    MemoryBuffer buffer(encodedData);
+    buffer.SetName(GetName());
+
+    // Decoding fills in the pixels the image already claims to have, so decode into a separate image and take only
+    // the pixel data, mip levels and siblings from it
+    Image decoded;
+    decoded.SetName(GetName());
+    bool success = decoded.LoadPixels(buffer);
+    if (success && (decoded.width_ != width_ || decoded.height_ != height_ || decoded.depth_ != depth_ ||
+        decoded.components_ != components_ || decoded.channelFormat_ != channelFormat_ ||
+        decoded.compressedFormat_ != compressedFormat_ || decoded.numCompressedLevels_ != numCompressedLevels_))
+    {
+        SE_LOG_ERROR("Decoded image " + GetName() + " does not match its header");
+        success = false;
+    }
+
+    if (success)
+    {
+        data_ = decoded.data_;
+        nextLevel_ = decoded.nextLevel_;
+        nextSibling_ = decoded.nextSibling_;
+        UpdateMemoryUse(decoded.GetMemoryUse());
+    }
+    else
+    {
+        SE_LOG_ERROR("Failed to decode image " + GetName());
+        UpdateMemoryUse(0);
+    }
+
+    decodePending_.store(false, std::memory_order_release);
+    return success;
+}
+
+bool Image::LoadPixels(Deserializer& source)
 {
     // Check for DDS, KTX or PVR compressed format
     String fileID = source.ReadFileID();
+    // Only the stb_image path decodes to float
+    channelFormat_ = ChannelFormat::UNorm8;
 
     if (fileID == "DDS ")
     {
@@ -260,75 +767,11 @@ bool Image::BeginLoad(Deserializer& source)
         if (hasDXGI)
             source.Read(&dxgiHeader, sizeof(dxgiHeader));
 
-        unsigned fourCC = ddsd.ddpfPixelFormat_.dwFourCC_;
-
-        // If the DXGI header is available then remap formats and check sRGB
-        if (hasDXGI)
-        {
-            switch (dxgiHeader.dxgiFormat)
-            {
-            case DDS_DXGI_FORMAT_BC1_UNORM:
-            case DDS_DXGI_FORMAT_BC1_UNORM_SRGB:
-                fourCC = FOURCC_DXT1;
-                break;
-            case DDS_DXGI_FORMAT_BC2_UNORM:
-            case DDS_DXGI_FORMAT_BC2_UNORM_SRGB:
-                fourCC = FOURCC_DXT3;
-                break;
-            case DDS_DXGI_FORMAT_BC3_UNORM:
-            case DDS_DXGI_FORMAT_BC3_UNORM_SRGB:
-                fourCC = FOURCC_DXT5;
-                break;
-            case DDS_DXGI_FORMAT_R8G8B8A8_UNORM:
-            case DDS_DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
-                fourCC = 0;
-                break;
-            default:
-                SE_LOG_ERROR("Unrecognized DDS DXGI image format");
-                return false;
-            }
-
-            // Check the internal sRGB formats
-            if (dxgiHeader.dxgiFormat == DDS_DXGI_FORMAT_BC1_UNORM_SRGB ||
-                dxgiHeader.dxgiFormat == DDS_DXGI_FORMAT_BC2_UNORM_SRGB ||
-                dxgiHeader.dxgiFormat == DDS_DXGI_FORMAT_BC3_UNORM_SRGB ||
-                dxgiHeader.dxgiFormat == DDS_DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
-            {
-                sRGB_ = true;
-            }
-        }
-        switch (fourCC)
-        {
-        case FOURCC_DXT1:
-            compressedFormat_ = CF_DXT1;
-            components_ = 3;
-            break;
-
-        case FOURCC_DXT3:
-            compressedFormat_ = CF_DXT3;
-            components_ = 4;
-            break;
-
-        case FOURCC_DXT5:
-            compressedFormat_ = CF_DXT5;
-            components_ = 4;
-            break;
-
-        case 0:
-            if (ddsd.ddpfPixelFormat_.dwRGBBitCount_ != 32 && ddsd.ddpfPixelFormat_.dwRGBBitCount_ != 24 &&
-                ddsd.ddpfPixelFormat_.dwRGBBitCount_ != 16)
-            {
-                SE_LOG_ERROR("Unsupported DDS pixel byte size");
-                return false;
-            }
-            compressedFormat_ = CF_RGBA;
-            components_ = 4;
-            break;
-
-        default:
-            SE_LOG_ERROR("Unrecognized DDS image format");
+        bool sRGB = false;
+        if (!GetDDSFormat(ddsd, hasDXGI ? &dxgiHeader : nullptr, compressedFormat_, components_, sRGB))
             return false;
-        }
+        if (sRGB)
+            sRGB_ = true;
 
         // Is it a cube map or texture array? If so determine the size of the image chain.
         cubemap_ = (ddsd.ddsCaps_.dwCaps2_ & DDSCAPS2_CUBEMAP_ALL_FACES) != 0 || (hasDXGI && (dxgiHeader.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE) != 0);
@@ -345,7 +788,7 @@ bool Image::BeginLoad(Deserializer& source)
         unsigned dataSize = 0;
         if (compressedFormat_ != CF_RGBA)
         {
-            const unsigned blockSize = compressedFormat_ == CF_DXT1 ? 8 : 16; //DXT1/BC1 is 8 bytes, DXT3/BC2 and DXT5/BC3 are 16 bytes
+            const unsigned blockSize = (compressedFormat_ == CF_DXT1 || compressedFormat_ == CF_BC4) ? 8 : 16; //DXT1/BC1 and BC4 are 8 bytes, DXT3/BC2, DXT5/BC3, BC5 and BC7 are 16 bytes
             // Add 3 to ensure valid block: ie 2x2 fits uses a whole 4x4 block
             unsigned blocksWide = (ddsd.dwWidth_ + 3) / 4;
             unsigned blocksHeight = (ddsd.dwHeight_ + 3) / 4;
@@ -506,8 +949,6 @@ bool Image::BeginLoad(Deserializer& source)
             }
         }
 
-
-        bits_ = components_ * 32;
     }
     else if (fileID == "\253KTX")
     {
@@ -551,63 +992,7 @@ bool Image::BeginLoad(Deserializer& source)
             return false;
         }
 
-        switch (internalFormat)
-        {
-        case 0x83f1:
-            compressedFormat_ = CF_DXT1;
-            components_ = 4;
-            break;
-
-        case 0x83f2:
-            compressedFormat_ = CF_DXT3;
-            components_ = 4;
-            break;
-
-        case 0x83f3:
-            compressedFormat_ = CF_DXT5;
-            components_ = 4;
-            break;
-
-        case 0x8d64:
-            compressedFormat_ = CF_ETC1;
-            components_ = 3;
-            break;
-
-        case 0x9274:
-            compressedFormat_ = CF_ETC2_RGB;
-            components_ = 3;
-            break;
-
-        case 0x9278:
-            compressedFormat_ = CF_ETC2_RGBA;
-            components_ = 4;
-            break;
-
-        case 0x8c00:
-            compressedFormat_ = CF_PVRTC_RGB_4BPP;
-            components_ = 3;
-            break;
-
-        case 0x8c01:
-            compressedFormat_ = CF_PVRTC_RGB_2BPP;
-            components_ = 3;
-            break;
-
-        case 0x8c02:
-            compressedFormat_ = CF_PVRTC_RGBA_4BPP;
-            components_ = 4;
-            break;
-
-        case 0x8c03:
-            compressedFormat_ = CF_PVRTC_RGBA_2BPP;
-            components_ = 4;
-            break;
-
-        default:
-            compressedFormat_ = CF_NONE;
-            break;
-        }
-
+        compressedFormat_ = GetKTXFormat(internalFormat, components_);
         if (compressedFormat_ == CF_NONE)
         {
             SE_LOG_ERROR("Unsupported texture format in KTX file");
@@ -670,64 +1055,7 @@ bool Image::BeginLoad(Deserializer& source)
             return false;
         }
 
-        switch (pixelFormatLo)
-        {
-        case 0:
-            compressedFormat_ = CF_PVRTC_RGB_2BPP;
-            components_ = 3;
-            break;
-
-        case 1:
-            compressedFormat_ = CF_PVRTC_RGBA_2BPP;
-            components_ = 4;
-            break;
-
-        case 2:
-            compressedFormat_ = CF_PVRTC_RGB_4BPP;
-            components_ = 3;
-            break;
-
-        case 3:
-            compressedFormat_ = CF_PVRTC_RGBA_4BPP;
-            components_ = 4;
-            break;
-
-        case 6:
-            compressedFormat_ = CF_ETC1;
-            components_ = 3;
-            break;
-
-        case 7:
-            compressedFormat_ = CF_DXT1;
-            components_ = 4;
-            break;
-
-        case 9:
-            compressedFormat_ = CF_DXT3;
-            components_ = 4;
-            break;
-
-        case 11:
-            compressedFormat_ = CF_DXT5;
-            components_ = 4;
-            break;
-
-        // .pvr files also support ETC2 texture format.
-        case 22:
-            compressedFormat_ = CF_ETC2_RGB;
-            components_ = 3;
-            break;
-
-        case 23:
-            compressedFormat_ = CF_ETC2_RGBA;
-            components_ = 4;
-            break;
-
-        default:
-            compressedFormat_ = CF_NONE;
-            break;
-        }
-
+        compressedFormat_ = GetPVRFormat(pixelFormatLo, components_);
         if (compressedFormat_ == CF_NONE)
         {
             SE_LOG_ERROR("Unsupported texture format in PVR file");
@@ -824,17 +1152,38 @@ bool Image::BeginLoad(Deserializer& source)
     {
         // Not DDS, KTX or PVR, use STBImage to load other image formats as uncompressed
         source.Seek(0);
-        int width, height, bits;
+        int width, height;
         unsigned components;
-        unsigned char* pixelData = GetImageData(source, width, height, bits_, components, isHDR_);
+        bool isHDR;
+        unsigned char* pixelData = GetImageData(source, width, height, components, isHDR);
         if (!pixelData)
         {
             SE_LOG_ERROR("Could not load image " + source.GetName() + ": " + String(stbi_failure_reason()));
             return false;
         }
-        SetSize(width, height, components);
-        SetData(pixelData);
-        FreeImageData(pixelData);
+
+        if (isHDR)
+        {
+            // Store as half floats, which keeps the dynamic range at half the memory of the decoded floats
+            const bool success = SetSize(width, height, components, ChannelFormat::Float16);
+            if (success)
+            {
+                ConvertFloatToHalf(reinterpret_cast<uint16_t*>(data_.get()), reinterpret_cast<const float*>(pixelData),
+                    (std::size_t)width * height * components);
+            }
+            FreeImageData(pixelData);
+            if (!success)
+            {
+                SE_LOG_ERROR("Unsupported pixel format in image " + source.GetName());
+                return false;
+            }
+        }
+        // Keep the decoder's buffer as the image data instead of copying it
+        else if (!AdoptImageData(pixelData, width, height, components))
+        {
+            SE_LOG_ERROR("Unsupported pixel format in image " + source.GetName());
+            return false;
+        }
     }
 
     return true;
@@ -843,6 +1192,7 @@ bool Image::BeginLoad(Deserializer& source)
 bool Image::Save(Serializer& dest) const
 {
     SE_PROFILE("SaveImage");
+    DecodePending();
 
     if (IsCompressed())
     {
@@ -850,6 +1200,12 @@ bool Image::Save(Serializer& dest) const
         return false;
     }
 
+    if (IsHDR())
+    {
+        SE_LOG_ERROR("Can not save HDR image " + GetName() + " to PNG");
+        return false;
+    }
+
     if (!data_)
     {
         SE_LOG_ERROR("Can not save zero-sized image " + GetName());
@@ -885,6 +1241,8 @@ bool Image::SaveFile(const FileIdentifier& fileName) const
         return SaveJPG(absoluteFileName, 100);
     else if (absoluteFileName.ends_with(".tga", false))
         return SaveTGA(absoluteFileName);
+    else if (absoluteFileName.ends_with(".hdr", false))
+        return SaveHDR(absoluteFileName);
 #ifdef SE_WEBP
     else if (absoluteFileName.EndsWith(".webp", false))
         return SaveWEBP(absoluteFileName, 100.0f);
@@ -893,6 +1251,59 @@ bool Image::SaveFile(const FileIdentifier& fileName) const
         return SavePNG(absoluteFileName);
 }
 
+unsigned Image::GetCookVersion() const
+{
+    // Compressed containers keep their block data as is, so skip the cache before they are even read
+    const String& name = GetName();
+    if (name.ends_with(".dds", false) || name.ends_with(".ktx", false) || name.ends_with(".pvr", false))
+        return 0;
+    // Siblings are known only once a lazily loaded file is decoded
+    DecodePending();
+    if (IsCompressed() || cubemap_ || array_ || nextSibling_)
+        return 0;
+    return 2;
+}
+
+bool Image::SaveCooked(Serializer& dest) const
+{
+    DecodePending();
+    if (IsCompressed() || !data_ || cubemap_ || array_ || nextSibling_)
+        return false;
+
+    bool success = dest.WriteInt(width_);
+    success &= dest.WriteInt(height_);
+    success &= dest.WriteInt(depth_);
+    success &= dest.WriteUInt(components_);
+    success &= dest.WriteUByte(static_cast<unsigned char>(channelFormat_));
+    success &= dest.WriteBool(sRGB_);
+
+    const unsigned dataSize = width_ * height_ * depth_ * GetPixelSize();
+    success &= dest.Write(data_.get(), dataSize) == dataSize;
+    return success;
+}
+
+bool Image::LoadCooked(Deserializer& source)
+{
+    const int width = source.ReadInt();
+    const int height = source.ReadInt();
+    const int depth = source.ReadInt();
+    const unsigned components = source.ReadUInt();
+    const unsigned char format = source.ReadUByte();
+    const bool sRGB = source.ReadBool();
+
+    if (format > static_cast<unsigned char>(ChannelFormat::Float32))
+        return false;
+    if (!SetSize(width, height, depth, components, static_cast<ChannelFormat>(format)))
+        return false;
+
+    const unsigned dataSize = width_ * height_ * depth_ * GetPixelSize();
+    if (source.Read(data_.get(), dataSize) != dataSize)
+        return false;
+
+    sRGB_ = sRGB;
+    return true;
+}
+
 bool Image::SetSize(int width, int height, unsigned components)
 {
     return SetSize(width, height, 1, components);
@@ -900,7 +1311,20 @@ bool Image::SetSize(int width, int height, unsigned components)
 
 bool Image::SetSize(int width, int height, int depth, unsigned components)
 {
-    if (width == width_ && height == height_ && depth == depth_ && components == components_)
+    return SetSize(width, height, depth, components, ChannelFormat::UNorm8);
+}
+
+bool Image::SetSize(int width, int height, unsigned components, ChannelFormat format)
+{
+    return SetSize(width, height, 1, components, format);
+}
+
+bool Image::SetSize(int width, int height, int depth, unsigned components, ChannelFormat format)
+{
+    // A lazily loaded image has the size but not the pixels yet
+    encodedData_.clear();
+    decodePending_ = false;
+    if (data_ && width == width_ && height == height_ && depth == depth_ && components == components_ && format == channelFormat_)
         return true;
 
     if (width <= 0 || height <= 0 || depth <= 0)
@@ -915,27 +1339,71 @@ bool Image::SetSize(int width, int height, int depth, unsigned components)
     if (data_)
         data_.reset();
 
-    data_ = std::shared_ptr<unsigned char>(new unsigned char[width * height * depth * components], std::default_delete<unsigned char[]>());
     width_ = width;
     height_ = height;
     depth_ = depth;
     components_ = components;
+    channelFormat_ = format;
     compressedFormat_ = CF_NONE;
     numCompressedLevels_ = 0;
     nextLevel_.reset();
 
-    SetMemoryUse(width * height * depth * components);
+    const unsigned dataSize = width * height * depth * GetPixelSize();
+    data_ = std::shared_ptr<unsigned char>(new unsigned char[dataSize], std::default_delete<unsigned char[]>());
+    SetMemoryUse(dataSize);
     return true;
 }
 
+/// Read the channels of one uncompressed pixel as floats. 8-bit channels are normalized to 0-1.
+static void LoadPixelChannels(float* dest, const unsigned char* src, unsigned components, ChannelFormat format)
+{
+    switch (format)
+    {
+    case ChannelFormat::Float32:
+        memcpy(dest, src, components * sizeof(float));
+        break;
+
+    case ChannelFormat::Float16:
+        ConvertHalfToFloat(dest, reinterpret_cast<const uint16_t*>(src), components);
+        break;
+
+    default:
+        for (unsigned c = 0; c < components; ++c)
+            dest[c] = (float)src[c] / 255.0f;
+        break;
+    }
+}
+
+/// Write the channels of one pixel of a Float16 or Float32 image.
+static void StoreFloatPixelChannels(unsigned char* dest, const float* src, unsigned components, ChannelFormat format)
+{
+    if (format == ChannelFormat::Float32)
+        memcpy(dest, src, components * sizeof(float));
+    else
+        ConvertFloatToHalf(reinterpret_cast<uint16_t*>(dest), src, components);
+}
+
 void Image::SetPixel(int x, int y, const Color& color)
 {
-    SetPixelInt(x, y, 0, color.ToUInt());
+    SetPixel(x, y, 0, color);
 }
 
 void Image::SetPixel(int x, int y, int z, const Color& color)
 {
-    SetPixelInt(x, y, z, color.ToUInt());
+    DecodePending();
+    if (channelFormat_ == ChannelFormat::UNorm8)
+    {
+        SetPixelInt(x, y, z, color.ToUInt());
+        return;
+    }
+
+    if (!data_ || x < 0 || x >= width_ || y < 0 || y >= height_ || z < 0 || z >= depth_ || IsCompressed())
+        return;
+
+    // Float channels are not clamped, so HDR colors are kept as they are
+    const float channels[4] = {color.r_, color.g_, color.b_, color.a_};
+    StoreFloatPixelChannels(data_.get() + (z * width_ * height_ + y * width_ + x) * GetPixelSize(), channels, components_,
+        channelFormat_);
 }
 
 void Image::SetPixelInt(int x, int y, unsigned uintColor)
@@ -945,6 +1413,15 @@ void Image::SetPixelInt(int x, int y, unsigned uintColor)
 
 void Image::SetPixelInt(int x, int y, int z, unsigned uintColor)
 {
+    DecodePending();
+    if (channelFormat_ != ChannelFormat::UNorm8)
+    {
+        Color color;
+        color.FromUInt(uintColor);
+        SetPixel(x, y, z, color);
+        return;
+    }
+
     if (!data_ || x < 0 || x >= width_ || y < 0 || y >= height_ || z < 0 || z >= depth_ || IsCompressed())
         return;
 
@@ -970,6 +1447,7 @@ void Image::SetPixelInt(int x, int y, int z, unsigned uintColor)
 
 void Image::SetData(const unsigned char* pixelData)
 {
+    DecodePending();
     if (!data_)
         return;
 
@@ -979,7 +1457,7 @@ void Image::SetData(const unsigned char* pixelData)
         return;
     }
 
-    auto size = (std::size_t)width_ * height_ * depth_ * components_;
+    auto size = (std::size_t)width_ * height_ * depth_ * GetPixelSize();
     if (pixelData)
         memcpy(data_.get(), pixelData, size);
     else
@@ -1000,14 +1478,16 @@ bool Image::LoadColorLUT(Deserializer& source)
     source.Seek(0);
     int width, height;
     unsigned components;
-    unsigned char* pixelDataIn = GetImageData(source, width, height, bits_, components, isHDR_);
+    bool isHDR;
+    unsigned char* pixelDataIn = GetImageData(source, width, height, components, isHDR);
     if (!pixelDataIn)
     {
         SE_LOG_ERROR("Could not load image {}: {}", source.GetName(), String(stbi_failure_reason()));
         return false;
     }
-    if (components != 3)
+    if (components != 3 || isHDR)
     {
+        FreeImageData(pixelDataIn);
         SE_LOG_ERROR("Invalid image format, can not load image");
         return false;
     }
@@ -1040,6 +1520,7 @@ bool Image::LoadColorLUT(Deserializer& source)
 
 bool Image::FlipHorizontal()
 {
+    DecodePending();
     if (!data_)
         return false;
 
@@ -1051,15 +1532,16 @@ bool Image::FlipHorizontal()
 
     if (!IsCompressed())
     {
-        std::shared_ptr<unsigned char> newData(new unsigned char[width_ * height_ * components_], std::default_delete<unsigned char[]>());
-        unsigned rowSize = width_ * components_;
+        const unsigned pixelSize = GetPixelSize();
+        std::shared_ptr<unsigned char> newData(new unsigned char[width_ * height_ * pixelSize], std::default_delete<unsigned char[]>());
+        unsigned rowSize = width_ * pixelSize;
 
         for (int y = 0; y < height_; ++y)
         {
             for (int x = 0; x < width_; ++x)
             {
-                for (unsigned c = 0; c < components_; ++c)
-                    newData.get()[y * rowSize + x * components_ + c] = data_.get()[y * rowSize + (width_ - x - 1) * components_ + c];
+                for (unsigned c = 0; c < pixelSize; ++c)
+                    newData.get()[y * rowSize + x * pixelSize + c] = data_.get()[y * rowSize + (width_ - x - 1) * pixelSize + c];
             }
         }
 
@@ -1113,6 +1595,7 @@ bool Image::FlipHorizontal()
 
 bool Image::FlipVertical()
 {
+    DecodePending();
     if (!data_)
         return false;
 
@@ -1124,8 +1607,8 @@ bool Image::FlipVertical()
 
     if (!IsCompressed())
     {
-        std::shared_ptr<unsigned char> newData(new unsigned char[width_ * height_ * components_], std::default_delete<unsigned char[]>());
-        unsigned rowSize = width_ * components_;
+        unsigned rowSize = width_ * GetPixelSize();
+        std::shared_ptr<unsigned char> newData(new unsigned char[rowSize * height_], std::default_delete<unsigned char[]>());
 
         for (int y = 0; y < height_; ++y)
             memcpy(&(newData.get()[(height_ - y - 1) * rowSize]), &data_.get()[y * rowSize], rowSize);
@@ -1177,27 +1660,180 @@ bool Image::FlipVertical()
     return true;
 }
 
+#ifndef __ANDROID__
+/// Minimum number of output pixels to resize in parallel.
+static const unsigned MIN_PARALLEL_RESIZE_PIXELS = 256 * 256;
+
+static stbir_filter GetResizeFilter(ResizeFilter filter)
+{
+    switch (filter)
+    {
+    case ResizeFilter::Box: return STBIR_FILTER_BOX;
+    case ResizeFilter::Triangle: return STBIR_FILTER_TRIANGLE;
+    case ResizeFilter::CubicBSpline: return STBIR_FILTER_CUBICBSPLINE;
+    case ResizeFilter::CatmullRom: return STBIR_FILTER_CATMULLROM;
+    case ResizeFilter::Mitchell: return STBIR_FILTER_MITCHELL;
+    case ResizeFilter::Point: return STBIR_FILTER_POINT_SAMPLE;
+    default: return STBIR_FILTER_DEFAULT;
+    }
+}
+
+/// Return the stb_image_resize2 data type of a channel format. sRGB applies only to 8-bit data.
+static stbir_datatype GetResizeDataType(ChannelFormat format, bool sRGB)
+{
+    switch (format)
+    {
+    case ChannelFormat::Float16: return STBIR_TYPE_HALF_FLOAT;
+    case ChannelFormat::Float32: return STBIR_TYPE_FLOAT;
+    default: return sRGB ? STBIR_TYPE_UINT8_SRGB : STBIR_TYPE_UINT8;
+    }
+}
+
+/// Resample pixels with stb_image_resize2. Large images are split across WorkQueue threads by output rows.
+static bool ResamplePixels(unsigned char* dest, int destWidth, int destHeight, const unsigned char* src, int srcWidth,
+    int srcHeight, unsigned components, stbir_filter horizontalFilter, stbir_filter verticalFilter, stbir_datatype dataType)
+{
+    static const stbir_pixel_layout layouts[] = { STBIR_1CHANNEL, STBIR_RA, STBIR_RGB, STBIR_RGBA };
+
+    STBIR_RESIZE resize;
+    stbir_resize_init(&resize, src, srcWidth, srcHeight, 0, dest, destWidth, destHeight, 0, layouts[components - 1],
+        dataType);
+    stbir_set_edgemodes(&resize, STBIR_EDGE_CLAMP, STBIR_EDGE_CLAMP);
+    stbir_set_filters(&resize, horizontalFilter, verticalFilter);
+
+    WorkQueue* workQueue = WorkQueue::Get();
+    // Worker threads may only be waited on from the main thread
+    if (!Thread::IsMainThread() || !workQueue->GetNumThreads() || (unsigned)(destWidth * destHeight) < MIN_PARALLEL_RESIZE_PIXELS)
+        return stbir_resize_extended(&resize) != 0;
+
+    const int numSplits = stbir_build_samplers_with_splits(&resize, workQueue->GetNumThreads() + 1);
+    if (!numSplits)
+        return false;
+
+    std::atomic<bool> success{true};
+    ForEachParallel(workQueue, 1, static_cast<unsigned>(numSplits), [&](unsigned beginSplit, unsigned endSplit)
+    {
+        if (!stbir_resize_extended_split(&resize, beginSplit, endSplit - beginSplit))
+            success = false;
+    });
+    stbir_free_samplers(&resize);
+    return success;
+}
+#endif
+
 bool Image::Resize(int width, int height)
+{
+    return Resize(width, height, Max(depth_, 1), ResizeFilter::Default);
+}
+
+bool Image::Resize(int width, int height, ResizeFilter filter, bool sRGB)
+{
+    return Resize(width, height, Max(depth_, 1), filter, sRGB);
+}
+
+bool Image::Resize(int width, int height, int depth, ResizeFilter filter, bool sRGB)
 {
     SE_PROFILE("ResizeImage");
 
-    if (IsCompressed())
+    // Resample every texture array layer before committing any, so that a failure leaves all layers consistent
+    std::vector<std::pair<Image*, std::shared_ptr<unsigned char>>> layers;
+    for (Image* layer = this; layer; layer = layer->GetNextSibling().get())
+    {
+        std::shared_ptr<unsigned char> newData;
+        if (!layer->ResampleData(newData, width, height, depth, filter, sRGB))
+            return false;
+        layers.emplace_back(layer, std::move(newData));
+    }
+
+    for (auto& [layer, newData] : layers)
+    {
+        if (!newData)
+            continue;
+        layer->width_ = width;
+        layer->height_ = height;
+        layer->depth_ = depth;
+        layer->data_ = std::move(newData);
+        layer->nextLevel_.reset();
+        layer->compressedFormat_ = CF_NONE;
+        layer->numCompressedLevels_ = 0;
+        layer->SetMemoryUse(width * height * depth * layer->GetPixelSize());
+    }
+    return true;
+}
+
+bool Image::ResampleData(std::shared_ptr<unsigned char>& newData, int width, int height, int depth, ResizeFilter filter,
+    bool sRGB)
+{
+    DecodePending();
+
+    if (IsCompressed() && compressedFormat_ != CF_RGBA)
     {
         SE_LOG_ERROR("Resize not supported for compressed images");
         return false;
     }
 
-    if (depth_ > 1)
+    // Uncompressed DDS images hold 8-bit RGBA pixels with the mip chain after the top level.
+    // Only the top level is resized, the result is a plain image without mips
+    if (compressedFormat_ == CF_RGBA)
+        depth_ = Max(depth_, 1);
+
+    if (!data_ || width <= 0 || height <= 0 || depth <= 0 || components_ < 1 || components_ > 4)
+        return false;
+
+    if (width == width_ && height == height_ && depth == depth_)
+        return true;
+
+#ifndef __ANDROID__
+    const unsigned sliceSize = width * height * GetPixelSize();
+    newData.reset(new unsigned char[sliceSize * depth], std::default_delete<unsigned char[]>());
+
+    // Resize each slice in XY first
+    std::unique_ptr<unsigned char[]> slices;
+    unsigned char* sliceData = newData.get();
+    if (depth != depth_)
+    {
+        slices.reset(new unsigned char[sliceSize * depth_]);
+        sliceData = slices.get();
+    }
+
+    const stbir_filter stbFilter = GetResizeFilter(filter);
+    const stbir_datatype dataType = GetResizeDataType(channelFormat_, sRGB);
+    for (int z = 0; z < depth_; ++z)
+    {
+        if (!ResamplePixels(sliceData + z * sliceSize, width, height, data_.get() + z * width_ * height_ * GetPixelSize(),
+            width_, height_, components_, stbFilter, stbFilter, dataType))
+        {
+            SE_LOG_ERROR("Failed to resize image");
+            return false;
+        }
+    }
+
+    // Then resample along Z by treating the volume as a 2D image of (width * height) x depth pixels.
+    // Horizontal point sampling at 1:1 scale leaves the rows untouched
+    if (depth != depth_)
+    {
+        if (!ResamplePixels(newData.get(), width * height, depth, sliceData, width * height, depth_, components_,
+            STBIR_FILTER_POINT_SAMPLE, stbFilter, dataType))
+        {
+            SE_LOG_ERROR("Failed to resize image");
+            return false;
+        }
+    }
+#else
+    if (depth_ > 1 || depth != depth_)
     {
         SE_LOG_ERROR("Resize not supported for 3D images");
         return false;
     }
 
-    if (!data_ || width <= 0 || height <= 0)
+    if (IsHDR())
+    {
+        SE_LOG_ERROR("Resize not supported for HDR images");
         return false;
+    }
 
     /// \todo Reducing image size does not sample all needed pixels
-    std::shared_ptr<unsigned char> newData(new unsigned char[width * height * components_], std::default_delete<unsigned char[]>());
+    newData.reset(new unsigned char[width * height * components_], std::default_delete<unsigned char[]>());
     for (int y = 0; y < height; ++y)
     {
         for (int x = 0; x < width; ++x)
@@ -1226,25 +1862,52 @@ bool Image::Resize(int width, int height)
             }
         }
     }
+#endif
 
-    if (data_)
-        data_.reset();
-
-    width_ = width;
-    height_ = height;
-    data_ = newData;
-    SetMemoryUse(width * height * depth_ * components_);
     return true;
 }
 
 void Image::Clear(const Color& color)
 {
-    ClearInt(color.ToUInt());
+    DecodePending();
+    if (channelFormat_ == ChannelFormat::UNorm8)
+    {
+        ClearInt(color.ToUInt());
+        return;
+    }
+
+    if (!data_)
+        return;
+
+    if (IsCompressed())
+    {
+        SE_LOG_ERROR("Clear not supported for compressed images");
+        return;
+    }
+
+    const unsigned pixelSize = GetPixelSize();
+    const float channels[4] = {color.r_, color.g_, color.b_, color.a_};
+    unsigned char pixel[16];
+    StoreFloatPixelChannels(pixel, channels, components_, channelFormat_);
+
+    unsigned char* data = data_.get();
+    unsigned char* dataEnd = data + width_ * height_ * depth_ * pixelSize;
+    for (; data < dataEnd; data += pixelSize)
+        memcpy(data, pixel, pixelSize);
 }
 
 void Image::ClearInt(unsigned uintColor)
 {
     SE_PROFILE("ClearImage");
+    DecodePending();
+
+    if (channelFormat_ != ChannelFormat::UNorm8)
+    {
+        Color color;
+        color.FromUInt(uintColor);
+        Clear(color);
+        return;
+    }
 
     if (!data_)
         return;
@@ -1274,6 +1937,7 @@ void Image::ClearInt(unsigned uintColor)
 bool Image::SaveBMP(const String& fileName) const
 {
     SE_PROFILE("SaveImageBMP");
+    DecodePending();
 
     auto fileSystem = FileSystem::Get();
     if (!fileSystem.CheckAccess(GetPath(fileName)))
@@ -1288,6 +1952,12 @@ bool Image::SaveBMP(const String& fileName) const
         return false;
     }
 
+    if (IsHDR())
+    {
+        SE_LOG_ERROR("Can not save HDR image to BMP");
+        return false;
+    }
+
     if (data_)
         return stbi_write_bmp(fileName.c_str(), width_, height_, components_, data_.get()) != 0;
     else
@@ -1308,6 +1978,7 @@ bool Image::SavePNG(const String& fileName) const
 bool Image::SaveTGA(const String& fileName) const
 {
     SE_PROFILE("SaveImageTGA");
+    DecodePending();
 
     auto fileSystem = FileSystem::Get();
     if (!fileSystem.CheckAccess(GetPath(fileName)))
@@ -1322,6 +1993,12 @@ bool Image::SaveTGA(const String& fileName) const
         return false;
     }
 
+    if (IsHDR())
+    {
+        SE_LOG_ERROR("Can not save HDR image to TGA");
+        return false;
+    }
+
     if (data_)
         return stbi_write_tga(GetNativePath(fileName).c_str(), width_, height_, components_, data_.get()) != 0;
     else
@@ -1331,29 +2008,94 @@ bool Image::SaveTGA(const String& fileName) const
 bool Image::SaveJPG(const String& fileName, int quality) const
 {
     SE_PROFILE("SaveImageJPG");
+    DecodePending();
+
+    auto fileSystem = FileSystem::Get();
+    if (!fileSystem.CheckAccess(GetPath(fileName)))
+    {
+        SE_LOG_ERROR("Access denied to " + fileName);
+        return false;
+    }
+
+    if (IsCompressed())
+    {
+        SE_LOG_ERROR("Can not save compressed image to JPG");
+        return false;
+    }
+
+    if (IsHDR())
+    {
+        SE_LOG_ERROR("Can not save HDR image to JPG");
+        return false;
+    }
+
+    if (data_)
+        return stbi_write_jpg(GetNativePath(fileName).c_str(), width_, height_, components_, data_.get(), quality) != 0;
+    else
+        return false;
+}
+
+bool Image::SaveHDR(const String& fileName) const
+{
+    SE_PROFILE("SaveImageHDR");
+    DecodePending();
+
+    if (IsCompressed())
+    {
+        SE_LOG_ERROR("Can not save compressed image to HDR");
+        return false;
+    }
+
+    if (!data_ || depth_ != 1 || components_ < 1 || components_ > 4)
+    {
+        SE_LOG_ERROR("Only 2D images can be saved to HDR");
+        return false;
+    }
 
-    auto fileSystem = FileSystem::Get();
-    if (!fileSystem.CheckAccess(GetPath(fileName)))
+    File outFile(fileName, FILE_WRITE);
+    if (!outFile.IsOpen())
     {
         SE_LOG_ERROR("Access denied to " + fileName);
         return false;
     }
 
-    if (IsCompressed())
+    bool success = outFile.WriteStringData(cformat("#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y %d +X %d\n", height_, width_));
+
+    // Flat scanlines are valid Radiance data and let each row be converted on its own, so no float copy of the whole
+    // image is needed
+    const unsigned rowSize = width_ * GetPixelSize();
+    std::vector<float> floatRow(width_ * components_);
+    std::vector<unsigned char> rgbeRow(width_ * 4);
+    for (int y = 0; y < height_ && success; ++y)
     {
-        SE_LOG_ERROR("Can not save compressed image to JPG");
-        return false;
+        const unsigned char* row = data_.get() + y * rowSize;
+        const float* floats = floatRow.data();
+        switch (channelFormat_)
+        {
+        case ChannelFormat::Float32:
+            floats = reinterpret_cast<const float*>(row);
+            break;
+
+        case ChannelFormat::Float16:
+            ConvertHalfToFloat(floatRow.data(), reinterpret_cast<const uint16_t*>(row), floatRow.size());
+            break;
+
+        default:
+            ConvertToFloat(floatRow.data(), row, width_, components_, false);
+            break;
+        }
+
+        ConvertFloatToRGBE(rgbeRow.data(), floats, width_, components_);
+        success = outFile.Write(rgbeRow.data(), rgbeRow.size()) == rgbeRow.size();
     }
 
-    if (data_)
-        return stbi_write_jpg(GetNativePath(fileName).c_str(), width_, height_, components_, data_.get(), quality) != 0;
-    else
-        return false;
+    return success;
 }
 
 bool Image::SaveDDS(const String& fileName) const
 {
     SE_PROFILE("SaveImageDDS");
+    DecodePending();
 
     File outFile(fileName, FILE_WRITE);
     if (!outFile.IsOpen())
@@ -1368,6 +2110,12 @@ bool Image::SaveDDS(const String& fileName) const
         return false;
     }
 
+    if (IsHDR())
+    {
+        SE_LOG_ERROR("Can not save HDR image to DDS");
+        return false;
+    }
+
     if (components_ != 4)
     {
         SE_LOG_ERROR("Can not save image with {} components to DDS", components_);
@@ -1403,8 +2151,131 @@ bool Image::SaveDDS(const String& fileName) const
     return true;
 }
 
+bool Image::SaveDDS(const String& fileName, CompressedFormat format) const
+{
+    SE_PROFILE("SaveImageDDS");
+    DecodePending();
+
+    const unsigned blockSize = GetCompressedBlockSize(format);
+    if (!blockSize)
+    {
+        SE_LOG_ERROR("Unsupported DDS compression format {}", static_cast<int>(format));
+        return false;
+    }
+
+    if (IsCompressed())
+    {
+        SE_LOG_ERROR("Can not save compressed image to DDS");
+        return false;
+    }
+
+    if (!data_ || IsHDR() || depth_ != 1 || components_ < 1 || components_ > 4)
+    {
+        SE_LOG_ERROR("Only 8-bit 2D images can be compressed to DDS");
+        return false;
+    }
+
+    // Use the stored mip chain if it is complete, otherwise generate the whole chain on a copy without modifying the image
+    std::vector<const Image*> levels;
+    GetLevels(levels);
+    std::shared_ptr<Image> copy;
+    if (levels.back()->GetWidth() > 1 || levels.back()->GetHeight() > 1)
+    {
+        copy = std::make_shared<Image>();
+        copy->SetSize(width_, height_, components_);
+        copy->SetData(data_.get());
+        copy->sRGB_ = sRGB_;
+        if (!copy->GenerateLevels())
+            return false;
+        levels.clear();
+        copy->GetLevels(levels);
+    }
+
+    File outFile(fileName, FILE_WRITE);
+    if (!outFile.IsOpen())
+    {
+        SE_LOG_ERROR("Access denied to " + fileName);
+        return false;
+    }
+
+    DDSurfaceDesc2 ddsd;        // NOLINT(hicpp-member-init)
+    memset(&ddsd, 0, sizeof(ddsd));
+    ddsd.dwSize_ = sizeof(ddsd);
+    ddsd.dwFlags_ = 0x00000001l /*DDSD_CAPS*/
+        | 0x00000002l /*DDSD_HEIGHT*/ | 0x00000004l /*DDSD_WIDTH*/ | 0x00020000l /*DDSD_MIPMAPCOUNT*/ | 0x00001000l /*DDSD_PIXELFORMAT*/
+        | 0x00080000l /*DDSD_LINEARSIZE*/;
+    ddsd.dwWidth_ = width_;
+    ddsd.dwHeight_ = height_;
+    ddsd.dwLinearSize_ = ((width_ + 3) / 4) * ((height_ + 3) / 4) * blockSize;
+    ddsd.dwMipMapCount_ = levels.size();
+    ddsd.ddpfPixelFormat_.dwSize_ = sizeof(ddsd.ddpfPixelFormat_);
+    ddsd.ddpfPixelFormat_.dwFlags_ = 0x00000004l /*DDPF_FOURCC*/;
+    ddsd.ddsCaps_.dwCaps_ = DDSCAPS_TEXTURE | (levels.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+    // BC7 and sRGB formats can only be described by the DX10 header
+    DDSHeader10 dxgiHeader;     // NOLINT(hicpp-member-init)
+    memset(&dxgiHeader, 0, sizeof(dxgiHeader));
+    const bool hasDXGI = format == CF_BC7 || sRGB_;
+    switch (format)
+    {
+    case CF_DXT1:
+        ddsd.ddpfPixelFormat_.dwFourCC_ = FOURCC_DXT1;
+        dxgiHeader.dxgiFormat = sRGB_ ? DDS_DXGI_FORMAT_BC1_UNORM_SRGB : DDS_DXGI_FORMAT_BC1_UNORM;
+        break;
+
+    case CF_DXT5:
+        ddsd.ddpfPixelFormat_.dwFourCC_ = FOURCC_DXT5;
+        dxgiHeader.dxgiFormat = sRGB_ ? DDS_DXGI_FORMAT_BC3_UNORM_SRGB : DDS_DXGI_FORMAT_BC3_UNORM;
+        break;
+
+    case CF_BC4:
+        ddsd.ddpfPixelFormat_.dwFourCC_ = FOURCC_ATI1;
+        dxgiHeader.dxgiFormat = DDS_DXGI_FORMAT_BC4_UNORM;
+        break;
+
+    case CF_BC5:
+        ddsd.ddpfPixelFormat_.dwFourCC_ = FOURCC_ATI2;
+        dxgiHeader.dxgiFormat = DDS_DXGI_FORMAT_BC5_UNORM;
+        break;
+
+    default:
+        dxgiHeader.dxgiFormat = sRGB_ ? DDS_DXGI_FORMAT_BC7_UNORM_SRGB : DDS_DXGI_FORMAT_BC7_UNORM;
+        break;
+    }
+    if (hasDXGI)
+    {
+        ddsd.ddpfPixelFormat_.dwFourCC_ = FOURCC_DX10;
+        dxgiHeader.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+        dxgiHeader.arraySize = 1;
+    }
+
+    outFile.WriteFileID("DDS ");
+    outFile.Write(&ddsd, sizeof(ddsd));
+    if (hasDXGI)
+        outFile.Write(&dxgiHeader, sizeof(dxgiHeader));
+
+    std::vector<unsigned char> blocks;
+    for (const Image* level : levels)
+    {
+        blocks.resize(((level->GetWidth() + 3) / 4) * ((level->GetHeight() + 3) / 4) * blockSize);
+        if (!CompressImage(blocks.data(), level->GetData(), level->GetWidth(), level->GetHeight(), level->GetComponents(), format))
+        {
+            SE_LOG_ERROR("Could not compress image data for " + fileName);
+            return false;
+        }
+        if (outFile.Write(blocks.data(), blocks.size()) != blocks.size())
+        {
+            SE_LOG_ERROR("Could not write compressed image data to " + fileName);
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool Image::SaveWEBP(const String& fileName, float compression /* = 0.0f */) const
 {
+    DecodePending();
 #ifdef SE_WEBP
     SE_PROFILE("SaveImageWEBP");
 
@@ -1423,6 +2294,12 @@ bool Image::SaveWEBP(const String& fileName, float compression /* = 0.0f */) con
         return false;
     }
 
+    if (IsHDR())
+    {
+        SE_LOG_ERROR("Can not save HDR image to WebP");
+        return false;
+    }
+
     if (height_ > WEBP_MAX_DIMENSION || width_ > WEBP_MAX_DIMENSION)
     {
         SE_LOG_ERROR("Maximum dimension supported by WebP is " + String(WEBP_MAX_DIMENSION));
@@ -1504,28 +2381,31 @@ Color Image::GetPixel(int x, int y) const
 
 Color Image::GetPixel(int x, int y, int z) const
 {
+    DecodePending();
     if (!data_ || z < 0 || z >= depth_ || IsCompressed())
         return Color::BLACK;
     x = Clamp(x, 0, width_ - 1);
     y = Clamp(y, 0, height_ - 1);
 
-    unsigned char* src = data_.get() + (z * width_ * height_ + y * width_ + x) * components_;
+    const unsigned char* src = data_.get() + (z * width_ * height_ + y * width_ + x) * GetPixelSize();
+    float channels[4];
+    LoadPixelChannels(channels, src, components_, channelFormat_);
     Color ret;
 
     switch (components_)
     {
     case 4:
-        ret.a_ = (float)src[3] / 255.0f;
+        ret.a_ = channels[3];
         // Fall through
     case 3:
-        ret.b_ = (float)src[2] / 255.0f;
+        ret.b_ = channels[2];
         // Fall through
     case 2:
-        ret.g_ = (float)src[1] / 255.0f;
-        ret.r_ = (float)src[0] / 255.0f;
+        ret.g_ = channels[1];
+        ret.r_ = channels[0];
         break;
     default:
-        ret.r_ = ret.g_ = ret.b_ = (float)src[0] / 255.0f;
+        ret.r_ = ret.g_ = ret.b_ = channels[0];
         break;
     }
 
@@ -1539,8 +2419,11 @@ unsigned Image::GetPixelInt(int x, int y) const
 
 unsigned Image::GetPixelInt(int x, int y, int z) const
 {
+    DecodePending();
     if (!data_ || z < 0 || z >= depth_ || IsCompressed())
         return 0xff000000;
+    if (channelFormat_ != ChannelFormat::UNorm8)
+        return GetPixel(x, y, z).ToUInt();
     x = Clamp(x, 0, width_ - 1);
     y = Clamp(y, 0, height_ - 1);
 
@@ -1615,6 +2498,7 @@ Color Image::GetPixelTrilinear(float x, float y, float z) const
 
 std::shared_ptr<Image> Image::GetNextLevel() const
 {
+    DecodePending();
     if (IsCompressed())
     {
         SE_LOG_ERROR("Can not generate mip level from compressed data");
@@ -1642,6 +2526,33 @@ std::shared_ptr<Image> Image::GetNextLevel() const
     if (depthOut < 1)
         depthOut = 1;
 
+    // Float images are box filtered in float precision
+    if (channelFormat_ != ChannelFormat::UNorm8)
+    {
+        if (depth_ > 1)
+        {
+            SE_LOG_ERROR("Mip level generation is not supported for 3D HDR images");
+            return std::shared_ptr<Image>();
+        }
+
+        auto mipImage = std::make_shared<Image>();
+        mipImage->SetSize(widthOut, heightOut, components_, channelFormat_);
+
+        const MipFilterKernel& kernel = GetMipFilterKernel(MipFilter::Box);
+        if (channelFormat_ == ChannelFormat::Float32)
+        {
+            DownsampleSeparable(reinterpret_cast<float*>(mipImage->data_.get()), widthOut,
+                reinterpret_cast<const float*>(data_.get()), width_, height_, components_, kernel, 0, heightOut);
+        }
+        else
+        {
+            std::vector<float> destFloat(widthOut * heightOut * components_);
+            DownsampleSeparable(destFloat.data(), reinterpret_cast<uint16_t*>(mipImage->data_.get()), widthOut,
+                reinterpret_cast<const uint16_t*>(data_.get()), width_, height_, components_, kernel, 0, heightOut);
+        }
+        return mipImage;
+    }
+
     auto mipImage = std::make_shared<Image>();
 
     if (depth_ > 1)
@@ -1916,6 +2827,7 @@ std::shared_ptr<Image> Image::GetNextLevel() const
 
 std::shared_ptr<Image> Image::ConvertToRGBA() const
 {
+    DecodePending();
     if (IsCompressed())
     {
         SE_LOG_ERROR("Can not convert compressed image to RGBA");
@@ -1931,6 +2843,11 @@ std::shared_ptr<Image> Image::ConvertToRGBA() const
         SE_LOG_ERROR("Can not convert image without data to RGBA");
         return std::shared_ptr<Image>();
     }
+    if (IsHDR())
+    {
+        SE_LOG_ERROR("Can not convert HDR image to RGBA");
+        return std::shared_ptr<Image>();
+    }
 
     // Already RGBA?
     if (components_ == 4)
@@ -1984,8 +2901,65 @@ std::shared_ptr<Image> Image::ConvertToRGBA() const
     return ret;
 }
 
+std::shared_ptr<Image> Image::ConvertToChannelFormat(ChannelFormat format, bool sRGB) const
+{
+    DecodePending();
+    if (IsCompressed())
+    {
+        SE_LOG_ERROR("Can not convert channel format of compressed image");
+        return std::shared_ptr<Image>();
+    }
+    if (!data_)
+    {
+        SE_LOG_ERROR("Can not convert channel format of image without data");
+        return std::shared_ptr<Image>();
+    }
+
+    auto ret = std::make_shared<Image>();
+    ret->SetSize(width_, height_, depth_, components_, format);
+    ret->sRGB_ = sRGB_;
+
+    if (format == channelFormat_)
+    {
+        memcpy(ret->GetData(), data_.get(), (std::size_t)width_ * height_ * depth_ * GetPixelSize());
+        return ret;
+    }
+
+    // Convert one row at a time through float to keep the temporary buffer small
+    const unsigned numRows = height_ * depth_;
+    const unsigned rowCount = width_ * components_;
+    const unsigned srcRowSize = width_ * GetPixelSize();
+    const unsigned destRowSize = width_ * ret->GetPixelSize();
+    std::vector<float> floatRow(rowCount);
+
+    for (unsigned y = 0; y < numRows; ++y)
+    {
+        const unsigned char* src = data_.get() + y * srcRowSize;
+        unsigned char* dest = ret->GetData() + y * destRowSize;
+
+        // Decode the source row. Float32 sources are read in place
+        const float* floats = floatRow.data();
+        if (channelFormat_ == ChannelFormat::Float32)
+            floats = reinterpret_cast<const float*>(src);
+        else if (channelFormat_ == ChannelFormat::Float16)
+            ConvertHalfToFloat(floatRow.data(), reinterpret_cast<const uint16_t*>(src), rowCount);
+        else
+            ConvertToFloat(floatRow.data(), src, width_, components_, sRGB);
+
+        if (format == ChannelFormat::Float32)
+            memcpy(dest, floats, rowCount * sizeof(float));
+        else if (format == ChannelFormat::Float16)
+            ConvertFloatToHalf(reinterpret_cast<uint16_t*>(dest), floats, rowCount);
+        else
+            ConvertFromFloat(dest, floats, width_, components_, sRGB);
+    }
+
+    return ret;
+}
+
 CompressedLevel Image::GetCompressedLevel(unsigned index) const
 {
+    DecodePending();
     CompressedLevel level;
 
     if (compressedFormat_ == CF_NONE)
@@ -2041,9 +3015,9 @@ CompressedLevel Image::GetCompressedLevel(unsigned index) const
             ++i;
         }
     }
-    else if (compressedFormat_ < CF_PVRTC_RGB_2BPP)
+    else if (compressedFormat_ < CF_PVRTC_RGB_2BPP || compressedFormat_ > CF_PVRTC_RGBA_4BPP)
     {
-        level.blockSize_ = (compressedFormat_ == CF_DXT1 || compressedFormat_ == CF_ETC1 || compressedFormat_ == CF_ETC2_RGB) ? 8 : 16;
+        level.blockSize_ = (compressedFormat_ == CF_DXT1 || compressedFormat_ == CF_BC4 || compressedFormat_ == CF_ETC1 || compressedFormat_ == CF_ETC2_RGB) ? 8 : 16;
         unsigned i = 0;
         unsigned offset = 0;
 
@@ -2127,7 +3101,11 @@ std::shared_ptr<Image> Image::GetDecompressedImage() const
 
     auto decompressedImage = std::make_shared<Image>();
     decompressedImage->SetSize(compressedLevel.width_, compressedLevel.height_, 4);
-    compressedLevel.Decompress(decompressedImage->GetData());
+    if (!compressedLevel.Decompress(decompressedImage->GetData()))
+    {
+        SE_LOG_ERROR("Failed to decompress image " + GetName());
+        return nullptr;
+    }
 
     return decompressedImage;
 }
@@ -2147,7 +3125,11 @@ std::shared_ptr<Image> Image::GetDecompressedImageLevel(unsigned index) const
 
         auto decompressedImage = std::make_shared<Image>();
         decompressedImage->SetSize(compressedLevel.width_, compressedLevel.height_, 4);
-        compressedLevel.Decompress(decompressedImage->GetData());
+        if (!compressedLevel.Decompress(decompressedImage->GetData()))
+        {
+            SE_LOG_ERROR("Failed to decompress image " + GetName());
+            return nullptr;
+        }
 
         return decompressedImage;
     }
@@ -2156,6 +3138,7 @@ std::shared_ptr<Image> Image::GetDecompressedImageLevel(unsigned index) const
 
 std::shared_ptr<Image> Image::GetSubimage(const IntRect& rect) const
 {
+    DecodePending();
     if (!data_)
         return nullptr;
 
@@ -2179,15 +3162,16 @@ std::shared_ptr<Image> Image::GetSubimage(const IntRect& rect) const
         int height = rect.Height();
 
         auto image = std::make_shared<Image>();
-        image->SetSize(width, height, components_);
+        image->SetSize(width, height, components_, channelFormat_);
 
+        const unsigned pixelSize = GetPixelSize();
         unsigned char* dest = image->GetData();
-        unsigned char* src = data_.get() + (y * width_ + x) * components_;
+        unsigned char* src = data_.get() + (y * width_ + x) * pixelSize;
         for (int i = 0; i < height; ++i)
         {
-            memcpy(dest, src, (std::size_t)width * components_);
-            dest += width * components_;
-            src += width_ * components_;
+            memcpy(dest, src, (std::size_t)width * pixelSize);
+            dest += width * pixelSize;
+            src += width_ * pixelSize;
         }
 
         return image;
@@ -2264,11 +3248,16 @@ std::shared_ptr<Image> Image::GetSubimage(const IntRect& rect) const
 
 void Image::PrecalculateLevels()
 {
+    DecodePending();
     if (!data_ || IsCompressed())
         return;
 
     SE_PROFILE("PrecalculateImageMipLevels");
 
+    // The whole-chain generator gives identical results for 2D images
+    if (depth_ == 1 && GenerateLevels())
+        return;
+
     nextLevel_.reset();
 
     if (width_ > 1 || height_ > 1)
@@ -2283,13 +3272,178 @@ void Image::PrecalculateLevels()
     }
 }
 
+/// Minimum size of a mip level in bytes to process its rows in parallel.
+static const unsigned MIN_PARALLEL_MIP_BYTES = 256 * 1024;
+/// Target size of a row band in bytes for mip generation.
+static const unsigned MIP_BAND_BYTES = 64 * 1024;
+/// Minimum number of rows in a band, to amortize the filter overlap between bands.
+static const unsigned MIN_MIP_BAND_ROWS = 16;
+
+/// Run callback(beginRow, endRow) over all rows of a mip level in cache-sized bands, in parallel if worthwhile.
+template <class Callback> static void ForEachMipRow(int numRows, unsigned rowBytes, Callback callback)
+{
+    const unsigned band = std::max(MIP_BAND_BYTES / std::max(rowBytes, 1u), MIN_MIP_BAND_ROWS);
+
+    WorkQueue* workQueue = WorkQueue::Get();
+    // Worker threads may only be waited on from the main thread
+    if (Thread::IsMainThread() && workQueue->GetNumThreads() && numRows * rowBytes >= MIN_PARALLEL_MIP_BYTES)
+    {
+        ForEachParallel(workQueue, band, static_cast<unsigned>(numRows), [&](unsigned beginRow, unsigned endRow)
+        {
+            callback(static_cast<int>(beginRow), static_cast<int>(endRow));
+        });
+    }
+    else
+    {
+        for (int beginRow = 0; beginRow < numRows; beginRow += band)
+            callback(beginRow, std::min(beginRow + static_cast<int>(band), numRows));
+    }
+}
+
+bool Image::GenerateLevels(MipFilter filter, bool gammaCorrect)
+{
+    DecodePending();
+    if (!data_ || IsCompressed() || depth_ != 1 || components_ < 1 || components_ > 4)
+    {
+        SE_LOG_ERROR("Mip chain generation is supported only for uncompressed 2D images");
+        return false;
+    }
+
+    SE_PROFILE("GenerateImageMipLevels");
+
+    nextLevel_.reset();
+
+    const unsigned components = components_;
+    Image* current = this;
+
+    // Float images need no quantization. Half float levels carry the unquantized float result down the chain
+    if (IsHDR())
+    {
+        const MipFilterKernel& kernel = GetMipFilterKernel(filter);
+        std::vector<float> source;
+        std::vector<float> dest;
+
+        while (current->width_ > 1 || current->height_ > 1)
+        {
+            const int srcWidth = current->width_;
+            const int srcHeight = current->height_;
+            const int width = std::max(srcWidth / 2, 1);
+            const int height = std::max(srcHeight / 2, 1);
+
+            auto mipImage = std::make_shared<Image>();
+            mipImage->SetSize(width, height, components, channelFormat_);
+            mipImage->sRGB_ = sRGB_;
+
+            if (channelFormat_ == ChannelFormat::Float32)
+            {
+                const auto* srcData = reinterpret_cast<const float*>(current->data_.get());
+                auto* destData = reinterpret_cast<float*>(mipImage->data_.get());
+                ForEachMipRow(height, srcWidth * components * sizeof(float) * 2, [&](int beginRow, int endRow)
+                {
+                    DownsampleSeparable(destData, width, srcData, srcWidth, srcHeight, components, kernel, beginRow, endRow);
+                });
+            }
+            else
+            {
+                dest.resize(width * height * components);
+                auto* destHalf = reinterpret_cast<uint16_t*>(mipImage->data_.get());
+                ForEachMipRow(height, srcWidth * components * sizeof(float) * 2, [&](int beginRow, int endRow)
+                {
+                    // The first level reads the half source directly
+                    if (current == this)
+                    {
+                        DownsampleSeparable(dest.data(), destHalf, width, reinterpret_cast<const uint16_t*>(data_.get()),
+                            srcWidth, srcHeight, components, kernel, beginRow, endRow);
+                    }
+                    else
+                    {
+                        DownsampleSeparable(dest.data(), destHalf, width, source.data(), srcWidth, srcHeight, components,
+                            kernel, beginRow, endRow);
+                    }
+                });
+                std::swap(source, dest);
+            }
+
+            current->nextLevel_ = mipImage;
+            current = mipImage.get();
+        }
+        return true;
+    }
+
+    // Plain box filtering works directly on 8-bit data and gives the same results as GetNextLevel()
+    if (filter == MipFilter::Box && !gammaCorrect)
+    {
+        while (current->width_ > 1 || current->height_ > 1)
+        {
+            const int width = std::max(current->width_ / 2, 1);
+            const int height = std::max(current->height_ / 2, 1);
+            auto mipImage = std::make_shared<Image>();
+            mipImage->SetSize(width, height, components);
+            mipImage->sRGB_ = sRGB_;
+
+            const unsigned char* src = current->data_.get();
+            unsigned char* dest = mipImage->data_.get();
+            ForEachMipRow(height, width * components * 2, [&](int beginRow, int endRow)
+            {
+                DownsampleBox(dest, width, src, current->width_, current->height_, components, beginRow, endRow);
+            });
+
+            current->nextLevel_ = mipImage;
+            current = mipImage.get();
+        }
+        return true;
+    }
+
+    // Otherwise filter in float precision, carrying the unquantized result down the chain
+    const MipFilterKernel& kernel = GetMipFilterKernel(filter);
+    std::vector<float> source;
+    std::vector<float> dest;
+
+    while (current->width_ > 1 || current->height_ > 1)
+    {
+        const int srcWidth = current->width_;
+        const int srcHeight = current->height_;
+        const int width = std::max(srcWidth / 2, 1);
+        const int height = std::max(srcHeight / 2, 1);
+
+        auto mipImage = std::make_shared<Image>();
+        mipImage->SetSize(width, height, components);
+        mipImage->sRGB_ = sRGB_;
+        dest.resize(width * height * components);
+
+        unsigned char* destBytes = mipImage->data_.get();
+        ForEachMipRow(height, srcWidth * components * sizeof(float) * 2, [&](int beginRow, int endRow)
+        {
+            // The first level reads the 8-bit source directly
+            if (current == this)
+            {
+                DownsampleSeparable(dest.data(), destBytes, width, data_.get(), srcWidth, srcHeight, components,
+                    kernel, gammaCorrect, beginRow, endRow);
+            }
+            else
+            {
+                DownsampleSeparable(dest.data(), destBytes, width, source.data(), srcWidth, srcHeight, components,
+                    kernel, gammaCorrect, beginRow, endRow);
+            }
+        });
+
+        current->nextLevel_ = mipImage;
+        current = mipImage.get();
+        std::swap(source, dest);
+    }
+    return true;
+}
+
 void Image::CleanupLevels()
 {
+    // A pending decode assigns the levels, so finish it first
+    DecodePending();
     nextLevel_.reset();
 }
 
 void Image::GetLevels(std::vector<Image*>& levels)
 {
+    DecodePending();
     levels.clear();
 
     Image* image = this;
@@ -2302,6 +3456,7 @@ void Image::GetLevels(std::vector<Image*>& levels)
 
 void Image::GetLevels(std::vector<const Image*>& levels) const
 {
+    DecodePending();
     levels.clear();
 
     const Image* image = this;
@@ -2312,61 +3467,96 @@ void Image::GetLevels(std::vector<const Image*>& levels) const
     }
 }
 
-unsigned char* Image::GetImageData(Deserializer& source, int& width, int& height, int& bits, unsigned& components, bool& isHDR)
+unsigned char* Image::GetImageData(Deserializer& source, int& width, int& height, unsigned& components, bool& isHDR)
 {
-    int dataSize = source.GetSize();
-
-    int texChannels = 4;
-
-    std::shared_ptr<unsigned char> buffer(new unsigned char[dataSize], std::default_delete<unsigned char[]>());
-    source.Read(buffer.get(), dataSize);
+    const std::size_t position = source.GetPosition();
+    const std::size_t dataSize = source.GetSize() - position;
 
     unsigned char* pixels = nullptr;
+    int channels = 0;
+    int desiredChannels = 0;
+    isHDR = false;
 
-    int sizeOfChannel = 8;
-    if (stbi_is_hdr_from_memory(buffer.get(), dataSize)) {
-        isHDR = true;
-    //    int sizeOfChannel_ = 32;
-        pixels = stbi_load_from_memory(buffer.get(), dataSize, &width, &height, (int*)&components, STBI_rgb_alpha);
+    // Decode straight from the source bytes when they are already in memory or the file can be memory-mapped,
+    // otherwise stream the file through stb's read buffer instead of reading it whole first
+    MappedFile mappedFile;
+    const unsigned char* mapped = GetMappedData(source);
+    if (!mapped)
+        mapped = MapFileSource(source, mappedFile);
+    if (mapped)
+    {
+        const auto* fileData = reinterpret_cast<const stbi_uc*>(mapped + position);
+        isHDR = stbi_is_hdr_from_memory(fileData, (int)dataSize) != 0;
+        desiredChannels = isHDR ? STBI_rgb_alpha : 0;
+        if (isHDR)
+            pixels = reinterpret_cast<unsigned char*>(stbi_loadf_from_memory(fileData, (int)dataSize, &width, &height, &channels, desiredChannels));
+        else
+            pixels = stbi_load_from_memory(fileData, (int)dataSize, &width, &height, &channels, desiredChannels);
+        source.Seek(source.GetSize());
     }
     else
-        pixels = stbi_load_from_memory(buffer.get(), dataSize, &width, &height, (int*)&components, 0);
+    {
+        const stbi_io_callbacks callbacks{ReadImageSource, SkipImageSource, IsImageSourceEof};
+        // The HDR test reads ahead through the callbacks, so rewind the source before decoding
+        isHDR = stbi_is_hdr_from_callbacks(&callbacks, &source) != 0;
+        desiredChannels = isHDR ? STBI_rgb_alpha : 0;
+        source.Seek(position);
+        if (isHDR)
+            pixels = reinterpret_cast<unsigned char*>(stbi_loadf_from_callbacks(&callbacks, &source, &width, &height, &channels, desiredChannels));
+        else
+            pixels = stbi_load_from_callbacks(&callbacks, &source, &width, &height, &channels, desiredChannels);
+    }
 
-    bits  = components * sizeOfChannel;
-    
     if (!pixels)
     {
         SE_LOG_ERROR("Could not load image '{0}'!", source.GetName());
-        // Return magenta checkerboad image
-
-        texChannels = 4;
+        // Return magenta checkerboad image. Allocate it like stb_image does, so that FreeImageData() can release it
+        const int texChannels = 4;
+        width = 2;
+        height = 2;
+        components = texChannels;
 
-        if (width)
-            width = 2;
-        if (height)
-            height = 2;
-        if (bits)
-            bits = texChannels * sizeOfChannel;
-
-        const int32_t size = (width) * (height) * texChannels;
-        uint8_t* data = new uint8_t[size];
-
-        uint8_t datatwo[16] = {
+        static const uint8_t checkerboard[16] = {
             255, 0, 255, 255,
             0,   0,   0, 255,
             0,   0,   0, 255,
             255, 0, 255, 255
         };
 
-        memcpy(data, datatwo, size);
-
+        auto* data = static_cast<uint8_t*>(STBI_MALLOC(sizeof checkerboard));
+        if (data)
+            memcpy(data, checkerboard, sizeof checkerboard);
+        isHDR = false;
         return data;
     }
 
-    isHDR = false;
+    // HDR files are requested as RGBA, in which case stb_image reports the channel count of the file instead
+    components = desiredChannels ? desiredChannels : channels;
     return pixels;
 }
 
+bool Image::AdoptImageData(unsigned char* pixelData, int width, int height, unsigned components)
+{
+    if (!pixelData || width <= 0 || height <= 0 || components < 1 || components > 4)
+    {
+        FreeImageData(pixelData);
+        return false;
+    }
+
+    data_ = std::shared_ptr<unsigned char>(pixelData, FreeImageData);
+    width_ = width;
+    height_ = height;
+    depth_ = 1;
+    components_ = components;
+    channelFormat_ = ChannelFormat::UNorm8;
+    compressedFormat_ = CF_NONE;
+    numCompressedLevels_ = 0;
+    nextLevel_.reset();
+
+    SetMemoryUse(width * height * components);
+    return true;
+}
+
 void Image::FreeImageData(unsigned char* pixelData)
 {
     if (!pixelData)
@@ -2383,6 +3573,9 @@ bool Image::HasAlphaChannel() const
 // Author: Josh Engebretson (AtomicGameEngine)
 bool Image::SetSubimage(const Image* image, const IntRect& rect)
 {
+    DecodePending();
+    if (image)
+        image->DecodePending();
     if (!data_)
         return false;
 
@@ -2392,9 +3585,9 @@ bool Image::SetSubimage(const Image* image, const IntRect& rect)
         return false;
     }
 
-    if (components_ != image->components_)
+    if (components_ != image->components_ || channelFormat_ != image->channelFormat_)
     {
-        SE_LOG_ERROR("Can not set subimage in image {} with different number of components", GetName());
+        SE_LOG_ERROR("Can not set subimage in image {} with different number of components or channel format", GetName());
         return false;
     }
 
@@ -2406,16 +3599,30 @@ bool Image::SetSubimage(const Image* image, const IntRect& rect)
 
     const int destWidth = rect.Width();
     const int destHeight = rect.Height();
+    const unsigned pixelSize = GetPixelSize();
     if (destWidth == image->GetWidth() && destHeight == image->GetHeight())
     {
         unsigned char* src = image->GetData();
-        unsigned char* dest = data_.get() + (rect.top_ * width_ + rect.left_) * components_;
+        unsigned char* dest = data_.get() + (rect.top_ * width_ + rect.left_) * pixelSize;
         for (int i = 0; i < destHeight; ++i)
         {
-            memcpy(dest, src, (std::size_t)destWidth * components_);
+            memcpy(dest, src, (std::size_t)destWidth * pixelSize);
 
-            src += destWidth * image->components_;
-            dest += width_ * components_;
+            src += destWidth * pixelSize;
+            dest += width_ * pixelSize;
+        }
+    }
+    else if (IsHDR())
+    {
+        for (int y = 0; y < destHeight; ++y)
+        {
+            for (int x = 0; x < destWidth; ++x)
+            {
+                // Calculate float coordinates between 0 - 1 for resampling
+                const float xF = (image->width_ > 1) ? static_cast<float>(x) / (destWidth - 1) : 0.0f;
+                const float yF = (image->height_ > 1) ? static_cast<float>(y) / (destHeight - 1) : 0.0f;
+                SetPixel(rect.left_ + x, rect.top_ + y, image->GetPixelBilinear(xF, yF));
+            }
         }
     }
     else
@@ -0,0 +1,276 @@
+#include <SeResource/ImageAtlas.h>
+
+#include <Se/Console.hpp>
+#include <Se/Profiler.hpp>
+#include <Se/Thread.h>
+#include <Se/WorkQueue.h>
+#include <SeMath/MathDefs.hpp>
+
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "STB/stb_rect_pack.h"
+
+#include <cstring>
+
+namespace Se
+{
+
+/// Largest page size stb_rect_pack can address with 16-bit coordinates.
+static const int MAX_ATLAS_PAGE_SIZE = 16384;
+/// Number of entries blitted by one work item.
+static const unsigned ATLAS_BLIT_BAND = 16;
+
+/// Copy an image into the page at its entry position and repeat its edge pixels outwards by extrude pixels.
+static void BlitExtruded(Image* page, const Image* image, const IntRect& rect, int extrude)
+{
+    const unsigned pixelSize = page->GetPixelSize();
+    const int width = image->GetWidth();
+    const int height = image->GetHeight();
+    const std::size_t srcStride = (std::size_t)width * pixelSize;
+    const std::size_t destStride = (std::size_t)page->GetWidth() * pixelSize;
+
+    unsigned char* destBase = page->GetData() + (rect.left_ - extrude) * pixelSize;
+    for (int y = -extrude; y < height + extrude; ++y)
+    {
+        const unsigned char* src = image->GetData() + Clamp(y, 0, height - 1) * srcStride;
+        unsigned char* dest = destBase + (rect.top_ + y) * destStride;
+
+        for (int x = 0; x < extrude; ++x, dest += pixelSize)
+            memcpy(dest, src, pixelSize);
+        memcpy(dest, src, srcStride);
+        dest += srcStride;
+        for (int x = 0; x < extrude; ++x, dest += pixelSize)
+            memcpy(dest, src + srcStride - pixelSize, pixelSize);
+    }
+}
+
+void ImageAtlasEntry::SerializeInBlock(Archive& archive)
+{
+    SerializeValue(archive, "name", name_);
+    archive.SerializeVLE("page", page_);
+    if (archive.IsHumanReadable())
+    {
+        SerializeValue(archive, "rect", rect_);
+        return;
+    }
+
+    // Binary archives store the rectangle as variable length integers
+    unsigned left = rect_.left_, top = rect_.top_, width = rect_.Width(), height = rect_.Height();
+    archive.SerializeVLE("left", left);
+    archive.SerializeVLE("top", top);
+    archive.SerializeVLE("width", width);
+    archive.SerializeVLE("height", height);
+    if (archive.IsInput())
+        rect_ = IntRect(left, top, left + width, top + height);
+}
+
+void ImageAtlas::SetMaxPageSize(int size)
+{
+    maxPageSize_ = static_cast<int>(NextPowerOfTwo(static_cast<unsigned>(Clamp(size, 1, MAX_ATLAS_PAGE_SIZE))));
+}
+
+bool ImageAtlas::AddImage(const String& name, std::shared_ptr<Image> image)
+{
+    if (!image || !image->GetWidth() || !image->GetHeight() || image->GetDepth() > 1)
+    {
+        SE_LOG_ERROR("Can not add empty or 3D image {} to atlas", name);
+        return false;
+    }
+
+    if (entryIndices_.count(name))
+    {
+        SE_LOG_ERROR("Image {} is already added to atlas", name);
+        return false;
+    }
+
+    entryIndices_[name] = static_cast<unsigned>(entries_.size());
+    ImageAtlasEntry entry;
+    entry.name_ = name;
+    entries_.push_back(entry);
+    images_.push_back(std::move(image));
+    return true;
+}
+
+void ImageAtlas::Clear()
+{
+    images_.clear();
+    pages_.clear();
+    pageSizes_.clear();
+    entries_.clear();
+    entryIndices_.clear();
+}
+
+bool ImageAtlas::Build()
+{
+    SE_PROFILE("BuildImageAtlas");
+
+    pages_.clear();
+    pageSizes_.clear();
+    if (images_.empty())
+        return true;
+
+    if (entries_.size() != images_.size())
+    {
+        SE_LOG_ERROR("Can not rebuild atlas loaded from archive without its images");
+        return false;
+    }
+
+    // Bring all inputs to a common pixel layout
+    std::vector<std::shared_ptr<Image>> inputs(images_.size());
+    bool mixedComponents = false;
+    for (unsigned i = 0; i < images_.size(); ++i)
+    {
+        inputs[i] = images_[i]->IsCompressed() ? images_[i]->GetDecompressedImage() : images_[i];
+        if (!inputs[i])
+        {
+            SE_LOG_ERROR("Failed to decompress atlas image {}", entries_[i].name_);
+            return false;
+        }
+        if (inputs[i]->GetChannelFormat() != inputs[0]->GetChannelFormat())
+        {
+            SE_LOG_ERROR("Atlas image {} has a different channel format", entries_[i].name_);
+            return false;
+        }
+        mixedComponents |= inputs[i]->GetComponents() != inputs[0]->GetComponents();
+    }
+    if (mixedComponents)
+    {
+        if (inputs[0]->IsHDR())
+        {
+            SE_LOG_ERROR("Float atlas images must have the same number of components");
+            return false;
+        }
+        for (auto& input : inputs)
+        {
+            if (input->GetComponents() < 4)
+                input = input->ConvertToRGBA();
+        }
+    }
+    const unsigned components = inputs[0]->GetComponents();
+    const ChannelFormat format = inputs[0]->GetChannelFormat();
+
+    // Each cell holds the image, its extruded border on all sides and the padding on the right and bottom
+    const int border = extrude_ * 2 + padding_;
+    std::vector<stbrp_rect> rects(inputs.size());
+    for (unsigned i = 0; i < inputs.size(); ++i)
+    {
+        const int cellWidth = inputs[i]->GetWidth() + border;
+        const int cellHeight = inputs[i]->GetHeight() + border;
+        if (cellWidth > maxPageSize_ || cellHeight > maxPageSize_)
+        {
+            SE_LOG_ERROR("Atlas image {} does not fit into {}x{} page", entries_[i].name_, maxPageSize_, maxPageSize_);
+            return false;
+        }
+        rects[i].id = static_cast<int>(i);
+        rects[i].w = static_cast<stbrp_coord>(cellWidth);
+        rects[i].h = static_cast<stbrp_coord>(cellHeight);
+    }
+
+    // Fill pages one at a time with the rectangles that did not fit into the previous ones
+    std::vector<stbrp_node> nodes(maxPageSize_);
+    std::vector<stbrp_rect> pending = rects;
+    while (!pending.empty())
+    {
+        stbrp_context context;
+        stbrp_init_target(&context, maxPageSize_, maxPageSize_, nodes.data(), static_cast<int>(nodes.size()));
+        stbrp_pack_rects(&context, pending.data(), static_cast<int>(pending.size()));
+
+        const unsigned pageIndex = static_cast<unsigned>(pageSizes_.size());
+        IntVector2 extent = IntVector2::ZERO;
+        std::vector<stbrp_rect> remaining;
+        for (const stbrp_rect& rect : pending)
+        {
+            if (!rect.was_packed)
+            {
+                remaining.push_back(rect);
+                continue;
+            }
+
+            ImageAtlasEntry& entry = entries_[rect.id];
+            const Image* input = inputs[rect.id].get();
+            entry.page_ = pageIndex;
+            entry.rect_.left_ = rect.x + extrude_;
+            entry.rect_.top_ = rect.y + extrude_;
+            entry.rect_.right_ = entry.rect_.left_ + input->GetWidth();
+            entry.rect_.bottom_ = entry.rect_.top_ + input->GetHeight();
+            // Padding is not needed past the last cell
+            extent.x_ = Max(extent.x_, entry.rect_.right_ + extrude_);
+            extent.y_ = Max(extent.y_, entry.rect_.bottom_ + extrude_);
+        }
+        if (remaining.size() == pending.size())
+        {
+            SE_LOG_ERROR("Failed to pack atlas images");
+            return false;
+        }
+
+        pageSizes_.emplace_back(static_cast<int>(NextPowerOfTwo(extent.x_)), static_cast<int>(NextPowerOfTwo(extent.y_)));
+        pending.swap(remaining);
+    }
+
+    for (const IntVector2& size : pageSizes_)
+    {
+        auto page = std::make_shared<Image>();
+        if (!page->SetSize(size.x_, size.y_, components, format))
+            return false;
+        memset(page->GetData(), 0, (std::size_t)size.x_ * size.y_ * page->GetPixelSize());
+        pages_.push_back(page);
+    }
+
+    // Entries cover disjoint page regions, so they can be blitted concurrently
+    auto blitEntries = [&](unsigned beginIndex, unsigned endIndex)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+            BlitExtruded(pages_[entries_[i].page_].get(), inputs[i].get(), entries_[i].rect_, extrude_);
+    };
+    WorkQueue* workQueue = WorkQueue::Get();
+    // Worker threads may only be waited on from the main thread
+    if (Thread::IsMainThread() && workQueue->GetNumThreads())
+        ForEachParallel(workQueue, ATLAS_BLIT_BAND, static_cast<unsigned>(entries_.size()), blitEntries);
+    else
+        blitEntries(0, static_cast<unsigned>(entries_.size()));
+
+    UpdateLookup();
+    return true;
+}
+
+const ImageAtlasEntry* ImageAtlas::GetEntry(const String& name) const
+{
+    auto it = entryIndices_.find(name);
+    return it != entryIndices_.end() ? &entries_[it->second] : nullptr;
+}
+
+void ImageAtlas::SerializeInBlock(Archive& archive)
+{
+    if (archive.IsInput())
+    {
+        images_.clear();
+        pages_.clear();
+    }
+
+    LibSTD::SerializeVectorAsObjects(archive, "pages", pageSizes_, "size");
+    LibSTD::SerializeVectorAsObjects(archive, "entries", entries_, "entry");
+
+    if (archive.IsInput())
+    {
+        for (const ImageAtlasEntry& entry : entries_)
+        {
+            if (entry.page_ >= pageSizes_.size())
+                throw ArchiveException("'{}/entries' references missing page {}", archive.GetCurrentBlockPath().c_str(), entry.page_);
+        }
+        UpdateLookup();
+    }
+}
+
+void ImageAtlas::UpdateLookup()
+{
+    entryIndices_.clear();
+    for (unsigned i = 0; i < entries_.size(); ++i)
+    {
+        ImageAtlasEntry& entry = entries_[i];
+        const Vector2 pageSize = Vector2(pageSizes_[entry.page_]);
+        entry.uv_ = Rect(entry.rect_.left_ / pageSize.x_, entry.rect_.top_ / pageSize.y_,
+            entry.rect_.right_ / pageSize.x_, entry.rect_.bottom_ / pageSize.y_);
+        entryIndices_[entry.name_] = i;
+    }
+}
+
+}
@@ -0,0 +1,369 @@
+#include "ImageConvert.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SE_CONVERT_SSE2
+#if defined(__F16C__)
+#include <immintrin.h>
+#define SE_CONVERT_F16C
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SE_CONVERT_NEON
+#endif
+
+namespace Se
+{
+
+namespace
+{
+
+/// Size of the linear to sRGB lookup table.
+constexpr unsigned LinearToSRGBTableSize = 4096;
+
+/// Return number of leading color channels that are affected by gamma. Alpha is always linear.
+unsigned GetNumColorChannels(unsigned components)
+{
+    return components >= 3 ? 3 : 1;
+}
+
+float SRGBToLinear(float value)
+{
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+float LinearToSRGB(float value)
+{
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+}
+
+const std::array<float, 256>& GetSRGBToLinearTable()
+{
+    static const std::array<float, 256> table = []
+    {
+        std::array<float, 256> result{};
+        for (unsigned i = 0; i < 256; ++i)
+            result[i] = SRGBToLinear(i / 255.0f);
+        return result;
+    }();
+    return table;
+}
+
+const std::array<unsigned char, LinearToSRGBTableSize>& GetLinearToSRGBTable()
+{
+    static const std::array<unsigned char, LinearToSRGBTableSize> table = []
+    {
+        std::array<unsigned char, LinearToSRGBTableSize> result{};
+        for (unsigned i = 0; i < LinearToSRGBTableSize; ++i)
+            result[i] = static_cast<unsigned char>(LinearToSRGB(i / float(LinearToSRGBTableSize - 1)) * 255.0f + 0.5f);
+        return result;
+    }();
+    return table;
+}
+
+const std::array<float, 256>& GetUnormToFloatTable()
+{
+    static const std::array<float, 256> table = []
+    {
+        std::array<float, 256> result{};
+        for (unsigned i = 0; i < 256; ++i)
+            result[i] = i / 255.0f;
+        return result;
+    }();
+    return table;
+}
+
+unsigned char QuantizeUnorm(float value)
+{
+    return static_cast<unsigned char>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+unsigned FloatToBits(float value)
+{
+    unsigned bits;
+    memcpy(&bits, &value, sizeof bits);
+    return bits;
+}
+
+float BitsToFloat(unsigned bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof value);
+    return value;
+}
+
+/// Float exponent bias difference between float and half, in float exponent position.
+constexpr unsigned HalfExponentAdjust = (127 - 15) << 23;
+/// Smallest float bit pattern that converts to a normal half.
+constexpr unsigned HalfMinNormal = 113 << 23;
+/// Adding this float aligns the 10 mantissa bits of a half subnormal at the bottom, rounding to nearest even.
+constexpr unsigned HalfSubnormalMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+uint16_t FloatToHalf(float value)
+{
+    const unsigned sign = FloatToBits(value) & 0x80000000u;
+    // Clamping also turns NaN into HALF_MAX
+    const float magnitude = std::abs(value);
+    const float absValue = magnitude < HALF_MAX ? magnitude : HALF_MAX;
+    unsigned bits = FloatToBits(absValue);
+
+    unsigned result;
+    if (bits < HalfMinNormal)
+        result = FloatToBits(absValue + BitsToFloat(HalfSubnormalMagic)) - HalfSubnormalMagic;
+    else
+    {
+        const unsigned mantissaOdd = (bits >> 13) & 1;
+        bits += 0xfff - HalfExponentAdjust + mantissaOdd;
+        result = bits >> 13;
+    }
+    return static_cast<uint16_t>(result | (sign >> 16));
+}
+
+float HalfToFloat(uint16_t value)
+{
+    const unsigned shiftedExponent = 0x7c00u << 13;
+    unsigned bits = (value & 0x7fffu) << 13;
+    const unsigned exponent = bits & shiftedExponent;
+    bits += HalfExponentAdjust;
+
+    if (exponent == shiftedExponent)
+        bits += (128 - 16) << 23;
+    else if (!exponent)
+        bits = FloatToBits(BitsToFloat(bits + (1 << 23)) - BitsToFloat(HalfMinNormal));
+
+    return BitsToFloat(bits | (value & 0x8000u) << 16);
+}
+
+}
+
+void ConvertFloatToHalf(uint16_t* dest, const float* src, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(SE_CONVERT_F16C)
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 maxValue = _mm_set1_ps(HALF_MAX);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 value = _mm_loadu_ps(src + i);
+        const __m128 sign = _mm_andnot_ps(absMask, value);
+        const __m128 clamped = _mm_or_ps(_mm_min_ps(_mm_and_ps(value, absMask), maxValue), sign);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dest + i), _mm_cvtps_ph(clamped, _MM_FROUND_TO_NEAREST_INT));
+    }
+#elif defined(SE_CONVERT_SSE2)
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 maxValue = _mm_set1_ps(HALF_MAX);
+    const __m128i minNormal = _mm_set1_epi32(HalfMinNormal);
+    const __m128i subnormalMagic = _mm_set1_epi32(HalfSubnormalMagic);
+    const __m128i normalBias = _mm_set1_epi32(0xfff - HalfExponentAdjust);
+    const __m128i one = _mm_set1_epi32(1);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 value = _mm_loadu_ps(src + i);
+        const __m128i sign = _mm_srli_epi32(_mm_castps_si128(_mm_andnot_ps(absMask, value)), 16);
+        // min returns the second operand for NaN, so NaN clamps to HALF_MAX like the scalar path
+        const __m128 absValue = _mm_min_ps(_mm_and_ps(value, absMask), maxValue);
+        const __m128i bits = _mm_castps_si128(absValue);
+
+        const __m128i subnormal = _mm_sub_epi32(
+            _mm_castps_si128(_mm_add_ps(absValue, _mm_castsi128_ps(subnormalMagic))), subnormalMagic);
+        const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(bits, 13), one);
+        const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, normalBias), mantissaOdd), 13);
+
+        const __m128i isSubnormal = _mm_cmplt_epi32(bits, minNormal);
+        __m128i result = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+        result = _mm_or_si128(result, sign);
+        // Sign extend the 16-bit results so that the signed saturating pack keeps them intact
+        result = _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dest + i), _mm_packs_epi32(result, result));
+    }
+#elif defined(SE_CONVERT_NEON) && defined(__aarch64__)
+    const float32x4_t maxValue = vdupq_n_f32(HALF_MAX);
+    const float32x4_t minValue = vdupq_n_f32(-HALF_MAX);
+    for (; i + 4 <= count; i += 4)
+    {
+        const float32x4_t value = vminq_f32(vmaxq_f32(vld1q_f32(src + i), minValue), maxValue);
+        vst1_u16(dest + i, vreinterpret_u16_f16(vcvt_f16_f32(value)));
+    }
+#endif
+    for (; i < count; ++i)
+        dest[i] = FloatToHalf(src[i]);
+}
+
+void ConvertHalfToFloat(float* dest, const uint16_t* src, std::size_t count)
+{
+    std::size_t i = 0;
+#if defined(SE_CONVERT_F16C)
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(dest + i, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i))));
+#elif defined(SE_CONVERT_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i magnitudeMask = _mm_set1_epi32(0x7fff);
+    const __m128i shiftedExponent = _mm_set1_epi32(0x7c00 << 13);
+    const __m128i exponentAdjust = _mm_set1_epi32(HalfExponentAdjust);
+    const __m128i infNanAdjust = _mm_set1_epi32((128 - 16) << 23);
+    const __m128i subnormalAdjust = _mm_set1_epi32(1 << 23);
+    const __m128 minNormal = _mm_castsi128_ps(_mm_set1_epi32(HalfMinNormal));
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128i half = _mm_unpacklo_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i)), zero);
+        __m128i bits = _mm_slli_epi32(_mm_and_si128(half, magnitudeMask), 13);
+        const __m128i exponent = _mm_and_si128(bits, shiftedExponent);
+        bits = _mm_add_epi32(bits, exponentAdjust);
+
+        const __m128i isInfNan = _mm_cmpeq_epi32(exponent, shiftedExponent);
+        bits = _mm_add_epi32(bits, _mm_and_si128(isInfNan, infNanAdjust));
+
+        // Zero and subnormals are renormalized by a float subtraction
+        const __m128i isSubnormal = _mm_cmpeq_epi32(exponent, zero);
+        const __m128i renormalized = _mm_castps_si128(
+            _mm_sub_ps(_mm_castsi128_ps(_mm_add_epi32(bits, subnormalAdjust)), minNormal));
+        bits = _mm_or_si128(_mm_and_si128(isSubnormal, renormalized), _mm_andnot_si128(isSubnormal, bits));
+
+        const __m128i sign = _mm_slli_epi32(_mm_andnot_si128(magnitudeMask, half), 16);
+        _mm_storeu_ps(dest + i, _mm_castsi128_ps(_mm_or_si128(bits, sign)));
+    }
+#elif defined(SE_CONVERT_NEON) && defined(__aarch64__)
+    for (; i + 4 <= count; i += 4)
+        vst1q_f32(dest + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(src + i))));
+#endif
+    for (; i < count; ++i)
+        dest[i] = HalfToFloat(src[i]);
+}
+
+void ConvertToFloat(float* dest, const unsigned char* src, unsigned numPixels, unsigned components, bool sRGB)
+{
+    if (!sRGB)
+    {
+        const unsigned count = numPixels * components;
+        unsigned i = 0;
+#ifdef SE_CONVERT_SSE2
+        // Divide rather than multiply by the reciprocal to give the same results as the table
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 scale = _mm_set1_ps(255.0f);
+        for (; i + 16 <= count; i += 16)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            const __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+            const __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+            _mm_storeu_ps(dest + i, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)), scale));
+            _mm_storeu_ps(dest + i + 4, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)), scale));
+            _mm_storeu_ps(dest + i + 8, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)), scale));
+            _mm_storeu_ps(dest + i + 12, _mm_div_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)), scale));
+        }
+#endif
+        const auto& table = GetUnormToFloatTable();
+        for (; i < count; ++i)
+            dest[i] = table[src[i]];
+        return;
+    }
+
+    const unsigned numColorChannels = GetNumColorChannels(components);
+    const float* tables[4];
+    for (unsigned c = 0; c < 4; ++c)
+        tables[c] = c < numColorChannels ? GetSRGBToLinearTable().data() : GetUnormToFloatTable().data();
+
+    for (unsigned i = 0; i < numPixels; ++i)
+    {
+        for (unsigned c = 0; c < components; ++c)
+            dest[i * components + c] = tables[c][src[i * components + c]];
+    }
+}
+
+void ConvertFromFloat(unsigned char* dest, const float* src, unsigned numPixels, unsigned components, bool sRGB)
+{
+    const auto& table = GetLinearToSRGBTable();
+    const unsigned numColorChannels = sRGB ? GetNumColorChannels(components) : 0;
+    unsigned i = 0;
+
+#ifdef SE_CONVERT_SSE2
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    if (!sRGB)
+    {
+        // Quantize 16 channels at a time with the same arithmetic as QuantizeUnorm()
+        const unsigned count = numPixels * components;
+        const __m128 scale = _mm_set1_ps(255.0f);
+        __m128i values[4];
+        for (; i + 16 <= count; i += 16)
+        {
+            for (unsigned j = 0; j < 4; ++j)
+            {
+                const __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + j * 4), zero), one);
+                values[j] = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half));
+            }
+            const __m128i packed = _mm_packus_epi16(_mm_packs_epi32(values[0], values[1]), _mm_packs_epi32(values[2], values[3]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), packed);
+        }
+        for (; i < count; ++i)
+            dest[i] = QuantizeUnorm(src[i]);
+        return;
+    }
+    else if (components == 4)
+    {
+        // Compute the table indices of RGB and the quantized alpha of one pixel at once
+        const __m128 scale = _mm_setr_ps(LinearToSRGBTableSize - 1, LinearToSRGBTableSize - 1, LinearToSRGBTableSize - 1, 255.0f);
+        alignas(16) int indices[4];
+        for (; i < numPixels; ++i)
+        {
+            const __m128 value = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i * 4), zero), one);
+            _mm_store_si128(reinterpret_cast<__m128i*>(indices), _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(value, scale), half)));
+            dest[i * 4] = table[indices[0]];
+            dest[i * 4 + 1] = table[indices[1]];
+            dest[i * 4 + 2] = table[indices[2]];
+            dest[i * 4 + 3] = static_cast<unsigned char>(indices[3]);
+        }
+        return;
+    }
+#endif
+
+    for (; i < numPixels; ++i)
+    {
+        for (unsigned c = 0; c < components; ++c)
+        {
+            const float value = src[i * components + c];
+            if (c < numColorChannels)
+            {
+                const float index = std::clamp(value, 0.0f, 1.0f) * (LinearToSRGBTableSize - 1) + 0.5f;
+                dest[i * components + c] = table[static_cast<unsigned>(index)];
+            }
+            else
+                dest[i * components + c] = QuantizeUnorm(value);
+        }
+    }
+}
+
+void ConvertFloatToRGBE(unsigned char* dest, const float* src, unsigned numPixels, unsigned components)
+{
+    // Keep the shared exponent within a byte
+    const float maxValue = 1e38f;
+
+    for (unsigned i = 0; i < numPixels; ++i, src += components, dest += 4)
+    {
+        float rgb[3];
+        for (unsigned c = 0; c < 3; ++c)
+            rgb[c] = std::clamp(src[components >= 3 ? c : 0], 0.0f, maxValue);
+
+        const float maxComponent = std::max(rgb[0], std::max(rgb[1], rgb[2]));
+        if (maxComponent < 1e-32f)
+        {
+            dest[0] = dest[1] = dest[2] = dest[3] = 0;
+            continue;
+        }
+
+        // Same as frexp(): maxComponent = m * 2^e with m in [0.5, 1). The scale 256 / 2^e is an exact power of two
+        const int exponent = static_cast<int>(FloatToBits(maxComponent) >> 23) - 126;
+        const float scale = BitsToFloat(static_cast<unsigned>(127 + 8 - exponent) << 23);
+        dest[0] = static_cast<unsigned char>(rgb[0] * scale);
+        dest[1] = static_cast<unsigned char>(rgb[1] * scale);
+        dest[2] = static_cast<unsigned char>(rgb[2] * scale);
+        dest[3] = static_cast<unsigned char>(exponent + 128);
+    }
+}
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Se
+{
+
+/// Largest finite half float value.
+static const float HALF_MAX = 65504.0f;
+
+/// Convert floats to half floats with round to nearest even. Values outside the half range are clamped to +-HALF_MAX.
+void ConvertFloatToHalf(uint16_t* dest, const float* src, std::size_t count);
+/// Convert half floats to floats.
+void ConvertHalfToFloat(float* dest, const uint16_t* src, std::size_t count);
+/// Convert 8-bit pixels to float, optionally decoding sRGB color channels to linear. Alpha is always linear.
+void ConvertToFloat(float* dest, const unsigned char* src, unsigned numPixels, unsigned components, bool sRGB);
+/// Convert float pixels to 8-bit with clamping, optionally encoding linear color channels to sRGB. Alpha is always linear.
+void ConvertFromFloat(unsigned char* dest, const float* src, unsigned numPixels, unsigned components, bool sRGB);
+/// Encode linear float pixels to Radiance RGBE. 1 and 2 component pixels are treated as grey, alpha is dropped.
+void ConvertFloatToRGBE(unsigned char* dest, const float* src, unsigned numPixels, unsigned components);
+
+}
@@ -3,11 +3,21 @@
 #include <Se/Algorithms.hpp>
 #include <Se/Console.hpp>
 #include <Se/IO/FileSystem.h>
+#include <Se/Profiler.hpp>
+#include <Se/Thread.h>
+#include <Se/WorkQueue.h>
 
 #include <SeResource/Image.h>
 #include <SeResource/ResourceCache.h>
 #include <SeResource/XMLFile.h>
 
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SE_IMAGECUBE_SSE2
+#endif
+
 #ifdef _MSC_VER
 #pragma warning(disable:4355)
 #endif
@@ -29,6 +39,232 @@ static std::shared_ptr<Image> GetTileImage(Image* src, int tileX, int tileY, int
         src->GetSubimage(IntRect(tileX * tileWidth, tileY * tileHeight, (tileX + 1) * tileWidth, (tileY + 1) * tileHeight)));
 }
 
+/// Number of rows processed by one work item in bulk cube operations.
+static const unsigned CUBE_ROW_BAND = 4;
+
+/// Call back with ranges of rows, in parallel on the WorkQueue when called from the main thread.
+template <class Callback> static void ForEachCubeRow(unsigned numRows, unsigned band, Callback callback)
+{
+    WorkQueue* workQueue = WorkQueue::Get();
+    // Worker threads may only be waited on from the main thread
+    if (Thread::IsMainThread() && workQueue->GetNumThreads())
+        ForEachParallel(workQueue, band, numRows, callback);
+    else if (numRows)
+        callback(0, numRows);
+}
+
+/// Convert image to linear float RGBA. 8-bit images are decoded from sRGB.
+static std::shared_ptr<Image> ConvertToFloatRGBA(const Image* image)
+{
+    std::shared_ptr<Image> decompressed;
+    if (image->IsCompressed())
+    {
+        decompressed = image->GetDecompressedImage();
+        if (!decompressed)
+            return nullptr;
+        image = decompressed.get();
+    }
+
+    auto floats = image->ConvertToChannelFormat(ChannelFormat::Float32, !image->IsHDR());
+    if (!floats || floats->GetComponents() == 4)
+        return floats;
+
+    auto ret = std::make_shared<Image>();
+    ret->SetSize(floats->GetWidth(), floats->GetHeight(), 4, ChannelFormat::Float32);
+    const unsigned components = floats->GetComponents();
+    const unsigned numPixels = floats->GetWidth() * floats->GetHeight();
+    const float* src = reinterpret_cast<const float*>(floats->GetData());
+    float* dest = reinterpret_cast<float*>(ret->GetData());
+    for (unsigned i = 0; i < numPixels; ++i, src += components, dest += 4)
+    {
+        // Luminance is spread to all color channels, 2 component images carry alpha in the second channel
+        dest[0] = src[0];
+        dest[1] = components == 3 ? src[1] : src[0];
+        dest[2] = components == 3 ? src[2] : src[0];
+        dest[3] = components == 2 ? src[1] : 1.0f;
+    }
+    return ret;
+}
+
+/// Convert linear float RGBA image to given channel format. 8-bit images are encoded to sRGB.
+static std::shared_ptr<Image> ConvertFromFloatRGBA(const std::shared_ptr<Image>& image, ChannelFormat format)
+{
+    return format == ChannelFormat::Float32 ? image : image->ConvertToChannelFormat(format, true);
+}
+
+/// Sample float RGBA pixels bilinearly at texel coordinates. Horizontal coordinates wrap if requested and clamp otherwise.
+static void SampleBilinear(float* dest, const float* pixels, int width, int height, float x, float y, bool wrapX)
+{
+    x -= 0.5f;
+    y -= 0.5f;
+    const int left = FloorToInt(x);
+    const int top = FloorToInt(y);
+    const float fx = x - left;
+    const float fy = y - top;
+
+    int x0 = left, x1 = left + 1;
+    if (wrapX)
+    {
+        x0 = (x0 % width + width) % width;
+        x1 = (x1 % width + width) % width;
+    }
+    else
+    {
+        x0 = Clamp(x0, 0, width - 1);
+        x1 = Clamp(x1, 0, width - 1);
+    }
+    const int y0 = Clamp(top, 0, height - 1);
+    const int y1 = Clamp(top + 1, 0, height - 1);
+
+    const float* p00 = pixels + (y0 * width + x0) * 4;
+    const float* p10 = pixels + (y0 * width + x1) * 4;
+    const float* p01 = pixels + (y1 * width + x0) * 4;
+    const float* p11 = pixels + (y1 * width + x1) * 4;
+    for (unsigned i = 0; i < 4; ++i)
+    {
+        const float topValue = p00[i] + (p10[i] - p00[i]) * fx;
+        const float bottomValue = p01[i] + (p11[i] - p01[i]) * fx;
+        dest[i] = topValue + (bottomValue - topValue) * fy;
+    }
+}
+
+/// Return the solid angle subtended by the cube face area from the face center to a point in [-1, 1] face coordinates.
+static float GetFaceAreaElement(float x, float y)
+{
+    return atan2f(x * y, sqrtf(x * x + y * y + 1.0f));
+}
+
+/// Return the solid angle subtended by a cube face texel.
+static float GetTexelSolidAngle(int x, int y, int width)
+{
+    const float scale = 2.0f / width;
+    const float x0 = x * scale - 1.0f;
+    const float y0 = y * scale - 1.0f;
+    const float x1 = x0 + scale;
+    const float y1 = y0 + scale;
+    return GetFaceAreaElement(x0, y0) - GetFaceAreaElement(x0, y1) - GetFaceAreaElement(x1, y0) + GetFaceAreaElement(x1, y1);
+}
+
+/// Return solid angles of all texels of a cube face. They are the same for every face.
+static std::vector<float> GetFaceSolidAngles(int width)
+{
+    std::vector<float> solidAngles(width * width);
+    for (int y = 0; y < width; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+            solidAngles[y * width + x] = GetTexelSolidAngle(x, y, width);
+    }
+    return solidAngles;
+}
+
+/// Return the normalized direction towards the center of a cube face texel.
+static Vector3 GetTexelDirection(CubeMapFace face, int x, int y, int width)
+{
+    return ImageCube::ProjectUVOnCube(face, { (x + 0.5f) / width, (y + 0.5f) / width }).Normalized();
+}
+
+/// Texels of a cube map in structure of arrays layout for convolution. Padded to a multiple of 4 with zero weights.
+struct CubeConvolutionSource
+{
+    /// Directions.
+    std::vector<float> x_, y_, z_;
+    /// Solid angles.
+    std::vector<float> solidAngle_;
+    /// Linear colors.
+    std::vector<float> r_, g_, b_;
+};
+
+/// Fill convolution source from float RGBA faces.
+static void FillConvolutionSource(CubeConvolutionSource& source, const std::vector<std::shared_ptr<Image>>& faces)
+{
+    const int width = faces[0]->GetWidth();
+    const unsigned numTexels = MAX_CUBEMAP_FACES * width * width;
+    const unsigned paddedSize = (numTexels + 3) & ~3u;
+    for (std::vector<float>* values : { &source.x_, &source.y_, &source.z_, &source.solidAngle_, &source.r_, &source.g_, &source.b_ })
+        values->assign(paddedSize, 0.0f);
+
+    const std::vector<float> solidAngles = GetFaceSolidAngles(width);
+    unsigned index = 0;
+    for (unsigned i = 0; i < MAX_CUBEMAP_FACES; ++i)
+    {
+        const float* pixels = reinterpret_cast<const float*>(faces[i]->GetData());
+        for (int y = 0; y < width; ++y)
+        {
+            for (int x = 0; x < width; ++x, ++index, pixels += 4)
+            {
+                const Vector3 direction = GetTexelDirection(static_cast<CubeMapFace>(i), x, y, width);
+                source.x_[index] = direction.x_;
+                source.y_[index] = direction.y_;
+                source.z_[index] = direction.z_;
+                source.solidAngle_[index] = solidAngles[y * width + x];
+                source.r_[index] = pixels[0];
+                source.g_[index] = pixels[1];
+                source.b_[index] = pixels[2];
+            }
+        }
+    }
+}
+
+/// Convolve the source with the GGX lobe around a normal, assuming that the view and reflection directions equal the
+/// normal. Each texel is weighted by D(h) * (n.l) * solid angle; as n.h = sqrt((1 + n.l) / 2), the weight only
+/// depends on n.l. Constant factors of D cancel out in the normalization.
+static void ConvolveGGX(float* dest, const CubeConvolutionSource& source, const Vector3& normal, float alphaSquared)
+{
+    const float k = (alphaSquared - 1.0f) * 0.5f;
+    const unsigned count = static_cast<unsigned>(source.x_.size());
+    float sumWeight = 0.0f, sumR = 0.0f, sumG = 0.0f, sumB = 0.0f;
+    unsigned i = 0;
+
+#ifdef SE_IMAGECUBE_SSE2
+    const __m128 nx = _mm_set1_ps(normal.x_);
+    const __m128 ny = _mm_set1_ps(normal.y_);
+    const __m128 nz = _mm_set1_ps(normal.z_);
+    const __m128 kk = _mm_set1_ps(k);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 zero = _mm_setzero_ps();
+    __m128 accWeight = zero, accR = zero, accG = zero, accB = zero;
+    for (; i < count; i += 4)
+    {
+        __m128 cosine = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, _mm_loadu_ps(&source.x_[i])),
+            _mm_mul_ps(ny, _mm_loadu_ps(&source.y_[i]))), _mm_mul_ps(nz, _mm_loadu_ps(&source.z_[i])));
+        cosine = _mm_max_ps(cosine, zero);
+        const __m128 t = _mm_add_ps(_mm_mul_ps(_mm_add_ps(one, cosine), kk), one);
+        const __m128 weight = _mm_div_ps(_mm_mul_ps(cosine, _mm_loadu_ps(&source.solidAngle_[i])), _mm_mul_ps(t, t));
+        accWeight = _mm_add_ps(accWeight, weight);
+        accR = _mm_add_ps(accR, _mm_mul_ps(weight, _mm_loadu_ps(&source.r_[i])));
+        accG = _mm_add_ps(accG, _mm_mul_ps(weight, _mm_loadu_ps(&source.g_[i])));
+        accB = _mm_add_ps(accB, _mm_mul_ps(weight, _mm_loadu_ps(&source.b_[i])));
+    }
+
+    alignas(16) float sums[4][4];
+    _mm_store_ps(sums[0], accWeight);
+    _mm_store_ps(sums[1], accR);
+    _mm_store_ps(sums[2], accG);
+    _mm_store_ps(sums[3], accB);
+    sumWeight = (sums[0][0] + sums[0][1]) + (sums[0][2] + sums[0][3]);
+    sumR = (sums[1][0] + sums[1][1]) + (sums[1][2] + sums[1][3]);
+    sumG = (sums[2][0] + sums[2][1]) + (sums[2][2] + sums[2][3]);
+    sumB = (sums[3][0] + sums[3][1]) + (sums[3][2] + sums[3][3]);
+#endif
+
+    for (; i < count; ++i)
+    {
+        const float cosine = Max(normal.x_ * source.x_[i] + normal.y_ * source.y_[i] + normal.z_ * source.z_[i], 0.0f);
+        const float t = (1.0f + cosine) * k + 1.0f;
+        const float weight = cosine * source.solidAngle_[i] / (t * t);
+        sumWeight += weight;
+        sumR += weight * source.r_[i];
+        sumG += weight * source.g_[i];
+        sumB += weight * source.b_[i];
+    }
+
+    const float invWeight = sumWeight > 0.0f ? 1.0f / sumWeight : 0.0f;
+    dest[0] = sumR * invWeight;
+    dest[1] = sumG * invWeight;
+    dest[2] = sumB * invWeight;
+    dest[3] = 1.0f;
+}
+
 ImageCube::ImageCube() : Resource("ImageCube") {}
 
 ImageCube::~ImageCube() = default;
@@ -188,7 +424,77 @@ bool ImageCube::BeginLoad(Deserializer& source)
         }
     }
 
-    // Calculate width and memory use
+    return UpdateFaceSize();
+}
+
+bool ImageCube::SetFaceImages(const std::vector<std::shared_ptr<Image>>& faces)
+{
+    if (faces.size() != MAX_CUBEMAP_FACES)
+    {
+        SE_LOG_ERROR("Cube map must have {} faces", (unsigned)MAX_CUBEMAP_FACES);
+        return false;
+    }
+
+    faceImages_ = faces;
+    if (!UpdateFaceSize())
+    {
+        SE_LOG_ERROR("Cube map faces must be square and of the same size");
+        return false;
+    }
+    return true;
+}
+
+bool ImageCube::SetEquirectangular(const Image* image, int width, ChannelFormat format)
+{
+    SE_PROFILE("ConvertEquirectangularToCube");
+
+    if (!image || width <= 0)
+    {
+        SE_LOG_ERROR("Can not convert empty equirectangular image to cube map");
+        return false;
+    }
+
+    auto source = ConvertToFloatRGBA(image);
+    if (!source)
+    {
+        SE_LOG_ERROR("Can not convert equirectangular image to cube map");
+        return false;
+    }
+
+    std::vector<std::shared_ptr<Image>> faces(MAX_CUBEMAP_FACES);
+    for (std::shared_ptr<Image>& face : faces)
+    {
+        face = std::make_shared<Image>();
+        face->SetSize(width, width, 4, ChannelFormat::Float32);
+    }
+
+    const int sourceWidth = source->GetWidth();
+    const int sourceHeight = source->GetHeight();
+    const float* sourcePixels = reinterpret_cast<const float*>(source->GetData());
+    ForEachCubeRow(MAX_CUBEMAP_FACES * width, CUBE_ROW_BAND, [&](unsigned beginRow, unsigned endRow)
+    {
+        for (unsigned row = beginRow; row < endRow; ++row)
+        {
+            const auto face = static_cast<CubeMapFace>(row / width);
+            const int y = row % width;
+            float* dest = reinterpret_cast<float*>(faces[face]->GetData()) + y * width * 4;
+            for (int x = 0; x < width; ++x, dest += 4)
+            {
+                const Vector3 direction = GetTexelDirection(face, x, y, width);
+                const float u = atan2f(direction.x_, direction.z_) / M_PI2 + 0.5f;
+                const float v = 0.5f - asinf(Clamp(direction.y_, -1.0f, 1.0f)) / M_PI;
+                SampleBilinear(dest, sourcePixels, sourceWidth, sourceHeight, u * sourceWidth, v * sourceHeight, true);
+            }
+        }
+    });
+
+    for (std::shared_ptr<Image>& face : faces)
+        face = ConvertFromFloatRGBA(face, format);
+    return SetFaceImages(faces);
+}
+
+bool ImageCube::UpdateFaceSize()
+{
     unsigned memoryUse = 0;
     width_ = 0;
     for (unsigned i = 0; i < faceImages_.size(); ++i)
@@ -210,6 +516,21 @@ bool ImageCube::BeginLoad(Deserializer& source)
     return true;
 }
 
+bool ImageCube::GetFloatFaces(std::vector<std::shared_ptr<Image>>& faces) const
+{
+    faces.resize(MAX_CUBEMAP_FACES);
+    for (unsigned i = 0; i < MAX_CUBEMAP_FACES; ++i)
+    {
+        faces[i] = i < faceImages_.size() && faceImages_[i] ? ConvertToFloatRGBA(faceImages_[i].get()) : nullptr;
+        if (!faces[i])
+        {
+            SE_LOG_ERROR("Cube map {} is missing face {}", GetName(), i);
+            return false;
+        }
+    }
+    return true;
+}
+
 std::shared_ptr<ImageCube> ImageCube::GetDecompressedImageLevel(unsigned index) const
 {
     auto copy = std::make_shared<ImageCube>();
@@ -232,6 +553,164 @@ std::shared_ptr<ImageCube> ImageCube::GetDecompressedImage() const
     return GetDecompressedImageLevel(0);
 }
 
+std::shared_ptr<Image> ImageCube::GetEquirectangular(int width, ChannelFormat format) const
+{
+    SE_PROFILE("ConvertCubeToEquirectangular");
+
+    std::vector<std::shared_ptr<Image>> faces;
+    if (width < 2 || !GetFloatFaces(faces))
+        return nullptr;
+
+    const int height = width / 2;
+    auto ret = std::make_shared<Image>();
+    ret->SetSize(width, height, 4, ChannelFormat::Float32);
+    ForEachCubeRow(height, CUBE_ROW_BAND, [&](unsigned beginRow, unsigned endRow)
+    {
+        for (unsigned y = beginRow; y < endRow; ++y)
+        {
+            const float latitude = (0.5f - (y + 0.5f) / height) * M_PI;
+            float* dest = reinterpret_cast<float*>(ret->GetData()) + y * width * 4;
+            for (int x = 0; x < width; ++x, dest += 4)
+            {
+                const float longitude = ((x + 0.5f) / width - 0.5f) * M_PI2;
+                const Vector3 direction(cosf(latitude) * sinf(longitude), sinf(latitude), cosf(latitude) * cosf(longitude));
+                const auto faceUV = ProjectDirectionOnFace(direction);
+                const float* pixels = reinterpret_cast<const float*>(faces[faceUV.first]->GetData());
+                SampleBilinear(dest, pixels, width_, width_, faceUV.second.x_ * width_, faceUV.second.y_ * width_, false);
+            }
+        }
+    });
+
+    return ConvertFromFloatRGBA(ret, format);
+}
+
+std::array<Vector3, 9> ImageCube::ProjectSphericalHarmonics9() const
+{
+    SE_PROFILE("ProjectCubeSH9");
+
+    std::array<Vector3, 9> result;
+    result.fill(Vector3::ZERO);
+
+    std::vector<std::shared_ptr<Image>> faces;
+    if (!GetFloatFaces(faces))
+        return result;
+
+    // Sum rows separately and add them up in order, so the result does not depend on the number of threads
+    const std::vector<float> solidAngles = GetFaceSolidAngles(width_);
+    std::vector<std::array<Vector3, 9>> rowSums(MAX_CUBEMAP_FACES * width_);
+    ForEachCubeRow(MAX_CUBEMAP_FACES * width_, CUBE_ROW_BAND, [&](unsigned beginRow, unsigned endRow)
+    {
+        for (unsigned row = beginRow; row < endRow; ++row)
+        {
+            const auto face = static_cast<CubeMapFace>(row / width_);
+            const int y = row % width_;
+            const float* pixels = reinterpret_cast<const float*>(faces[face]->GetData()) + y * width_ * 4;
+            float sums[9][3] = {};
+            for (int x = 0; x < width_; ++x, pixels += 4)
+            {
+                const Vector3 d = GetTexelDirection(face, x, y, width_);
+                const float solidAngle = solidAngles[y * width_ + x];
+                const float basis[9] = {
+                    0.282095f,
+                    0.488603f * d.y_,
+                    0.488603f * d.z_,
+                    0.488603f * d.x_,
+                    1.092548f * d.x_ * d.y_,
+                    1.092548f * d.y_ * d.z_,
+                    0.315392f * (3.0f * d.z_ * d.z_ - 1.0f),
+                    1.092548f * d.x_ * d.z_,
+                    0.546274f * (d.x_ * d.x_ - d.y_ * d.y_)
+                };
+                for (unsigned i = 0; i < 9; ++i)
+                {
+                    const float weight = basis[i] * solidAngle;
+                    sums[i][0] += pixels[0] * weight;
+                    sums[i][1] += pixels[1] * weight;
+                    sums[i][2] += pixels[2] * weight;
+                }
+            }
+            for (unsigned i = 0; i < 9; ++i)
+                rowSums[row][i] = Vector3(sums[i][0], sums[i][1], sums[i][2]);
+        }
+    });
+
+    for (const auto& rowSum : rowSums)
+    {
+        for (unsigned i = 0; i < 9; ++i)
+            result[i] += rowSum[i];
+    }
+    return result;
+}
+
+std::vector<std::shared_ptr<ImageCube>> ImageCube::GeneratePrefilteredGGX(unsigned numLevels, ChannelFormat format,
+    int maxSourceWidth) const
+{
+    SE_PROFILE("PrefilterCubeGGX");
+
+    std::vector<std::shared_ptr<ImageCube>> levels;
+    std::vector<std::shared_ptr<Image>> faces;
+    if (!numLevels || !GetFloatFaces(faces))
+        return levels;
+    numLevels = Min(numLevels, LogBaseTwo(width_) + 1);
+
+    std::vector<std::shared_ptr<Image>> levelFaces(MAX_CUBEMAP_FACES);
+    for (unsigned i = 0; i < MAX_CUBEMAP_FACES; ++i)
+        levelFaces[i] = ConvertFromFloatRGBA(faces[i], format);
+    levels.push_back(std::make_shared<ImageCube>());
+    if (!levels.back()->SetFaceImages(levelFaces))
+        return {};
+    if (numLevels == 1)
+        return levels;
+
+    // Rough levels share one box-filtered source
+    const int sourceWidth = Clamp(maxSourceWidth, 1, width_);
+    std::vector<std::shared_ptr<Image>> sourceFaces(MAX_CUBEMAP_FACES);
+    for (unsigned i = 0; i < MAX_CUBEMAP_FACES; ++i)
+    {
+        sourceFaces[i] = faces[i];
+        if (sourceWidth != width_)
+        {
+            sourceFaces[i] = faces[i]->ConvertToChannelFormat(ChannelFormat::Float32);
+            if (!sourceFaces[i] || !sourceFaces[i]->Resize(sourceWidth, sourceWidth, ResizeFilter::Box))
+                return {};
+        }
+    }
+    CubeConvolutionSource source;
+    FillConvolutionSource(source, sourceFaces);
+
+    for (unsigned level = 1; level < numLevels; ++level)
+    {
+        const int width = Max(width_ >> level, 1);
+        const float roughness = static_cast<float>(level) / (numLevels - 1);
+        const float alpha = roughness * roughness;
+        for (std::shared_ptr<Image>& face : levelFaces)
+        {
+            face = std::make_shared<Image>();
+            face->SetSize(width, width, 4, ChannelFormat::Float32);
+        }
+
+        ForEachCubeRow(MAX_CUBEMAP_FACES * width, 1, [&](unsigned beginRow, unsigned endRow)
+        {
+            for (unsigned row = beginRow; row < endRow; ++row)
+            {
+                const auto face = static_cast<CubeMapFace>(row / width);
+                const int y = row % width;
+                float* dest = reinterpret_cast<float*>(levelFaces[face]->GetData()) + y * width * 4;
+                for (int x = 0; x < width; ++x, dest += 4)
+                    ConvolveGGX(dest, source, GetTexelDirection(face, x, y, width), alpha * alpha);
+            }
+        });
+
+        for (std::shared_ptr<Image>& face : levelFaces)
+            face = ConvertFromFloatRGBA(face, format);
+        levels.push_back(std::make_shared<ImageCube>());
+        if (!levels.back()->SetFaceImages(levelFaces))
+            return {};
+    }
+
+    return levels;
+}
+
 Color ImageCube::SampleNearest(const Vector3& direction) const
 {
     const auto projection = ProjectDirectionOnFaceTexel(direction);
@@ -264,6 +743,8 @@ SphericalHarmonicsColor9 ImageCube::CalculateSphericalHarmonics() const
         const unsigned bestLevel = GetSphericalHarmonicsMipLevel();
         const unsigned bestLevelWidth = width_ >> bestLevel;
         auto decompressedImage = faceImage->GetDecompressedImageLevel(bestLevel);
+        if (!decompressedImage)
+            continue;
 
         for (int y = 0; y < bestLevelWidth; ++y)
         {
@@ -303,8 +784,8 @@ std::pair<CubeMapFace, IntVector2> ImageCube::ProjectDirectionOnFaceTexel(const
 {
     const auto faceUV = ProjectDirectionOnFace(direction);
     const Vector2& uv = faceUV.second;
-    const int x = Clamp(FloorToInt(uv.x_ * width_), 0, width_);
-    const int y = Clamp(FloorToInt(uv.y_ * width_), 0, width_);
+    const int x = Clamp(FloorToInt(uv.x_ * width_), 0, width_ - 1);
+    const int y = Clamp(FloorToInt(uv.y_ * width_), 0, width_ - 1);
     return { faceUV.first, { x, y } };
 }
 
@@ -332,21 +813,33 @@ std::pair<CubeMapFace, Vector2> ImageCube::ProjectDirectionOnFace(const Vector3&
     const float y = direction.y_;
     const float z = direction.z_;
 
-    auto testAxis = [](float axis, float a, float b) { return 2 * axis + M_LARGE_EPSILON > Abs(a) + Abs(b); };
+    const float absX = Abs(x);
+    const float absY = Abs(y);
+    const float absZ = Abs(z);
 
+    // Project on the face of the dominant axis
     std::pair<CubeMapFace, Vector2> result;
-    if (testAxis(x, y, z))
-        result = { FACE_POSITIVE_X, { -z /  x, -y /  x } }; // x =  1, y = -v, z = -u
-    else if (testAxis(-x, y, z))
-        result = { FACE_NEGATIVE_X, {  z / -x, -y / -x } }; // x = -1, y = -v, z =  u
-    else if (testAxis(y, x, z))
-        result = { FACE_POSITIVE_Y, {  x /  y,  z /  y } }; // x =  u, y =  1, z =  v
-    else if (testAxis(-y, x, z))
-        result = { FACE_NEGATIVE_Y, {  x / -y, -z / -y } }; // x =  u, y = -1, z = -v
-    else if (testAxis(z, x, y))
-        result = { FACE_POSITIVE_Z, {  x /  y, -y /  z } }; // x =  u, y = -v, z =  1
-    else // if (testAxis(-z, x, y))
-        result = { FACE_NEGATIVE_Z, { -x / -y, -y / -z } }; // x = -u, y = -v, z = -1
+    if (absX >= absY && absX >= absZ)
+    {
+        if (x >= 0.0f)
+            result = { FACE_POSITIVE_X, { -z /  x, -y /  x } }; // x =  1, y = -v, z = -u
+        else
+            result = { FACE_NEGATIVE_X, {  z / -x, -y / -x } }; // x = -1, y = -v, z =  u
+    }
+    else if (absY >= absZ)
+    {
+        if (y >= 0.0f)
+            result = { FACE_POSITIVE_Y, {  x /  y,  z /  y } }; // x =  u, y =  1, z =  v
+        else
+            result = { FACE_NEGATIVE_Y, {  x / -y, -z / -y } }; // x =  u, y = -1, z = -v
+    }
+    else
+    {
+        if (z >= 0.0f)
+            result = { FACE_POSITIVE_Z, {  x /  z, -y /  z } }; // x =  u, y = -v, z =  1
+        else
+            result = { FACE_NEGATIVE_Z, { -x / -z, -y / -z } }; // x = -u, y = -v, z = -1
+    }
 
     // Convert from [-1, 1] to [0, 1]
     result.second.x_ = result.second.x_ * 0.5f + 0.5f;
@@ -0,0 +1,333 @@
+#include "ImageMip.h"
+#include "ImageConvert.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SE_MIP_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SE_MIP_NEON
+#endif
+
+namespace Se
+{
+
+namespace
+{
+
+/// Kaiser window half-width in destination pixels.
+constexpr float KaiserWidth = 3.0f;
+/// Kaiser window shape parameter.
+constexpr float KaiserAlpha = 4.0f;
+
+float Bessel0(float x)
+{
+    // Power series of the modified Bessel function of the first kind, order zero
+    float sum = 1.0f;
+    float term = 1.0f;
+    for (int k = 1; k < 32; ++k)
+    {
+        const float factor = x / (2.0f * k);
+        term *= factor * factor;
+        sum += term;
+        if (term < sum * 1e-7f)
+            break;
+    }
+    return sum;
+}
+
+float Sinc(float x)
+{
+    if (std::abs(x) < 1e-5f)
+        return 1.0f;
+    const float pix = 3.14159265358979f * x;
+    return std::sin(pix) / pix;
+}
+
+MipFilterKernel CreateKernel(MipFilter filter)
+{
+    MipFilterKernel kernel;
+    if (filter == MipFilter::Box)
+    {
+        kernel.firstOffset_ = 0;
+        kernel.weights_ = { 0.5f, 0.5f };
+        return kernel;
+    }
+
+    // Destination pixel x covers source pixels 2x and 2x+1, so its center is at source 2x+0.5
+    const int radius = static_cast<int>(KaiserWidth * 2.0f);
+    kernel.firstOffset_ = 1 - radius;
+    float sum = 0.0f;
+    for (int offset = kernel.firstOffset_; offset <= radius; ++offset)
+    {
+        const float x = (offset - 0.5f) * 0.5f;
+        const float t = x / KaiserWidth;
+        const float window = t * t < 1.0f ? Bessel0(KaiserAlpha * std::sqrt(1.0f - t * t)) / Bessel0(KaiserAlpha) : 0.0f;
+        const float weight = Sinc(x) * window;
+        kernel.weights_.push_back(weight);
+        sum += weight;
+    }
+    for (float& weight : kernel.weights_)
+        weight /= sum;
+    return kernel;
+}
+
+#ifdef SE_MIP_SSE2
+/// Average 4 RGBA pixels from each of 8 upper and lower source pixels. Same rounding as the scalar path.
+inline void DownsampleBoxRGBA4(unsigned char* out, const unsigned char* upper, const unsigned char* lower)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i result[2];
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        const __m128i u = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upper + i * 16));
+        const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lower + i * 16));
+        // Vertical sums of pixels 0-1 and 2-3 as 16-bit lanes
+        const __m128i sumLo = _mm_add_epi16(_mm_unpacklo_epi8(u, zero), _mm_unpacklo_epi8(l, zero));
+        const __m128i sumHi = _mm_add_epi16(_mm_unpackhi_epi8(u, zero), _mm_unpackhi_epi8(l, zero));
+        // Horizontal sums of neighbouring pixels
+        const __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(sumLo, sumHi), _mm_unpackhi_epi64(sumLo, sumHi));
+        result[i] = _mm_srli_epi16(sum, 2);
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(result[0], result[1]));
+}
+#elif defined(SE_MIP_NEON)
+/// Average 4 RGBA pixels from each of 8 upper and lower source pixels. Same rounding as the scalar path.
+inline void DownsampleBoxRGBA4(unsigned char* out, const unsigned char* upper, const unsigned char* lower)
+{
+    uint8x8_t result[2];
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        const uint8x16_t u = vld1q_u8(upper + i * 16);
+        const uint8x16_t l = vld1q_u8(lower + i * 16);
+        const uint16x8_t sumLo = vaddl_u8(vget_low_u8(u), vget_low_u8(l));
+        const uint16x8_t sumHi = vaddl_u8(vget_high_u8(u), vget_high_u8(l));
+        const uint16x8_t sum = vaddq_u16(vcombine_u16(vget_low_u16(sumLo), vget_low_u16(sumHi)),
+            vcombine_u16(vget_high_u16(sumLo), vget_high_u16(sumHi)));
+        result[i] = vshrn_n_u16(sum, 2);
+    }
+    vst1q_u8(out, vcombine_u8(result[0], result[1]));
+}
+#endif
+
+/// Box filter a row from x on. Source pixels 2x and 2x+1 must both exist.
+template <unsigned C>
+void DownsampleBoxRow(unsigned char* out, const unsigned char* upper, const unsigned char* lower, int x, int destWidth)
+{
+    for (; x < destWidth; ++x)
+    {
+        const unsigned char* u = upper + x * 2 * C;
+        const unsigned char* l = lower + x * 2 * C;
+        for (unsigned c = 0; c < C; ++c)
+            out[x * C + c] = static_cast<unsigned char>(((unsigned)u[c] + u[c + C] + l[c] + l[c + C]) >> 2);
+    }
+}
+
+/// Filter one row horizontally. Pixels whose taps are all inside the row skip edge clamping.
+template <unsigned C>
+void FilterRowHorizontal(float* out, const float* in, int destWidth, int srcWidth, const MipFilterKernel& kernel)
+{
+    const int numTaps = static_cast<int>(kernel.weights_.size());
+    const float* weights = kernel.weights_.data();
+
+    // Interior range [interiorBegin, interiorEnd) where 0 <= 2x + firstOffset and 2x + firstOffset + numTaps <= srcWidth
+    const int interiorBegin = std::min(std::max((1 - kernel.firstOffset_) / 2, 0), destWidth);
+    const int lastInterior = srcWidth - numTaps - kernel.firstOffset_;
+    const int interiorEnd = std::max(std::min(lastInterior >= 0 ? lastInterior / 2 + 1 : 0, destWidth), interiorBegin);
+
+    auto filterClamped = [&](int x)
+    {
+        float sum[C]{};
+        const int first = x * 2 + kernel.firstOffset_;
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            const float* pixel = in + std::clamp(first + tap, 0, srcWidth - 1) * C;
+            for (unsigned c = 0; c < C; ++c)
+                sum[c] += pixel[c] * weights[tap];
+        }
+        for (unsigned c = 0; c < C; ++c)
+            out[x * C + c] = sum[c];
+    };
+
+    for (int x = 0; x < interiorBegin; ++x)
+        filterClamped(x);
+    for (int x = interiorBegin; x < interiorEnd; ++x)
+    {
+        float sum[C]{};
+        const float* pixel = in + (x * 2 + kernel.firstOffset_) * C;
+        for (int tap = 0; tap < numTaps; ++tap, pixel += C)
+        {
+            for (unsigned c = 0; c < C; ++c)
+                sum[c] += pixel[c] * weights[tap];
+        }
+        for (unsigned c = 0; c < C; ++c)
+            out[x * C + c] = sum[c];
+    }
+    for (int x = interiorEnd; x < destWidth; ++x)
+        filterClamped(x);
+}
+
+/// Downsample a band of output rows into destFloat. sourceRow(y, buffer) returns source row y as float, storeRow(y, row)
+/// receives each finished output row.
+template <class SourceRow, class StoreRow>
+void DownsampleSeparableImpl(float* destFloat, int destWidth, int srcWidth, int srcHeight, unsigned components,
+    const MipFilterKernel& kernel, int beginRow, int endRow, SourceRow sourceRow, StoreRow storeRow)
+{
+    const int numTaps = static_cast<int>(kernel.weights_.size());
+    const unsigned srcStride = srcWidth * components;
+    const unsigned destStride = destWidth * components;
+
+    // Source rows touched by this band of output rows
+    const int firstRow = std::max(beginRow * 2 + kernel.firstOffset_, 0);
+    const int lastRow = std::min((endRow - 1) * 2 + kernel.firstOffset_ + numTaps - 1, srcHeight - 1);
+
+    // Horizontal pass into the band-local buffer
+    std::vector<float> rowBuffer(srcStride);
+    std::vector<float> band((lastRow - firstRow + 1) * destStride);
+    for (int y = firstRow; y <= lastRow; ++y)
+    {
+        const float* in = sourceRow(y, rowBuffer.data());
+        float* out = &band[(y - firstRow) * destStride];
+
+        switch (components)
+        {
+        case 1: FilterRowHorizontal<1>(out, in, destWidth, srcWidth, kernel); break;
+        case 2: FilterRowHorizontal<2>(out, in, destWidth, srcWidth, kernel); break;
+        case 3: FilterRowHorizontal<3>(out, in, destWidth, srcWidth, kernel); break;
+        default: FilterRowHorizontal<4>(out, in, destWidth, srcWidth, kernel); break;
+        }
+    }
+
+    // Vertical pass, accumulating whole rows to keep the inner loop contiguous
+    for (int y = beginRow; y < endRow; ++y)
+    {
+        float* out = destFloat + y * destStride;
+        const int first = y * 2 + kernel.firstOffset_;
+        for (int tap = 0; tap < numTaps; ++tap)
+        {
+            const float* in = &band[(std::clamp(first + tap, 0, srcHeight - 1) - firstRow) * destStride];
+            const float weight = kernel.weights_[tap];
+            if (tap == 0)
+            {
+                for (unsigned i = 0; i < destStride; ++i)
+                    out[i] = in[i] * weight;
+            }
+            else
+            {
+                for (unsigned i = 0; i < destStride; ++i)
+                    out[i] += in[i] * weight;
+            }
+        }
+
+        storeRow(y, out);
+    }
+}
+
+}
+
+const MipFilterKernel& GetMipFilterKernel(MipFilter filter)
+{
+    static const MipFilterKernel boxKernel = CreateKernel(MipFilter::Box);
+    static const MipFilterKernel kaiserKernel = CreateKernel(MipFilter::Kaiser);
+    return filter == MipFilter::Kaiser ? kaiserKernel : boxKernel;
+}
+
+void DownsampleBox(unsigned char* dest, int destWidth, const unsigned char* src, int srcWidth, int srcHeight,
+    unsigned components, int beginRow, int endRow)
+{
+    const unsigned srcStride = srcWidth * components;
+    const unsigned destStride = destWidth * components;
+
+    for (int y = beginRow; y < endRow; ++y)
+    {
+        const unsigned char* upper = src + std::min(y * 2, srcHeight - 1) * srcStride;
+        const unsigned char* lower = src + std::min(y * 2 + 1, srcHeight - 1) * srcStride;
+        unsigned char* out = dest + y * destStride;
+
+        // A 1 pixel wide source averages the same pixel twice
+        if (srcWidth < 2)
+        {
+            for (unsigned c = 0; c < components; ++c)
+                out[c] = static_cast<unsigned char>(((unsigned)upper[c] + upper[c] + lower[c] + lower[c]) >> 2);
+            continue;
+        }
+
+        // Source pixels 2x and 2x+1 always exist otherwise
+        int x = 0;
+        switch (components)
+        {
+        case 1:
+            DownsampleBoxRow<1>(out, upper, lower, x, destWidth);
+            break;
+        case 2:
+            DownsampleBoxRow<2>(out, upper, lower, x, destWidth);
+            break;
+        case 3:
+            DownsampleBoxRow<3>(out, upper, lower, x, destWidth);
+            break;
+        default:
+#if defined(SE_MIP_SSE2) || defined(SE_MIP_NEON)
+            for (; x + 4 <= destWidth; x += 4)
+                DownsampleBoxRGBA4(out + x * 4, upper + x * 8, lower + x * 8);
+#endif
+            DownsampleBoxRow<4>(out, upper, lower, x, destWidth);
+            break;
+        }
+    }
+}
+
+void DownsampleSeparable(float* destFloat, unsigned char* dest, int destWidth, const unsigned char* src, int srcWidth,
+    int srcHeight, unsigned components, const MipFilterKernel& kernel, bool gammaCorrect, int beginRow, int endRow)
+{
+    const unsigned destStride = destWidth * components;
+    DownsampleSeparableImpl(destFloat, destWidth, srcWidth, srcHeight, components, kernel, beginRow, endRow,
+        [&](int y, float* buffer)
+    {
+        ConvertToFloat(buffer, src + y * srcWidth * components, srcWidth, components, gammaCorrect);
+        return buffer;
+    },
+        [&](int y, const float* row) { ConvertFromFloat(dest + y * destStride, row, destWidth, components, gammaCorrect); });
+}
+
+void DownsampleSeparable(float* destFloat, unsigned char* dest, int destWidth, const float* src, int srcWidth,
+    int srcHeight, unsigned components, const MipFilterKernel& kernel, bool gammaCorrect, int beginRow, int endRow)
+{
+    const unsigned destStride = destWidth * components;
+    DownsampleSeparableImpl(destFloat, destWidth, srcWidth, srcHeight, components, kernel, beginRow, endRow,
+        [&](int y, float*) { return src + y * srcWidth * components; },
+        [&](int y, const float* row) { ConvertFromFloat(dest + y * destStride, row, destWidth, components, gammaCorrect); });
+}
+
+void DownsampleSeparable(float* dest, int destWidth, const float* src, int srcWidth, int srcHeight, unsigned components,
+    const MipFilterKernel& kernel, int beginRow, int endRow)
+{
+    DownsampleSeparableImpl(dest, destWidth, srcWidth, srcHeight, components, kernel, beginRow, endRow,
+        [&](int y, float*) { return src + y * srcWidth * components; }, [](int, const float*) {});
+}
+
+void DownsampleSeparable(float* destFloat, uint16_t* dest, int destWidth, const uint16_t* src, int srcWidth,
+    int srcHeight, unsigned components, const MipFilterKernel& kernel, int beginRow, int endRow)
+{
+    const unsigned destStride = destWidth * components;
+    DownsampleSeparableImpl(destFloat, destWidth, srcWidth, srcHeight, components, kernel, beginRow, endRow,
+        [&](int y, float* buffer)
+    {
+        ConvertHalfToFloat(buffer, src + y * srcWidth * components, srcWidth * components);
+        return buffer;
+    },
+        [&](int y, const float* row) { ConvertFloatToHalf(dest + y * destStride, row, destStride); });
+}
+
+void DownsampleSeparable(float* destFloat, uint16_t* dest, int destWidth, const float* src, int srcWidth,
+    int srcHeight, unsigned components, const MipFilterKernel& kernel, int beginRow, int endRow)
+{
+    const unsigned destStride = destWidth * components;
+    DownsampleSeparableImpl(destFloat, destWidth, srcWidth, srcHeight, components, kernel, beginRow, endRow,
+        [&](int y, float*) { return src + y * srcWidth * components; },
+        [&](int y, const float* row) { ConvertFloatToHalf(dest + y * destStride, row, destStride); });
+}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SeResource/Image.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace Se
+{
+
+/// Separable downsampling kernel for halving an image dimension.
+struct MipFilterKernel
+{
+    /// Source offset of the first tap relative to twice the destination coordinate.
+    int firstOffset_{};
+    /// Normalized tap weights.
+    std::vector<float> weights_;
+};
+
+/// Return the downsampling kernel of a mip filter.
+const MipFilterKernel& GetMipFilterKernel(MipFilter filter);
+
+/// Downsample output rows [beginRow, endRow) of an 8-bit 2D image by two with a 2x2 box filter. Edges are clamped, so 1-pixel wide or high sources are supported.
+void DownsampleBox(unsigned char* dest, int destWidth, const unsigned char* src, int srcWidth, int srcHeight,
+    unsigned components, int beginRow, int endRow);
+/// Downsample output rows [beginRow, endRow) of an 8-bit 2D image by two with a separable kernel, optionally in linear space. The source rows needed by the band are filtered horizontally into a band-local buffer first, so memory use does not grow with image size. Writes both the unquantized float result and the 8-bit result.
+void DownsampleSeparable(float* destFloat, unsigned char* dest, int destWidth, const unsigned char* src, int srcWidth,
+    int srcHeight, unsigned components, const MipFilterKernel& kernel, bool gammaCorrect, int beginRow, int endRow);
+/// Downsample output rows [beginRow, endRow) of an unquantized float 2D image by two with a separable kernel. Writes both the float result and the 8-bit result.
+void DownsampleSeparable(float* destFloat, unsigned char* dest, int destWidth, const float* src, int srcWidth,
+    int srcHeight, unsigned components, const MipFilterKernel& kernel, bool gammaCorrect, int beginRow, int endRow);
+/// Downsample output rows [beginRow, endRow) of a float 2D image by two with a separable kernel.
+void DownsampleSeparable(float* dest, int destWidth, const float* src, int srcWidth, int srcHeight, unsigned components,
+    const MipFilterKernel& kernel, int beginRow, int endRow);
+/// Downsample output rows [beginRow, endRow) of a half float 2D image by two with a separable kernel. Writes both the float result and the half result.
+void DownsampleSeparable(float* destFloat, uint16_t* dest, int destWidth, const uint16_t* src, int srcWidth,
+    int srcHeight, unsigned components, const MipFilterKernel& kernel, int beginRow, int endRow);
+/// Downsample output rows [beginRow, endRow) of an unquantized float 2D image by two into half floats with a separable kernel. Writes both the float result and the half result.
+void DownsampleSeparable(float* destFloat, uint16_t* dest, int destWidth, const float* src, int srcWidth,
+    int srcHeight, unsigned components, const MipFilterKernel& kernel, int beginRow, int endRow);
+
+}
@@ -3,12 +3,16 @@
 #include <Se/Console.hpp>
 #include <Se/IO/File.h>
 #include <Se/IO/FileSystem.h>
+#include <Se/Profiler.hpp>
+#include <Se/Thread.h>
+#include <Se/WorkQueue.h>
 
 #define NANOSVG_IMPLEMENTATION
 #include "nanosvg/nanosvg.h"
 #define NANOSVGRAST_IMPLEMENTATION
 #include "nanosvg/nanosvgrast.h"
 
+#include <atomic>
 #include <vector>
 #include <string>
 #include <memory>
@@ -16,39 +20,168 @@
 namespace Se
 {
 
+/// Minimum number of output pixels to rasterize in row bands.
+static const unsigned MIN_BANDED_SVG_PIXELS = 256 * 256;
+/// Number of rows in a band.
+static const unsigned SVG_RASTER_BAND = 64;
+
+/// Rasterize the document scaled to the destination width. Scanlines are independent in nanosvg, so large outputs are rendered
+/// in fixed row bands with separate rasterizers. Edge positions are stepped from the first row of each band, so the
+/// bands are the same whether they run in parallel or not and the result does not depend on the number of threads.
+static bool RasterizeDocument(NSVGimage* document, unsigned char* dest, int width, int height)
+{
+    SE_PROFILE("RasterizeSVG");
+
+    const float scale = width / document->width;
+    const int stride = width * 4;
+    const unsigned band = (unsigned)(width * height) < MIN_BANDED_SVG_PIXELS ? static_cast<unsigned>(height) : SVG_RASTER_BAND;
+    std::atomic<bool> success{true};
+    auto rasterizeBands = [&](unsigned beginRow, unsigned endRow)
+    {
+        NSVGrasterizer* rast = nsvgCreateRasterizer();
+        if (rast == nullptr)
+        {
+            success = false;
+            return;
+        }
+        for (unsigned row = beginRow; row < endRow; row += band)
+        {
+            const unsigned numRows = Min(band, endRow - row);
+            nsvgRasterize(rast, document, 0, -static_cast<float>(row), scale, dest + row * stride, width, numRows, stride);
+        }
+        nsvgDeleteRasterizer(rast);
+    };
+
+    WorkQueue* workQueue = WorkQueue::Get();
+    // Worker threads may only be waited on from the main thread
+    if (Thread::IsMainThread() && workQueue->GetNumThreads())
+        ForEachParallel(workQueue, band, static_cast<unsigned>(height), rasterizeBands);
+    else
+        rasterizeBands(0, height);
+
+    if (!success)
+        SE_LOG_ERROR("Error creating SVG rasterizer");
+    return success;
+}
+
 bool ImageSVG::BeginLoad(Deserializer& source)
 {
-    String fileData = source.ReadString();
+    std::lock_guard<std::mutex> lock(rasterMutex_);
 
-    NSVGimage *nsvgImage = nsvgParse(fileData.data(), "px", dpi_);
-    if (nsvgImage == nullptr) {
+    svgData_ = source.ReadString();
+    document_.reset();
+    rasters_.clear();
+    rasterCacheSize_ = 0;
+    if (!ParseDocument(dpi_))
+    {
       SE_LOG_ERROR("Error loading SVG file: {}", GetName());
       return false;
     }
 
-    NSVGrasterizer *rast = nsvgCreateRasterizer();
-    if (rast == nullptr) {
-      SE_LOG_ERROR("Error creating SVG rasterizer");
-      nsvgDelete(nsvgImage);
-      return false;
-    }
-
     if (this->GetWidth() == 0 || this->GetHeight() == 0) {
       //this->SetSize(256, 256, 4);
-      this->SetSize(nsvgImage->width, nsvgImage->height, 4);
+      this->SetSize(document_->width, document_->height, 4);
+    }
+
+    return RasterizeDocument(document_.get(), this->GetData(), this->GetWidth(), this->GetHeight());
+}
+
+std::shared_ptr<Image> ImageSVG::GetRaster(int width, int height, float dpi)
+{
+    if (width <= 0 || height <= 0)
+        return nullptr;
+    if (dpi <= 0.0f)
+        dpi = dpi_;
+
+    // Held while rasterizing, so concurrent requests for the same size render only once
+    std::lock_guard<std::mutex> lock(rasterMutex_);
+
+    const RasterKey key{width, height, dpi};
+    auto it = rasters_.find(key);
+    if (it != rasters_.end())
+    {
+        it->second.lastUse_ = ++rasterUseCount_;
+        return it->second.image_;
+    }
+
+    if (svgData_.empty() || (dpi != documentDPI_ && !ParseDocument(dpi)))
+        return nullptr;
+
+    auto raster = std::make_shared<Image>();
+    raster->SetName(GetName());
+    if (!raster->SetSize(width, height, 4) || !RasterizeDocument(document_.get(), raster->GetData(), width, height))
+        return nullptr;
+
+    // Rasters larger than the whole cache are returned without caching them
+    const unsigned size = raster->GetMemoryUse();
+    if (size <= maxRasterCacheSize_)
+    {
+        EvictRasters(maxRasterCacheSize_ - size);
+        rasters_[key] = CachedRaster{raster, ++rasterUseCount_};
+        rasterCacheSize_ += size;
     }
+    return raster;
+}
+
+void ImageSVG::SetMaxRasterCacheSize(unsigned size)
+{
+    std::lock_guard<std::mutex> lock(rasterMutex_);
+    maxRasterCacheSize_ = size;
+    EvictRasters(maxRasterCacheSize_);
+}
+
+void ImageSVG::ClearRasterCache()
+{
+    std::lock_guard<std::mutex> lock(rasterMutex_);
+    rasters_.clear();
+    rasterCacheSize_ = 0;
+}
+
+unsigned ImageSVG::GetRasterCacheSize() const
+{
+    std::lock_guard<std::mutex> lock(rasterMutex_);
+    return rasterCacheSize_;
+}
 
-    int width = this->GetWidth();  // Increased size for better quality
-    int height = this->GetHeight(); // Increased size for better quality
+unsigned ImageSVG::GetNumCachedRasters() const
+{
+    std::lock_guard<std::mutex> lock(rasterMutex_);
+    return static_cast<unsigned>(rasters_.size());
+}
+
+void ImageSVG::EvictRasters(unsigned size)
+{
+    while (rasterCacheSize_ > size && !rasters_.empty())
+    {
+        auto oldest = rasters_.begin();
+        for (auto it = rasters_.begin(); it != rasters_.end(); ++it)
+        {
+            if (it->second.lastUse_ < oldest->second.lastUse_)
+                oldest = it;
+        }
+        rasterCacheSize_ -= oldest->second.image_->GetMemoryUse();
+        rasters_.erase(oldest);
+    }
+}
 
+bool ImageSVG::ParseDocument(float dpi)
+{
+    // nsvgParse modifies its input, keep the original text for parsing at another DPI
+    std::vector<char> text(svgData_.begin(), svgData_.end());
+    text.push_back('\0');
 
-//    unsigned char *pixels = new unsigned char[width * height * 4];
-    nsvgRasterize(rast, nsvgImage, 0, 0, width / nsvgImage->width, this->GetData(), width,
-                  height, width * 4);
+    NSVGimage* document = nsvgParse(text.data(), "px", dpi);
+    if (document == nullptr)
+        return false;
+    if (document->width <= 0.0f || document->height <= 0.0f)
+    {
+        nsvgDelete(document);
+        return false;
+    }
 
-    nsvgDeleteRasterizer(rast);
-    nsvgDelete(nsvgImage);
+    document_ = std::shared_ptr<NSVGimage>(document, nsvgDelete);
+    documentDPI_ = dpi;
     return true;
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,197 @@
+#include "IndexedArchive.h"
+
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/MemoryBuffer.hpp>
+
+#include <cstring>
+
+namespace Se
+{
+
+namespace
+{
+
+/// File ID at the beginning and at the end of the container.
+const char* fileID = "SEIA";
+/// Size of the file ID.
+const unsigned fileIDSize = 4;
+/// Size of the footer: table of contents offset and file ID.
+const unsigned footerSize = sizeof(unsigned) + fileIDSize;
+
+}
+
+IndexedArchiveWriter::IndexedArchiveWriter() = default;
+
+bool IndexedArchiveWriter::SaveObjectCallback(const String& name, const std::function<void(Archive&)>& serializeValue)
+{
+    const unsigned offset = data_.GetSize();
+    data_.Seek(offset);
+    try
+    {
+        BinaryOutputArchive archive{data_};
+        serializeValue(archive);
+        archive.Flush();
+    }
+    catch (const ArchiveException& e)
+    {
+        data_.Resize(offset);
+        SE_LOG_ERROR("Failed to save object '{}' to indexed archive: {}", name, e.what());
+        return false;
+    }
+
+    auto iter = entries_.find(name);
+    if (iter == entries_.end())
+    {
+        names_.push_back(name);
+        iter = entries_.emplace(name, IndexedArchiveEntry{}).first;
+    }
+    iter->second = IndexedArchiveEntry{offset, static_cast<unsigned>(data_.GetSize()) - offset};
+    return true;
+}
+
+bool IndexedArchiveWriter::Save(Serializer& dest) const
+{
+    bool success = dest.WriteFileID(fileID);
+
+    // Blocks are written in the order of saving, replaced blocks are dropped
+    std::vector<IndexedArchiveEntry> entries;
+    entries.reserve(names_.size());
+    unsigned offset = fileIDSize;
+    for (const String& name : names_)
+    {
+        const IndexedArchiveEntry& entry = entries_.at(name);
+        success &= dest.Write(data_.GetData() + entry.offset_, entry.size_) == entry.size_;
+        entries.push_back(IndexedArchiveEntry{offset, entry.size_});
+        offset += entry.size_;
+    }
+
+    const unsigned indexOffset = offset;
+    success &= dest.WriteVLE(names_.size());
+    for (unsigned i = 0; i < names_.size(); ++i)
+    {
+        success &= dest.WriteString(names_[i]);
+        success &= dest.WriteUInt(entries[i].offset_);
+        success &= dest.WriteUInt(entries[i].size_);
+    }
+    success &= dest.WriteUInt(indexOffset);
+    success &= dest.WriteFileID(fileID);
+
+    if (!success)
+        SE_LOG_ERROR("Failed to write indexed archive");
+    return success;
+}
+
+bool IndexedArchiveWriter::SaveFile(const String& fileName) const
+{
+    File file;
+    if (!file.Open(fileName, FILE_WRITE))
+        return false;
+    return Save(file);
+}
+
+bool IndexedArchiveReader::Open(const String& fileName)
+{
+    Close();
+    if (!file_.Open(fileName))
+        return false;
+    if (!ReadIndex(fileName))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+bool IndexedArchiveReader::Load(Deserializer& source)
+{
+    Close();
+    buffer_.resize(source.GetSize() - source.GetPosition());
+    if (source.Read(buffer_.data(), buffer_.size()) != buffer_.size() || !ReadIndex(source.GetName()))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void IndexedArchiveReader::Close()
+{
+    file_.Close();
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    entries_.clear();
+}
+
+const IndexedArchiveEntry* IndexedArchiveReader::GetEntry(const String& name) const
+{
+    const auto iter = entries_.find(name);
+    return iter != entries_.end() ? &iter->second : nullptr;
+}
+
+bool IndexedArchiveReader::LoadObjectCallback(const String& name, const std::function<void(Archive&)>& serializeValue) const
+{
+    const IndexedArchiveEntry* entry = GetEntry(name);
+    if (!entry)
+    {
+        SE_LOG_ERROR("Indexed archive does not contain object '{}'", name);
+        return false;
+    }
+
+    try
+    {
+        MemoryBuffer blockBuffer{GetData() + entry->offset_, entry->size_};
+        BinaryInputArchive archive{blockBuffer};
+        serializeValue(archive);
+        archive.Flush();
+        return true;
+    }
+    catch (const ArchiveException& e)
+    {
+        SE_LOG_ERROR("Failed to load object '{}' from indexed archive: {}", name, e.what());
+        return false;
+    }
+}
+
+bool IndexedArchiveReader::ReadIndex(const String& sourceName)
+{
+    const unsigned char* data = GetData();
+    const std::size_t size = GetSize();
+    if (size < fileIDSize + footerSize || memcmp(data, fileID, fileIDSize) != 0
+        || memcmp(data + size - fileIDSize, fileID, fileIDSize) != 0)
+    {
+        SE_LOG_ERROR("{} is not a valid indexed archive", sourceName);
+        return false;
+    }
+
+    unsigned indexOffset{};
+    memcpy(&indexOffset, data + size - footerSize, sizeof(unsigned));
+    if (indexOffset < fileIDSize || indexOffset > size - footerSize)
+    {
+        SE_LOG_ERROR("{} has a corrupted index", sourceName);
+        return false;
+    }
+
+    MemoryBuffer index{data + indexOffset, size - footerSize - indexOffset};
+    const unsigned numEntries = index.ReadVLE();
+    for (unsigned i = 0; i < numEntries && !index.IsEof(); ++i)
+    {
+        const String name = index.ReadString();
+        IndexedArchiveEntry entry;
+        entry.offset_ = index.ReadUInt();
+        entry.size_ = index.ReadUInt();
+        if (entry.offset_ < fileIDSize || entry.offset_ > indexOffset || entry.size_ > indexOffset - entry.offset_)
+            break;
+        entries_[name] = entry;
+    }
+
+    if (entries_.size() != numEntries)
+    {
+        SE_LOG_ERROR("{} has a corrupted index", sourceName);
+        entries_.clear();
+        return false;
+    }
+    return true;
+}
+
+}
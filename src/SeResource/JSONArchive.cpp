@@ -1,9 +1,16 @@
 // Copyright (c) 2017-2020 the rbfx project.
 
 //#include <GFrost/Core/StringUtils.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
+
+#include <Se/IO/Deserializer.hpp>
 #include <SeArc/ArchiveSerialization.hpp>
 #include <SeResource/JSONArchive.h>
 
+#include <cctype>
+#include <climits>
+#include <exception>
 #include <string>
 
 namespace Se
@@ -284,4 +291,565 @@ JSONOutputArchiveBlock::JSONOutputArchiveBlock(const char* name, ArchiveBlockTyp
 
 #undef SE_VALUE_IN_IMPL
 
+    /// Flags for streamed JSON: the syntax JSONFile accepts, with strings decoded in place.
+    static const unsigned JSON_STREAM_PARSE_FLAGS =
+        rapidjson::kParseCommentsFlag | rapidjson::kParseTrailingCommasFlag | rapidjson::kParseInsituFlag;
+
+    /// Pull parser over JSON text held in memory. Strings are decoded in place, so tokens view into the text.
+    class JSONStreamReader : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, JSONStreamReader>
+    {
+    public:
+        /// Construct over null-terminated text.
+        JSONStreamReader(const Se::String& name, std::unique_ptr<char[]> text)
+            : name_(name)
+            , text_(std::move(text))
+            , stream_(text_.get())
+        {
+            reader_.IterativeParseInit();
+        }
+
+        /// Read the next token. Throw on parse error.
+        const JSONStreamToken& Next()
+        {
+            if (reader_.IterativeParseComplete())
+            {
+                token_ = JSONStreamToken{};
+                return token_;
+            }
+
+            if (!reader_.IterativeParseNext<JSON_STREAM_PARSE_FLAGS>(stream_, *this))
+            {
+                throw ArchiveException("Could not parse JSON from '{}': {} at offset {}", name_.c_str(),
+                    rapidjson::GetParseError_En(reader_.GetParseErrorCode()), reader_.GetErrorOffset());
+            }
+            return token_;
+        }
+
+        /// Skip the rest of a value that starts with the token.
+        void Skip(JSONStreamToken first)
+        {
+            unsigned depth = first.type_ == JSONStreamToken::StartObject || first.type_ == JSONStreamToken::StartArray;
+            while (depth)
+            {
+                switch (Next().type_)
+                {
+                case JSONStreamToken::StartObject:
+                case JSONStreamToken::StartArray:
+                    ++depth;
+                    break;
+                case JSONStreamToken::EndObject:
+                case JSONStreamToken::EndArray:
+                    --depth;
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+        /// Read the rest of a value that starts with the token into a Value tree.
+        void ReadValue(JSONStreamToken first, Value& value)
+        {
+            if (first.type_ != JSONStreamToken::StartObject && first.type_ != JSONStreamToken::StartArray)
+            {
+                AssignScalar(value, first);
+                return;
+            }
+
+            // Same in-place filling as JSONFile: only the innermost container grows
+            value.SetType(first.type_ == JSONStreamToken::StartObject ? VALUE_OBJECT : VALUE_ARRAY);
+            std::vector<Value*> stack{&value};
+            Se::String key;
+            while (!stack.empty())
+            {
+                const JSONStreamToken& token = Next();
+                if (token.type_ == JSONStreamToken::Key)
+                {
+                    key.assign(token.stringValue_.data(), token.stringValue_.length());
+                    continue;
+                }
+                if (token.type_ == JSONStreamToken::EndObject || token.type_ == JSONStreamToken::EndArray)
+                {
+                    stack.pop_back();
+                    continue;
+                }
+
+                Value& parent = *stack.back();
+                Value* element;
+                if (parent.IsArray())
+                {
+                    parent.Push(Value::EMPTY);
+                    element = &parent[parent.Size() - 1];
+                }
+                else
+                    element = &parent[key];
+
+                if (token.type_ == JSONStreamToken::StartObject || token.type_ == JSONStreamToken::StartArray)
+                {
+                    element->SetType(token.type_ == JSONStreamToken::StartObject ? VALUE_OBJECT : VALUE_ARRAY);
+                    stack.push_back(element);
+                }
+                else
+                    AssignScalar(*element, token);
+            }
+        }
+
+        /// Return the number of elements of the array whose opening bracket was just read. The first call scans the rest of
+        /// the text once and records the sizes of all arrays that follow, so nested and later arrays are not scanned again.
+        unsigned CountArrayElements()
+        {
+            const unsigned arrayIndex = numArrays_ - 1;
+            if (arraySizes_.empty())
+            {
+                firstScannedArray_ = arrayIndex;
+                ScanArraySizes();
+            }
+            return arrayIndex - firstScannedArray_ < arraySizes_.size() ? arraySizes_[arrayIndex - firstScannedArray_] : 0;
+        }
+
+        /// Record the element counts of the current array and all arrays after it in text order.
+        void ScanArraySizes()
+        {
+            struct Container
+            {
+                /// Index into arraySizes_, or -1 for objects.
+                int arraySize_;
+                /// Whether an element of the container has started and not been ended by a comma.
+                bool inElement_;
+            };
+            std::vector<Container> stack{{0, false}};
+            arraySizes_.push_back(0);
+
+            // Counts an element of the innermost array at the first character of the element
+            auto startElement = [&]()
+            {
+                if (!stack.empty() && stack.back().arraySize_ >= 0 && !stack.back().inElement_)
+                {
+                    ++arraySizes_[stack.back().arraySize_];
+                    stack.back().inElement_ = true;
+                }
+            };
+
+            for (const char* ptr = stream_.src_; *ptr; ++ptr)
+            {
+                const char ch = *ptr;
+                if (ch == '/' && (ptr[1] == '/' || ptr[1] == '*'))
+                {
+                    const bool lineComment = ptr[1] == '/';
+                    for (ptr += 2; *ptr && (lineComment ? *ptr != '\n' : !(ptr[0] == '*' && ptr[1] == '/')); ++ptr)
+                        ;
+                    if (!*ptr)
+                        break;
+                    if (!lineComment)
+                        ++ptr;
+                    continue;
+                }
+                if (isspace(static_cast<unsigned char>(ch)) || ch == ':')
+                    continue;
+                if (ch == ',')
+                {
+                    if (!stack.empty())
+                        stack.back().inElement_ = false;
+                    continue;
+                }
+                if (ch == ']' || ch == '}')
+                {
+                    if (!stack.empty())
+                        stack.pop_back();
+                    continue;
+                }
+
+                startElement();
+                if (ch == '[')
+                {
+                    stack.push_back({static_cast<int>(arraySizes_.size()), false});
+                    arraySizes_.push_back(0);
+                }
+                else if (ch == '{')
+                    stack.push_back({-1, false});
+                else if (ch == '"')
+                {
+                    for (++ptr; *ptr && *ptr != '"'; ++ptr)
+                    {
+                        if (*ptr == '\\' && ptr[1])
+                            ++ptr;
+                    }
+                    if (!*ptr)
+                        break;
+                }
+            }
+        }
+
+        /// Assign a scalar token to a value.
+        static void AssignScalar(Value& value, const JSONStreamToken& token)
+        {
+            switch (token.type_)
+            {
+            case JSONStreamToken::Bool:
+                value = token.boolValue_;
+                break;
+            case JSONStreamToken::Number:
+                if (token.numberType_ == VALUE_NT_INT)
+                    value = static_cast<int>(token.numberValue_);
+                else if (token.numberType_ == VALUE_NT_UINT)
+                    value = static_cast<unsigned>(token.numberValue_);
+                else
+                    value = token.numberValue_;
+                break;
+            case JSONStreamToken::String:
+                value = Se::String(token.stringValue_.data(), token.stringValue_.length());
+                break;
+            default:
+                value.SetType(VALUE_NULL);
+                break;
+            }
+        }
+
+        /// @name rapidjson reader events
+        /// @{
+        bool Null() { return SetToken(JSONStreamToken::Null); }
+        bool Bool(bool value) { token_.boolValue_ = value; return SetToken(JSONStreamToken::Bool); }
+        bool Int(int value) { return SetNumber(value, VALUE_NT_INT); }
+        // Same number types a loaded Value gets: unsigned only when it does not fit an int
+        bool Uint(unsigned value) { return SetNumber(value, value <= INT_MAX ? VALUE_NT_INT : VALUE_NT_UINT); }
+        bool Int64(int64_t value) { return SetNumber(static_cast<double>(value), VALUE_NT_FLOAT_DOUBLE); }
+        bool Uint64(uint64_t value) { return SetNumber(static_cast<double>(value), VALUE_NT_FLOAT_DOUBLE); }
+        bool Double(double value) { return SetNumber(value, VALUE_NT_FLOAT_DOUBLE); }
+        bool String(const char* str, rapidjson::SizeType length, bool /*copy*/)
+        {
+            token_.stringValue_ = std::string_view(str, length);
+            return SetToken(JSONStreamToken::String);
+        }
+        bool Key(const char* str, rapidjson::SizeType length, bool /*copy*/)
+        {
+            token_.stringValue_ = std::string_view(str, length);
+            return SetToken(JSONStreamToken::Key);
+        }
+        bool StartObject() { return SetToken(JSONStreamToken::StartObject); }
+        bool EndObject(rapidjson::SizeType /*memberCount*/) { return SetToken(JSONStreamToken::EndObject); }
+        bool StartArray() { ++numArrays_; return SetToken(JSONStreamToken::StartArray); }
+        bool EndArray(rapidjson::SizeType /*elementCount*/) { return SetToken(JSONStreamToken::EndArray); }
+        /// @}
+
+    private:
+        bool SetToken(JSONStreamToken::Type type)
+        {
+            token_.type_ = type;
+            return true;
+        }
+
+        bool SetNumber(double value, ValueNumberType numberType)
+        {
+            token_.numberValue_ = value;
+            token_.numberType_ = numberType;
+            return SetToken(JSONStreamToken::Number);
+        }
+
+        /// Source name for errors.
+        Se::String name_;
+        /// Text, decoded in place as it is read.
+        std::unique_ptr<char[]> text_;
+        /// Stream over the text.
+        rapidjson::InsituStringStream stream_;
+        /// Parser.
+        rapidjson::Reader reader_;
+        /// Last token.
+        JSONStreamToken token_;
+        /// Number of arrays started so far.
+        unsigned numArrays_{};
+        /// Element counts of the scanned arrays in text order.
+        std::vector<unsigned> arraySizes_;
+        /// Index of the first scanned array among all arrays.
+        unsigned firstScannedArray_{};
+    };
+
+    /// Return the token a buffered value would have been read as. Containers only report their start.
+    static JSONStreamToken ToStreamToken(const Value& value)
+    {
+        JSONStreamToken token;
+        switch (value.GetValueType())
+        {
+        case VALUE_BOOL:
+            token.type_ = JSONStreamToken::Bool;
+            token.boolValue_ = value.GetBool();
+            break;
+        case VALUE_NUMBER:
+            token.type_ = JSONStreamToken::Number;
+            token.numberValue_ = value.GetDouble();
+            token.numberType_ = value.GetNumberType();
+            break;
+        case VALUE_STRING:
+            token.type_ = JSONStreamToken::String;
+            token.stringValue_ = std::string_view(value.GetString().c_str(), value.GetString().length());
+            break;
+        case VALUE_ARRAY:
+            token.type_ = JSONStreamToken::StartArray;
+            break;
+        case VALUE_OBJECT:
+            token.type_ = JSONStreamToken::StartObject;
+            break;
+        default:
+            token.type_ = JSONStreamToken::Null;
+            break;
+        }
+        return token;
+    }
+
+    JSONStreamInputArchiveBlock::JSONStreamInputArchiveBlock(const char* name, ArchiveBlockType type,
+        JSONStreamReader* reader, unsigned sizeHint)
+            : ArchiveBlockBase(name, type)
+            , reader_(reader)
+            , sizeHint_(sizeHint)
+    {
+    }
+
+    JSONStreamInputArchiveBlock::JSONStreamInputArchiveBlock(const char* name, ArchiveBlockType type, const Value* value)
+            : ArchiveBlockBase(name, type)
+            , value_(value)
+    {
+    }
+
+    const Value* JSONStreamInputArchiveBlock::ReadElement(ArchiveBase& archive, const char* elementName, JSONStreamToken& token)
+    {
+        // Buffered blocks read like JSONInputArchive
+        if (value_)
+        {
+            const Value* elementValue = nullptr;
+            if (IsArchiveBlockValueArray(type_))
+            {
+                if (nextElementIndex_ >= value_->Size())
+                    throw archive.ElementNotFoundException(elementName, nextElementIndex_);
+                elementValue = &value_->Get(nextElementIndex_);
+                ++nextElementIndex_;
+            }
+            else
+            {
+                if (!value_->Contains(elementName))
+                    throw archive.ElementNotFoundException(elementName);
+                elementValue = &value_->Get(elementName);
+            }
+
+            token = ToStreamToken(*elementValue);
+            return elementValue;
+        }
+
+        if (IsArchiveBlockValueArray(type_))
+        {
+            if (!ended_)
+            {
+                token = reader_->Next();
+                if (token.type_ != JSONStreamToken::EndArray)
+                {
+                    ++nextElementIndex_;
+                    return nullptr;
+                }
+                ended_ = true;
+            }
+            throw archive.ElementNotFoundException(elementName, nextElementIndex_);
+        }
+
+        if (!bufferedMembers_.empty())
+        {
+            auto it = bufferedMembers_.find(elementName);
+            if (it != bufferedMembers_.end())
+            {
+                token = ToStreamToken(it->second);
+                return &it->second;
+            }
+        }
+
+        if (!SeekMember(elementName))
+            throw archive.ElementNotFoundException(elementName);
+
+        hasPendingKey_ = false;
+        token = reader_->Next();
+        return nullptr;
+    }
+
+    bool JSONStreamInputArchiveBlock::HasElementOrBlock(const char* name) const
+    {
+        if (value_)
+            return value_->Contains(name);
+        if (type_ != ArchiveBlockType::Unordered)
+            return false;
+        return bufferedMembers_.count(name) || SeekMember(name);
+    }
+
+    bool JSONStreamInputArchiveBlock::SeekMember(const char* name) const
+    {
+        if (hasPendingKey_)
+        {
+            if (pendingKey_ == name)
+                return true;
+
+            BufferMember(pendingKey_);
+            hasPendingKey_ = false;
+        }
+
+        while (!ended_)
+        {
+            const JSONStreamToken& token = reader_->Next();
+            if (token.type_ == JSONStreamToken::EndObject)
+            {
+                ended_ = true;
+                break;
+            }
+
+            if (token.stringValue_ == name)
+            {
+                pendingKey_ = name;
+                hasPendingKey_ = true;
+                return true;
+            }
+
+            BufferMember(String(token.stringValue_.data(), token.stringValue_.length()));
+        }
+        return false;
+    }
+
+    void JSONStreamInputArchiveBlock::BufferMember(const String& key) const
+    {
+        // Later duplicates replace earlier ones, like in a loaded Value
+        Value& member = bufferedMembers_[key];
+        member.SetType(VALUE_NULL);
+        reader_->ReadValue(reader_->Next(), member);
+    }
+
+    void JSONStreamInputArchiveBlock::Close(ArchiveBase& archive)
+    {
+        // Nothing to skip in buffered blocks, and nothing worth reading after an error
+        if (value_ || ended_ || std::uncaught_exceptions())
+            return;
+
+        // Skip the items that were not asked for
+        if (IsArchiveBlockValueArray(type_))
+        {
+            for (JSONStreamToken token = reader_->Next(); token.type_ != JSONStreamToken::EndArray; token = reader_->Next())
+                reader_->Skip(token);
+        }
+        else
+        {
+            if (hasPendingKey_)
+                reader_->Skip(reader_->Next());
+            while (reader_->Next().type_ != JSONStreamToken::EndObject)
+                reader_->Skip(reader_->Next());
+        }
+        ended_ = true;
+    }
+
+    JSONStreamInputArchive::JSONStreamInputArchive(Deserializer& source)
+        : name_(source.GetName())
+    {
+        const unsigned dataSize = source.GetSize() - source.GetPosition();
+        std::unique_ptr<char[]> text(new char[dataSize + 1]);
+        const unsigned readSize = source.Read(text.get(), dataSize);
+        text[readSize] = '\0';
+        reader_ = std::make_unique<JSONStreamReader>(name_, std::move(text));
+    }
+
+    JSONStreamInputArchive::~JSONStreamInputArchive() = default;
+
+    void JSONStreamInputArchive::BeginBlock(const char* name, unsigned& sizeHint, bool safe, ArchiveBlockType type)
+    {
+        CheckBeforeBlock(name);
+        CheckBlockOrElementName(name);
+
+        // The root block is the first value in the stream
+        JSONStreamToken token;
+        const Value* blockValue = nullptr;
+        if (stack_.empty())
+            token = reader_->Next();
+        else
+            blockValue = GetCurrentBlock().ReadElement(*this, name, token);
+
+        if (blockValue)
+        {
+            if (!IsArchiveBlockTypeMatching(*blockValue, type))
+                throw UnexpectedElementValueException(name);
+            stack_.push_back(Block{ name, type, blockValue });
+        }
+        else if (IsArchiveBlockValueArray(type) && token.type_ == JSONStreamToken::StartArray)
+        {
+            const unsigned numElements = type == ArchiveBlockType::Array ? reader_->CountArrayElements() : 0;
+            stack_.push_back(Block{ name, type, reader_.get(), numElements });
+        }
+        else if (IsArchiveBlockValueObject(type) && token.type_ == JSONStreamToken::StartObject)
+            stack_.push_back(Block{ name, type, reader_.get(), 0 });
+        else
+        {
+            // Null and empty containers of the other kind are accepted, like in JSONInputArchive
+            const bool isEmpty = token.type_ == JSONStreamToken::Null
+                || (IsArchiveBlockValueArray(type) && token.type_ == JSONStreamToken::StartObject
+                    && reader_->Next().type_ == JSONStreamToken::EndObject)
+                || (IsArchiveBlockValueObject(type) && token.type_ == JSONStreamToken::StartArray
+                    && reader_->Next().type_ == JSONStreamToken::EndArray);
+            if (!isEmpty)
+                throw UnexpectedElementValueException(name);
+            stack_.push_back(Block{ name, type, &Value::EMPTY });
+        }
+
+        sizeHint = GetCurrentBlock().GetSizeHint();
+    }
+
+    void JSONStreamInputArchive::Serialize(const char* name, bool& value)
+    {
+        value = ReadElement(name, JSONStreamToken::Bool).boolValue_;
+    }
+
+    void JSONStreamInputArchive::Serialize(const char* name, long long& value)
+    {
+        // Strings in the stream and in buffered values are both null-terminated
+        value = ToInt64(ReadElement(name, JSONStreamToken::String).stringValue_.data());
+    }
+
+    void JSONStreamInputArchive::Serialize(const char* name, unsigned long long& value)
+    {
+        value = ToUInt64(ReadElement(name, JSONStreamToken::String).stringValue_.data());
+    }
+
+    void JSONStreamInputArchive::Serialize(const char* name, String& value)
+    {
+        const std::string_view stringValue = ReadElement(name, JSONStreamToken::String).stringValue_;
+        value.assign(stringValue.data(), stringValue.length());
+    }
+
+    void JSONStreamInputArchive::SerializeBytes(const char* name, void* bytes, unsigned size)
+    {
+        const std::string_view stringValue = ReadElement(name, JSONStreamToken::String).stringValue_;
+        ReadBytesFromHexString(name, String(stringValue.data(), stringValue.length()), bytes, size);
+    }
+
+    void JSONStreamInputArchive::SerializeVLE(const char* name, unsigned& value)
+    {
+        value = static_cast<unsigned>(ReadElement(name, JSONStreamToken::Number).numberValue_);
+    }
+
+    const JSONStreamToken& JSONStreamInputArchive::ReadElement(const char* name, JSONStreamToken::Type type)
+    {
+        CheckBeforeElement(name);
+        CheckBlockOrElementName(name);
+        GetCurrentBlock().ReadElement(*this, name, token_);
+        if (token_.type_ != type)
+            throw UnexpectedElementValueException(name);
+        return token_;
+    }
+
+// Generate serialization implementation (streaming JSON input). Numbers convert like Value::GetInt and Value::GetUInt
+#define SE_STREAM_VALUE_IN_IMPL(type, numberType) \
+    void JSONStreamInputArchive::Serialize(const char* name, type& value) \
+    { \
+        value = static_cast<type>(static_cast<numberType>(ReadElement(name, JSONStreamToken::Number).numberValue_)); \
+    }
+
+    SE_STREAM_VALUE_IN_IMPL(signed char, int);
+    SE_STREAM_VALUE_IN_IMPL(short, int);
+    SE_STREAM_VALUE_IN_IMPL(int, int);
+    SE_STREAM_VALUE_IN_IMPL(unsigned char, unsigned);
+    SE_STREAM_VALUE_IN_IMPL(unsigned short, unsigned);
+    SE_STREAM_VALUE_IN_IMPL(unsigned int, unsigned);
+    SE_STREAM_VALUE_IN_IMPL(float, float);
+    SE_STREAM_VALUE_IN_IMPL(double, double);
+
+#undef SE_STREAM_VALUE_IN_IMPL
+
 }
@@ -1,13 +1,19 @@
 #include <rapidjson/document.h>
+#include <rapidjson/error/en.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/prettywriter.h>
 
 #include <Se/Console.hpp>
 #include <Se/IO/MemoryBuffer.hpp>
+#include <Se/ValueDocument.h>
 
 #include <SeResource/JSONArchive.h>
 
 #include <SeResource/JSONFile.h>
+#include <SeResource/ResourceCookCache.h>
+
+#include <climits>
 //#include "JSONArchive.h"
 
 
@@ -17,61 +23,105 @@ namespace Se
 using namespace rapidjson;
 
 
-// Convert rapidjson value to JSON value.
-static void ToJSONValue(JSONValue& jsonValue, const rapidjson::Value& rapidjsonValue)
+/// Flags for loading JSON resources.
+static const unsigned JSON_PARSE_FLAGS = kParseCommentsFlag | kParseTrailingCommasFlag;
+
+/// Builds a JSON value straight from rapidjson reader events, without an intermediate rapidjson document.
+class JSONValueHandler : public BaseReaderHandler<UTF8<>, JSONValueHandler>
 {
-    switch (rapidjsonValue.GetType())
+public:
+    /// Construct with the value to fill.
+    explicit JSONValueHandler(JSONValue& root) : root_(root) {}
+
+    bool Null() { Add().SetType(VALUE_NULL); return true; }
+    bool Bool(bool value) { Add() = value; return true; }
+    bool Int(int value) { Add() = value; return true; }
+    // Same number types a rapidjson document reports: unsigned only when it does not fit an int
+    bool Uint(unsigned value)
     {
-    case kNullType:
-        // Reset to null type
-        jsonValue.SetType(VALUE_NULL);
-        break;
-
-    case kFalseType:
-        jsonValue = false;
-        break;
-
-    case kTrueType:
-        jsonValue = true;
-        break;
-
-    case kNumberType:
-        if (rapidjsonValue.IsInt())
-            jsonValue = rapidjsonValue.GetInt();
-        else if (rapidjsonValue.IsUint())
-            jsonValue = rapidjsonValue.GetUint();
+        if (value <= INT_MAX)
+            Add() = static_cast<int>(value);
         else
-            jsonValue = rapidjsonValue.GetDouble();
-        break;
-
-    case kStringType:
-        jsonValue = rapidjsonValue.GetString();
-        break;
-
-    case kArrayType:
-        {
-            jsonValue.Resize(rapidjsonValue.Size());
-            for (unsigned i = 0; i < rapidjsonValue.Size(); ++i)
-            {
-                ToJSONValue(jsonValue[i], rapidjsonValue[i]);
-            }
-        }
-        break;
+            Add() = value;
+        return true;
+    }
+    // The reader only reports 64-bit integers outside the 32-bit ranges
+    bool Int64(int64_t value) { Add() = static_cast<double>(value); return true; }
+    bool Uint64(uint64_t value) { Add() = static_cast<double>(value); return true; }
+    bool Double(double value) { Add() = value; return true; }
+    bool String(const char* str, SizeType length, bool /*copy*/) { Add() = Se::String(str, length); return true; }
+    bool StartObject() { Open(VALUE_OBJECT); return true; }
+    bool Key(const char* str, SizeType length, bool /*copy*/) { key_.assign(str, length); return true; }
+    bool EndObject(SizeType /*memberCount*/) { stack_.pop_back(); return true; }
+    bool StartArray() { Open(VALUE_ARRAY); return true; }
+    bool EndArray(SizeType /*elementCount*/) { stack_.pop_back(); return true; }
+
+private:
+    /// Return the next value slot: the root, a new array element or the member for the last key.
+    JSONValue& Add()
+    {
+        if (stack_.empty())
+            return root_;
 
-    case kObjectType:
+        JSONValue& parent = *stack_.back();
+        if (parent.IsArray())
         {
-            jsonValue.SetType(VALUE_OBJECT);
-            for (rapidjson::Value::ConstMemberIterator i = rapidjsonValue.MemberBegin(); i != rapidjsonValue.MemberEnd(); ++i)
-            {
-                JSONValue& value = jsonValue[String(i->name.GetString())];
-                ToJSONValue(value, i->value);
-            }
+            parent.Push(JSONValue::EMPTY);
+            return parent[parent.Size() - 1];
         }
-        break;
+        return parent[key_];
+    }
 
-    default:
-        break;
+    /// Add a container and make it the current parent. Only the innermost container grows, so the pointers to the
+    /// outer ones stay valid.
+    void Open(ValueType type)
+    {
+        JSONValue& value = Add();
+        value.SetType(type);
+        stack_.push_back(&value);
     }
+
+    /// Value being filled.
+    JSONValue& root_;
+    /// Open arrays and objects.
+    std::vector<JSONValue*> stack_;
+    /// Last object key.
+    Se::String key_;
+};
+
+/// Forwards rapidjson reader events to a value document.
+class ValueDocumentHandler : public BaseReaderHandler<UTF8<>, ValueDocumentHandler>
+{
+public:
+    /// Construct with the document to fill.
+    explicit ValueDocumentHandler(ValueDocument& document) : document_(document) {}
+
+    bool Null() { return document_.Null(); }
+    bool Bool(bool value) { return document_.Bool(value); }
+    bool Int(int value) { return document_.Int(value); }
+    bool Uint(unsigned value) { return document_.Uint(value); }
+    bool Int64(int64_t value) { return document_.Int64(value); }
+    bool Uint64(uint64_t value) { return document_.Uint64(value); }
+    bool Double(double value) { return document_.Double(value); }
+    bool String(const char* str, SizeType length, bool copy) { return document_.String(str, length, copy); }
+    bool StartObject() { return document_.StartObject(); }
+    bool Key(const char* str, SizeType length, bool copy) { return document_.Key(str, length, copy); }
+    bool EndObject(SizeType memberCount) { return document_.EndObject(memberCount); }
+    bool StartArray() { return document_.StartArray(); }
+    bool EndArray(SizeType elementCount) { return document_.EndArray(elementCount); }
+
+private:
+    /// Document being filled.
+    ValueDocument& document_;
+};
+
+/// Read the whole source into a null-terminated buffer. Return false if reading fails.
+static bool ReadJSONText(Deserializer& source, char* buffer, unsigned dataSize)
+{
+    if (source.Read(buffer, dataSize) != dataSize)
+        return false;
+    buffer[dataSize] = '\0';
+    return true;
 }
 
 bool JSONFile::BeginLoad(Deserializer& source)
@@ -83,25 +133,65 @@ bool JSONFile::BeginLoad(Deserializer& source)
         return false;
     }
 
-    std::shared_ptr<char> buffer(new char[dataSize + 1], std::default_delete<char[]>());
-    if (source.Read(buffer.get(), dataSize) != dataSize)
+    std::unique_ptr<char[]> buffer(new char[dataSize + 1]);
+    if (!ReadJSONText(source, buffer.get(), dataSize))
         return false;
-    buffer.get()[dataSize] = '\0';
 
-    rapidjson::Document document;
-    if (document.Parse<kParseCommentsFlag | kParseTrailingCommasFlag>(buffer.get()).HasParseError())
+    // Parse in place and fill the value tree from the reader events; strings are copied into the values once
+    JSONValue root;
+    JSONValueHandler handler(root);
+    InsituStringStream stream(buffer.get());
+    Reader reader;
+    if (reader.Parse<JSON_PARSE_FLAGS | kParseInsituFlag>(stream, handler).IsError())
     {
-        SE_LOG_ERROR("Could not parse JSON data from " + source.GetName());
+        SE_LOG_ERROR("Could not parse JSON data from {}: {} at offset {}", source.GetName(),
+            GetParseError_En(reader.GetParseErrorCode()), reader.GetErrorOffset());
         return false;
     }
 
-    ToJSONValue(root_, document);
+    root_ = std::move(root);
 
     //SetMemoryUse(dataSize);
 
     return true;
 }
 
+bool JSONFile::ParseDocument(Deserializer& source, ValueDocument& document, bool inSitu)
+{
+    document.Clear();
+
+    const unsigned dataSize = source.GetSize() - source.GetPosition();
+    Reader reader;
+    ValueDocumentHandler handler(document);
+    bool success;
+    if (inSitu)
+    {
+        // The text lives as long as the document, so strings can point into it
+        auto* text = static_cast<char*>(document.GetArena().Allocate(dataSize + 1, 1));
+        if (!ReadJSONText(source, text, dataSize))
+            return false;
+        InsituStringStream stream(text);
+        success = !reader.Parse<JSON_PARSE_FLAGS | kParseInsituFlag>(stream, handler).IsError();
+    }
+    else
+    {
+        std::unique_ptr<char[]> text(new char[dataSize + 1]);
+        if (!ReadJSONText(source, text.get(), dataSize))
+            return false;
+        StringStream stream(text.get());
+        success = !reader.Parse<JSON_PARSE_FLAGS>(stream, handler).IsError();
+    }
+
+    if (!success)
+    {
+        SE_LOG_ERROR("Could not parse JSON data from {}: {} at offset {}", source.GetName(),
+            GetParseError_En(reader.GetParseErrorCode()), reader.GetErrorOffset());
+        document.Clear();
+        return false;
+    }
+    return true;
+}
+
 static void ToRapidjsonValue(rapidjson::Value& rapidjsonValue, const JSONValue& jsonValue, rapidjson::MemoryPoolAllocator<>& allocator)
 {
     switch (jsonValue.GetValueType())
@@ -178,6 +268,21 @@ bool JSONFile::Save(Serializer& dest) const
     return Save(dest, "\t");
 }
 
+bool JSONFile::SaveCooked(Serializer& dest) const
+{
+    return WriteCookedValue(dest, root_);
+}
+
+bool JSONFile::LoadCooked(Deserializer& source)
+{
+    JSONValue root;
+    if (!ReadCookedValue(source, root))
+        return false;
+
+    root_ = std::move(root);
+    return true;
+}
+
 bool JSONFile::Save(Serializer& dest, const String& indendation) const
 {
     rapidjson::Document document;
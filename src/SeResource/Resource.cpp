@@ -90,7 +90,12 @@ Resource::Resource(const String& typeName) :
     asyncLoadState_(ASYNC_DONE),
     type_(typeName)
 {
+    handle_ = ResourceSlotTable::Get().Acquire(this);
+}
 
+Resource::~Resource()
+{
+    ResourceSlotTable::Get().Release(handle_);
 }
 
 Resource* Resource::LoadFromCache(String type, const String& name)
@@ -133,6 +138,12 @@ bool Resource::EndLoad()
     return true;
 }
 
+bool Resource::EndLoadStep(bool& finished)
+{
+    finished = true;
+    return EndLoad();
+}
+
 bool Resource::Save(Serializer& dest) const
 {
     SE_LOG_ERROR("Save not supported for {}", this->GetType());
@@ -5,6 +5,7 @@
 #include <Se/Profiler.hpp>
 #include <Se/WorkQueue.h>
 #include <Se/IO/FileSystem.h>
+#include <Se/IO/MemoryBuffer.hpp>
 #include <SeVFS/FileWatcher.h>
 #include <Se/Console.hpp>
 #include <Se/IO/PackageFile.h>
@@ -63,6 +64,25 @@ static const char* checkDirs[] =
 
 static const std::shared_ptr<Resource> noResource;
 
+/// Return read order key of a resource: priority of the mount point and offset inside a package. Loose files go last.
+static std::pair<unsigned, unsigned> GetReadOrderKey(const VirtualFileSystem* vfs, const FileIdentifier& name)
+{
+    for (unsigned i = vfs->NumMountPoints(); i-- > 0;)
+    {
+        const MountPointPtr mountPoint = vfs->GetMountPoint(i);
+        if (!mountPoint || !mountPoint->Exists(name))
+            continue;
+
+        if (auto* package = dynamic_cast<PackageFile*>(mountPoint.get()))
+        {
+            if (const PackageEntry* entry = package->GetEntry(name.fileName_))
+                return {i, entry->offset_};
+        }
+        break;
+    }
+    return {M_MAX_UNSIGNED, 0};
+}
+
 std::unordered_map<String, std::function<std::shared_ptr<Resource>()>> ResourceCache::resourceFactory_;
 //std::vecto<String, String> ResourceCache::resourceNames_;
 
@@ -299,9 +319,10 @@ bool ResourceCache::ReloadResource(Resource* resource)
     resource->onReloadStarted();
 
     bool success = false;
+    HiresTimer ioTimer;
     AbstractFilePtr file = GetFile(resource->GetName());
     if (file)
-        success = resource->Load(*(file.get()));
+        success = LoadResource(*resource, *file, ioTimer.GetUSec(false));
 
     if (success)
     {
@@ -474,6 +495,7 @@ std::shared_ptr<Resource> ResourceCache::GetResource(String type, const String&
     }
 
     // Attempt to load the resource
+    HiresTimer ioTimer;
     const AbstractFilePtr file = GetFile(sanitatedName, sendEventOnFailure);
     if (!file)
         return nullptr;   // Error is already logged
@@ -482,7 +504,7 @@ std::shared_ptr<Resource> ResourceCache::GetResource(String type, const String&
     resource->SetName(sanitatedName);
     resource->SetAbsoluteFileName(file->GetAbsoluteName());
 
-    if (!resource->Load(*(file.get())))
+    if (!LoadResource(*resource, *file, ioTimer.GetUSec(false)))
     {
         // Error should already been logged by corresponding resource descendant class
         if (sendEventOnFailure)
@@ -502,6 +524,12 @@ std::shared_ptr<Resource> ResourceCache::GetResource(String type, const String&
     return resource;
 }
 
+ResourceHandle ResourceCache::GetResourceHandle(String type, const String& name, bool sendEventOnFailure)
+{
+    const std::shared_ptr<Resource> resource = GetResource(type, name, sendEventOnFailure);
+    return resource ? resource->GetHandle() : ResourceHandle{};
+}
+
 bool ResourceCache::BackgroundLoadResource(String type, const String& name, bool sendEventOnFailure, Resource* caller)
 {
 #ifdef SE_THREADING
@@ -522,6 +550,294 @@ bool ResourceCache::BackgroundLoadResource(String type, const String& name, bool
 #endif
 }
 
+bool ResourceCache::BeginLoadResource(Resource& resource, Deserializer& source)
+{
+    if (!cookCache_.IsEnabled() || !resource.GetCookVersion())
+        return resource.BeginLoad(source);
+
+    const ResourceCookKey key = cookCache_.GetSourceKey(source);
+    if (cookCache_.LoadCooked(resource, key))
+        return true;
+
+    if (!resource.BeginLoad(source))
+        return false;
+
+    cookCache_.StoreCooked(resource, key);
+    return true;
+}
+
+unsigned ResourceCache::PrefetchResources(const std::vector<ResourceRef>& resources, ResourcePrefetchCallback callback, bool sendEventOnFailure)
+{
+    if (!Thread::IsMainThread())
+    {
+        SE_LOG_ERROR("Attempted to prefetch resources from outside the main thread");
+        return 0;
+    }
+
+    SE_PROFILE("PrefetchResources");
+
+    auto batch = std::make_shared<BackgroundLoadBatch>();
+    batch->callback_ = std::move(callback);
+
+    // Drop duplicates and resources that are loaded already
+    std::vector<ResourceRef> pending;
+    pending.reserve(resources.size());
+    std::unordered_set<std::pair<String, String>> visited;
+    for (const ResourceRef& ref : resources)
+    {
+        String sanitatedName = SanitateResourceName(ref.name_);
+        if (sanitatedName.empty() || !visited.emplace(ref.type_, sanitatedName).second)
+            continue;
+
+        ++batch->progress_.numTotal_;
+        if (FindResource(ref.type_, sanitatedName))
+            ++batch->progress_.numLoaded_;
+        else
+            pending.emplace_back(ref.type_, sanitatedName);
+    }
+
+    // Order reads by package and offset inside the package so the loader streams sequentially
+    const auto* vfs = VirtualFileSystem::Get();
+    std::vector<std::pair<std::pair<unsigned, unsigned>, unsigned>> readOrder(pending.size());
+    for (unsigned i = 0; i < pending.size(); ++i)
+        readOrder[i] = {GetReadOrderKey(vfs, GetResolvedIdentifier(FileIdentifier::FromUri(pending[i].name_))), i};
+    std::sort(readOrder.begin(), readOrder.end());
+
+    std::vector<ResourceRef> sorted;
+    sorted.reserve(pending.size());
+    for (const auto& [_, index] : readOrder)
+        sorted.push_back(std::move(pending[index]));
+
+    unsigned numQueued = 0;
+#ifdef SE_THREADING
+    numQueued = backgroundLoader_->QueueResources(sorted, sendEventOnFailure, batch);
+#else
+    // When threading not supported, fall back to synchronous loading
+    for (const ResourceRef& ref : sorted)
+    {
+        if (GetResource(ref.type_, ref.name_, sendEventOnFailure))
+            ++batch->progress_.numLoaded_;
+        else
+            ++batch->progress_.numFailed_;
+
+        if (batch->callback_ && !batch->progress_.IsComplete())
+            batch->callback_(batch->progress_);
+    }
+#endif
+
+    // Report now if nothing is left to wait for, otherwise the loader reports completion
+    if (batch->progress_.IsComplete() && batch->callback_)
+        batch->callback_(batch->progress_);
+
+    return numQueued;
+}
+
+unsigned ResourceCache::PrefetchResources(const String& manifestFileName, ResourcePrefetchCallback callback, bool sendEventOnFailure)
+{
+    std::vector<ResourceRef> resources;
+    if (!LoadResourceManifest(manifestFileName, resources))
+        return 0;
+
+    return PrefetchResources(resources, std::move(callback), sendEventOnFailure);
+}
+
+unsigned ResourceCache::LoadResources(const std::vector<ResourceRef>& resources, bool sendEventOnFailure)
+{
+    if (!Thread::IsMainThread())
+    {
+        SE_LOG_ERROR("Attempted to load resources from outside the main thread");
+        return 0;
+    }
+
+    SE_PROFILE("LoadResources");
+
+    struct BatchItem
+    {
+        String type_;
+        std::shared_ptr<Resource> resource_;
+        ResourceLoadRecord record_;
+        std::size_t offset_{};
+        bool success_{};
+    };
+
+    // Drop duplicates and resources that are loaded already, create the rest
+    unsigned numLoaded = 0;
+    std::vector<BatchItem> items;
+    items.reserve(resources.size());
+    std::unordered_set<std::pair<String, String>> visited;
+    for (const ResourceRef& ref : resources)
+    {
+        String sanitatedName = SanitateResourceName(ref.name_);
+        if (sanitatedName.empty() || !visited.emplace(ref.type_, sanitatedName).second)
+            continue;
+
+#ifdef SE_THREADING
+        backgroundLoader_->WaitForResource(ref.type_, sanitatedName);
+#endif
+        if (FindResource(ref.type_, sanitatedName))
+        {
+            ++numLoaded;
+            continue;
+        }
+
+        std::shared_ptr<Resource> resource = CreateResource(ref.type_);
+        if (!resource)
+        {
+            if (sendEventOnFailure)
+            {
+                // E_UNKNOWNRESOURCETYPE
+                onUnknownResourceType(ref.type_);
+            }
+            continue;
+        }
+
+        resource->SetName(sanitatedName);
+        items.push_back(BatchItem{ref.type_, std::move(resource)});
+    }
+
+    // Read all files in one sequential pass into a single buffer, so the parsers never wait on the file system
+    const auto* vfs = VirtualFileSystem::Get();
+    std::vector<std::pair<std::pair<unsigned, unsigned>, unsigned>> readOrder(items.size());
+    for (unsigned i = 0; i < items.size(); ++i)
+        readOrder[i] = {GetReadOrderKey(vfs, GetResolvedIdentifier(FileIdentifier::FromUri(items[i].resource_->GetName()))), i};
+    std::sort(readOrder.begin(), readOrder.end());
+
+    std::vector<unsigned char> data;
+    for (const auto& [_, index] : readOrder)
+    {
+        BatchItem& item = items[index];
+        HiresTimer ioTimer;
+        const AbstractFilePtr file = GetFile(item.resource_->GetName(), sendEventOnFailure);
+        if (!file)
+        {
+            // Error is already logged
+            item.resource_ = nullptr;
+            continue;
+        }
+
+        SE_LOG_DEBUG("Loading resource " + item.resource_->GetName());
+        item.resource_->SetAbsoluteFileName(file->GetAbsoluteName());
+        const std::size_t size = file->GetSize();
+        item.offset_ = data.size();
+        item.record_.bytes_ = size;
+        data.resize(item.offset_ + size);
+        item.success_ = file->Read(data.data() + item.offset_, size) == size;
+        if (!item.success_)
+            SE_LOG_ERROR("Could not read resource '{}'", item.resource_->GetName());
+        item.record_.ioWaitUs_ = ioTimer.GetUSec(false);
+    }
+
+    // Parse in parallel. Each document is built into its own storage, so the workers share no parser state
+    ForEachParallel(WorkQueue::Get(), 1u, static_cast<unsigned>(items.size()), [&](unsigned beginIndex, unsigned endIndex)
+    {
+        for (unsigned i = beginIndex; i < endIndex; ++i)
+        {
+            BatchItem& item = items[i];
+            if (!item.success_)
+                continue;
+
+            MemoryBuffer source(data.data() + item.offset_, item.record_.bytes_);
+            source.SetName(item.resource_->GetName());
+            item.resource_->SetAsyncLoadState(ASYNC_LOADING);
+            HiresTimer timer;
+            item.success_ = BeginLoadResource(*item.resource_, source);
+            item.record_.beginLoadUs_ = timer.GetUSec(false);
+        }
+    });
+
+    // Finalize and store in request order on the main thread
+    std::unordered_set<String> changedTypes;
+    for (BatchItem& item : items)
+    {
+        if (!item.resource_)
+            continue;
+
+        Resource& resource = *item.resource_;
+        resource.SetAsyncLoadState(ASYNC_DONE);
+        if (item.success_)
+        {
+            HiresTimer timer;
+            item.success_ = resource.EndLoad();
+            item.record_.endLoadUs_ = timer.GetUSec(false);
+        }
+
+        item.record_.type_ = resource.GetType();
+        item.record_.name_ = resource.GetName();
+        item.record_.success_ = item.success_;
+        loadStats_.AddRecord(item.record_);
+
+        if (item.success_)
+            ++numLoaded;
+        else
+        {
+            // Error should already been logged by corresponding resource descendant class
+            if (sendEventOnFailure)
+                onLoadFailed(resource.GetName());
+
+            if (!returnFailedResources_)
+                continue;
+        }
+
+        resource.ResetUseTimer();
+        resourceGroups_[item.type_].resources_[resource.GetName()] = item.resource_;
+        changedTypes.insert(item.type_);
+    }
+
+    for (const String& type : changedTypes)
+        UpdateResourceGroup(type);
+
+    return numLoaded;
+}
+
+bool ResourceCache::SaveResourceManifest(const String& fileName) const
+{
+    JSONFile manifest;
+    JSONValue& list = manifest.GetRoot()["resources"];
+    list.SetType(VALUE_ARRAY);
+
+    {
+        MutexLock lock(resourceMutex_);
+        for (const auto& [type, group] : resourceGroups_)
+        {
+            for (const auto& [name, resource] : group.resources_)
+            {
+                JSONValue entry;
+                entry["type"] = type;
+                entry["name"] = name;
+                list.Push(entry);
+            }
+        }
+    }
+
+    if (!manifest.SaveFile(FileIdentifier::FromUri(fileName)))
+    {
+        SE_LOG_ERROR("Could not save resource manifest {}", fileName);
+        return false;
+    }
+    return true;
+}
+
+bool ResourceCache::LoadResourceManifest(const String& fileName, std::vector<ResourceRef>& result)
+{
+    JSONFile manifest;
+    if (!manifest.LoadFile(FileIdentifier::FromUri(fileName)))
+    {
+        SE_LOG_ERROR("Could not load resource manifest {}", fileName);
+        return false;
+    }
+
+    const JSONArray& list = manifest.GetRoot().Get("resources").GetArray();
+    result.reserve(result.size() + list.size());
+    for (const JSONValue& entry : list)
+    {
+        const String& type = entry.Get("type").GetString();
+        const String& name = entry.Get("name").GetString();
+        if (!type.empty() && !name.empty())
+            result.emplace_back(type, name);
+    }
+    return true;
+}
+
 std::shared_ptr<Resource> ResourceCache::GetTempResource(String type, const String& name, bool sendEventOnFailure)
 {
     String sanitatedName = SanitateResourceName(name);
@@ -547,6 +863,7 @@ std::shared_ptr<Resource> ResourceCache::GetTempResource(String type, const Stri
     }
 
     // Attempt to load the resource
+    HiresTimer ioTimer;
     AbstractFilePtr file = GetFile(sanitatedName, sendEventOnFailure);
     if (!file)
         return std::shared_ptr<Resource>();  // Error is already logged
@@ -555,7 +872,7 @@ std::shared_ptr<Resource> ResourceCache::GetTempResource(String type, const Stri
     resource->SetName(file->GetName());
     resource->SetAbsoluteFileName(file->GetAbsoluteName());
 
-    if (!resource->Load(*(file.get())))
+    if (!LoadResource(*resource, *file, ioTimer.GetUSec(false)))
     {
         // Error should already been logged by corresponding resource descendant class
         if (sendEventOnFailure)
@@ -725,9 +1042,41 @@ String ResourceCache::PrintMemoryUsage() const
     output += cformat("%-28s %4s %9s %9s %9s %9s\n", 
         "All", countString.c_str(), memUseString.c_str(), memMaxString.c_str(), 
         "-", memTotalString.c_str());
+
+    if (cookCache_.IsEnabled())
+        output += "\n" + cookCache_.PrintStats();
     return output;
 }
 
+bool ResourceCache::LoadResource(Resource& resource, Deserializer& source, long long ioWaitUs)
+{
+    // Same as Resource::Load(), but goes through the cooked resource cache and times each phase
+    SE_PROFILE_C("Load", PROFILER_COLOR_RESOURCES);
+    String eventName = format("{}::Load(\"{}\")", resource.GetType(), resource.GetName());
+    SE_PROFILE_ZONENAME(eventName);
+
+    ResourceLoadRecord record;
+    record.ioWaitUs_ = ioWaitUs;
+    record.bytes_ = source.GetSize();
+
+    resource.SetAsyncLoadState(Thread::IsMainThread() ? ASYNC_DONE : ASYNC_LOADING);
+    HiresTimer timer;
+    bool success = BeginLoadResource(resource, source);
+    record.beginLoadUs_ = timer.GetUSec(true);
+    if (success)
+    {
+        success = resource.EndLoad();
+        record.endLoadUs_ = timer.GetUSec(false);
+    }
+    resource.SetAsyncLoadState(ASYNC_DONE);
+
+    record.type_ = resource.GetType();
+    record.name_ = resource.GetName();
+    record.success_ = success;
+    loadStats_.AddRecord(record);
+    return success;
+}
+
 const std::shared_ptr<Resource>& ResourceCache::FindResource(String type, String nameHash)
 {
     MutexLock lock(resourceMutex_);
@@ -0,0 +1,352 @@
+#include <SeResource/ResourceCookCache.h>
+#include <SeResource/Resource.h>
+
+#include <Se/Console.hpp>
+#include <Se/Profiler.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <Se/IO/MappedFile.h>
+#include <Se/IO/MemoryBuffer.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace Se
+{
+
+/// Identifier of the cooked blob header.
+static const char* COOKED_FILE_ID = "SECK";
+
+ResourceCookCache::ResourceCookCache()
+{
+}
+
+void ResourceCookCache::SetCacheDir(const String& pathName)
+{
+    if (pathName.empty())
+    {
+        cacheDir_.clear();
+        return;
+    }
+
+    String cacheDir = AddTrailingSlash(pathName);
+    if (!FileSystem::Get().CreateDirsRecursive(cacheDir))
+    {
+        SE_LOG_ERROR("Could not create cooked resource cache directory {}", cacheDir);
+        return;
+    }
+
+    cacheDir_ = cacheDir;
+    SE_LOG_INFO("Cooked resource cache enabled at {}", cacheDir_);
+}
+
+String ResourceCookCache::GetCookedFileName(const String& type, const ResourceCookKey& key, unsigned version) const
+{
+    return cacheDir_ + type + "/" + String(cformat("%016llx_%llu_%u.cooked", key.hash_, key.size_, version));
+}
+
+ResourceCookKey ResourceCookCache::GetSourceKey(Deserializer& source)
+{
+    const std::size_t position = source.GetPosition();
+    const std::size_t remaining = source.GetSize() - position;
+    if (!remaining)
+        return {};
+
+    // Plain files are hashed from a mapping instead of being copied through the stream, and only again once they change
+    auto* file = dynamic_cast<File*>(&source);
+    if (file && !file->IsPackaged() && !position)
+    {
+        const String fileName = file->GetName();
+        const FileTime modifiedTime = FileSystem::Get().GetLastModifiedTime(fileName);
+        {
+            MutexLock lock(sourceFileKeysMutex_);
+            auto it = sourceFileKeys_.find(fileName);
+            if (it != sourceFileKeys_.end() && it->second.modifiedTime_ == modifiedTime && it->second.key_.size_ == remaining)
+                return it->second.key_;
+        }
+
+        MappedFile mappedFile;
+        if (mappedFile.OpenMapped(fileName) && mappedFile.GetSize() == remaining)
+        {
+            SE_PROFILE("HashCookSource");
+            const ResourceCookKey key{HashCookSource(0, mappedFile.GetData(), remaining), remaining};
+            MutexLock lock(sourceFileKeysMutex_);
+            sourceFileKeys_[fileName] = {modifiedTime, key};
+            return key;
+        }
+    }
+
+    SE_PROFILE("HashCookSource");
+
+    ResourceCookKey key{0, remaining};
+    unsigned char block[65536];
+    std::size_t hashed = 0;
+    while (hashed < remaining)
+    {
+        const std::size_t readBytes = source.Read(block, std::min(sizeof block, remaining - hashed));
+        if (!readBytes)
+            break;
+        key.hash_ = HashCookSource(key.hash_, block, readBytes);
+        hashed += readBytes;
+    }
+    source.Seek(position);
+    return hashed == remaining ? key : ResourceCookKey{};
+}
+
+bool ResourceCookCache::LoadCooked(Resource& resource, const ResourceCookKey& key)
+{
+    const unsigned version = resource.GetCookVersion();
+    if (!IsEnabled() || !version || !key.IsValid())
+        return false;
+
+    SE_PROFILE("LoadCookedResource");
+
+    const String fileName = GetCookedFileName(resource.GetType(), key, version);
+    if (!FileSystem::Get().FileExists(fileName))
+    {
+        ++misses_;
+        return false;
+    }
+
+    // The resource decodes straight from the mapped blob
+    MappedFile blob(fileName);
+    MemoryBuffer header(blob.GetData(), blob.GetSize());
+    if (!blob.IsOpen() || header.ReadFileID() != COOKED_FILE_ID || header.ReadUInt64() != key.hash_
+        || header.ReadUInt64() != key.size_ || header.ReadUInt() != version)
+    {
+        SE_LOG_WARNING("Discarding invalid cooked blob {} for resource {}", fileName, resource.GetName());
+        ++misses_;
+        return false;
+    }
+
+    MemoryBuffer buffer(blob.GetData() + header.GetPosition(), blob.GetSize() - header.GetPosition());
+    if (!resource.LoadCooked(buffer))
+    {
+        SE_LOG_WARNING("Could not load cooked blob {} for resource {}", fileName, resource.GetName());
+        ++misses_;
+        return false;
+    }
+
+    ++hits_;
+    return true;
+}
+
+bool ResourceCookCache::StoreCooked(const Resource& resource, const ResourceCookKey& key)
+{
+    const unsigned version = resource.GetCookVersion();
+    if (!IsEnabled() || !version || !key.IsValid())
+        return false;
+
+    SE_PROFILE("StoreCookedResource");
+
+    auto& fileSystem = FileSystem::Get();
+    const String fileName = GetCookedFileName(resource.GetType(), key, version);
+    if (!fileSystem.CreateDirsRecursive(GetPath(fileName)))
+        return false;
+
+    // Write to a unique temporary first so that concurrent readers never observe a partial blob
+    static std::atomic<unsigned> tempCounter{};
+    const String tempFileName = fileName + String(cformat(".%u.tmp", ++tempCounter));
+    {
+        File file(tempFileName, FILE_WRITE);
+        if (!file.IsOpen())
+            return false;
+
+        bool success = file.WriteFileID(COOKED_FILE_ID);
+        success &= file.WriteUInt64(key.hash_);
+        success &= file.WriteUInt64(key.size_);
+        success &= file.WriteUInt(version);
+        if (!success || !resource.SaveCooked(file))
+        {
+            file.Close();
+            fileSystem.Delete(tempFileName);
+            return false;
+        }
+    }
+
+    if (!fileSystem.Rename(tempFileName, fileName))
+    {
+        fileSystem.Delete(tempFileName);
+        return false;
+    }
+
+    ++stores_;
+    return true;
+}
+
+float ResourceCookCache::GetHitRate() const
+{
+    const unsigned hits = hits_;
+    const unsigned total = hits + misses_;
+    return total ? static_cast<float>(hits) / total : 0.0f;
+}
+
+void ResourceCookCache::ResetStats()
+{
+    hits_ = 0;
+    misses_ = 0;
+    stores_ = 0;
+}
+
+String ResourceCookCache::PrintStats() const
+{
+    return cformat("Cooked resource cache: %u hits, %u misses, %u stored, hit rate %.1f%%\n",
+        GetNumHits(), GetNumMisses(), GetNumStores(), GetHitRate() * 100.0f);
+}
+
+/// Mix one 64-bit word into the hash.
+static inline unsigned long long MixCookWord(unsigned long long hash, unsigned long long word)
+{
+    word *= 0x87c37b91114253d5ull;
+    word = (word << 31) | (word >> 33);
+    word *= 0x4cf5ad432745937full;
+    hash ^= word;
+    hash = (hash << 27) | (hash >> 37);
+    return hash * 5 + 0x52dce729;
+}
+
+unsigned long long HashCookSource(unsigned long long hash, const unsigned char* data, std::size_t size)
+{
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        unsigned long long word;
+        memcpy(&word, data + i, sizeof word);
+        hash = MixCookWord(hash, word);
+    }
+
+    if (i < size)
+    {
+        unsigned long long word = size - i;
+        for (unsigned shift = 8; i < size; ++i, shift += 8)
+            word |= static_cast<unsigned long long>(data[i]) << shift;
+        hash = MixCookWord(hash, word);
+    }
+    return hash;
+}
+
+bool WriteCookedValue(Serializer& dest, const Value& value)
+{
+    bool success = dest.WriteUByte((unsigned char)value.GetValueType());
+    switch (value.GetValueType())
+    {
+    case VALUE_BOOL:
+        success &= dest.WriteBool(value.GetBool());
+        break;
+
+    case VALUE_NUMBER:
+        success &= dest.WriteUByte((unsigned char)value.GetNumberType());
+        success &= dest.WriteDouble(value.GetDouble());
+        break;
+
+    case VALUE_STRING:
+        success &= dest.WriteVLE(value.GetString().length());
+        success &= dest.WriteStringData(value.GetString());
+        break;
+
+    case VALUE_ARRAY:
+        success &= dest.WriteVLE(value.Size());
+        for (const Value& element : value.GetArray())
+            success &= WriteCookedValue(dest, element);
+        break;
+
+    case VALUE_OBJECT:
+        success &= dest.WriteVLE(value.Size());
+        for (const auto& [key, element] : value.GetObject())
+        {
+            success &= dest.WriteVLE(key.length());
+            success &= dest.WriteStringData(key);
+            success &= WriteCookedValue(dest, element);
+        }
+        break;
+
+    default:
+        break;
+    }
+    return success;
+}
+
+static bool ReadCookedString(Deserializer& source, String& value)
+{
+    const unsigned length = source.ReadVLE();
+    if (length > source.GetSize() - source.GetPosition())
+        return false;
+
+    value.resize(length);
+    return !length || source.Read(&value[0], length) == length;
+}
+
+bool ReadCookedValue(Deserializer& source, Value& value)
+{
+    if (source.IsEof())
+        return false;
+
+    const auto valueType = static_cast<ValueType>(source.ReadUByte());
+    switch (valueType)
+    {
+    case VALUE_NULL:
+        value.SetType(VALUE_NULL);
+        return true;
+
+    case VALUE_BOOL:
+        value = source.ReadBool();
+        return true;
+
+    case VALUE_NUMBER:
+    {
+        const auto numberType = static_cast<ValueNumberType>(source.ReadUByte());
+        const double number = source.ReadDouble();
+        if (numberType == VALUE_NT_INT)
+            value = static_cast<int>(number);
+        else if (numberType == VALUE_NT_UINT)
+            value = static_cast<unsigned>(number);
+        else
+            value = number;
+        return true;
+    }
+
+    case VALUE_STRING:
+    {
+        String string;
+        if (!ReadCookedString(source, string))
+            return false;
+        value = string;
+        return true;
+    }
+
+    case VALUE_ARRAY:
+    {
+        const unsigned size = source.ReadVLE();
+        if (size > source.GetSize() - source.GetPosition())
+            return false;
+        value.SetType(VALUE_ARRAY);
+        value.Resize(size);
+        for (unsigned i = 0; i < size; ++i)
+        {
+            if (!ReadCookedValue(source, value[i]))
+                return false;
+        }
+        return true;
+    }
+
+    case VALUE_OBJECT:
+    {
+        const unsigned size = source.ReadVLE();
+        if (size > source.GetSize() - source.GetPosition())
+            return false;
+        value.SetType(VALUE_OBJECT);
+        String key;
+        for (unsigned i = 0; i < size; ++i)
+        {
+            if (!ReadCookedString(source, key) || !ReadCookedValue(source, value[key]))
+                return false;
+        }
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+}
@@ -0,0 +1,68 @@
+#include <SeResource/ResourceHandle.h>
+
+namespace Se
+{
+
+ResourceHandle ResourceSlotTable::Acquire(Resource* resource)
+{
+    MutexLock lock(mutex_);
+
+    unsigned index;
+    if (!freeSlots_.empty())
+    {
+        index = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+    else
+    {
+        if (numSlots_ >= PageSize * MaxPages)
+            return ResourceHandle{};
+
+        index = numSlots_++;
+        if (index % PageSize == 0)
+        {
+            pageStorage_.emplace_back(new Slot[PageSize]);
+            pages_[index / PageSize].store(pageStorage_.back().get(), std::memory_order_release);
+        }
+    }
+
+    Slot& slot = pages_[index / PageSize].load(std::memory_order_relaxed)[index % PageSize];
+    // Released after the generation of the previous occupant was bumped, see Get()
+    slot.resource_.store(resource, std::memory_order_release);
+    return ResourceHandle{index, slot.generation_.load(std::memory_order_relaxed)};
+}
+
+void ResourceSlotTable::Release(const ResourceHandle& handle)
+{
+    MutexLock lock(mutex_);
+
+    if (handle.index_ >= numSlots_)
+        return;
+
+    Slot& slot = pages_[handle.index_ / PageSize].load(std::memory_order_relaxed)[handle.index_ % PageSize];
+    if (slot.generation_.load(std::memory_order_relaxed) != handle.generation_)
+        return;
+
+    // Skip zero on wrap-around, it marks an unassigned handle
+    unsigned generation = handle.generation_ + 1;
+    if (!generation)
+        generation = 1;
+    slot.generation_.store(generation, std::memory_order_release);
+    slot.resource_.store(nullptr, std::memory_order_relaxed);
+    freeSlots_.push_back(handle.index_);
+}
+
+unsigned ResourceSlotTable::GetNumUsed() const
+{
+    MutexLock lock(mutex_);
+    return numSlots_ - static_cast<unsigned>(freeSlots_.size());
+}
+
+ResourceSlotTable& ResourceSlotTable::Get()
+{
+    // Never destroyed, as resources may outlive static destruction order
+    static ResourceSlotTable* ptr_ = new ResourceSlotTable();
+    return *ptr_;
+}
+
+}
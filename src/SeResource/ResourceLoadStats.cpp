@@ -0,0 +1,202 @@
+#include <SeResource/ResourceLoadStats.h>
+#include <SeResource/JSONFile.h>
+
+#include <Se/Console.hpp>
+#include <SeVFS/FileIdentifier.h>
+
+#include <algorithm>
+
+namespace Se
+{
+
+void ResourceLoadHistogram::Add(long long us)
+{
+    us = std::max(us, 0LL);
+
+    unsigned index = 0;
+    while (index < NumBuckets - 1 && us >= GetBucketUpperBoundUs(index))
+        ++index;
+
+    ++buckets_[index];
+    ++count_;
+    totalUs_ += us;
+    maxUs_ = std::max(maxUs_, us);
+}
+
+long long ResourceLoadHistogram::GetBucketUpperBoundUs(unsigned index)
+{
+    return index < NumBuckets - 1 ? FirstBucketUs << index : -1;
+}
+
+JSONValue ResourceLoadHistogram::ToJSON() const
+{
+    JSONValue result;
+    result["count"] = count_;
+    result["totalUs"] = static_cast<double>(totalUs_);
+    result["averageUs"] = static_cast<double>(GetAverageUs());
+    result["maxUs"] = static_cast<double>(maxUs_);
+
+    JSONValue& buckets = result["buckets"];
+    buckets.SetType(VALUE_ARRAY);
+    for (unsigned i = 0; i < NumBuckets; ++i)
+    {
+        JSONValue bucket;
+        bucket["upperUs"] = static_cast<double>(GetBucketUpperBoundUs(i));
+        bucket["count"] = buckets_[i];
+        buckets.Push(bucket);
+    }
+    return result;
+}
+
+void ResourceLoadStats::AddRecord(const ResourceLoadRecord& record)
+{
+    if (!enabled_)
+        return;
+
+    MutexLock lock(mutex_);
+
+    ResourceLoadTypeStats& stats = typeStats_[record.type_];
+    ++stats.count_;
+    if (!record.success_)
+        ++stats.failed_;
+    stats.bytes_ += record.bytes_;
+    if (record.background_)
+        stats.queueWait_.Add(record.queueWaitUs_);
+    stats.ioWait_.Add(record.ioWaitUs_);
+    stats.beginLoad_.Add(record.beginLoadUs_);
+    stats.endLoad_.Add(record.endLoadUs_);
+
+    if (!keepRecords_ || !maxRecords_)
+        return;
+
+    // Overwrite the oldest record once full so that long sessions do not grow without bound
+    if (records_.size() < maxRecords_)
+        records_.push_back(record);
+    else
+    {
+        records_[firstRecord_] = record;
+        firstRecord_ = (firstRecord_ + 1) % records_.size();
+    }
+}
+
+void ResourceLoadStats::SetMaxRecords(unsigned count)
+{
+    MutexLock lock(mutex_);
+
+    std::vector<ResourceLoadRecord> records = GetRecordsLocked();
+    if (records.size() > count)
+        records.erase(records.begin(), records.end() - count);
+    records_ = std::move(records);
+    firstRecord_ = 0;
+    maxRecords_ = count;
+}
+
+unsigned ResourceLoadStats::GetMaxRecords() const
+{
+    MutexLock lock(mutex_);
+    return maxRecords_;
+}
+
+void ResourceLoadStats::Clear()
+{
+    MutexLock lock(mutex_);
+    records_.clear();
+    firstRecord_ = 0;
+    typeStats_.clear();
+}
+
+std::vector<ResourceLoadRecord> ResourceLoadStats::GetRecords() const
+{
+    MutexLock lock(mutex_);
+    return GetRecordsLocked();
+}
+
+std::vector<ResourceLoadRecord> ResourceLoadStats::GetRecordsLocked() const
+{
+    std::vector<ResourceLoadRecord> result;
+    result.reserve(records_.size());
+    result.insert(result.end(), records_.begin() + firstRecord_, records_.end());
+    result.insert(result.end(), records_.begin(), records_.begin() + firstRecord_);
+    return result;
+}
+
+std::unordered_map<String, ResourceLoadTypeStats> ResourceLoadStats::GetTypeStats() const
+{
+    MutexLock lock(mutex_);
+    return typeStats_;
+}
+
+long long ResourceLoadStats::GetAverageEndLoadUs(const String& type) const
+{
+    MutexLock lock(mutex_);
+    auto i = typeStats_.find(type);
+    return i != typeStats_.end() ? i->second.endLoad_.GetAverageUs() : 0;
+}
+
+JSONValue ResourceLoadStats::ToJSON() const
+{
+    MutexLock lock(mutex_);
+
+    JSONValue result;
+    JSONValue& types = result["types"];
+    types.SetType(VALUE_OBJECT);
+    for (const auto& [type, stats] : typeStats_)
+    {
+        JSONValue& entry = types[type];
+        entry["count"] = stats.count_;
+        entry["failed"] = stats.failed_;
+        entry["bytes"] = static_cast<double>(stats.bytes_);
+        entry["queueWait"] = stats.queueWait_.ToJSON();
+        entry["ioWait"] = stats.ioWait_.ToJSON();
+        entry["beginLoad"] = stats.beginLoad_.ToJSON();
+        entry["endLoad"] = stats.endLoad_.ToJSON();
+    }
+
+    JSONValue& records = result["resources"];
+    records.SetType(VALUE_ARRAY);
+    for (const ResourceLoadRecord& record : GetRecordsLocked())
+    {
+        JSONValue entry;
+        entry["type"] = record.type_;
+        entry["name"] = record.name_;
+        entry["queueWaitUs"] = static_cast<double>(record.queueWaitUs_);
+        entry["ioWaitUs"] = static_cast<double>(record.ioWaitUs_);
+        entry["beginLoadUs"] = static_cast<double>(record.beginLoadUs_);
+        entry["endLoadUs"] = static_cast<double>(record.endLoadUs_);
+        entry["bytes"] = static_cast<double>(record.bytes_);
+        entry["background"] = record.background_;
+        entry["success"] = record.success_;
+        records.Push(entry);
+    }
+    return result;
+}
+
+bool ResourceLoadStats::SaveJSON(const String& fileName) const
+{
+    JSONFile file;
+    file.GetRoot() = ToJSON();
+    if (!file.SaveFile(FileIdentifier::FromUri(fileName)))
+    {
+        SE_LOG_ERROR("Could not save resource load statistics to {}", fileName);
+        return false;
+    }
+    return true;
+}
+
+String ResourceLoadStats::PrintStats() const
+{
+    const auto typeStats = GetTypeStats();
+
+    String output = "Resource Type                 Cnt  Fail      Size   Queue/avg  Open/avg   Begin/avg   End/avg   Begin/max\n\n";
+    for (const auto& [type, stats] : typeStats)
+    {
+        output += cformat("%-28s %4u %5u %9s %9.2fms %7.2fms %9.2fms %7.2fms %9.2fms\n",
+            type.c_str(), stats.count_, stats.failed_, StringMemory(stats.bytes_).c_str(),
+            stats.queueWait_.GetAverageUs() / 1000.0, stats.ioWait_.GetAverageUs() / 1000.0,
+            stats.beginLoad_.GetAverageUs() / 1000.0, stats.endLoad_.GetAverageUs() / 1000.0,
+            stats.beginLoad_.maxUs_ / 1000.0);
+    }
+    return output;
+}
+
+}
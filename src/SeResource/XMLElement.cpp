@@ -13,6 +13,9 @@ namespace Se
 
 const XMLElement XMLElement::EMPTY;
 
+std::unordered_map<String, std::shared_ptr<const XPathQuery>> XPathQuery::cache_;
+std::mutex XPathQuery::cacheMutex_;
+
 XMLElement::XMLElement() :
     node_(nullptr),
     xpathResultSet_(nullptr),
@@ -220,18 +223,22 @@ XMLElement XMLElement::SelectSingle(const String& query, pugi::xpath_variable_se
     if (IsNullWithFile())
         return XMLElement();
 
+    // Queries without variables are compiled once and shared
+    if (!variables)
+        return SelectSinglePrepared(*XPathQuery::GetCached(query));
+
     const pugi::xml_node& node = xpathNode_ ? xpathNode_->node() : pugi::xml_node(node_);
-    pugi::xpath_node result = node.select_single_node(query.c_str(), variables);
+    pugi::xpath_node result = node.select_node(query.c_str(), variables);
     return XMLElement(file_, nullptr, &result, 0);
 }
 
 XMLElement XMLElement::SelectSinglePrepared(const XPathQuery& query) const
 {
-    if (!file_ || (!node_ && !xpathNode_ && !query.GetXPathQuery()))
+    if (IsNullWithFile() || !query.GetXPathQuery())
         return XMLElement();
 
     const pugi::xml_node& node = xpathNode_ ? xpathNode_->node() : pugi::xml_node(node_);
-    pugi::xpath_node result = node.select_single_node(*query.GetXPathQuery());
+    pugi::xpath_node result = node.select_node(*query.GetXPathQuery());
     return XMLElement(file_, nullptr, &result, 0);
 }
 
@@ -240,6 +247,10 @@ XPathResultSet XMLElement::Select(const String& query, pugi::xpath_variable_set*
     if (IsNullWithFile())
         return XPathResultSet();
 
+    // Queries without variables are compiled once and shared
+    if (!variables)
+        return SelectPrepared(*XPathQuery::GetCached(query));
+
     const pugi::xml_node& node = xpathNode_ ? xpathNode_->node() : pugi::xml_node(node_);
     pugi::xpath_node_set result = node.select_nodes(query.c_str(), variables);
     return XPathResultSet(file_, &result);
@@ -247,7 +258,7 @@ XPathResultSet XMLElement::Select(const String& query, pugi::xpath_variable_set*
 
 XPathResultSet XMLElement::SelectPrepared(const XPathQuery& query) const
 {
-    if (!file_ || (!node_ && !xpathNode_ && query.GetXPathQuery()))
+    if (IsNullWithFile() || !query.GetXPathQuery())
         return XPathResultSet();
 
     const pugi::xml_node& node = xpathNode_ ? xpathNode_->node() : pugi::xml_node(node_);
@@ -1100,6 +1111,30 @@ XPathQuery::XPathQuery(const String& queryString, const String& variableString)
 
 XPathQuery::~XPathQuery() = default;
 
+std::shared_ptr<const XPathQuery> XPathQuery::GetCached(const String& queryString)
+{
+    static const unsigned maxCachedQueries = 1024;
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto iter = cache_.find(queryString);
+    if (iter != cache_.end())
+        return iter->second;
+
+    // Queries are rarely generated at runtime, so simply start over when the cache grows too large
+    if (cache_.size() >= maxCachedQueries)
+        cache_.clear();
+
+    auto query = std::make_shared<const XPathQuery>(queryString);
+    cache_.emplace(queryString, query);
+    return query;
+}
+
+void XPathQuery::ClearCache()
+{
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    cache_.clear();
+}
+
 void XPathQuery::Bind()
 {
     // Delete previous query object and create a new one binding it with variable set
@@ -1,5 +1,6 @@
 
 #include <Se/Profiler.hpp>
+#include <Se/Timer.h>
 #include <Se/IO/Deserializer.hpp>
 #include <Se/Console.hpp>
 #include <Se/IO/MemoryBuffer.hpp>
@@ -55,6 +56,9 @@ XMLFile::~XMLFile() {}
 
 bool XMLFile::BeginLoad(Deserializer& source)
 {
+    patchDocument_.reset();
+    nextPatch_ = nullptr;
+
     unsigned dataSize = source.GetSize();
     if (!dataSize && !source.GetName().empty())
     {
@@ -62,11 +66,20 @@ bool XMLFile::BeginLoad(Deserializer& source)
         return false;
     }
 
-    std::shared_ptr<char> buffer(new char[dataSize], std::default_delete<char[]>());
-    if (source.Read(buffer.get(), dataSize) != dataSize)
+    // Read into memory owned by the document and parse it in place, without the extra copy made by load_buffer
+    void* buffer = pugi::get_memory_allocation_function()(dataSize ? dataSize : 1);
+    if (!buffer)
+    {
+        SE_LOG_ERROR("Could not allocate {} bytes for XML data from {}", dataSize, source.GetName());
+        return false;
+    }
+    if (source.Read(buffer, dataSize) != dataSize)
+    {
+        pugi::get_memory_deallocation_function()(buffer);
         return false;
+    }
 
-    if (!document_->load_buffer(buffer.get(), dataSize))
+    if (!document_->load_buffer_inplace_own(buffer, dataSize))
     {
         SE_LOG_ERROR("Could not parse XML data from " + source.GetName());
         document_->reset();
@@ -82,20 +95,20 @@ bool XMLFile::BeginLoad(Deserializer& source)
         //auto vfs = VirtualFileSystem::Get();
         // If being async loaded, GetResource() is not safe, so use GetTempResource() instead
         auto inheritedXMLFile = std::make_shared<XMLFile>();
-        inheritedXMLFile->LoadFile(inherit);
         //XMLFile* inheritedXMLFile = GetAsyncLoadState() == ASYNC_DONE ? cache->GetResource<XMLFile>(inherit) :
         //    cache->GetTempResource<XMLFile>(inherit);
-        if (!inheritedXMLFile)
+        if (!inheritedXMLFile->LoadFile(inherit))
         {
             SE_LOG_ERROR("Could not find inherited XML file: {}", inherit.c_str());
             return false;
         }
 
-        // Patch this XMLFile and leave the original inherited XMLFile as it is
-        std::unique_ptr<pugi::xml_document> patchDocument(document_.release());
-        document_ = std::make_unique<pugi::xml_document>();
-        document_->reset(*inheritedXMLFile->document_);
-        Patch(rootElem);
+        // Take over the inherited document, it is loaded for this file only. Every patch node runs an XPath query
+        // over the whole document, so the patch is applied in EndLoad() where background loads can slice it
+        patchDocument_ = std::move(document_);
+        document_ = std::move(inheritedXMLFile->document_);
+        inheritedXMLFile->document_ = std::make_unique<pugi::xml_document>();
+        nextPatch_ = pugi::xml_node(rootElem.GetNode()).first_child().internal_object();
 
         // Store resource dependencies so we know when to reload/repatch when the inherited resource changes
         //cache->StoreResourceDependency(this, inherit);
@@ -109,6 +122,42 @@ bool XMLFile::BeginLoad(Deserializer& source)
     return true;
 }
 
+bool XMLFile::EndLoad()
+{
+    while (nextPatch_)
+        ApplyNextPatch();
+    patchDocument_.reset();
+    return true;
+}
+
+bool XMLFile::EndLoadStep(bool& finished)
+{
+    // Apply at least one patch node per step so that a slow node cannot stall the load
+    HiresTimer timer;
+    unsigned numApplied = 0;
+    while (nextPatch_ && (!numApplied || timer.GetUSec(false) < PatchStepUs))
+    {
+        ApplyNextPatch();
+        ++numApplied;
+    }
+    numPatchesApplied_ += numApplied;
+    patchUs_ += timer.GetUSec(false);
+
+    finished = !nextPatch_;
+    if (finished)
+        patchDocument_.reset();
+    return true;
+}
+
+long long XMLFile::GetEndLoadCostEstimate() const
+{
+    // Without a pending patch only the resource state is left to update
+    if (!nextPatch_)
+        return 1;
+    // A slice overshoots by at most one patch node
+    return PatchStepUs + (numPatchesApplied_ ? patchUs_ / numPatchesApplied_ : 0);
+}
+
 bool XMLFile::Save(Serializer& dest) const
 {
     return Save(dest, "\t");
@@ -212,32 +261,42 @@ void XMLFile::Patch(const XMLElement& patchElement)
     pugi::xml_node root = pugi::xml_node(patchElement.GetNode());
 
     for (auto& patch : root)
-    {
-        pugi::xml_attribute sel = patch.attribute("sel");
-        if (sel.empty())
-        {
-            SE_LOG_ERROR("XML Patch failed due to node not having a sel attribute.");
-            continue;
-        }
+        ApplyPatch(patch);
+}
 
-        // Only select a single node at a time, they can use xpath to select specific ones in multiple otherwise the node set becomes invalid due to changes
-        //pugi::xpath_node original = document_->select_single_node(sel.value());
-        pugi::xpath_node original = document_->select_node(sel.value());
-        if (!original)
-        {
-            SE_LOG_ERROR("XML Patch failed with bad select: {}.", sel.value());
-            continue;
-        }
+void XMLFile::ApplyNextPatch()
+{
+    const pugi::xml_node patch(nextPatch_);
+    nextPatch_ = patch.next_sibling().internal_object();
+    ApplyPatch(patch);
+}
 
-        if (strcmp(patch.name(), "add") == 0)
-            PatchAdd(patch, original);
-        else if (strcmp(patch.name(), "replace") == 0)
-            PatchReplace(patch, original);
-        else if (strcmp(patch.name(), "remove") == 0)
-            PatchRemove(original);
-        else
-            SE_LOG_ERROR("XMLFiles used for patching should only use 'add', 'replace' or 'remove' elements.");
+void XMLFile::ApplyPatch(const pugi::xml_node& patch) const
+{
+    pugi::xml_attribute sel = patch.attribute("sel");
+    if (sel.empty())
+    {
+        SE_LOG_ERROR("XML Patch failed due to node not having a sel attribute.");
+        return;
     }
+
+    // Only select a single node at a time, they can use xpath to select specific ones in multiple otherwise the node set becomes invalid due to changes
+    //pugi::xpath_node original = document_->select_single_node(sel.value());
+    pugi::xpath_node original = document_->select_node(sel.value());
+    if (!original)
+    {
+        SE_LOG_ERROR("XML Patch failed with bad select: {}.", sel.value());
+        return;
+    }
+
+    if (strcmp(patch.name(), "add") == 0)
+        PatchAdd(patch, original);
+    else if (strcmp(patch.name(), "replace") == 0)
+        PatchReplace(patch, original);
+    else if (strcmp(patch.name(), "remove") == 0)
+        PatchRemove(original);
+    else
+        SE_LOG_ERROR("XMLFiles used for patching should only use 'add', 'replace' or 'remove' elements.");
 }
 
 void XMLFile::PatchAdd(const pugi::xml_node& patch, pugi::xpath_node& original) const
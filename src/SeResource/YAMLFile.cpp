@@ -7,81 +7,169 @@
 #include <Se/String.hpp>
 #include <Se/IO/Serializer.hpp>
 #include <Se/IO/Deserializer.hpp>
+#include <Se/ValueDocument.h>
 #include <SeResource/JSONValue.h>
+#include <SeResource/ResourceCookCache.h>
 
+#include <cctype>
+#include <charconv>
+#include <climits>
 #include <cstring>
 
-#ifndef strtof64
-#define strtof64 strtof
-#endif
-
 namespace Se
 {
 
-Value ToValue(const ryml::ConstNodeRef& node)
+/// Fills a Value in place from YAML events. Containers are added to their parent before they are filled, so no
+/// subtree is copied or moved into place afterwards.
+class YAMLValueBuilder
 {
-    Value value;
-    if (node.is_map())
+public:
+    /// Construct with the value to fill.
+    explicit YAMLValueBuilder(Value& root) : root_(root) {}
+
+    bool Null() { Add().SetType(VALUE_NULL); return true; }
+    bool Bool(bool value) { Add() = value; return true; }
+    bool Int(int value) { Add() = value; return true; }
+    bool Double(double value) { Add() = value; return true; }
+    bool String(std::string_view value) { Add() = Se::String(value.data(), value.length()); return true; }
+    bool StartMap() { Open(VALUE_OBJECT); return true; }
+    bool Key(std::string_view key) { key_.assign(key.data(), key.length()); return true; }
+    bool EndMap() { stack_.pop_back(); return true; }
+    bool StartSeq() { Open(VALUE_ARRAY); return true; }
+    bool EndSeq() { stack_.pop_back(); return true; }
+
+private:
+    /// Return the next value slot: the root, a new sequence element or the member for the last key.
+    Value& Add()
     {
-        for (auto child : node.children())
+        if (stack_.empty())
+            return root_;
+
+        Value& parent = *stack_.back();
+        if (parent.IsArray())
         {
-            auto keyTmp = String(child.key().str, child.key().size());
-            value.Set(keyTmp, ToValue(child));
+            parent.Push(Value::EMPTY);
+            return parent[parent.Size() - 1];
         }
+        return parent[key_];
     }
-    else if (node.is_seq())
+
+    /// Add a container and make it the current parent. Only the innermost container grows, so the pointers to the
+    /// outer ones stay valid.
+    void Open(ValueType type)
     {
-        for (auto child : node.children())
-        {
-            value.Push(ToValue(child));
-        }
+        Value& value = Add();
+        value.SetType(type);
+        stack_.push_back(&value);
     }
-    else if(node.key_is_null() && node.val_is_null())
-    {
 
-    }
-    else if (node.is_keyval())
-    {  
-        auto yamlValue = node.val();
-        Value tmpValue = Value::EMPTY;
+    /// Value being filled.
+    Value& root_;
+    /// Open maps and sequences.
+    std::vector<Value*> stack_;
+    /// Last map key.
+    Se::String key_;
+};
+
+/// Forwards YAML events to a value document.
+class YAMLDocumentBuilder
+{
+public:
+    /// Construct with the document to fill.
+    explicit YAMLDocumentBuilder(ValueDocument& document) : document_(document) {}
+
+    bool Null() { return document_.Null(); }
+    bool Bool(bool value) { return document_.Bool(value); }
+    bool Int(int value) { return document_.Int(value); }
+    bool Double(double value) { return document_.Double(value); }
+    bool String(std::string_view value) { return document_.String(value.data(), static_cast<unsigned>(value.length())); }
+    bool StartMap() { return document_.StartObject(); }
+    bool Key(std::string_view key) { return document_.Key(key.data(), static_cast<unsigned>(key.length())); }
+    bool EndMap() { return document_.EndObject(); }
+    bool StartSeq() { return document_.StartArray(); }
+    bool EndSeq() { return document_.EndArray(); }
+
+private:
+    /// Document being filled.
+    ValueDocument& document_;
+};
 
-        // Handle primitive types
-        if (yamlValue.is_number() && yamlValue.is_integer()) 
+/// Report a scalar value. Plain scalars that parse completely as an integer or a real become numbers; integers outside
+/// the int range keep their text, like before.
+template <class Handler> static bool EmitScalar(Handler& handler, const ryml::Tree& tree, ryml::id_type node)
+{
+    const ryml::csubstr scalar = tree.val(node);
+    const std::string_view text(scalar.str, scalar.len);
+    if (tree.is_val_quoted(node))
+        return handler.String(text);
+    if (text.empty() || ryml::scalar_is_null(scalar))
+        return handler.Null();
+    if (text == "true")
+        return handler.Bool(true);
+    if (text == "false")
+        return handler.Bool(false);
+
+    // std::from_chars does not take a leading plus, and would read "inf" and "nan" which YAML spells differently
+    const char* first = text.data() + (text[0] == '+' ? 1 : 0);
+    const char* last = text.data() + text.length();
+    const char* digits = first != last && *first == '-' ? first + 1 : first;
+    if (digits != last && (isdigit(static_cast<unsigned char>(*digits)) || *digits == '.'))
+    {
+        long long intValue;
+        const std::from_chars_result intResult = std::from_chars(first, last, intValue);
+        if (intResult.ptr == last)
         {
-            long long llValue = strtoll(yamlValue.str, nullptr, 10);
-            if (llValue >= INT_MIN && llValue <= INT_MAX)
-                tmpValue = (int)llValue;
-            else
-                tmpValue = String(yamlValue.str, yamlValue.size());
+            if (intResult.ec == std::errc() && intValue >= INT_MIN && intValue <= INT_MAX)
+                return handler.Int(static_cast<int>(intValue));
+            return handler.String(text);
         }
-        else if (yamlValue.is_number() && yamlValue.is_unsigned_integer())
+
+        double doubleValue;
+        const std::from_chars_result doubleResult = std::from_chars(first, last, doubleValue);
+        if (doubleResult.ec == std::errc() && doubleResult.ptr == last)
+            return handler.Double(doubleValue);
+    }
+    return handler.String(text);
+}
+
+/// Report a node and its children in document order. A stream of several documents reads as a sequence.
+template <class Handler> static bool EmitNode(Handler& handler, const ryml::Tree& tree, ryml::id_type node)
+{
+    if (tree.is_map(node))
+    {
+        if (!handler.StartMap())
+            return false;
+        for (ryml::id_type child = tree.first_child(node); child != ryml::NONE; child = tree.next_sibling(child))
         {
-            unsigned long long ullValue = strtoull(yamlValue.str, nullptr, 10);
-            if (ullValue >= 0 && ullValue <= UINT_MAX)
-                tmpValue = (unsigned)ullValue;
-            else
-                tmpValue = String(yamlValue.str, yamlValue.size());
+            const ryml::csubstr key = tree.key(child);
+            if (!handler.Key(std::string_view(key.str, key.len)) || !EmitNode(handler, tree, child))
+                return false;
         }
-        else if (yamlValue.is_number() && yamlValue.is_real()) {
-            tmpValue = yamlValue.str ? strtof64(yamlValue.str, nullptr) : 0;
-        } 
-        else {
-            String tmpStr = yamlValue.str ? String(yamlValue.str, yamlValue.size()) : "";
-            if (tmpStr == "true" || tmpStr == "false")
-                tmpValue = ToBool(tmpStr);
-
-            else if (yamlValue.str)
-                tmpValue = yamlValue.str ? String(yamlValue.str, yamlValue.size()) : "";
-        }
-
-        value = tmpValue;
+        return handler.EndMap();
     }
 
-    else if (node.has_val())
+    if (tree.is_seq(node))
     {
-        value = Value::EMPTY;
+        if (!handler.StartSeq())
+            return false;
+        for (ryml::id_type child = tree.first_child(node); child != ryml::NONE; child = tree.next_sibling(child))
+        {
+            if (!EmitNode(handler, tree, child))
+                return false;
+        }
+        return handler.EndSeq();
     }
-    return value;
+
+    if (tree.has_val(node))
+        return EmitScalar(handler, tree, node);
+    return handler.Null();
+}
+
+/// Read the source text and parse it in place. The tree views into the text, so both must be kept together.
+static void ParseYAMLTree(Deserializer& source, String& text, ryml::Tree& tree)
+{
+    text = source.ReadString();
+    ryml::parse_in_place(ryml::to_substr(text), &tree);
 }
 
 void ToYml(ryml::NodeRef* node, const Value& input)
@@ -144,11 +232,41 @@ void ToYml(ryml::NodeRef* node, const Value& input)
     //     node->set_val(input.To.c_str());
 }
 
-bool YAMLFile::BeginLoad(Deserializer& source) {
-    
-    String content = source.ReadString();
-    ryml::Tree tree = ryml::parse_in_place(ryml::to_substr(content));
-    value_ = ToValue(tree.crootref());
+bool YAMLFile::BeginLoad(Deserializer& source)
+{
+    String text;
+    ryml::Tree tree;
+    ParseYAMLTree(source, text, tree);
+
+    Value value;
+    YAMLValueBuilder builder(value);
+    EmitNode(builder, tree, tree.root_id());
+    value_ = std::move(value);
+    return true;
+}
+
+bool YAMLFile::Parse(Deserializer& source, YAMLEventHandler& handler)
+{
+    String text;
+    ryml::Tree tree;
+    ParseYAMLTree(source, text, tree);
+    return EmitNode(handler, tree, tree.root_id());
+}
+
+bool YAMLFile::ParseDocument(Deserializer& source, ValueDocument& document)
+{
+    document.Clear();
+
+    String text;
+    ryml::Tree tree;
+    ParseYAMLTree(source, text, tree);
+    YAMLDocumentBuilder builder(document);
+    if (!EmitNode(builder, tree, tree.root_id()))
+    {
+        SE_LOG_ERROR("Could not build document from YAML data in {}", source.GetName());
+        document.Clear();
+        return false;
+    }
     return true;
 }
 
@@ -178,4 +296,19 @@ bool YAMLFile::Save(Serializer& dest) const
     return dest.WriteString(ToString());
 }
 
+bool YAMLFile::SaveCooked(Serializer& dest) const
+{
+    return WriteCookedValue(dest, value_);
+}
+
+bool YAMLFile::LoadCooked(Deserializer& source)
+{
+    Value value;
+    if (!ReadCookedValue(source, value))
+        return false;
+
+    value_ = std::move(value);
+    return true;
+}
+
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Se/String.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+// Reference coders shared by the Base64 test and benchmark
+
+namespace Se
+{
+
+inline const char referenceAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/// Character at a time reference encoder.
+inline String EncodeReference(const std::vector<unsigned char>& data)
+{
+    String result;
+    for (std::size_t i = 0; i < data.size(); i += 3)
+    {
+        const unsigned remaining = static_cast<unsigned>(std::min<std::size_t>(3, data.size() - i));
+        unsigned triple = 0;
+        for (unsigned j = 0; j < 3; ++j)
+            triple = triple << 8u | (j < remaining ? data[i + j] : 0u);
+        for (unsigned j = 0; j < 4; ++j)
+            result += j <= remaining ? referenceAlphabet[triple >> (18u - 6u * j) & 0x3fu] : '=';
+    }
+    return result;
+}
+
+/// Character at a time reference decoder.
+inline std::vector<unsigned char> DecodeReference(const String& text)
+{
+    std::vector<unsigned char> result;
+    unsigned accumulator = 0;
+    unsigned bits = 0;
+    for (char ch : text)
+    {
+        const char* found = strchr(referenceAlphabet, ch);
+        if (ch == '=' || !found)
+            break;
+        accumulator = accumulator << 6u | static_cast<unsigned>(found - referenceAlphabet);
+        bits += 6;
+        if (bits >= 8)
+        {
+            bits -= 8;
+            result.push_back(static_cast<unsigned char>(accumulator >> bits));
+        }
+    }
+    return result;
+}
+
+}
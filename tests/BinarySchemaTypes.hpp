@@ -0,0 +1,146 @@
+#pragma once
+
+#include <Se/Console.hpp>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <Se/IO/VectorBuffer.h>
+#include <SeArc/ArchiveSerialization.hpp>
+#include <SeResource/BinaryArchive.h>
+
+// Types shared by the BinarySchema test and benchmark
+
+namespace Se
+{
+
+struct SchemaPoint
+{
+    float x_{};
+    float y_{};
+    float z_{};
+    int id_{};
+
+    static constexpr auto GetArchiveFields()
+    {
+        return std::make_tuple(MakeArchiveField("x", &SchemaPoint::x_), MakeArchiveField("y", &SchemaPoint::y_),
+            MakeArchiveField("z", &SchemaPoint::z_), MakeArchiveField("id", &SchemaPoint::id_));
+    }
+
+    bool operator ==(const SchemaPoint& rhs) const { return x_ == rhs.x_ && y_ == rhs.y_ && z_ == rhs.z_ && id_ == rhs.id_; }
+};
+
+struct SchemaRecord
+{
+    String name_;
+    int id_{};
+    bool enabled_{};
+    double weight_{};
+    SchemaPoint origin_;
+    std::vector<float> samples_;
+    std::vector<SchemaPoint> points_;
+    std::vector<String> tags_;
+
+    static constexpr auto GetArchiveFields()
+    {
+        return std::make_tuple(MakeArchiveField("name", &SchemaRecord::name_), MakeArchiveField("id", &SchemaRecord::id_),
+            MakeArchiveField("enabled", &SchemaRecord::enabled_), MakeArchiveField("weight", &SchemaRecord::weight_),
+            MakeArchiveField("origin", &SchemaRecord::origin_), MakeArchiveField("samples", &SchemaRecord::samples_),
+            MakeArchiveField("points", &SchemaRecord::points_), MakeArchiveField("tags", &SchemaRecord::tags_));
+    }
+
+    bool operator ==(const SchemaRecord& rhs) const
+    {
+        return name_ == rhs.name_ && id_ == rhs.id_ && enabled_ == rhs.enabled_ && weight_ == rhs.weight_
+            && origin_ == rhs.origin_ && samples_ == rhs.samples_ && points_ == rhs.points_ && tags_ == rhs.tags_;
+    }
+};
+
+struct SchemaScene
+{
+    unsigned version_{};
+    std::vector<SchemaRecord> records_;
+
+    static constexpr auto GetArchiveFields()
+    {
+        return std::make_tuple(MakeArchiveField("version", &SchemaScene::version_),
+            MakeArchiveField("records", &SchemaScene::records_));
+    }
+};
+
+/// Same layout as SchemaPoint, serialized through the archive.
+struct LegacyPoint
+{
+    float x_{};
+    float y_{};
+    float z_{};
+    int id_{};
+
+    void SerializeInBlock(Archive& archive)
+    {
+        SerializeValue(archive, "x", x_);
+        SerializeValue(archive, "y", y_);
+        SerializeValue(archive, "z", z_);
+        SerializeValue(archive, "id", id_);
+    }
+};
+
+/// Same layout as SchemaRecord, serialized through the archive.
+struct LegacyRecord
+{
+    String name_;
+    int id_{};
+    bool enabled_{};
+    double weight_{};
+    LegacyPoint origin_;
+    std::vector<float> samples_;
+    std::vector<LegacyPoint> points_;
+    std::vector<String> tags_;
+
+    void SerializeInBlock(Archive& archive)
+    {
+        SerializeValue(archive, "name", name_);
+        SerializeValue(archive, "id", id_);
+        SerializeValue(archive, "enabled", enabled_);
+        SerializeValue(archive, "weight", weight_);
+        SerializeValue(archive, "origin", origin_);
+        SerializeValue(archive, "samples", samples_);
+        SerializeValue(archive, "points", points_);
+        SerializeValue(archive, "tags", tags_);
+    }
+};
+
+struct LegacyScene
+{
+    unsigned version_{};
+    std::vector<LegacyRecord> records_;
+
+    void SerializeInBlock(Archive& archive)
+    {
+        SerializeValue(archive, "version", version_);
+        SerializeValue(archive, "records", records_);
+    }
+};
+
+template <class T> void SaveBinary(VectorBuffer& buffer, T& value)
+{
+    BinaryOutputArchive archive(buffer);
+    SerializeValue(archive, "scene", value);
+    archive.Flush();
+}
+
+template <class T> bool LoadBinary(const VectorBuffer& buffer, T& value)
+{
+    MemoryBuffer source(buffer.GetData(), buffer.GetSize());
+    try
+    {
+        BinaryInputArchive archive(source);
+        SerializeValue(archive, "scene", value);
+        archive.Flush();
+        return true;
+    }
+    catch (const ArchiveException& e)
+    {
+        SE_LOG_PRINT("Expected error: {}", e.what());
+        return false;
+    }
+}
+
+}
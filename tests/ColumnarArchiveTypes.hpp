@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Se/Console.hpp>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <Se/IO/VectorBuffer.h>
+#include <SeArc/ArchiveSerialization.hpp>
+#include <SeResource/BinaryArchive.h>
+
+// Types shared by the ColumnarArchive test and benchmark
+
+namespace Se
+{
+
+struct ColumnParticle
+{
+    float x_{};
+    float y_{};
+    float z_{};
+    int id_{};
+    bool active_{};
+    String name_;
+
+    static constexpr auto GetArchiveFields()
+    {
+        return std::make_tuple(MakeArchiveField("x", &ColumnParticle::x_), MakeArchiveField("y", &ColumnParticle::y_),
+            MakeArchiveField("z", &ColumnParticle::z_), MakeArchiveField("id", &ColumnParticle::id_),
+            MakeArchiveField("active", &ColumnParticle::active_), MakeArchiveField("name", &ColumnParticle::name_));
+    }
+
+    bool operator ==(const ColumnParticle& rhs) const
+    {
+        return x_ == rhs.x_ && y_ == rhs.y_ && z_ == rhs.z_ && id_ == rhs.id_ && active_ == rhs.active_ && name_ == rhs.name_;
+    }
+};
+
+struct ColumnSystem
+{
+    std::vector<ColumnParticle> particles_;
+    bool columns_{true};
+    bool compress_{};
+
+    void SerializeInBlock(Archive& archive)
+    {
+        if (columns_)
+            LibSTD::SerializeVectorAsColumns(archive, "particles", particles_, compress_);
+        else
+            LibSTD::SerializeVectorAsObjects(archive, "particles", particles_);
+    }
+};
+
+template <class T>
+bool SaveSystemBinary(VectorBuffer& buffer, T& system)
+{
+    BinaryOutputArchive archive(buffer);
+    SerializeValue(archive, "system", system);
+    archive.Flush();
+    return true;
+}
+
+template <class T>
+bool LoadSystemBinary(const VectorBuffer& buffer, T& system)
+{
+    MemoryBuffer source(buffer.GetData(), buffer.GetSize());
+    try
+    {
+        BinaryInputArchive archive(source);
+        SerializeValue(archive, "system", system);
+        archive.Flush();
+        return true;
+    }
+    catch (const ArchiveException& e)
+    {
+        SE_LOG_PRINT("Expected error: {}", e.what());
+        return false;
+    }
+}
+
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Se/Console.hpp>
+
+#include <chrono>
+
+/// Measures wall-clock time between laps of a benchmark.
+class BenchTimer
+{
+public:
+    /// Return microseconds elapsed since construction or the previous lap and start the next lap.
+    long long Lap()
+    {
+        const Clock::time_point now = Clock::now();
+        const long long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - start_).count();
+        start_ = now;
+        return elapsed;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    /// Start of the current lap.
+    Clock::time_point start_{Clock::now()};
+};
+
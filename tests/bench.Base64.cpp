@@ -0,0 +1,36 @@
+#include "SeBench.hpp"
+#include "Base64Reference.hpp"
+
+#include <Se/Base64.h>
+
+#include <random>
+
+using namespace Se;
+
+void BenchBase64()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench Base64\n"
+              "-------------------------------------------------------");
+
+    // Throughput against the character at a time implementation
+    std::mt19937 random(42);
+    std::vector<unsigned char> payload(8 * 1024 * 1024);
+    for (unsigned char& byte : payload)
+        byte = static_cast<unsigned char>(random());
+
+    BenchTimer timer;
+    const String referenceText = EncodeReference(payload);
+    const long long referenceEncodeTime = timer.Lap();
+    const std::vector<unsigned char> referenceBytes = DecodeReference(referenceText);
+    const long long referenceDecodeTime = timer.Lap();
+    String payloadText;
+    BufferToBase64String(payloadText, payload.data(), payload.size());
+    const long long encodeTime = timer.Lap();
+    std::vector<unsigned char> payloadBytes;
+    Base64StringToBuffer(payloadBytes, payloadText);
+    const long long decodeTime = timer.Lap();
+
+    SE_LOG_PRINT("{} KB base64: per character encode {} us decode {} us, vectorized encode {} us decode {} us",
+        payload.size() / 1024, referenceEncodeTime, referenceDecodeTime, encodeTime, decodeTime);
+}
@@ -0,0 +1,42 @@
+#include "SeBench.hpp"
+#include "BinarySchemaTypes.hpp"
+
+using namespace Se;
+
+void BenchBinarySchema()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench BinarySchema\n"
+              "-------------------------------------------------------");
+
+    SchemaScene scene;
+    LegacyScene legacy;
+    scene.version_ = legacy.version_ = 2;
+    const unsigned numRecords = 20000;
+    for (unsigned i = 0; i < numRecords; ++i)
+    {
+        const float f = i * 0.5f;
+        scene.records_.push_back(SchemaRecord{cformat("record%u", i), static_cast<int>(i), i % 3 == 0, i * 0.25,
+            {f, 1.0f, -f, 7}, {f, f + 1.0f}, {{f, 0.0f, 1.0f, 1}, {2.0f, f, 3.0f, 2}}, {"a", "b"}});
+        legacy.records_.push_back(LegacyRecord{cformat("record%u", i), static_cast<int>(i), i % 3 == 0, i * 0.25,
+            {f, 1.0f, -f, 7}, {f, f + 1.0f}, {{f, 0.0f, 1.0f, 1}, {2.0f, f, 3.0f, 2}}, {"a", "b"}});
+    }
+
+    BenchTimer timer;
+    VectorBuffer legacyBuffer;
+    SaveBinary(legacyBuffer, legacy);
+    const long long legacySaveTime = timer.Lap();
+    VectorBuffer schemaBuffer;
+    SaveBinary(schemaBuffer, scene);
+    const long long schemaSaveTime = timer.Lap();
+
+    LegacyScene legacyLoaded;
+    LoadBinary(schemaBuffer, legacyLoaded);
+    const long long legacyLoadTime = timer.Lap();
+    SchemaScene schemaLoaded;
+    LoadBinary(legacyBuffer, schemaLoaded);
+    const long long schemaLoadTime = timer.Lap();
+
+    SE_LOG_PRINT("{} KB binary: SerializeInBlock save {} us load {} us, field list save {} us load {} us",
+        schemaBuffer.GetSize() / 1024, legacySaveTime, legacyLoadTime, schemaSaveTime, schemaLoadTime);
+}
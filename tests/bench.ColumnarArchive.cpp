@@ -0,0 +1,45 @@
+#include "SeBench.hpp"
+#include "ColumnarArchiveTypes.hpp"
+
+using namespace Se;
+
+void BenchColumnarArchive()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench ColumnarArchive\n"
+              "-------------------------------------------------------");
+
+    // Large arrays in binary: objects, columns and compressed columns
+    ColumnSystem large;
+    const unsigned numParticles = 1000000;
+    large.particles_.reserve(numParticles);
+    for (unsigned i = 0; i < numParticles; ++i)
+    {
+        large.particles_.push_back(ColumnParticle{static_cast<float>(i % 1000), 0.0f, 2.0f, static_cast<int>(i),
+            i % 7 != 0, i % 100 == 0 ? "marked" : ""});
+    }
+
+    long long saveTimes[3]{};
+    long long loadTimes[3]{};
+    unsigned sizes[3]{};
+    for (unsigned mode = 0; mode < 3; ++mode)
+    {
+        large.columns_ = mode != 0;
+        large.compress_ = mode == 2;
+
+        BenchTimer timer;
+        VectorBuffer buffer;
+        SaveSystemBinary(buffer, large);
+        saveTimes[mode] = timer.Lap();
+
+        ColumnSystem largeLoaded;
+        largeLoaded.columns_ = large.columns_;
+        LoadSystemBinary(buffer, largeLoaded);
+        loadTimes[mode] = timer.Lap();
+        sizes[mode] = buffer.GetSize();
+    }
+
+    SE_LOG_PRINT("{} particles in binary: objects {} KB save {} us load {} us, columns {} KB save {} us load {} us, "
+        "LZ4 columns {} KB save {} us load {} us", numParticles, sizes[0] / 1024, saveTimes[0], loadTimes[0],
+        sizes[1] / 1024, saveTimes[1], loadTimes[1], sizes[2] / 1024, saveTimes[2], loadTimes[2]);
+}
@@ -0,0 +1,51 @@
+#include "SeBench.hpp"
+
+#include <SeResource/ImageCube.h>
+
+#include <cmath>
+
+using namespace Se;
+
+void BenchImageCube()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench ImageCube\n"
+              "-------------------------------------------------------");
+
+    const int panoramaWidth = 512;
+    Image panorama;
+    panorama.SetSize(panoramaWidth, panoramaWidth / 2, 4, ChannelFormat::Float32);
+    for (int y = 0; y < panorama.GetHeight(); ++y)
+    {
+        const float up = sinf((0.5f - (y + 0.5f) / panorama.GetHeight()) * M_PI);
+        for (int x = 0; x < panorama.GetWidth(); ++x)
+            panorama.SetPixel(x, y, Color(1.0f + up, 1.0f + up, 1.0f, 1.0f));
+    }
+
+    ImageCube largeCube;
+    largeCube.SetEquirectangular(&panorama, 128, ChannelFormat::Float16);
+
+    // Bulk projection against per-texel calls
+    BenchTimer timer;
+    Vector3 perTexelSum = Vector3::ZERO;
+    for (unsigned i = 0; i < MAX_CUBEMAP_FACES; ++i)
+    {
+        const auto face = static_cast<CubeMapFace>(i);
+        for (int y = 0; y < largeCube.GetWidth(); ++y)
+        {
+            for (int x = 0; x < largeCube.GetWidth(); ++x)
+            {
+                const Color color = largeCube.GetImage(face)->GetPixel(x, y);
+                perTexelSum += largeCube.ProjectTexelOnCube(face, x, y).Normalized() * color.r_;
+            }
+        }
+    }
+    const long long perTexelTime = timer.Lap();
+    largeCube.ProjectSphericalHarmonics9();
+    const long long bulkTime = timer.Lap();
+    largeCube.GeneratePrefilteredGGX(8, ChannelFormat::Float16);
+    const long long prefilterTime = timer.Lap();
+
+    SE_LOG_PRINT("128x128 cube: per-texel L1 loop {} us (sum {}), bulk SH9 {} us, 8 level GGX prefilter {} us", perTexelTime,
+        perTexelSum.y_, bulkTime, prefilterTime);
+}
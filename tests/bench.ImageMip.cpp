@@ -0,0 +1,63 @@
+#include "SeBench.hpp"
+
+#include <SeResource/Image.h>
+
+#include <random>
+
+using namespace Se;
+
+namespace
+{
+
+/// Return time of building the whole mip chain by chained GetNextLevel() calls in microseconds.
+long long TimeChainedLevels(const Image& source)
+{
+    Image image;
+    image.SetSize(source.GetWidth(), source.GetHeight(), source.GetComponents());
+    image.SetData(source.GetData());
+
+    BenchTimer timer;
+    std::shared_ptr<Image> current = image.GetNextLevel();
+    while (current->GetWidth() > 1 || current->GetHeight() > 1)
+        current = current->GetNextLevel();
+    return timer.Lap();
+}
+
+/// Return time of GenerateLevels() in microseconds.
+long long TimeGeneratedLevels(const Image& source, MipFilter filter, bool gammaCorrect)
+{
+    Image image;
+    image.SetSize(source.GetWidth(), source.GetHeight(), source.GetComponents());
+    image.SetData(source.GetData());
+
+    BenchTimer timer;
+    image.GenerateLevels(filter, gammaCorrect);
+    return timer.Lap();
+}
+
+}
+
+void BenchImageMip()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench ImageMip\n"
+              "-------------------------------------------------------");
+
+    std::mt19937 random(31);
+    for (unsigned components : {1u, 4u})
+    {
+        Image source;
+        source.SetSize(2048, 2048, components);
+        const unsigned dataSize = source.GetWidth() * source.GetHeight() * components;
+        for (unsigned i = 0; i < dataSize; ++i)
+            source.GetData()[i] = static_cast<unsigned char>(random());
+
+        const long long chainedTime = TimeChainedLevels(source);
+        const long long boxTime = TimeGeneratedLevels(source, MipFilter::Box, false);
+        const long long gammaTime = TimeGeneratedLevels(source, MipFilter::Box, true);
+        const long long kaiserTime = TimeGeneratedLevels(source, MipFilter::Kaiser, false);
+
+        SE_LOG_PRINT("2048x2048x{} mip chain: chained GetNextLevel {} us, GenerateLevels box {} us, "
+            "gamma-correct box {} us, Kaiser {} us", components, chainedTime, boxTime, gammaTime, kaiserTime);
+    }
+}
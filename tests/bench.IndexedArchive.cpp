@@ -0,0 +1,92 @@
+#include "SeBench.hpp"
+
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <Se/IO/MappedFile.h>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <SeArc/ArchiveSerialization.hpp>
+#include <SeResource/IndexedArchive.h>
+
+using namespace Se;
+
+namespace
+{
+
+struct BenchChunk
+{
+    int x_{};
+    int y_{};
+    std::vector<String> names_;
+    std::vector<float> heights_;
+
+    void SerializeInBlock(Archive& archive)
+    {
+        SerializeValue(archive, "x", x_);
+        SerializeValue(archive, "y", y_);
+        SerializeValue(archive, "names", names_);
+        SerializeValue(archive, "heights", heights_);
+    }
+};
+
+}
+
+void BenchIndexedArchive()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench IndexedArchive\n"
+              "-------------------------------------------------------");
+
+    auto& fileSystem = FileSystem::Get();
+    const String fileName = fileSystem.GetTemporaryDir() + "SeIndexedArchiveBench.bin";
+    const String sequentialFileName = fileSystem.GetTemporaryDir() + "SeIndexedArchiveBench.seq";
+
+    const int gridSize = 16;
+    std::vector<BenchChunk> chunks;
+    IndexedArchiveWriter writer;
+    for (int y = 0; y < gridSize; ++y)
+    {
+        for (int x = 0; x < gridSize; ++x)
+        {
+            BenchChunk chunk{x, y, {}, {}};
+            for (unsigned i = 0; i < 1000; ++i)
+            {
+                chunk.names_.push_back(cformat("object_%d_%d_%u", x, y, i));
+                chunk.heights_.push_back(x * 0.5f + y + i);
+            }
+            writer.SaveObject(cformat("chunk_%d_%d", x, y), chunk);
+            chunks.push_back(std::move(chunk));
+        }
+    }
+    writer.SaveFile(fileName);
+    {
+        File file(sequentialFileName, FILE_WRITE);
+        BinaryOutputArchive archive(file);
+        SerializeValue(archive, "chunks", chunks);
+        archive.Flush();
+    }
+
+    // Loading the last chunk against a single sequential archive of all chunks
+    BenchTimer timer;
+    std::vector<BenchChunk> sequential;
+    {
+        MappedFile mapped(sequentialFileName);
+        MemoryBuffer buffer(mapped.GetData(), mapped.GetSize());
+        BinaryInputArchive archive(buffer);
+        SerializeValue(archive, "chunks", sequential);
+        archive.Flush();
+    }
+    const long long sequentialTime = timer.Lap();
+    {
+        IndexedArchiveReader reader;
+        BenchChunk last;
+        reader.Open(fileName);
+        reader.LoadObject("chunk_15_15", last);
+    }
+    const long long indexedTime = timer.Lap();
+
+    SE_LOG_PRINT("Last of {} chunks: sequential archive {} us, indexed archive {} us", chunks.size(), sequentialTime,
+        indexedTime);
+
+    fileSystem.Delete(fileName);
+    fileSystem.Delete(sequentialFileName);
+}
@@ -0,0 +1,39 @@
+#include "SeBench.hpp"
+
+#include <Se/IO/MemoryBuffer.hpp>
+#include <Se/ValueDocument.h>
+#include <SeResource/JSONFile.h>
+
+using namespace Se;
+
+void BenchJSONFile()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench JSONFile\n"
+              "-------------------------------------------------------");
+
+    JSONValue records(VALUE_ARRAY);
+    const unsigned numRecords = 20000;
+    for (unsigned i = 0; i < numRecords; ++i)
+    {
+        JSONValue record;
+        record["id"] = i;
+        record["name"] = cformat("record \"%u\"", i);
+        record["position"].Push(i * 0.5);
+        record["position"].Push(-1.0);
+        records.Push(record);
+    }
+    const String largeText = ToPrettyString(records);
+
+    BenchTimer timer;
+    JSONFile largeFile;
+    largeFile.FromString(largeText);
+    const long long valueTime = timer.Lap();
+    MemoryBuffer largeBuffer(largeText.c_str(), largeText.length());
+    ValueDocument largeDocument;
+    JSONFile::ParseDocument(largeBuffer, largeDocument);
+    const long long documentTime = timer.Lap();
+
+    SE_LOG_PRINT("{} KB JSON: load to Value {} us, in-situ ValueDocument {} us", largeText.length() / 1024, valueTime,
+        documentTime);
+}
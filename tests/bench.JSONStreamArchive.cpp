@@ -0,0 +1,76 @@
+#include "SeBench.hpp"
+
+#include <Se/IO/MemoryBuffer.hpp>
+#include <SeArc/ArchiveSerialization.hpp>
+#include <SeResource/JSONArchive.h>
+#include <SeResource/JSONFile.h>
+
+using namespace Se;
+
+namespace
+{
+
+struct BenchArchiveItem
+{
+    String name_;
+    float weight_{};
+    std::vector<int> counts_;
+
+    void SerializeInBlock(Archive& archive)
+    {
+        SerializeValue(archive, "name", name_);
+        SerializeValue(archive, "weight", weight_);
+        SerializeValue(archive, "counts", counts_);
+    }
+};
+
+struct BenchArchiveConfig
+{
+    std::vector<BenchArchiveItem> items_;
+
+    void SerializeInBlock(Archive& archive)
+    {
+        SerializeValue(archive, "items", items_);
+    }
+};
+
+}
+
+void BenchJSONStreamArchive()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench JSONStreamArchive\n"
+              "-------------------------------------------------------");
+
+    BenchArchiveConfig large;
+    const unsigned numItems = 20000;
+    for (unsigned i = 0; i < numItems; ++i)
+        large.items_.push_back(BenchArchiveItem{cformat("item%u", i), i * 0.25f, {1, 2, static_cast<int>(i)}});
+    JSONFile largeOutput;
+    largeOutput.SaveObject("config", large);
+    const String largeText = largeOutput.ToString();
+
+    BenchTimer timer;
+    JSONFile largeFile;
+    BenchArchiveConfig largeLoaded;
+    largeFile.FromString(largeText);
+    largeFile.LoadObject("config", largeLoaded);
+    const long long valueTime = timer.Lap();
+
+    BenchArchiveConfig largeStreamed;
+    MemoryBuffer buffer(largeText.c_str(), largeText.length());
+    try
+    {
+        JSONStreamInputArchive archive(buffer);
+        SerializeValue(archive, "config", largeStreamed);
+        archive.Flush();
+    }
+    catch (const ArchiveException& e)
+    {
+        SE_LOG_ERROR("Could not stream config: {}", e.what());
+    }
+    const long long streamTime = timer.Lap();
+
+    SE_LOG_PRINT("{} KB JSON config: JSONFile + JSONInputArchive {} us, JSONStreamInputArchive {} us",
+        largeText.length() / 1024, valueTime, streamTime);
+}
@@ -0,0 +1,97 @@
+#include "SeBench.hpp"
+
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <Se/Thread.h>
+#include <Se/WorkQueue.h>
+#include <SeResource/JSONFile.h>
+#include <SeResource/ResourceCache.h>
+#include <SeResource/XMLFile.h>
+#include <SeResource/YAMLFile.h>
+#include <SeVFS/VirtualFileSystem.h>
+
+#include <thread>
+
+using namespace Se;
+
+namespace
+{
+
+void WriteBenchFile(const String& fileName, const String& text)
+{
+    File file(fileName, FILE_WRITE);
+    file.Write(text.c_str(), text.length());
+}
+
+}
+
+void BenchResourceBatch()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench ResourceBatch\n"
+              "-------------------------------------------------------");
+
+    Thread::SetMainThread();
+    ResourceCache::RegisterResource<JSONFile>(JSONFile::GetTypeStatic());
+    ResourceCache::RegisterResource<YAMLFile>(YAMLFile::GetTypeStatic());
+    ResourceCache::RegisterResource<XMLFile>(XMLFile::GetTypeStatic());
+
+    auto* workQueue = WorkQueue::Get();
+    const unsigned numCores = std::thread::hardware_concurrency();
+    if (workQueue->GetNumThreads() == 0 && numCores > 1)
+        workQueue->CreateThreads(numCores - 1);
+
+    // Small level documents of each text format
+    auto& fileSystem = FileSystem::Get();
+    const String dataDir = fileSystem.GetTemporaryDir() + "SeResourceBatchBench/";
+    fileSystem.RemoveDir(dataDir, true);
+    fileSystem.CreateDir(dataDir);
+
+    const unsigned numDocuments = 100;
+    const unsigned numEntries = 200;
+    std::vector<ResourceRef> refs;
+    for (unsigned i = 0; i < numDocuments; ++i)
+    {
+        String json = cformat("{\"id\": %u, \"entries\": [", i);
+        String yaml = cformat("id: %u\nentries:\n", i);
+        String xml = cformat("<document id=\"%u\">\n", i);
+        for (unsigned j = 0; j < numEntries; ++j)
+        {
+            json += cformat("%s{\"name\": \"entry%u\", \"value\": %u.5}", j ? ", " : "", j, j);
+            yaml += cformat("  - name: entry%u\n    value: %u.5\n", j, j);
+            xml += cformat("    <entry name=\"entry%u\" value=\"%u.5\" />\n", j, j);
+        }
+        json += "]}";
+        xml += "</document>\n";
+
+        const String name = cformat("doc%u", i);
+        WriteBenchFile(dataDir + name + ".json", json);
+        WriteBenchFile(dataDir + name + ".yaml", yaml);
+        WriteBenchFile(dataDir + name + ".xml", xml);
+        refs.emplace_back(JSONFile::GetTypeStatic(), name + ".json");
+        refs.emplace_back(YAMLFile::GetTypeStatic(), name + ".yaml");
+        refs.emplace_back(XMLFile::GetTypeStatic(), name + ".xml");
+    }
+
+    auto vfs = VirtualFileSystem::Get();
+    auto mountPoint = vfs->MountDir(dataDir);
+    auto& cache = ResourceCache::Get();
+
+    // One after another against batched
+    BenchTimer timer;
+    for (const ResourceRef& ref : refs)
+        cache.GetResource(ref.type_, ref.name_);
+    const long long sequentialTime = timer.Lap();
+    cache.ReleaseAllResources(true);
+
+    timer.Lap();
+    cache.LoadResources(refs);
+    const long long batchTime = timer.Lap();
+
+    SE_LOG_PRINT("{} documents with {} worker threads: one by one {} us, batched {} us", refs.size(),
+        workQueue->GetNumThreads(), sequentialTime, batchTime);
+
+    cache.ReleaseAllResources(true);
+    vfs->Unmount(mountPoint);
+    fileSystem.RemoveDir(dataDir, true);
+}
@@ -0,0 +1,83 @@
+#include "SeBench.hpp"
+
+#include <Se/ValueDocument.h>
+
+using namespace Se;
+
+void BenchValueDocument()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench ValueDocument\n"
+              "-------------------------------------------------------");
+
+    // Parse-and-walk style workload against a heap Value tree
+    const unsigned numRecords = 50000;
+    BenchTimer timer;
+    Value records(VALUE_ARRAY);
+    for (unsigned i = 0; i < numRecords; ++i)
+    {
+        Value record;
+        record["id"] = i;
+        record["name"] = cformat("record%u", i);
+        record["enabled"] = i % 3 != 0;
+        Value& position = record["position"];
+        position["x"] = i * 0.5;
+        position["y"] = 1.0;
+        position["z"] = -2.0;
+        Value& tags = record["tags"];
+        tags.Push("a");
+        tags.Push("b");
+        records.Push(std::move(record));
+    }
+    const long long valueBuildTime = timer.Lap();
+
+    ValueDocument large;
+    large.StartArray();
+    for (unsigned i = 0; i < numRecords; ++i)
+    {
+        const String name = cformat("record%u", i);
+        large.StartObject();
+        large.Key("id", 2);
+        large.Uint(i);
+        large.Key("name", 4);
+        large.String(name.c_str(), static_cast<unsigned>(name.length()));
+        large.Key("enabled", 7);
+        large.Bool(i % 3 != 0);
+        large.Key("position", 8);
+        large.StartObject();
+        large.Key("x", 1);
+        large.Double(i * 0.5);
+        large.Key("y", 1);
+        large.Double(1.0);
+        large.Key("z", 1);
+        large.Double(-2.0);
+        large.EndObject();
+        large.Key("tags", 4);
+        large.StartArray();
+        large.String("a", 1);
+        large.String("b", 1);
+        large.EndArray();
+        large.EndObject();
+    }
+    large.EndArray();
+    const long long documentBuildTime = timer.Lap();
+
+    double valueSum = 0.0;
+    for (const Value& record : records.GetArray())
+        valueSum += record.Get("position").Get("x").GetDouble() + record.Get("id").GetUInt() + record.Get("name").GetString().length();
+    const long long valueWalkTime = timer.Lap();
+
+    double documentSum = 0.0;
+    const ValueNode& largeRoot = large.GetRoot();
+    for (unsigned i = 0; i < largeRoot.Size(); ++i)
+    {
+        const ValueNode& record = largeRoot[i];
+        documentSum += record["position"]["x"].GetDouble() + record["id"].GetUInt() + record["name"].GetStringView().length();
+    }
+    const long long documentWalkTime = timer.Lap();
+
+    SE_LOG_PRINT("{} records: Value build {} us walk {} us, ValueDocument build {} us walk {} us, {} KB arena, sums {} {}",
+        numRecords, valueBuildTime, valueWalkTime, documentBuildTime, documentWalkTime, large.GetMemoryUse() / 1024, valueSum,
+        documentSum);
+
+}
@@ -0,0 +1,44 @@
+#include "SeBench.hpp"
+
+#include <SeResource/XMLFile.h>
+
+using namespace Se;
+
+void BenchXMLFile()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench XMLFile\n"
+              "-------------------------------------------------------");
+
+    // UI layout parsed in place
+    const unsigned numElements = 20000;
+    String text = "<layout name=\"main\">\n";
+    for (unsigned i = 0; i < numElements; ++i)
+    {
+        text += cformat("    <element type=\"Button\" name=\"button%u\">"
+            "<attribute name=\"Text\" value=\"Item %u\" /><attribute name=\"Size\" value=\"%u 24\" /></element>\n", i, i, i % 300);
+    }
+    text += "</layout>\n";
+
+    BenchTimer timer;
+    XMLFile layout;
+    layout.FromString(text);
+    const long long loadTime = timer.Lap();
+
+    // Queries compiled for every element against one shared compiled query
+    const XMLElement root = layout.GetRoot("layout");
+    unsigned numFound = 0;
+    for (XMLElement element = root.GetChild("element"); element; element = element.GetNext("element"))
+    {
+        XPathQuery query("attribute[@name='Text']");
+        numFound += element.SelectSinglePrepared(query).GetAttribute("value").starts_with("Item ");
+    }
+    const long long uncachedTime = timer.Lap();
+    for (XMLElement element = root.GetChild("element"); element; element = element.GetNext("element"))
+        numFound += element.SelectSingle("attribute[@name='Text']").GetAttribute("value").starts_with("Item ");
+    const long long cachedTime = timer.Lap();
+    XPathQuery::ClearCache();
+
+    SE_LOG_PRINT("{} KB XML layout: load {} us, {} queries compiled each time {} us, shared {} us",
+        text.length() / 1024, loadTime, numFound / 2, uncachedTime, cachedTime);
+}
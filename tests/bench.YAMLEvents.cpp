@@ -0,0 +1,62 @@
+#include "SeBench.hpp"
+
+#include <Se/IO/MemoryBuffer.hpp>
+#include <Se/ValueDocument.h>
+#include <SeResource/YAMLFile.h>
+
+using namespace Se;
+
+namespace
+{
+
+/// Handler that only counts the keys, so that the parse itself is measured.
+class YAMLKeyCounter : public YAMLEventHandler
+{
+public:
+    bool Null() override { return true; }
+    bool Bool(bool /*value*/) override { return true; }
+    bool Int(int /*value*/) override { return true; }
+    bool Double(double /*value*/) override { return true; }
+    bool String(std::string_view /*value*/) override { return true; }
+    bool StartMap() override { return true; }
+    bool Key(std::string_view /*key*/) override { ++numKeys_; return true; }
+    bool EndMap() override { return true; }
+    bool StartSeq() override { return true; }
+    bool EndSeq() override { return true; }
+
+    unsigned numKeys_{};
+};
+
+}
+
+void BenchYAMLEvents()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Bench YAMLEvents\n"
+              "-------------------------------------------------------");
+
+    // Larger file as a Value tree, a document and events
+    String largeText;
+    const unsigned numRecords = 20000;
+    largeText.reserve(numRecords * 80);
+    largeText += "records:\n";
+    for (unsigned i = 0; i < numRecords; ++i)
+        largeText += cformat("  - id: %u\n    name: record%u\n    position: [%g, 1.5, -2]\n", i, i, i * 0.5);
+
+    MemoryBuffer largeBuffer(largeText.c_str(), largeText.length());
+    BenchTimer timer;
+    YAMLFile largeFile;
+    largeFile.Load(largeBuffer);
+    const long long valueTime = timer.Lap();
+    largeBuffer.Seek(0);
+    ValueDocument largeDocument;
+    YAMLFile::ParseDocument(largeBuffer, largeDocument);
+    const long long documentTime = timer.Lap();
+    largeBuffer.Seek(0);
+    YAMLKeyCounter largeCounter;
+    YAMLFile::Parse(largeBuffer, largeCounter);
+    const long long eventTime = timer.Lap();
+
+    SE_LOG_PRINT("{} KB YAML: load to Value {} us, ValueDocument {} us, events only {} us ({} keys)", largeText.length() / 1024,
+        valueTime, documentTime, eventTime, largeCounter.numKeys_);
+}
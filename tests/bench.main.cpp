@@ -0,0 +1,66 @@
+#include <Se/Console.hpp>
+
+#include <cstring>
+
+void BenchValueDocument();
+void BenchJSONFile();
+void BenchYAMLEvents();
+void BenchJSONStreamArchive();
+void BenchBinarySchema();
+void BenchColumnarArchive();
+void BenchIndexedArchive();
+void BenchBase64();
+void BenchXMLFile();
+void BenchResourceBatch();
+void BenchImageCube();
+void BenchImageMip();
+
+namespace
+{
+
+/// Named benchmark entry point.
+struct Benchmark
+{
+    /// Name used to select the benchmark on the command line.
+    const char* name_;
+    /// Function running the benchmark.
+    void (*function_)();
+};
+
+const Benchmark benchmarks[] =
+{
+    {"ValueDocument", BenchValueDocument},
+    {"JSONFile", BenchJSONFile},
+    {"YAMLEvents", BenchYAMLEvents},
+    {"JSONStreamArchive", BenchJSONStreamArchive},
+    {"BinarySchema", BenchBinarySchema},
+    {"ColumnarArchive", BenchColumnarArchive},
+    {"IndexedArchive", BenchIndexedArchive},
+    {"Base64", BenchBase64},
+    {"XMLFile", BenchXMLFile},
+    {"ResourceBatch", BenchResourceBatch},
+    {"ImageCube", BenchImageCube},
+    {"ImageMip", BenchImageMip},
+};
+
+}
+
+/// Run the benchmarks named on the command line, or all of them.
+int main(int argc, char** argv)
+{
+    Console::setOutputLog(Console::DefaultColored);
+
+#ifndef NDEBUG
+    SE_LOG_WARNING("Benchmarks are not built for Release, configure a separate build with -DCMAKE_BUILD_TYPE=Release");
+#endif
+
+    for (const Benchmark& benchmark : benchmarks)
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc && !selected; ++i)
+            selected = !strcmp(argv[i], benchmark.name_);
+        if (selected)
+            benchmark.function_();
+    }
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <Se/Thread.h>
+#include <Se/Timer.h>
+#include <SeResource/ResourceCache.h>
+#include <SeResource/XMLFile.h>
+#include <SeVFS/VirtualFileSystem.h>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace Se;
+
+namespace
+{
+
+/// Resource that finishes in several EndLoadStep() slices of known cost.
+class SlicedProbe : public Resource
+{
+public:
+    /// Number of EndLoadStep() slices.
+    static constexpr unsigned NumSteps = 4;
+    /// Cost of one slice in microseconds.
+    static constexpr long long StepUs = 2000;
+
+    SlicedProbe() : Resource(GetTypeStatic()) {}
+
+    static String GetTypeStatic() { return "SlicedProbe"; }
+
+    bool BeginLoad(Deserializer& /*source*/) override
+    {
+        stepsLeft_ = NumSteps;
+        return true;
+    }
+
+    bool EndLoad() override
+    {
+        while (stepsLeft_)
+            Step();
+        return true;
+    }
+
+    bool EndLoadStep(bool& finished) override
+    {
+        Step();
+        finished = stepsLeft_ == 0;
+        return true;
+    }
+
+    long long GetEndLoadCostEstimate() const override { return StepUs; }
+
+private:
+    void Step()
+    {
+        HiresTimer timer;
+        while (timer.GetUSec(false) < StepUs)
+            ;
+        --stepsLeft_;
+    }
+
+    unsigned stepsLeft_{};
+};
+
+}
+
+void TestBackgroundLoader()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test BackgroundLoader\n"
+              "-------------------------------------------------------");
+
+    // Resource cache calls are accepted only from the main thread
+    Thread::SetMainThread();
+    // Initializes the high-resolution timer frequency
+    Time::Get();
+    ResourceCache::RegisterResource<SlicedProbe>(SlicedProbe::GetTypeStatic());
+    ResourceCache::RegisterResource<XMLFile>(XMLFile::GetTypeStatic());
+
+    auto& fileSystem = FileSystem::Get();
+    const String dataDir = fileSystem.GetTemporaryDir() + "SeBackgroundLoaderTest/";
+    fileSystem.RemoveDir(dataDir, true);
+    [[maybe_unused]] const bool created = fileSystem.CreateDir(dataDir);
+    assert(created);
+
+    const unsigned numResources = 7;
+    for (unsigned i = 0; i < numResources; ++i)
+    {
+        File file(dataDir + String(cformat("sliced%u.txt", i)), FILE_WRITE);
+        file.WriteString("sliced");
+    }
+
+    // Layout and a patch file inheriting it with one patch node per element
+    const unsigned numElements = 1000;
+    String base = "<layout>\n";
+    String patch = "<patch inherit=\"base.xml\">\n";
+    for (unsigned i = 0; i < numElements; ++i)
+    {
+        base += cformat("    <element name=\"e%u\" />\n", i);
+        patch += cformat("    <add sel=\"/layout/element[@name='e%u']\" type=\"@style\">s%u</add>\n", i, i);
+    }
+    base += "</layout>\n";
+    patch += "</patch>\n";
+    {
+        File baseFile(dataDir + "base.xml", FILE_WRITE);
+        baseFile.WriteString(base);
+        File patchFile(dataDir + "patch.xml", FILE_WRITE);
+        patchFile.WriteString(patch);
+    }
+
+    auto vfs = VirtualFileSystem::Get();
+    auto mountPoint = vfs->MountDir(dataDir);
+    auto& cache = ResourceCache::Get();
+    const int oldBudgetMs = cache.GetFinishBackgroundResourcesMs();
+
+    // Run simulated frames until the queue drains, return the longest frame
+    unsigned frameNumber = 0;
+    auto runFrames = [&](unsigned& numFrames)
+    {
+        long long maxFrameUs = 0;
+        numFrames = 0;
+        HiresTimer timeout;
+        while (cache.GetNumBackgroundLoadResources() && timeout.GetUSec(false) < 10000000)
+        {
+            HiresTimer frameTimer;
+            Time::onBeginFrame({++frameNumber, 0.016f});
+            const long long frameUs = frameTimer.GetUSec(false);
+            // Frames where only the loader thread was waited for do not count
+            if (frameUs >= SlicedProbe::StepUs)
+            {
+                maxFrameUs = std::max(maxFrameUs, frameUs);
+                ++numFrames;
+            }
+            Time::Sleep(1);
+        }
+        return maxFrameUs;
+    };
+
+    // Finishing is spread over frames that stay close to the budget instead of one long frame
+    const int budgetMs = 5;
+    cache.SetFinishBackgroundResourcesMs(budgetMs);
+    for (unsigned i = 0; i < numResources - 1; ++i)
+        cache.BackgroundLoadResource(SlicedProbe::GetTypeStatic(), cformat("sliced%u.txt", i));
+    unsigned numFrames = 0;
+    [[maybe_unused]] const long long maxFrameUs = runFrames(numFrames);
+    [[maybe_unused]] const unsigned stepsPerFrame = budgetMs * 1000 / SlicedProbe::StepUs;
+    assert(maxFrameUs < budgetMs * 1000 + 2 * SlicedProbe::StepUs);
+    assert(numFrames >= (numResources - 1) * SlicedProbe::NumSteps / stepsPerFrame);
+
+    // A step over the whole budget still advances once per frame
+    cache.SetFinishBackgroundResourcesMs(1);
+    cache.BackgroundLoadResource(SlicedProbe::GetTypeStatic(), cformat("sliced%u.txt", numResources - 1));
+    runFrames(numFrames);
+    assert(numFrames == SlicedProbe::NumSteps);
+
+    // Every slice is accounted to the load record
+    for (unsigned i = 0; i < numResources; ++i)
+        assert(cache.GetExistingResource(SlicedProbe::GetTypeStatic(), cformat("sliced%u.txt", i)));
+    [[maybe_unused]] const ResourceLoadTypeStats stats = cache.GetLoadStats().GetTypeStats().at(SlicedProbe::GetTypeStatic());
+    assert(stats.count_ == numResources && stats.endLoad_.count_ == numResources);
+    assert(stats.endLoad_.GetAverageUs() >= SlicedProbe::NumSteps * SlicedProbe::StepUs);
+
+    // Inherited patches are applied in slices that fit the budget, with the same result as a synchronous load
+    cache.SetFinishBackgroundResourcesMs(budgetMs);
+    cache.BackgroundLoadResource(XMLFile::GetTypeStatic(), "patch.xml");
+    [[maybe_unused]] const long long maxPatchFrameUs = runFrames(numFrames);
+    assert(maxPatchFrameUs < budgetMs * 1000 + 2 * XMLFile::PatchStepUs);
+    assert(numFrames > 1);
+    [[maybe_unused]] auto* patched = cache.GetExistingResource<XMLFile>("patch.xml");
+    XMLFile patchedSync;
+    [[maybe_unused]] const bool loadedSync = patchedSync.LoadFile(FileIdentifier::FromUri("patch.xml"));
+    assert(patched && loadedSync && patched->ToString() == patchedSync.ToString());
+    assert(patched->GetRoot("layout").GetChild("element").GetNext("element").GetAttribute("style") == "s1");
+
+    cache.SetFinishBackgroundResourcesMs(oldBudgetMs);
+    cache.ReleaseResources(SlicedProbe::GetTypeStatic(), String::EMPTY, true);
+    cache.ReleaseResources(XMLFile::GetTypeStatic(), String::EMPTY, true);
+    vfs->Unmount(mountPoint);
+    fileSystem.RemoveDir(dataDir, true);
+}
@@ -0,0 +1,116 @@
+#include "Base64Reference.hpp"
+
+#include <Se/Base64.h>
+#include <Se/Console.hpp>
+#include <Se/IO/VectorBuffer.h>
+#include <SeArc/ArchiveSerialization.hpp>
+#include <SeResource/Base64Archive.h>
+
+#include <cassert>
+#include <cstring>
+#include <random>
+
+using namespace Se;
+
+namespace
+{
+
+struct Base64Item
+{
+    String name_;
+    std::vector<int> values_;
+
+    void SerializeInBlock(Archive& archive)
+    {
+        SerializeValue(archive, "name", name_);
+        SerializeValue(archive, "values", values_);
+    }
+};
+
+}
+
+void TestBase64()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test Base64\n"
+              "-------------------------------------------------------");
+
+    // Known vectors
+    std::vector<unsigned char> decoded;
+    String encoded;
+    BufferToBase64String(encoded, "foobar", 6);
+    assert(encoded == "Zm9vYmFy");
+    BufferToBase64String(encoded, "fooba", 5);
+    assert(encoded == "Zm9vYmE=");
+    BufferToBase64String(encoded, "foob", 4);
+    assert(encoded == "Zm9vYg==");
+    [[maybe_unused]] bool decodedOk = Base64StringToBuffer(decoded, "Zm9vYg");
+    assert(decodedOk && decoded.size() == 4 && decoded[3] == 'b');
+    decodedOk = Base64StringToBuffer(decoded, "");
+    assert(decodedOk && decoded.empty());
+    decodedOk = Base64StringToBuffer(decoded, "Zm9vY") || Base64StringToBuffer(decoded, "Zm9v=mFy");
+    assert(!decodedOk);
+
+    // Every length across the vector and scalar paths
+    std::mt19937 random(42);
+    for (unsigned size = 0; size <= 200; ++size)
+    {
+        std::vector<unsigned char> data(size);
+        for (unsigned char& byte : data)
+            byte = static_cast<unsigned char>(random());
+
+        BufferToBase64String(encoded, data.data(), data.size());
+        assert(encoded == EncodeReference(data));
+        decodedOk = Base64StringToBuffer(decoded, encoded);
+        assert(decodedOk && decoded == data);
+
+        // Invalid characters anywhere are rejected
+        if (!encoded.empty())
+        {
+            String broken = encoded;
+            broken[size >= 3 ? random() % (size / 3 * 4) : 0] = static_cast<char>(random() % 2 ? '*' : 0x80 | random());
+            decodedOk = Base64StringToBuffer(decoded, broken);
+            assert(!decodedOk);
+        }
+    }
+
+    // Every byte value in the middle of a long text
+    String alphabetText(std::string(200, 'A'));
+    for (unsigned ch = 0; ch < 256; ++ch)
+    {
+        alphabetText[37] = static_cast<char>(ch);
+        [[maybe_unused]] const bool valid = isalnum(ch) || ch == '+' || ch == '/';
+        decodedOk = Base64StringToBuffer(decoded, alphabetText);
+        assert(decodedOk == valid);
+    }
+
+    // Streaming
+    std::vector<unsigned char> large(1000003);
+    for (unsigned char& byte : large)
+        byte = static_cast<unsigned char>(random());
+    VectorBuffer textBuffer;
+    [[maybe_unused]] const bool encodedOk = EncodeBase64(textBuffer, large.data(), large.size());
+    assert(encodedOk);
+    const String largeText(reinterpret_cast<const char*>(textBuffer.GetData()), textBuffer.GetSize());
+    BufferToBase64String(encoded, large.data(), large.size());
+    assert(largeText == encoded);
+    VectorBuffer byteBuffer;
+    decodedOk = DecodeBase64(byteBuffer, largeText.data(), largeText.length());
+    assert(decodedOk);
+    assert(byteBuffer.GetSize() == large.size() && memcmp(byteBuffer.GetData(), large.data(), large.size()) == 0);
+
+    // Archives
+    Base64Item item{"item", {1, 2, 3}};
+    Base64OutputArchive output;
+    SerializeValue(output, "item", item);
+    output.Flush();
+    Base64Item loaded;
+    Base64InputArchive input(output.GetBase64());
+    SerializeValue(input, "item", loaded);
+    assert(loaded.name_ == item.name_ && loaded.values_ == item.values_);
+    // Invalid text is not decoded up to the first bad character
+    Base64InputArchive brokenInput(output.GetBase64().substr(0, 8) + "*");
+    Base64Item partial;
+    SerializeValue(brokenInput, "item", partial);
+    assert(partial.name_.empty() && partial.values_.empty());
+}
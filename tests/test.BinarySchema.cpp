@@ -0,0 +1,68 @@
+#include "BinarySchemaTypes.hpp"
+
+#include <Se/Console.hpp>
+#include <SeResource/JSONFile.h>
+
+#include <cassert>
+#include <cstring>
+
+using namespace Se;
+
+void TestBinarySchema()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test BinarySchema\n"
+              "-------------------------------------------------------");
+
+    static_assert(Detail::ArchiveFixedSize<SchemaPoint>::value == 16);
+    static_assert(Detail::ArchiveFixedSize<SchemaRecord>::value == 0);
+
+    SchemaScene scene;
+    LegacyScene legacy;
+    scene.version_ = legacy.version_ = 2;
+    const unsigned numRecords = 200;
+    for (unsigned i = 0; i < numRecords; ++i)
+    {
+        const float f = i * 0.5f;
+        scene.records_.push_back(SchemaRecord{cformat("record%u", i), static_cast<int>(i), i % 3 == 0, i * 0.25,
+            {f, 1.0f, -f, 7}, {f, f + 1.0f}, {{f, 0.0f, 1.0f, 1}, {2.0f, f, 3.0f, 2}}, {"a", "b"}});
+        legacy.records_.push_back(LegacyRecord{cformat("record%u", i), static_cast<int>(i), i % 3 == 0, i * 0.25,
+            {f, 1.0f, -f, 7}, {f, f + 1.0f}, {{f, 0.0f, 1.0f, 1}, {2.0f, f, 3.0f, 2}}, {"a", "b"}});
+    }
+
+    // Both paths write the same bytes
+    VectorBuffer legacyBuffer;
+    SaveBinary(legacyBuffer, legacy);
+    VectorBuffer schemaBuffer;
+    SaveBinary(schemaBuffer, scene);
+    assert(legacyBuffer.GetSize() == schemaBuffer.GetSize());
+    assert(memcmp(legacyBuffer.GetData(), schemaBuffer.GetData(), schemaBuffer.GetSize()) == 0);
+
+    // And read each other's output
+    LegacyScene legacyLoaded;
+    [[maybe_unused]] const bool legacyLoadedOk = LoadBinary(schemaBuffer, legacyLoaded);
+    SchemaScene schemaLoaded;
+    [[maybe_unused]] const bool schemaLoadedOk = LoadBinary(legacyBuffer, schemaLoaded);
+    assert(legacyLoadedOk && schemaLoadedOk);
+    assert(schemaLoaded.version_ == 2 && schemaLoaded.records_ == scene.records_);
+    assert(legacyLoaded.records_.size() == numRecords && legacyLoaded.records_.back().name_ == scene.records_.back().name_);
+    assert(legacyLoaded.records_.back().points_[1].y_ == scene.records_.back().points_[1].y_);
+
+    // Truncated input fails
+    VectorBuffer truncated(schemaBuffer.GetData(), schemaBuffer.GetSize() / 2);
+    SchemaScene failed;
+    [[maybe_unused]] const bool truncatedLoaded = LoadBinary(truncated, failed);
+    assert(!truncatedLoaded);
+
+    // Human-readable archives get named fields
+    SchemaRecord& record = scene.records_[3];
+    JSONFile file;
+    [[maybe_unused]] const bool saved = file.SaveObject("record", record);
+    assert(saved);
+    [[maybe_unused]] const JSONValue& root = file.GetRoot();
+    assert(root.Get("name").GetString() == "record3" && root.Get("origin").Get("z").GetFloat() == -1.5f);
+    assert(root.Get("points")[1].Get("id").GetInt() == 2 && root.Get("tags")[1].GetString() == "b");
+    SchemaRecord loaded;
+    [[maybe_unused]] const bool loadedOk = file.LoadObject("record", loaded);
+    assert(loadedOk && loaded == record);
+}
@@ -0,0 +1,127 @@
+#include "ColumnarArchiveTypes.hpp"
+
+#include <Se/Console.hpp>
+#include <SeResource/JSONFile.h>
+
+#include <cassert>
+#include <cstring>
+
+using namespace Se;
+
+namespace
+{
+
+/// Fixed-size field with padding between its members.
+struct ColumnTag
+{
+    char kind_;
+    int value_;
+
+    static constexpr auto GetArchiveFields()
+    {
+        return std::make_tuple(MakeArchiveField("kind", &ColumnTag::kind_), MakeArchiveField("value", &ColumnTag::value_));
+    }
+};
+
+struct ColumnMarker
+{
+    ColumnTag tag_;
+
+    static constexpr auto GetArchiveFields() { return std::make_tuple(MakeArchiveField("tag", &ColumnMarker::tag_)); }
+};
+
+struct ColumnMarkers
+{
+    std::vector<ColumnMarker> markers_;
+
+    void SerializeInBlock(Archive& archive) { LibSTD::SerializeVectorAsColumns(archive, "markers", markers_); }
+};
+
+}
+
+void TestColumnarArchive()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ColumnarArchive\n"
+              "-------------------------------------------------------");
+
+    std::vector<unsigned char> decoded;
+    String encoded;
+    BufferToBase64String(encoded, "Man", 3);
+    assert(encoded == "TWFu");
+    BufferToBase64String(encoded, "Ma", 2);
+    [[maybe_unused]] bool decodedOk = Base64StringToBuffer(decoded, encoded);
+    assert(encoded == "TWE=" && decodedOk && decoded.size() == 2 && decoded[1] == 'a');
+    decodedOk = Base64StringToBuffer(decoded, "TW*=") || Base64StringToBuffer(decoded, "TWE=A");
+    assert(!decodedOk);
+
+    ColumnSystem system;
+    for (unsigned i = 0; i < 5; ++i)
+        system.particles_.push_back(ColumnParticle{i * 0.5f, 1.0f, -1.0f * i, static_cast<int>(i), i % 2 == 0, cformat("p%u", i)});
+
+    // One packed string per field in JSON
+    JSONFile file;
+    [[maybe_unused]] const bool saved = file.SaveObject("system", system);
+    assert(saved);
+    [[maybe_unused]] const JSONValue& particles = file.GetRoot().Get("particles");
+    assert(particles.Get("size").GetUInt() == 5 && particles.Get("x").IsString() && particles.Get("active").IsString());
+    assert(particles.Get("name").Size() == 5 && particles.Get("name")[4].GetString() == "p4");
+    ColumnSystem loaded;
+    [[maybe_unused]] bool loadedOk = file.LoadObject("system", loaded);
+    assert(loadedOk && loaded.particles_ == system.particles_);
+
+    JSONValue broken = file.GetRoot();
+    broken["particles"]["y"] = "AAAA";
+    JSONFile brokenFile;
+    brokenFile.GetRoot() = broken;
+    loadedOk = brokenFile.LoadObject("system", loaded);
+    assert(!loadedOk);
+
+    // Padding inside column values is not stored
+    VectorBuffer markerBuffers[2];
+    for (unsigned i = 0; i < 2; ++i)
+    {
+        ColumnMarkers markers;
+        markers.markers_.resize(10);
+        memset(markers.markers_.data(), i ? 0x55 : 0xaa, markers.markers_.size() * sizeof(ColumnMarker));
+        for (unsigned j = 0; j < markers.markers_.size(); ++j)
+            markers.markers_[j].tag_ = ColumnTag{static_cast<char>('a' + j), static_cast<int>(j * 1000)};
+        [[maybe_unused]] const bool markersSaved = SaveSystemBinary(markerBuffers[i], markers);
+        assert(markersSaved);
+    }
+    assert(sizeof(ColumnTag) > 5 && markerBuffers[0].GetBuffer() == markerBuffers[1].GetBuffer());
+    ColumnMarkers markersLoaded;
+    loadedOk = LoadSystemBinary(markerBuffers[0], markersLoaded);
+    assert(loadedOk && markersLoaded.markers_.size() == 10);
+    assert(markersLoaded.markers_[9].tag_.kind_ == 'j' && markersLoaded.markers_[9].tag_.value_ == 9000);
+
+    // Large arrays in binary: objects, columns and compressed columns
+    ColumnSystem large;
+    const unsigned numParticles = 10000;
+    large.particles_.reserve(numParticles);
+    for (unsigned i = 0; i < numParticles; ++i)
+    {
+        large.particles_.push_back(ColumnParticle{static_cast<float>(i % 1000), 0.0f, 2.0f, static_cast<int>(i),
+            i % 7 != 0, i % 100 == 0 ? "marked" : ""});
+    }
+
+    [[maybe_unused]] unsigned sizes[3]{};
+    for (unsigned mode = 0; mode < 3; ++mode)
+    {
+        large.columns_ = mode != 0;
+        large.compress_ = mode == 2;
+
+        VectorBuffer buffer;
+        [[maybe_unused]] const bool largeSaved = SaveSystemBinary(buffer, large);
+        assert(largeSaved);
+
+        ColumnSystem largeLoaded;
+        largeLoaded.columns_ = large.columns_;
+        loadedOk = LoadSystemBinary(buffer, largeLoaded);
+        assert(loadedOk);
+
+        assert(largeLoaded.particles_ == large.particles_);
+        sizes[mode] = buffer.GetSize();
+    }
+    assert(sizes[2] < sizes[1]);
+}
@@ -0,0 +1,116 @@
+#include <Se/Console.hpp>
+#include <Se/IO/VectorBuffer.h>
+#include <SeResource/BinaryArchive.h>
+#include <SeResource/ImageAtlas.h>
+#include <SeResource/JSONArchive.h>
+#include <SeResource/JSONFile.h>
+
+#include <cassert>
+
+using namespace Se;
+
+void TestImageAtlas()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ImageAtlas\n"
+              "-------------------------------------------------------");
+
+    // Enough images of varying size to spill over several small pages
+    const unsigned numImages = 300;
+    ImageAtlas atlas;
+    atlas.SetMaxPageSize(100);
+    // Negative borders are clamped
+    atlas.SetPadding(-3);
+    atlas.SetExtrude(-1);
+    assert(atlas.GetPadding() == 0 && atlas.GetExtrude() == 0);
+    atlas.SetPadding(2);
+    atlas.SetExtrude(1);
+    assert(atlas.GetMaxPageSize() == 128);
+    for (unsigned i = 0; i < numImages; ++i)
+    {
+        auto image = std::make_shared<Image>();
+        image->SetSize(3 + i % 13, 2 + i % 7, 4);
+        for (int y = 0; y < image->GetHeight(); ++y)
+        {
+            for (int x = 0; x < image->GetWidth(); ++x)
+                image->SetPixelInt(x, y, 0xff000000 | (i << 8) | (y << 4) | x);
+        }
+        [[maybe_unused]] const bool added = atlas.AddImage(cformat("image%u", i), image);
+        assert(added);
+    }
+    // Mixed component counts are expanded to RGBA
+    auto grey = std::make_shared<Image>();
+    grey->SetSize(5, 5, 1);
+    grey->ClearInt(0x80);
+    [[maybe_unused]] const bool addedGrey = atlas.AddImage("grey", grey);
+    [[maybe_unused]] const bool addedGreyAgain = atlas.AddImage("grey", grey);
+    assert(addedGrey && !addedGreyAgain);
+
+    [[maybe_unused]] const bool built = atlas.Build();
+    assert(built);
+    assert(atlas.GetPages().size() > 1 && atlas.GetPages().size() == atlas.GetPageSizes().size());
+    for ([[maybe_unused]] const auto& page : atlas.GetPages())
+    {
+        assert(page->GetComponents() == 4 && page->GetWidth() <= 128 && page->GetHeight() <= 128);
+        assert(IsPowerOfTwo(page->GetWidth()) && IsPowerOfTwo(page->GetHeight()));
+    }
+
+    for (unsigned i = 0; i < numImages; ++i)
+    {
+        const ImageAtlasEntry* entry = atlas.GetEntry(cformat("image%u", i));
+        assert(entry && entry->rect_.Width() == 3 + (int)i % 13 && entry->rect_.Height() == 2 + (int)i % 7);
+        [[maybe_unused]] const Image* page = atlas.GetPages()[entry->page_].get();
+        const IntRect& rect = entry->rect_;
+        for (int y = 0; y < rect.Height(); ++y)
+        {
+            for (int x = 0; x < rect.Width(); ++x)
+                assert(page->GetPixelInt(rect.left_ + x, rect.top_ + y) == (0xff000000 | (i << 8) | (y << 4) | x));
+        }
+        // Edges are extruded by one pixel
+        assert(page->GetPixelInt(rect.left_ - 1, rect.top_ - 1) == page->GetPixelInt(rect.left_, rect.top_));
+        assert(page->GetPixelInt(rect.right_, rect.bottom_ - 1) == page->GetPixelInt(rect.right_ - 1, rect.bottom_ - 1));
+        assert(entry->uv_.min_.x_ == (float)rect.left_ / page->GetWidth());
+        assert(entry->uv_.max_.y_ == (float)rect.bottom_ / page->GetHeight());
+    }
+    [[maybe_unused]] const ImageAtlasEntry* greyEntry = atlas.GetEntry("grey");
+    assert(greyEntry && (atlas.GetPages()[greyEntry->page_]->GetPixelInt(greyEntry->rect_.left_, greyEntry->rect_.top_) & 0xffffff) == 0x808080);
+    assert(!atlas.GetEntry("missing"));
+
+    // Lookup table round trips through binary and JSON archives without the pages
+    auto checkLoaded = [&](const ImageAtlas& loaded)
+    {
+        assert(loaded.GetPages().empty() && loaded.GetPageSizes() == atlas.GetPageSizes());
+        assert(loaded.GetEntries().size() == atlas.GetEntries().size());
+        for (const ImageAtlasEntry& entry : atlas.GetEntries())
+        {
+            [[maybe_unused]] const ImageAtlasEntry* loadedEntry = loaded.GetEntry(entry.name_);
+            assert(loadedEntry && loadedEntry->page_ == entry.page_ && loadedEntry->rect_ == entry.rect_);
+            assert(loadedEntry->uv_ == entry.uv_);
+        }
+    };
+
+    VectorBuffer buffer;
+    {
+        BinaryOutputArchive archive(buffer);
+        SerializeValue(archive, "atlas", atlas);
+    }
+    buffer.Seek(0);
+    {
+        ImageAtlas loaded;
+        BinaryInputArchive archive(buffer);
+        SerializeValue(archive, "atlas", loaded);
+        checkLoaded(loaded);
+    }
+
+    JSONFile jsonFile;
+    {
+        JSONOutputArchive archive(&jsonFile);
+        SerializeValue(archive, "atlas", atlas);
+    }
+    {
+        ImageAtlas loaded;
+        JSONInputArchive archive(&jsonFile);
+        SerializeValue(archive, "atlas", loaded);
+        checkLoaded(loaded);
+    }
+}
@@ -0,0 +1,99 @@
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <SeResource/Image.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+
+using namespace Se;
+
+void TestImageCompress()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ImageCompress\n"
+              "-------------------------------------------------------");
+
+    // Smooth gradients with an alpha ramp; sizes are not multiples of 4 to cover edge blocks
+    Image image;
+    image.SetSize(70, 38, 4);
+    for (int y = 0; y < image.GetHeight(); ++y)
+    {
+        for (int x = 0; x < image.GetWidth(); ++x)
+            image.SetPixel(x, y, Color(x / 70.0f, y / 38.0f, 0.5f, 0.6f + y / 100.0f));
+    }
+
+    auto& fileSystem = FileSystem::Get();
+    const String fileName = fileSystem.GetTemporaryDir() + "SeImageCompressTest.dds";
+
+    const CompressedFormat formats[] = {CF_DXT1, CF_DXT5, CF_BC4, CF_BC5, CF_BC7};
+    for (CompressedFormat format : formats)
+    {
+        [[maybe_unused]] const bool saved = image.SaveDDS(fileName, format);
+        assert(saved);
+
+        Image loaded;
+        {
+            File file(fileName);
+            [[maybe_unused]] const bool loadedFile = loaded.Load(file);
+            assert(loadedFile);
+        }
+        assert(loaded.GetCompressedFormat() == format);
+        // 70x38 down to 1x1
+        assert(loaded.GetNumCompressedLevels() == 7);
+
+        auto decompressed = loaded.GetDecompressedImage();
+        assert(decompressed && decompressed->GetWidth() == 70 && decompressed->GetHeight() == 38);
+
+        // Compare only the channels the format stores
+        const unsigned numChannels = format == CF_BC4 ? 1 : (format == CF_BC5 ? 2 : (format == CF_DXT1 ? 3 : 4));
+        [[maybe_unused]] int maxError = 0;
+        for (int i = 0; i < 70 * 38; ++i)
+        {
+            for (unsigned c = 0; c < numChannels; ++c)
+                maxError = std::max(maxError, std::abs(image.GetData()[i * 4 + c] - decompressed->GetData()[i * 4 + c]));
+        }
+        assert(maxError <= 12);
+    }
+
+    // The mip chain is generated on a copy
+    std::vector<const Image*> imageLevels;
+    image.GetLevels(imageLevels);
+    assert(imageLevels.size() == 1);
+
+    // Each block holds two unrelated gradients in the columns of the first BC7 partition, which one line through
+    // colour space can not fit but two subsets can
+    Image split;
+    split.SetSize(8, 8, 4);
+    for (int y = 0; y < 8; ++y)
+    {
+        for (int x = 0; x < 8; ++x)
+        {
+            const float t = (y % 4) / 3.0f;
+            split.SetPixel(x, y, (x % 4) < 2 ? Color(t, 0.0f, 0.0f) : Color(0.0f, 1.0f - t, t));
+        }
+    }
+    [[maybe_unused]] const bool savedSplit = split.SaveDDS(fileName, CF_BC7);
+    assert(savedSplit);
+    Image loadedSplit;
+    {
+        File file(fileName);
+        [[maybe_unused]] const bool loadedFile = loadedSplit.Load(file);
+        assert(loadedFile);
+    }
+    const CompressedLevel splitLevel = loadedSplit.GetCompressedLevel(0);
+    for (unsigned i = 0; i < splitLevel.dataSize_; i += 16)
+    {
+        // Mode 1 or 3 store the mode in the lowest bits as 01 or 0001
+        [[maybe_unused]] const unsigned modeBits = splitLevel.data_[i] & 0xf;
+        assert(modeBits == 0x2 || modeBits == 0x6 || modeBits == 0xa || modeBits == 0xe || modeBits == 0x8);
+    }
+    auto decompressedSplit = loadedSplit.GetDecompressedImage();
+    [[maybe_unused]] int maxSplitError = 0;
+    for (int i = 0; i < 8 * 8 * 4; ++i)
+        maxSplitError = std::max(maxSplitError, std::abs(split.GetData()[i] - decompressedSplit->GetData()[i]));
+    assert(maxSplitError <= 4);
+
+    fileSystem.Delete(fileName);
+}
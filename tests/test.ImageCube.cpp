@@ -0,0 +1,69 @@
+#include <Se/Console.hpp>
+#include <SeResource/ImageCube.h>
+
+#include <cassert>
+#include <cmath>
+
+using namespace Se;
+
+void TestImageCube()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ImageCube\n"
+              "-------------------------------------------------------");
+
+    // Direction lookup inverts face projection on every face
+    for (unsigned i = 0; i < MAX_CUBEMAP_FACES; ++i)
+    {
+        const Vector2 uv(0.3f, 0.8f);
+        [[maybe_unused]] const auto faceUV = ImageCube::ProjectDirectionOnFace(ImageCube::ProjectUVOnCube(static_cast<CubeMapFace>(i), uv));
+        assert(faceUV.first == i && faceUV.second.Equals(uv));
+    }
+
+    // Radiance 1 + y has analytic SH coefficients L00 = sqrt(pi) * 2 and L1-1 = sqrt(pi / 3) * 2
+    const int panoramaWidth = 512;
+    Image panorama;
+    panorama.SetSize(panoramaWidth, panoramaWidth / 2, 4, ChannelFormat::Float32);
+    for (int y = 0; y < panorama.GetHeight(); ++y)
+    {
+        const float up = sinf((0.5f - (y + 0.5f) / panorama.GetHeight()) * M_PI);
+        for (int x = 0; x < panorama.GetWidth(); ++x)
+            panorama.SetPixel(x, y, Color(1.0f + up, 1.0f + up, 1.0f, 1.0f));
+    }
+
+    ImageCube cube;
+    [[maybe_unused]] const bool projected = cube.SetEquirectangular(&panorama, 32, ChannelFormat::Float32);
+    assert(projected);
+    assert(cube.GetWidth() == 32 && cube.GetImages().size() == MAX_CUBEMAP_FACES);
+    assert(std::abs(cube.GetImage(FACE_POSITIVE_Y)->GetPixel(16, 16).r_ - 2.0f) < 0.01f);
+    assert(std::abs(cube.GetImage(FACE_NEGATIVE_Y)->GetPixel(16, 16).r_) < 0.01f);
+    assert(std::abs(cube.GetImage(FACE_POSITIVE_X)->GetPixel(16, 16).r_ - 1.0f) < 0.05f);
+
+    [[maybe_unused]] const std::array<Vector3, 9> sh = cube.ProjectSphericalHarmonics9();
+    assert(std::abs(sh[0].x_ - 2.0f * sqrtf(M_PI)) < 0.01f && std::abs(sh[0].z_ - 2.0f * sqrtf(M_PI)) < 0.01f);
+    assert(std::abs(sh[1].x_ - 2.0f * sqrtf(M_PI / 3.0f)) < 0.01f && std::abs(sh[1].z_) < 0.01f);
+    for (unsigned i = 2; i < 9; ++i)
+        assert(sh[i].Length() < 0.01f);
+
+    // Panorama survives the round trip away from the poles
+    auto roundTrip = cube.GetEquirectangular(panoramaWidth / 4, ChannelFormat::Float32);
+    assert(roundTrip && roundTrip->GetWidth() == panoramaWidth / 4 && roundTrip->GetHeight() == panoramaWidth / 8);
+    for (int y = 8; y < roundTrip->GetHeight() - 8; y += 5)
+    {
+        [[maybe_unused]] const float expected = 1.0f + sinf((0.5f - (y + 0.5f) / roundTrip->GetHeight()) * M_PI);
+        for (int x = 0; x < roundTrip->GetWidth(); x += 7)
+            assert(std::abs(roundTrip->GetPixel(x, y).r_ - expected) < 0.01f);
+    }
+
+    // Constant light stays constant; roughness 1 is a cosine lobe that averages 1 + y to 5 / 3 straight up
+    auto levels = cube.GeneratePrefilteredGGX(6, ChannelFormat::Float32, 16);
+    assert(levels.size() == 6 && levels[0]->GetWidth() == 32 && levels[5]->GetWidth() == 1);
+    assert(levels[0]->GetImage(FACE_POSITIVE_Y)->GetPixel(16, 16).r_ == cube.GetImage(FACE_POSITIVE_Y)->GetPixel(16, 16).r_);
+    for (const auto& level : levels)
+    {
+        [[maybe_unused]] const Color top = level->GetImage(FACE_POSITIVE_Y)->GetPixelBilinear(0.5f, 0.5f);
+        assert(top.r_ > 1.0f && top.r_ < 2.01f && std::abs(top.b_ - 1.0f) < 0.001f);
+    }
+    assert(std::abs(levels[5]->GetImage(FACE_POSITIVE_Y)->GetPixel(0, 0).r_ - 5.0f / 3.0f) < 0.01f);
+    assert(std::abs(levels[5]->GetImage(FACE_NEGATIVE_Y)->GetPixel(0, 0).r_ - 1.0f / 3.0f) < 0.01f);
+}
@@ -0,0 +1,372 @@
+#include <Se/Console.hpp>
+#include <Se/Thread.h>
+#include <Se/WorkQueue.h>
+#include <SeResource/Image.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Implemented by ETCPACK, which the ETC decoder used for every block before it was decoded natively
+extern void setupAlphaTable();
+extern void decompressBlockAlphaC(unsigned char* data, unsigned char* img, int width, int height, int ix, int iy, int channels);
+extern void decompressBlockETC2c(unsigned int block_part1, unsigned int block_part2, unsigned char* img, int width, int height,
+    int startx, int starty, int channels);
+
+using namespace Se;
+
+namespace
+{
+
+/// Deterministic pseudo-random block data.
+std::vector<unsigned char> MakeRandomData(unsigned size, unsigned seed)
+{
+    std::vector<unsigned char> data(size);
+    for (unsigned char& value : data)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        value = static_cast<unsigned char>(seed >> 24);
+    }
+    return data;
+}
+
+/// Expand a 5:6:5 colour to RGBA8.
+void Unpack565(const unsigned char* packed, unsigned char* colour)
+{
+    const unsigned value = packed[0] | (packed[1] << 8);
+    const unsigned red = (value >> 11) & 0x1f;
+    const unsigned green = (value >> 5) & 0x3f;
+    const unsigned blue = value & 0x1f;
+    colour[0] = static_cast<unsigned char>((red << 3) | (red >> 2));
+    colour[1] = static_cast<unsigned char>((green << 2) | (green >> 4));
+    colour[2] = static_cast<unsigned char>((blue << 3) | (blue >> 2));
+    colour[3] = 255;
+}
+
+/// Decode one DXT pixel the straightforward way, one channel and one index at a time.
+void DecodePixelDXT(const unsigned char* block, CompressedFormat format, int x, int y, unsigned char* rgba)
+{
+    const unsigned char* colourBlock = format == CF_DXT1 ? block : block + 8;
+    unsigned char codes[4][4];
+    Unpack565(colourBlock, codes[0]);
+    Unpack565(colourBlock + 2, codes[1]);
+    const bool threeColour = format == CF_DXT1 && (colourBlock[0] | (colourBlock[1] << 8)) <= (colourBlock[2] | (colourBlock[3] << 8));
+    for (int i = 0; i < 3; ++i)
+    {
+        const int c = codes[0][i];
+        const int d = codes[1][i];
+        codes[2][i] = static_cast<unsigned char>(threeColour ? (c + d) / 2 : (2 * c + d) / 3);
+        codes[3][i] = static_cast<unsigned char>(threeColour ? 0 : (c + 2 * d) / 3);
+    }
+    codes[2][3] = 255;
+    codes[3][3] = threeColour ? 0 : 255;
+    memcpy(rgba, codes[(colourBlock[4 + y] >> (2 * x)) & 0x3], 4);
+
+    if (format == CF_DXT3)
+    {
+        const unsigned alpha = (block[2 * y + x / 2] >> (4 * (x & 1))) & 0xf;
+        rgba[3] = static_cast<unsigned char>(alpha * 17);
+    }
+    else if (format == CF_DXT5)
+    {
+        const int alpha0 = block[0];
+        const int alpha1 = block[1];
+        const int bit = 3 * (y * 4 + x);
+        unsigned index = 0;
+        for (int i = 0; i < 3; ++i)
+            index |= ((block[2 + (bit + i) / 8] >> ((bit + i) % 8)) & 1) << i;
+
+        if (index < 2)
+            rgba[3] = static_cast<unsigned char>(index ? alpha1 : alpha0);
+        else if (alpha0 > alpha1)
+            rgba[3] = static_cast<unsigned char>(((8 - index) * alpha0 + (index - 1) * alpha1) / 7);
+        else if (index < 6)
+            rgba[3] = static_cast<unsigned char>(((6 - index) * alpha0 + (index - 1) * alpha1) / 5);
+        else
+            rgba[3] = index == 6 ? 0 : 255;
+    }
+}
+
+/// Decode a DXT image pixel by pixel.
+std::vector<unsigned char> DecodeReferenceDXT(const unsigned char* blocks, int width, int height, int depth, CompressedFormat format)
+{
+    const int blockSize = format == CF_DXT1 ? 8 : 16;
+    const int blocksPerRow = (width + 3) / 4;
+    const int blocksPerSlice = blocksPerRow * ((height + 3) / 4);
+    std::vector<unsigned char> rgba(width * height * depth * 4);
+    for (int z = 0; z < depth; ++z)
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                const unsigned char* block = blocks + (z * blocksPerSlice + (y / 4) * blocksPerRow + x / 4) * blockSize;
+                DecodePixelDXT(block, format, x % 4, y % 4, &rgba[((z * height + y) * width + x) * 4]);
+            }
+        }
+    }
+    return rgba;
+}
+
+/// Decode an ETC image with ETCPACK one block at a time.
+std::vector<unsigned char> DecodeReferenceETC(unsigned char* blocks, int width, int height, bool hasAlpha)
+{
+    setupAlphaTable();
+
+    const int blockSize = hasAlpha ? 16 : 8;
+    std::vector<unsigned char> rgba(width * height * 4);
+    for (int y = 0; y < height; y += 4)
+    {
+        for (int x = 0; x < width; x += 4)
+        {
+            unsigned char* colourBlock = hasAlpha ? blocks + 8 : blocks;
+            const unsigned part1 = (colourBlock[0] << 24) | (colourBlock[1] << 16) | (colourBlock[2] << 8) | colourBlock[3];
+            const unsigned part2 = (colourBlock[4] << 24) | (colourBlock[5] << 16) | (colourBlock[6] << 8) | colourBlock[7];
+
+            unsigned char pixels[4 * 16];
+            memset(pixels, 0xff, sizeof pixels);
+            decompressBlockETC2c(part1, part2, pixels, 4, 4, 0, 0, 4);
+            if (hasAlpha)
+                decompressBlockAlphaC(blocks, pixels + 3, 4, 4, 0, 0, 4);
+
+            for (int py = 0; py < 4 && y + py < height; ++py)
+            {
+                for (int px = 0; px < 4 && x + px < width; ++px)
+                    memcpy(&rgba[((y + py) * width + x + px) * 4], &pixels[(py * 4 + px) * 4], 4);
+            }
+            blocks += blockSize;
+        }
+    }
+    return rgba;
+}
+
+/// Field sizes of a BC7 mode in bits, as listed in the format specification.
+struct BC7Mode
+{
+    int numSubsets_;
+    unsigned partitionBits_, rotationBits_, indexSelectionBits_, colourBits_, alphaBits_;
+    bool endpointPBits_, sharedPBits_;
+    unsigned indexBits_, secondaryIndexBits_;
+};
+
+const BC7Mode bc7Modes[8] =
+{
+    {3, 4, 0, 0, 4, 0, true, false, 3, 0},
+    {2, 6, 0, 0, 6, 0, false, true, 3, 0},
+    {3, 6, 0, 0, 5, 0, false, false, 2, 0},
+    {2, 6, 0, 0, 7, 0, true, false, 2, 0},
+    {1, 0, 2, 1, 5, 6, false, false, 2, 3},
+    {1, 0, 2, 0, 7, 8, false, false, 2, 2},
+    {1, 0, 0, 0, 7, 7, true, false, 4, 0},
+    {2, 6, 0, 0, 5, 5, true, false, 2, 0}
+};
+
+/// Writes little-endian bit fields to a zeroed BC7 block.
+struct BC7Writer
+{
+    unsigned char* data_;
+    unsigned position_;
+
+    void Write(unsigned value, unsigned numBits)
+    {
+        for (unsigned i = 0; i < numBits; ++i, ++position_)
+            data_[position_ >> 3] |= ((value >> i) & 1) << (position_ & 7);
+    }
+};
+
+/// Build a BC7 block of the given mode with varying endpoints and indices, and the pixels it must decode to. Partitioned
+/// modes use the row partitions 13 (rows 0-1 and 2-3) and 8 (rows 0-1, 2 and 3), whose anchors are pixels 15, and 8 and 15.
+void MakeBlockBC7(int mode, int rotation, int indexSelection, unsigned char* block, unsigned char* rgba)
+{
+    static const int weights2[4] = {0, 21, 43, 64};
+    static const int weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+    static const int weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+    const BC7Mode& info = bc7Modes[mode];
+    auto subsetOf = [&](int i) { return info.numSubsets_ == 1 ? 0 : (info.numSubsets_ == 2 ? i / 8 : std::max(i / 4 - 1, 0)); };
+    auto isAnchor = [&](int i) { return i == 0 || (info.numSubsets_ > 1 && i == 15) || (info.numSubsets_ == 3 && i == 8); };
+
+    memset(block, 0, 16);
+    BC7Writer bits{block, 0};
+    bits.Write(1u << mode, mode + 1);
+    bits.Write(info.numSubsets_ == 2 ? 13 : 8, info.partitionBits_);
+    bits.Write(rotation, info.rotationBits_);
+    bits.Write(indexSelection, info.indexSelectionBits_);
+
+    const int numEndpoints = 2 * info.numSubsets_;
+    int endpoints[6][4];
+    for (int c = 0; c < 4; ++c)
+    {
+        const unsigned numBits = c < 3 ? info.colourBits_ : info.alphaBits_;
+        for (int e = 0; e < numEndpoints; ++e)
+        {
+            endpoints[e][c] = (e * 37 + c * 11 + mode * 5 + 3) & ((1 << numBits) - 1);
+            bits.Write(endpoints[e][c], numBits);
+        }
+    }
+
+    int pBits[6] = {};
+    for (int e = 0; e < numEndpoints; ++e)
+    {
+        if (info.endpointPBits_ || (info.sharedPBits_ && !(e & 1)))
+        {
+            pBits[e] = (e + mode) & 1;
+            bits.Write(pBits[e], 1);
+        }
+        else if (info.sharedPBits_)
+            pBits[e] = pBits[e - 1];
+    }
+
+    // Expand endpoints to 8 bits, colour-only modes are opaque
+    const bool hasPBits = info.endpointPBits_ || info.sharedPBits_;
+    for (int e = 0; e < numEndpoints; ++e)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            if (c == 3 && !info.alphaBits_)
+            {
+                endpoints[e][c] = 255;
+                continue;
+            }
+            unsigned numBits = c < 3 ? info.colourBits_ : info.alphaBits_;
+            if (hasPBits)
+            {
+                endpoints[e][c] = (endpoints[e][c] << 1) | pBits[e];
+                ++numBits;
+            }
+            if (numBits < 8)
+                endpoints[e][c] = (endpoints[e][c] << (8 - numBits)) | (endpoints[e][c] >> (2 * numBits - 8));
+        }
+    }
+
+    int indices[2][16];
+    const unsigned indexBits[2] = {info.indexBits_, info.secondaryIndexBits_};
+    for (int set = 0; set < (info.secondaryIndexBits_ ? 2 : 1); ++set)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            const unsigned numBits = indexBits[set] - (set ? i == 0 : isAnchor(i));
+            indices[set][i] = (i * 5 + set * 3 + mode) & ((1 << numBits) - 1);
+            bits.Write(indices[set][i], numBits);
+        }
+    }
+    if (!info.secondaryIndexBits_)
+        memcpy(indices[1], indices[0], sizeof indices[1]);
+
+    auto weightsOf = [&](unsigned numBits) { return numBits == 2 ? weights2 : (numBits == 3 ? weights3 : weights4); };
+    const unsigned secondaryBits = info.secondaryIndexBits_ ? info.secondaryIndexBits_ : info.indexBits_;
+    const bool swapped = indexSelection != 0;
+    for (int i = 0; i < 16; ++i)
+    {
+        const int* e0 = endpoints[2 * subsetOf(i)];
+        const int* e1 = endpoints[2 * subsetOf(i) + 1];
+        const int colourWeight = weightsOf(swapped ? secondaryBits : info.indexBits_)[indices[swapped ? 1 : 0][i]];
+        const int alphaWeight = weightsOf(swapped ? info.indexBits_ : secondaryBits)[indices[swapped ? 0 : 1][i]];
+        unsigned char* pixel = rgba + 4 * i;
+        for (int c = 0; c < 4; ++c)
+        {
+            const int weight = c < 3 ? colourWeight : alphaWeight;
+            pixel[c] = static_cast<unsigned char>(((64 - weight) * e0[c] + weight * e1[c] + 32) >> 6);
+        }
+        if (rotation)
+            std::swap(pixel[3], pixel[rotation - 1]);
+    }
+}
+
+/// Decompress a level, either split between worker threads or serially from a thread that is not the main thread.
+std::vector<unsigned char> Decompress(const CompressedLevel& level, bool parallel)
+{
+    std::vector<unsigned char> rgba(level.width_ * level.height_ * std::max(level.depth_, 1) * 4);
+    [[maybe_unused]] bool success = false;
+    if (parallel)
+        success = level.Decompress(rgba.data());
+    else
+        std::thread([&]() { success = level.Decompress(rgba.data()); }).join();
+    assert(success);
+    return rgba;
+}
+
+CompressedLevel MakeLevel(std::vector<unsigned char>& data, CompressedFormat format, int width, int height, int depth)
+{
+    CompressedLevel level;
+    level.data_ = data.data();
+    level.format_ = format;
+    level.width_ = width;
+    level.height_ = height;
+    level.depth_ = depth;
+    level.dataSize_ = static_cast<unsigned>(data.size());
+    return level;
+}
+
+}
+
+void TestImageDecompress()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ImageDecompress\n"
+              "-------------------------------------------------------");
+
+    // Large enough to be split between worker threads, sizes are not multiples of 4 to cover edge blocks
+    Thread::SetMainThread();
+    auto* workQueue = WorkQueue::Get();
+    if (workQueue->GetNumThreads() == 0)
+        workQueue->CreateThreads(2);
+    const int width = 270;
+    const int height = 262;
+    const unsigned numBlocks = ((width + 3) / 4) * ((height + 3) / 4);
+
+    // Random blocks cover the three colour DXT1 mode, both DXT5 alpha codebooks and all ETC2 modes
+    const CompressedFormat dxtFormats[] = {CF_DXT1, CF_DXT3, CF_DXT5};
+    for (CompressedFormat format : dxtFormats)
+    {
+        const int depth = format == CF_DXT3 ? 2 : 1;
+        std::vector<unsigned char> data = MakeRandomData(numBlocks * depth * (format == CF_DXT1 ? 8 : 16), format);
+        const CompressedLevel level = MakeLevel(data, format, width, height, depth);
+        const std::vector<unsigned char> reference = DecodeReferenceDXT(data.data(), width, height, depth, format);
+        [[maybe_unused]] const std::vector<unsigned char> parallel = Decompress(level, true);
+        [[maybe_unused]] const std::vector<unsigned char> serial = Decompress(level, false);
+        assert(parallel == reference && serial == reference);
+    }
+
+    const CompressedFormat etcFormats[] = {CF_ETC1, CF_ETC2_RGB, CF_ETC2_RGBA};
+    for (CompressedFormat format : etcFormats)
+    {
+        const bool hasAlpha = format == CF_ETC2_RGBA;
+        std::vector<unsigned char> data = MakeRandomData(numBlocks * (hasAlpha ? 16 : 8), format);
+        const CompressedLevel level = MakeLevel(data, format, width, height, 1);
+        const std::vector<unsigned char> reference = DecodeReferenceETC(data.data(), width, height, hasAlpha);
+        [[maybe_unused]] const std::vector<unsigned char> parallel = Decompress(level, true);
+        [[maybe_unused]] const std::vector<unsigned char> serial = Decompress(level, false);
+        assert(parallel == reference && serial == reference);
+    }
+
+    // PVRTC has no separate reference, splitting the rows must not change the result
+    const CompressedFormat pvrtcFormats[] = {CF_PVRTC_RGB_2BPP, CF_PVRTC_RGBA_2BPP, CF_PVRTC_RGB_4BPP, CF_PVRTC_RGBA_4BPP};
+    for (CompressedFormat format : pvrtcFormats)
+    {
+        const int size = 256;
+        const unsigned bitsPerPixel = format == CF_PVRTC_RGB_2BPP || format == CF_PVRTC_RGBA_2BPP ? 2 : 4;
+        std::vector<unsigned char> data = MakeRandomData(size * size * bitsPerPixel / 8, format);
+        const CompressedLevel level = MakeLevel(data, format, size, size, 1);
+        [[maybe_unused]] const std::vector<unsigned char> parallel = Decompress(level, true);
+        [[maybe_unused]] const std::vector<unsigned char> serial = Decompress(level, false);
+        assert(parallel == serial);
+    }
+
+    // Every BC7 mode, including rotation and the mode 4 index selection
+    for (int mode = 0; mode < 8; ++mode)
+    {
+        for (int variant = 0; variant < 8; ++variant)
+        {
+            const int rotation = bc7Modes[mode].rotationBits_ ? variant & 3 : 0;
+            const int indexSelection = bc7Modes[mode].indexSelectionBits_ ? variant >> 2 : 0;
+            std::vector<unsigned char> data(16);
+            unsigned char expected[64];
+            MakeBlockBC7(mode, rotation, indexSelection, data.data(), expected);
+            const CompressedLevel level = MakeLevel(data, CF_BC7, 4, 4, 1);
+            [[maybe_unused]] const std::vector<unsigned char> decoded = Decompress(level, true);
+            assert(!memcmp(decoded.data(), expected, sizeof expected));
+        }
+    }
+}
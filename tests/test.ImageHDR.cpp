@@ -0,0 +1,78 @@
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <SeResource/Image.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace Se;
+
+void TestImageHDR()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ImageHDR\n"
+              "-------------------------------------------------------");
+
+    // Values well above 1 must survive storage, mips and saving
+    auto value = [](int x, int y) { return Color(x * 1.5f, 0.25f + y * 0.5f, 40.0f - x, 1.0f); };
+
+    Image image;
+    image.SetSize(40, 24, 4, ChannelFormat::Float16);
+    assert(image.IsHDR() && image.GetPixelSize() == 8 && image.GetMemoryUse() == 40 * 24 * 8);
+    for (int y = 0; y < image.GetHeight(); ++y)
+    {
+        for (int x = 0; x < image.GetWidth(); ++x)
+            image.SetPixel(x, y, value(x, y));
+    }
+    // Half floats keep 11 significant bits
+    [[maybe_unused]] const Color stored = image.GetPixel(33, 17);
+    assert(std::abs(stored.r_ - 49.5f) < 0.05f && std::abs(stored.g_ - 8.75f) < 0.01f && std::abs(stored.b_ - 7.0f) < 0.01f);
+
+    auto& fileSystem = FileSystem::Get();
+    const String fileName = fileSystem.GetTemporaryDir() + "SeImageHDRTest.hdr";
+    [[maybe_unused]] const bool savedHDR = image.SaveHDR(fileName);
+    [[maybe_unused]] const bool savedPNG = image.SavePNG(fileSystem.GetTemporaryDir() + "SeImageHDRTest.png");
+    assert(savedHDR && !savedPNG);
+
+    Image loaded;
+    {
+        File file(fileName);
+        [[maybe_unused]] const bool loadedFile = loaded.Load(file);
+        assert(loadedFile);
+    }
+    assert(loaded.GetChannelFormat() == ChannelFormat::Float16 && loaded.GetComponents() == 4);
+    assert(loaded.GetWidth() == 40 && loaded.GetHeight() == 24);
+    // RGBE stores 8 mantissa bits relative to the largest channel
+    for (int y = 0; y < loaded.GetHeight(); ++y)
+    {
+        for (int x = 0; x < loaded.GetWidth(); ++x)
+        {
+            [[maybe_unused]] const Color expected = value(x, y);
+            [[maybe_unused]] const Color actual = loaded.GetPixel(x, y);
+            [[maybe_unused]] const float tolerance = std::max(expected.r_, std::max(expected.g_, expected.b_)) / 64.0f;
+            assert(std::abs(actual.r_ - expected.r_) <= tolerance);
+            assert(std::abs(actual.g_ - expected.g_) <= tolerance);
+            assert(std::abs(actual.b_ - expected.b_) <= tolerance);
+        }
+    }
+    fileSystem.Delete(fileName);
+
+    // Box filtered mips average without clamping
+    [[maybe_unused]] const bool generated = image.GenerateLevels();
+    assert(generated);
+    std::vector<Image*> levels;
+    image.GetLevels(levels);
+    assert(levels.size() == 6 && levels[1]->GetChannelFormat() == ChannelFormat::Float16);
+    assert(std::abs(levels[1]->GetPixel(10, 3).r_ - 30.75f) < 0.05f);
+
+    auto floats = image.ConvertToChannelFormat(ChannelFormat::Float32);
+    assert(floats && floats->GetPixelSize() == 16 && floats->GetPixel(33, 17).r_ == stored.r_);
+    [[maybe_unused]] const bool resized = floats->Resize(20, 12, ResizeFilter::Box);
+    assert(resized && floats->GetChannelFormat() == ChannelFormat::Float32);
+    assert(std::abs(floats->GetPixel(10, 3).r_ - 30.75f) < 0.05f);
+
+    auto bytes = image.ConvertToChannelFormat(ChannelFormat::UNorm8);
+    assert(bytes && !bytes->IsHDR() && bytes->GetPixelInt(33, 17) == 0xffffffff);
+}
@@ -0,0 +1,159 @@
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <Se/IO/VectorBuffer.h>
+#include <Se/Thread.h>
+#include <SeResource/Image.h>
+#include <SeResource/ResourceCache.h>
+#include <SeVFS/VirtualFileSystem.h>
+
+#include <cassert>
+#include <thread>
+
+using namespace Se;
+
+void TestImageLazy()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ImageLazy\n"
+              "-------------------------------------------------------");
+
+    Image image;
+    image.SetSize(37, 21, 3);
+    for (int y = 0; y < image.GetHeight(); ++y)
+    {
+        for (int x = 0; x < image.GetWidth(); ++x)
+            image.SetPixelInt(x, y, 0xff000000 | (x * 6) << 8 | y * 12);
+    }
+    VectorBuffer png;
+    [[maybe_unused]] const bool saved = image.Save(png);
+    assert(saved);
+
+    // Header probing does not decode the pixels
+    ImageInfo info;
+    png.Seek(0);
+    [[maybe_unused]] bool probed = Image::ReadInfo(png, info);
+    assert(probed);
+    assert(info.width_ == 37 && info.height_ == 21 && info.components_ == 3 && info.compressedFormat_ == CF_NONE);
+    assert(info.channelFormat_ == ChannelFormat::UNorm8);
+
+    const unsigned char garbage[16] = {};
+    MemoryBuffer garbageBuffer(garbage, sizeof garbage);
+    probed = Image::ReadInfo(garbageBuffer, info);
+    assert(!probed);
+
+    // Lazy load reports the header and keeps the file until the pixels are needed
+    Image lazy;
+    lazy.SetLazyDecode(true);
+    png.Seek(0);
+    [[maybe_unused]] bool loaded = lazy.Load(png);
+    assert(loaded);
+    assert(lazy.IsDecodePending() && lazy.GetWidth() == 37 && lazy.GetHeight() == 21 && lazy.GetComponents() == 3);
+    assert(lazy.GetMemoryUse() == png.GetSize());
+    assert(lazy.GetData() && !lazy.IsDecodePending());
+    assert(lazy.GetMemoryUse() == 37 * 21 * 3);
+    for (int y = 0; y < lazy.GetHeight(); ++y)
+    {
+        for (int x = 0; x < lazy.GetWidth(); ++x)
+            assert(lazy.GetPixelInt(x, y) == image.GetPixelInt(x, y));
+    }
+
+    // Threads sharing a pending image decode it once and all see the same pixels
+    Image shared;
+    shared.SetLazyDecode(true);
+    png.Seek(0);
+    loaded = shared.Load(png);
+    assert(loaded && shared.IsDecodePending());
+    const unsigned numThreads = 4;
+    const unsigned char* sharedData[numThreads] = {};
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < numThreads; ++i)
+        threads.emplace_back([&shared, &sharedData, i] { sharedData[i] = shared.GetData(); });
+    for (std::thread& thread : threads)
+        thread.join();
+    for (unsigned i = 0; i < numThreads; ++i)
+        assert(sharedData[i] && sharedData[i] == shared.GetData());
+    assert(!shared.IsDecodePending() && shared.GetMemoryUse() == 37 * 21 * 3);
+    assert(shared.GetPixelInt(36, 20) == image.GetPixelInt(36, 20));
+
+    // Any pixel access decodes first
+    Image resized;
+    resized.SetLazyDecode(true);
+    png.Seek(0);
+    loaded = resized.Load(png);
+    [[maybe_unused]] const bool resizedOk = resized.Resize(10, 5);
+    assert(loaded && resizedOk && !resized.IsDecodePending());
+    assert(resized.GetWidth() == 10 && resized.GetData());
+
+    // Resizing away the pending file drops it
+    Image replaced;
+    replaced.SetLazyDecode(true);
+    png.Seek(0);
+    loaded = replaced.Load(png);
+    [[maybe_unused]] const bool sized = replaced.SetSize(37, 21, 3);
+    assert(loaded && sized && !replaced.IsDecodePending() && replaced.GetData());
+
+    // Level and cooking queries decode first
+    Image levels;
+    levels.SetLazyDecode(true);
+    png.Seek(0);
+    loaded = levels.Load(png);
+    std::vector<const Image*> imageLevels;
+    static_cast<const Image&>(levels).GetLevels(imageLevels);
+    assert(loaded && !levels.IsDecodePending() && imageLevels.size() == 1 && imageLevels[0]->GetData());
+    png.Seek(0);
+    loaded = levels.Load(png);
+    levels.CleanupLevels();
+    assert(loaded && !levels.IsDecodePending());
+    png.Seek(0);
+    loaded = levels.Load(png);
+    [[maybe_unused]] const unsigned cookVersion = levels.GetCookVersion();
+    assert(loaded && cookVersion && !levels.IsDecodePending());
+
+    // Compressed formats are probed from their headers and keep their level layout
+    auto& fileSystem = FileSystem::Get();
+    const String fileName = fileSystem.GetTemporaryDir() + "SeImageLazyTest.dds";
+    [[maybe_unused]] const bool savedDDS = image.ConvertToRGBA()->SaveDDS(fileName, CF_DXT1);
+    assert(savedDDS);
+    {
+        File file(fileName);
+        probed = Image::ReadInfo(file, info);
+        assert(probed);
+        assert(info.width_ == 37 && info.height_ == 21 && info.compressedFormat_ == CF_DXT1 && info.numLevels_ == 6);
+
+        Image dds;
+        dds.SetLazyDecode(true);
+        file.Seek(0);
+        loaded = dds.Load(file);
+        assert(loaded && dds.IsDecodePending());
+        assert(dds.IsCompressed() && dds.GetNumCompressedLevels() == 6);
+        [[maybe_unused]] const CompressedLevel level = dds.GetCompressedLevel(5);
+        assert(!dds.IsDecodePending() && level.data_ && level.width_ == 1 && level.height_ == 1);
+    }
+    fileSystem.Delete(fileName);
+
+    // Images loaded through the resource cache opt in with a factory
+    Thread::SetMainThread();
+    const String dataDir = fileSystem.GetTemporaryDir() + "SeImageLazyTest/";
+    fileSystem.RemoveDir(dataDir, true);
+    [[maybe_unused]] const bool created = fileSystem.CreateDir(dataDir);
+    [[maybe_unused]] const bool savedPNG = image.SavePNG(dataDir + "lazy.png");
+    assert(created && savedPNG);
+    auto vfs = VirtualFileSystem::Get();
+    auto mountPoint = vfs->MountDir(dataDir);
+    ResourceCache::RegisterResource<Image>(Image::GetTypeStatic(), []
+    {
+        auto lazyImage = std::make_shared<Image>();
+        lazyImage->SetLazyDecode(true);
+        return lazyImage;
+    });
+    auto& cache = ResourceCache::Get();
+    [[maybe_unused]] auto* cached = cache.GetResource<Image>("lazy.png");
+    assert(cached && cached->IsDecodePending() && cached->GetWidth() == 37);
+    assert(cached->GetPixelInt(36, 20) == image.GetPixelInt(36, 20) && !cached->IsDecodePending());
+    ResourceCache::RegisterResource<Image>(Image::GetTypeStatic());
+    cache.ReleaseResources(Image::GetTypeStatic(), String::EMPTY, true);
+    vfs->Unmount(mountPoint);
+    fileSystem.RemoveDir(dataDir, true);
+}
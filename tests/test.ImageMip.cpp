@@ -0,0 +1,133 @@
+#include <Se/Console.hpp>
+#include <SeResource/Image.h>
+
+#include <cassert>
+#include <cstring>
+#include <random>
+
+using namespace Se;
+
+namespace
+{
+
+/// Fill an 8-bit image with a 1-pixel checkerboard of two colors.
+void FillCheckerboard(Image& image, const Color& even, const Color& odd)
+{
+    for (int y = 0; y < image.GetHeight(); ++y)
+    {
+        for (int x = 0; x < image.GetWidth(); ++x)
+            image.SetPixel(x, y, (x + y) % 2 ? odd : even);
+    }
+}
+
+/// Return number of stored mip levels starting from the image.
+unsigned CountLevels(Image& image)
+{
+    std::vector<Image*> levels;
+    image.GetLevels(levels);
+    return levels.size();
+}
+
+}
+
+void TestImageMip()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ImageMip\n"
+              "-------------------------------------------------------");
+
+    // Box filtered chains match chained GetNextLevel() bit for bit, including odd, non-square and 1D sizes and
+    // levels large enough to be split into row bands
+    std::mt19937 random(31);
+    const IntVector2 sizes[] = {{64, 64}, {67, 41}, {7, 5}, {3, 3}, {1, 9}, {13, 1}, {100, 3}, {1025, 300}};
+    for (const IntVector2& size : sizes)
+    {
+        for (unsigned components = 1; components <= 4; ++components)
+        {
+            Image image;
+            image.SetSize(size.x_, size.y_, components);
+            const unsigned dataSize = size.x_ * size.y_ * components;
+            for (unsigned i = 0; i < dataSize; ++i)
+                image.GetData()[i] = static_cast<unsigned char>(random());
+
+            Image chained;
+            chained.SetSize(size.x_, size.y_, components);
+            chained.SetData(image.GetData());
+            std::vector<std::shared_ptr<Image>> reference;
+            for (const Image* current = &chained; current->GetWidth() > 1 || current->GetHeight() > 1;
+                current = reference.back().get())
+                reference.push_back(current->GetNextLevel());
+
+            [[maybe_unused]] const bool generated = image.GenerateLevels();
+            assert(generated);
+            std::vector<Image*> levels;
+            image.GetLevels(levels);
+            assert(levels.size() == reference.size() + 1);
+            for (unsigned i = 0; i < reference.size(); ++i)
+            {
+                [[maybe_unused]] const Image& level = *levels[i + 1];
+                [[maybe_unused]] const Image& expected = *reference[i];
+                assert(level.GetWidth() == expected.GetWidth() && level.GetHeight() == expected.GetHeight());
+                assert(level.GetComponents() == components);
+                assert(!memcmp(level.GetData(), expected.GetData(), level.GetWidth() * level.GetHeight() * components));
+            }
+        }
+    }
+
+    // Kaiser keeps flat areas flat, averages fine detail out, and differs from box on an edge
+    Image kaiser;
+    kaiser.SetSize(33, 20, 4);
+    FillCheckerboard(kaiser, Color(0.2f, 0.4f, 0.6f, 1.0f), Color(0.2f, 0.4f, 0.6f, 1.0f));
+    [[maybe_unused]] bool generated = kaiser.GenerateLevels(MipFilter::Kaiser);
+    assert(generated && CountLevels(kaiser) == 6);
+    std::vector<Image*> kaiserLevels;
+    kaiser.GetLevels(kaiserLevels);
+    for (const Image* level : kaiserLevels)
+    {
+        for (int y = 0; y < level->GetHeight(); ++y)
+        {
+            for (int x = 0; x < level->GetWidth(); ++x)
+                assert(level->GetPixel(x, y).ToUInt() == kaiserLevels[0]->GetPixel(0, 0).ToUInt());
+        }
+    }
+
+    FillCheckerboard(kaiser, Color::BLACK, Color::WHITE);
+    generated = kaiser.GenerateLevels(MipFilter::Kaiser);
+    assert(generated && std::abs(kaiser.GetNextLevel()->GetPixel(5, 5).r_ - 0.5f) < 0.02f);
+
+    Image edge;
+    edge.SetSize(32, 32, 1);
+    for (int y = 0; y < edge.GetHeight(); ++y)
+    {
+        for (int x = 0; x < edge.GetWidth(); ++x)
+            edge.SetPixel(x, y, x < 15 ? Color::BLACK : Color::WHITE);
+    }
+    Image edgeBox;
+    edgeBox.SetSize(32, 32, 1);
+    edgeBox.SetData(edge.GetData());
+    generated = edge.GenerateLevels(MipFilter::Kaiser) && edgeBox.GenerateLevels(MipFilter::Box);
+    assert(generated);
+    assert(memcmp(edge.GetNextLevel()->GetData(), edgeBox.GetNextLevel()->GetData(), 16 * 16));
+
+    // Gamma-correct filtering averages color in linear space, alpha stays linear
+    Image gamma;
+    gamma.SetSize(16, 16, 4);
+    FillCheckerboard(gamma, Color(0.0f, 0.0f, 0.0f, 0.0f), Color(1.0f, 1.0f, 1.0f, 1.0f));
+    generated = gamma.GenerateLevels(MipFilter::Box, true);
+    assert(generated && CountLevels(gamma) == 5);
+    std::vector<Image*> gammaLevels;
+    gamma.GetLevels(gammaLevels);
+    for (unsigned i = 1; i < gammaLevels.size(); ++i)
+    {
+        [[maybe_unused]] const unsigned pixel = gammaLevels[i]->GetPixel(0, 0).ToUInt();
+        // Linear 0.5 is 188 in sRGB
+        assert(std::abs(static_cast<int>(pixel & 0xffu) - 188) <= 1);
+        assert(std::abs(static_cast<int>(pixel >> 24u) - 128) <= 1);
+    }
+
+    Image plain;
+    plain.SetSize(16, 16, 4);
+    plain.SetData(gamma.GetData());
+    generated = plain.GenerateLevels();
+    assert(generated && std::abs(static_cast<int>(plain.GetNextLevel()->GetPixel(0, 0).ToUInt() & 0xffu) - 128) <= 1);
+}
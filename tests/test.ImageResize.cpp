@@ -0,0 +1,92 @@
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <Se/IO/VectorBuffer.h>
+#include <SeResource/Image.h>
+
+#include <cassert>
+#include <cstring>
+
+using namespace Se;
+
+namespace
+{
+
+/// Fill an RGBA image with a solid color.
+void FillImage(Image& image, int width, int height, const Color& color)
+{
+    image.SetSize(width, height, 4);
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+            image.SetPixel(x, y, color);
+    }
+}
+
+/// Build a DX10 DDS texture array from a plain DDS of the first layer and the pixels of the others.
+VectorBuffer MakeArrayDDS(const String& fileName, const std::vector<const Image*>& layers)
+{
+    File file(fileName);
+    std::vector<unsigned char> data(file.GetSize());
+    file.Read(data.data(), data.size());
+
+    // "DDS " and the 124 byte surface description, the pixel format four character code is at offset 84
+    const unsigned headerSize = 4 + 124;
+    const unsigned fourCC = 'D' | ('X' << 8) | ('1' << 16) | ('0' << 24);
+    memcpy(&data[84], &fourCC, sizeof fourCC);
+
+    // R8G8B8A8_UNORM, 2D texture, array size
+    const unsigned dx10Header[5] = {28, 3, 0, static_cast<unsigned>(layers.size()), 0};
+    VectorBuffer buffer;
+    buffer.Write(data.data(), headerSize);
+    buffer.Write(dx10Header, sizeof dx10Header);
+    for (const Image* layer : layers)
+        buffer.Write(layer->GetData(), layer->GetWidth() * layer->GetHeight() * 4);
+    buffer.Seek(0);
+    return buffer;
+}
+
+}
+
+void TestImageResize()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ImageResize\n"
+              "-------------------------------------------------------");
+
+    auto& fileSystem = FileSystem::Get();
+    const String fileName = fileSystem.GetTemporaryDir() + "SeImageResizeTest.dds";
+
+    Image red, blue;
+    FillImage(red, 8, 8, Color::RED);
+    FillImage(blue, 8, 8, Color::BLUE);
+    [[maybe_unused]] const bool saved = red.SaveDDS(fileName);
+    assert(saved);
+
+    // Every overload resizes all array layers the same way
+    for (unsigned overload = 0; overload < 3; ++overload)
+    {
+        VectorBuffer dds = MakeArrayDDS(fileName, {&red, &blue});
+        Image array;
+        [[maybe_unused]] const bool loaded = array.Load(dds);
+        assert(loaded && array.IsArray() && array.GetNextSibling());
+
+        [[maybe_unused]] bool resized = false;
+        if (overload == 0)
+            resized = array.Resize(4, 2);
+        else if (overload == 1)
+            resized = array.Resize(4, 2, ResizeFilter::Box);
+        else
+            resized = array.Resize(4, 2, 1, ResizeFilter::Triangle);
+        assert(resized);
+
+        [[maybe_unused]] const std::shared_ptr<Image> sibling = array.GetNextSibling();
+        assert(array.GetWidth() == 4 && array.GetHeight() == 2);
+        assert(sibling->GetWidth() == 4 && sibling->GetHeight() == 2 && sibling->GetDepth() == 1);
+        assert(sibling->GetMemoryUse() == 4 * 2 * 4);
+        // Solid layers stay solid
+        assert(array.GetPixelInt(3, 1) == Color::RED.ToUInt() && sibling->GetPixelInt(3, 1) == Color::BLUE.ToUInt());
+    }
+
+    fileSystem.Delete(fileName);
+}
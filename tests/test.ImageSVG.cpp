@@ -0,0 +1,68 @@
+#include <Se/Console.hpp>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <SeResource/ImageSVG.h>
+
+#include <cassert>
+#include <cstring>
+
+using namespace Se;
+
+void TestImageSVG()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ImageSVG\n"
+              "-------------------------------------------------------");
+
+    // Left half red, right half blue
+    const char* svg =
+        "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"32\" height=\"16\">"
+        "<rect x=\"0\" y=\"0\" width=\"16\" height=\"16\" fill=\"#ff0000\"/>"
+        "<rect x=\"16\" y=\"0\" width=\"16\" height=\"16\" fill=\"#0000ff\"/>"
+        "</svg>";
+
+    ImageSVG image;
+    MemoryBuffer source(svg, strlen(svg) + 1);
+    [[maybe_unused]] const bool loaded = image.BeginLoad(source);
+    assert(loaded);
+    assert(image.GetWidth() == 32 && image.GetHeight() == 16);
+    assert(image.GetPixelInt(4, 8) == 0xff0000ff && image.GetPixelInt(28, 8) == 0xffff0000);
+
+    // Each size is rendered once
+    auto large = image.GetRaster(512, 256);
+    assert(large && large->GetWidth() == 512 && large->GetHeight() == 256);
+    assert(large->GetPixelInt(100, 200) == 0xff0000ff && large->GetPixelInt(400, 10) == 0xffff0000);
+    [[maybe_unused]] auto cached = image.GetRaster(512, 256);
+    [[maybe_unused]] auto otherDPI = image.GetRaster(512, 256, 144.0f);
+    assert(cached == large && otherDPI != large);
+    assert(image.GetNumCachedRasters() == 2);
+
+    image.ClearRasterCache();
+    [[maybe_unused]] auto rerendered = image.GetRaster(512, 256);
+    assert(rerendered != large && image.GetNumCachedRasters() == 1);
+
+    // The document is scaled to the width and cropped at the bottom
+    [[maybe_unused]] auto wide = image.GetRaster(512, 128);
+    assert(wide->GetPixelInt(100, 100) == 0xff0000ff && wide->GetPixelInt(400, 100) == 0xffff0000);
+
+    // Least recently used rasters are evicted over the size limit
+    const unsigned rasterSize = 64 * 32 * 4;
+    image.ClearRasterCache();
+    assert(image.GetRasterCacheSize() == 0);
+    image.SetMaxRasterCacheSize(2 * rasterSize);
+    auto first = image.GetRaster(64, 32);
+    [[maybe_unused]] auto second = image.GetRaster(64, 32, 48.0f);
+    [[maybe_unused]] auto firstAgain = image.GetRaster(64, 32);
+    assert(firstAgain == first);
+    auto third = image.GetRaster(64, 32, 72.0f);
+    assert(image.GetNumCachedRasters() == 2 && image.GetRasterCacheSize() == 2 * rasterSize);
+    firstAgain = image.GetRaster(64, 32);
+    [[maybe_unused]] auto thirdAgain = image.GetRaster(64, 32, 72.0f);
+    [[maybe_unused]] auto secondAgain = image.GetRaster(64, 32, 48.0f);
+    assert(firstAgain == first && thirdAgain == third && secondAgain != second);
+
+    // Rasters over the whole limit are not cached
+    [[maybe_unused]] auto uncached = image.GetRaster(512, 256);
+    assert(uncached && image.GetRasterCacheSize() <= 2 * rasterSize);
+    image.SetMaxRasterCacheSize(rasterSize);
+    assert(image.GetNumCachedRasters() == 1 && image.GetRasterCacheSize() == rasterSize);
+}
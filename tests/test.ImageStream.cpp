@@ -0,0 +1,85 @@
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <Se/IO/PackageFile.h>
+#include <SeResource/Image.h>
+
+#include <cassert>
+#include <cstring>
+
+using namespace Se;
+
+namespace
+{
+
+/// Return whether two images have the same size, format and pixels.
+bool SamePixels(const Image& lhs, const Image& rhs)
+{
+    if (lhs.GetWidth() != rhs.GetWidth() || lhs.GetHeight() != rhs.GetHeight() || lhs.GetComponents() != rhs.GetComponents() ||
+        lhs.GetChannelFormat() != rhs.GetChannelFormat())
+        return false;
+    const std::size_t size = lhs.GetWidth() * lhs.GetHeight() * lhs.GetPixelSize();
+    return !memcmp(lhs.GetData(), rhs.GetData(), size);
+}
+
+}
+
+void TestImageStream()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ImageStream\n"
+              "-------------------------------------------------------");
+
+    auto& fileSystem = FileSystem::Get();
+    const String dataDir = fileSystem.GetTemporaryDir() + "SeImageStreamTest/";
+    const String packageName = fileSystem.GetTemporaryDir() + "SeImageStreamTest.pak";
+    fileSystem.RemoveDir(dataDir, true);
+    fileSystem.Delete(packageName);
+    [[maybe_unused]] const bool created = fileSystem.CreateDir(dataDir);
+    assert(created);
+
+    Image source;
+    source.SetSize(67, 41, 4);
+    for (int y = 0; y < source.GetHeight(); ++y)
+    {
+        for (int x = 0; x < source.GetWidth(); ++x)
+            source.SetPixel(x, y, Color(x / 67.0f, y / 41.0f, (x ^ y) / 128.0f, 0.5f + x / 200.0f));
+    }
+    [[maybe_unused]] const bool savedPNG = source.SavePNG(dataDir + "stream.png");
+    [[maybe_unused]] const bool savedHDR = source.SaveHDR(dataDir + "stream.hdr");
+    assert(savedPNG && savedHDR);
+    [[maybe_unused]] const bool packed = Tool::Pack(dataDir, packageName, true);
+    assert(packed);
+    PackageFile package(packageName);
+
+    // Plain files are memory-mapped, packaged files are compressed and streamed through stb_image's callbacks,
+    // buffers are decoded in place. All must give the same pixels
+    const char* fileNames[] = {"stream.png", "stream.hdr"};
+    for (const char* fileName : fileNames)
+    {
+        Image mapped;
+        File diskFile(dataDir + fileName);
+        [[maybe_unused]] const bool loadedMapped = mapped.Load(diskFile);
+        assert(loadedMapped && diskFile.GetPosition() == diskFile.GetSize());
+
+        Image streamed;
+        File packagedFile(&package, fileName);
+        assert(packagedFile.IsPackaged());
+        [[maybe_unused]] const bool loadedStreamed = streamed.Load(packagedFile);
+        assert(loadedStreamed);
+
+        Image buffered;
+        diskFile.Seek(0);
+        const std::vector<unsigned char> data = diskFile.ReadBinary();
+        MemoryBuffer buffer(data.data(), data.size());
+        [[maybe_unused]] const bool loadedBuffered = buffered.Load(buffer);
+        assert(loadedBuffered);
+
+        assert(mapped.GetWidth() == source.GetWidth() && mapped.GetHeight() == source.GetHeight());
+        assert(SamePixels(mapped, streamed) && SamePixels(mapped, buffered));
+    }
+
+    fileSystem.Delete(packageName);
+    fileSystem.RemoveDir(dataDir, true);
+}
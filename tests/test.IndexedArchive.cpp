@@ -0,0 +1,110 @@
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <Se/IO/MappedFile.h>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <SeArc/ArchiveSerialization.hpp>
+#include <SeResource/IndexedArchive.h>
+
+#include <cassert>
+
+using namespace Se;
+
+namespace
+{
+
+struct IndexedChunk
+{
+    int x_{};
+    int y_{};
+    std::vector<String> names_;
+    std::vector<float> heights_;
+
+    void SerializeInBlock(Archive& archive)
+    {
+        SerializeValue(archive, "x", x_);
+        SerializeValue(archive, "y", y_);
+        SerializeValue(archive, "names", names_);
+        SerializeValue(archive, "heights", heights_);
+    }
+
+    bool operator ==(const IndexedChunk& rhs) const
+    {
+        return x_ == rhs.x_ && y_ == rhs.y_ && names_ == rhs.names_ && heights_ == rhs.heights_;
+    }
+};
+
+IndexedChunk MakeChunk(int x, int y)
+{
+    IndexedChunk chunk{x, y, {}, {}};
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        chunk.names_.push_back(cformat("object_%d_%d_%u", x, y, i));
+        chunk.heights_.push_back(x * 0.5f + y + i);
+    }
+    return chunk;
+}
+
+}
+
+void TestIndexedArchive()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test IndexedArchive\n"
+              "-------------------------------------------------------");
+
+    auto& fileSystem = FileSystem::Get();
+    const String fileName = fileSystem.GetTemporaryDir() + "SeIndexedArchiveTest.bin";
+
+    // Named blocks, one of them replaced
+    const int gridSize = 16;
+    std::vector<IndexedChunk> chunks;
+    IndexedArchiveWriter writer;
+    for (int y = 0; y < gridSize; ++y)
+    {
+        for (int x = 0; x < gridSize; ++x)
+        {
+            chunks.push_back(MakeChunk(x, y));
+            [[maybe_unused]] const bool saved = writer.SaveObject(cformat("chunk_%d_%d", x, y), chunks.back());
+            assert(saved);
+        }
+    }
+    chunks[0].heights_.resize(3);
+    [[maybe_unused]] bool success = writer.SaveObject("chunk_0_0", chunks[0]);
+    assert(success && writer.GetNumBlocks() == gridSize * gridSize);
+    success = writer.SaveFile(fileName);
+    assert(success);
+
+    IndexedArchiveReader reader;
+    success = reader.Open(fileName);
+    assert(success && reader.GetEntries().size() == gridSize * gridSize);
+    assert(reader.HasObject("chunk_15_15") && !reader.HasObject("chunk_16_0"));
+    IndexedChunk loaded;
+    success = reader.LoadObject("chunk_0_0", loaded);
+    assert(success && loaded == chunks[0]);
+    success = reader.LoadObject("chunk_7_3", loaded);
+    assert(success && loaded == chunks[3 * gridSize + 7]);
+    success = reader.LoadObject("chunk_16_0", loaded);
+    assert(!success);
+
+    // Same content from a stream
+    {
+        File file(fileName);
+        IndexedArchiveReader streamReader;
+        success = streamReader.Load(file) && streamReader.LoadObject("chunk_15_15", loaded);
+        assert(success && loaded == chunks.back());
+    }
+
+    // Broken containers are rejected
+    {
+        MappedFile mapped(fileName);
+        assert(mapped.IsOpen() && mapped.IsMapped());
+        MemoryBuffer truncated(mapped.GetData(), mapped.GetSize() - 1);
+        IndexedArchiveReader brokenReader;
+        success = brokenReader.Load(truncated);
+        assert(!success && brokenReader.GetEntries().empty());
+    }
+
+    reader.Close();
+    fileSystem.Delete(fileName);
+}
@@ -0,0 +1,90 @@
+#include <Se/Console.hpp>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <Se/ValueDocument.h>
+#include <SeResource/JSONFile.h>
+
+#include <cassert>
+
+using namespace Se;
+
+void TestJSONFile()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test JSONFile\n"
+              "-------------------------------------------------------");
+
+    const String text = R"({
+        // Comments and trailing commas are accepted
+        "name": "line\nbreak é",
+        "int": -12,
+        "uint": 3000000000,
+        "big": -5000000000,
+        "real": 0.25,
+        "flags": [true, false, null,],
+        "nested": {"list": [[1, 2], {"key": "value"}], "empty": {}},
+    })";
+
+    JSONFile file;
+    [[maybe_unused]] bool parsed = file.FromString(text);
+    assert(parsed);
+    const JSONValue& root = file.GetRoot();
+    assert(root.IsObject() && root.Size() == 7);
+    assert(root.Get("name").GetString() == "line\nbreak \xc3\xa9");
+    assert(root.Get("int").GetNumberType() == VALUE_NT_INT && root.Get("int").GetInt() == -12);
+    assert(root.Get("uint").GetNumberType() == VALUE_NT_UINT && root.Get("uint").GetUInt() == 3000000000u);
+    assert(root.Get("big").GetNumberType() == VALUE_NT_FLOAT_DOUBLE && root.Get("big").GetDouble() == -5000000000.0);
+    assert(root.Get("real").GetDouble() == 0.25);
+    [[maybe_unused]] const JSONValue& flags = root.Get("flags");
+    assert(flags.Size() == 3 && flags[0U].GetBool() && !flags[1].GetBool() && flags[2].IsNull());
+    [[maybe_unused]] const JSONValue& nested = root.Get("nested");
+    assert(nested.Get("list")[0U][1].GetInt() == 2 && nested.Get("list")[1].Get("key").GetString() == "value");
+    assert(nested.Get("empty").IsObject() && nested.Get("empty").Size() == 0);
+
+    // Failed parse keeps the previous content
+    [[maybe_unused]] const JSONValue previous = root;
+    parsed = file.FromString("{\"broken\": [1, 2}");
+    assert(!parsed && file.GetRoot() == previous);
+
+    // Same content as a compact document, with and without in-situ strings
+    for (bool inSitu : {true, false})
+    {
+        MemoryBuffer buffer(text.c_str(), text.length());
+        ValueDocument document;
+        parsed = JSONFile::ParseDocument(buffer, document, inSitu);
+        assert(parsed);
+        assert(document.IsComplete() && document.ToValue() == file.GetRoot());
+        assert(document.GetRoot()["name"].GetStringView() == "line\nbreak \xc3\xa9");
+        assert(document.GetRoot()["nested"]["list"][1]["key"].GetStringView() == "value");
+    }
+    {
+        MemoryBuffer buffer("[1, 2", 5);
+        ValueDocument document;
+        parsed = JSONFile::ParseDocument(buffer, document);
+        assert(!parsed && document.GetRoot().IsNull());
+    }
+
+    // Load and walk a larger file
+    JSONValue records(VALUE_ARRAY);
+    const unsigned numRecords = 200;
+    for (unsigned i = 0; i < numRecords; ++i)
+    {
+        JSONValue record;
+        record["id"] = i;
+        record["name"] = cformat("record \"%u\"", i);
+        record["position"].Push(i * 0.5);
+        record["position"].Push(-1.0);
+        records.Push(record);
+    }
+    const String largeText = ToPrettyString(records);
+
+    JSONFile largeFile;
+    parsed = largeFile.FromString(largeText);
+    assert(parsed);
+    MemoryBuffer largeBuffer(largeText.c_str(), largeText.length());
+    ValueDocument largeDocument;
+    parsed = JSONFile::ParseDocument(largeBuffer, largeDocument);
+    assert(parsed);
+
+    assert(largeFile.GetRoot() == records && largeDocument.GetRoot().Size() == numRecords);
+    assert(largeDocument.GetRoot()[numRecords - 1]["name"].GetString() == cformat("record \"%u\"", numRecords - 1));
+}
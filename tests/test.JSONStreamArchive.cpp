@@ -0,0 +1,166 @@
+#include <Se/Console.hpp>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <SeArc/ArchiveSerialization.hpp>
+#include <SeResource/JSONArchive.h>
+#include <SeResource/JSONFile.h>
+
+#include <cassert>
+
+using namespace Se;
+
+namespace
+{
+
+struct StreamArchiveItem
+{
+    String name_;
+    float weight_{};
+    std::vector<int> counts_;
+
+    void SerializeInBlock(Archive& archive)
+    {
+        SerializeValue(archive, "name", name_);
+        SerializeValue(archive, "weight", weight_);
+        SerializeValue(archive, "counts", counts_);
+    }
+
+    bool operator ==(const StreamArchiveItem& rhs) const
+    {
+        return name_ == rhs.name_ && weight_ == rhs.weight_ && counts_ == rhs.counts_;
+    }
+};
+
+struct StreamArchiveConfig
+{
+    int version_{};
+    bool enabled_{};
+    long long id_{};
+    String title_{"untitled"};
+    StreamArchiveItem main_;
+    std::vector<StreamArchiveItem> items_;
+
+    void SerializeInBlock(Archive& archive)
+    {
+        SerializeValue(archive, "version", version_);
+        SerializeValue(archive, "enabled", enabled_);
+        SerializeValue(archive, "id", id_);
+        SerializeOptionalValue(archive, "title", title_, String("untitled"));
+        SerializeValue(archive, "main", main_);
+        SerializeValue(archive, "items", items_);
+    }
+
+    bool operator ==(const StreamArchiveConfig& rhs) const
+    {
+        return version_ == rhs.version_ && enabled_ == rhs.enabled_ && id_ == rhs.id_ && title_ == rhs.title_
+            && main_ == rhs.main_ && items_ == rhs.items_;
+    }
+};
+
+struct StreamArchiveGrid
+{
+    std::vector<std::vector<int>> rows_;
+    std::vector<String> names_;
+
+    void SerializeInBlock(Archive& archive)
+    {
+        SerializeValue(archive, "rows", rows_);
+        SerializeValue(archive, "names", names_);
+    }
+};
+
+template <class T> bool LoadFromStream(const String& text, T& value)
+{
+    MemoryBuffer buffer(text.c_str(), text.length());
+    try
+    {
+        JSONStreamInputArchive archive(buffer);
+        SerializeValue(archive, "config", value);
+        archive.Flush();
+        return true;
+    }
+    catch (const ArchiveException& e)
+    {
+        SE_LOG_PRINT("Expected error: {}", e.what());
+        return false;
+    }
+}
+
+}
+
+void TestJSONStreamArchive()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test JSONStreamArchive\n"
+              "-------------------------------------------------------");
+
+    // Keys out of order, unknown keys, comments and a missing optional value
+    const String text = R"({
+        "main": {"counts": [1, 2, 3], "name": "main \"item\"", "weight": 0.5},
+        "unknown": {"nested": [1, [2, {"x": "]"}]]},
+        "items": [
+            {"name": "a", "weight": 1, "counts": []},
+            {"extra": null, "weight": 2.5, "counts": [4,], "name": "b"} // trailing comma
+        ],
+        "id": "-5000000000",
+        "enabled": true,
+        "version": 3,
+    })";
+
+    StreamArchiveConfig streamed;
+    [[maybe_unused]] bool success = LoadFromStream(text, streamed);
+    assert(success);
+    assert(streamed.version_ == 3 && streamed.enabled_ && streamed.id_ == -5000000000ll && streamed.title_ == "untitled");
+    assert(streamed.main_.name_ == "main \"item\"" && streamed.main_.weight_ == 0.5f && streamed.main_.counts_.size() == 3);
+    assert(streamed.items_.size() == 2 && streamed.items_[0].counts_.empty() && streamed.items_[1].name_ == "b");
+    assert(streamed.items_[1].weight_ == 2.5f && streamed.items_[1].counts_ == std::vector<int>{4});
+
+    // Same result as the Value tree archive
+    JSONFile file;
+    StreamArchiveConfig loaded;
+    success = file.FromString(text) && file.LoadObject("config", loaded);
+    assert(success && loaded == streamed);
+
+    // Round trip through the output archive, which writes object members in hash order
+    streamed.title_ = "titled";
+    JSONFile output;
+    success = output.SaveObject("config", streamed);
+    assert(success);
+    StreamArchiveConfig reloaded;
+    success = LoadFromStream(output.ToString(), reloaded);
+    assert(success && reloaded == streamed);
+
+    // Nested streamed arrays get their sizes from one scan, brackets in strings and comments are not counted
+    StreamArchiveGrid grid;
+    success = LoadFromStream(R"({"rows": [[1, 2], [3], [], [4, 5, 6,]], "names": ["a]", /* ], */ "b,[", "c"], "tail": [[7]]})", grid);
+    assert(success && grid.rows_.size() == 4 && grid.rows_[0] == std::vector<int>({1, 2}) && grid.rows_[2].empty());
+    assert(grid.rows_[3] == std::vector<int>({4, 5, 6}) && grid.names_.size() == 3 && grid.names_[1] == "b,[");
+
+    // Errors
+    StreamArchiveConfig failed;
+    success = LoadFromStream(R"({"version": "3"})", failed);
+    assert(!success);
+    success = LoadFromStream(R"({"version": 3, "enabled": true})", failed);
+    assert(!success);
+    success = LoadFromStream(R"({"version": 3, "enabled": tru})", failed);
+    assert(!success);
+
+    // Larger config through both archives
+    StreamArchiveConfig large;
+    const unsigned numItems = 200;
+    for (unsigned i = 0; i < numItems; ++i)
+        large.items_.push_back(StreamArchiveItem{cformat("item%u", i), i * 0.25f, {1, 2, static_cast<int>(i)}});
+    JSONFile largeOutput;
+    success = largeOutput.SaveObject("config", large);
+    assert(success);
+    const String largeText = largeOutput.ToString();
+
+    JSONFile largeFile;
+    StreamArchiveConfig largeLoaded;
+    success = largeFile.FromString(largeText) && largeFile.LoadObject("config", largeLoaded);
+    assert(success);
+    StreamArchiveConfig largeStreamed;
+    success = LoadFromStream(largeText, largeStreamed);
+    assert(success);
+
+    assert(largeLoaded == large && largeStreamed == large);
+}
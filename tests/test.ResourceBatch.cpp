@@ -0,0 +1,112 @@
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <Se/Thread.h>
+#include <Se/WorkQueue.h>
+#include <SeResource/JSONFile.h>
+#include <SeResource/ResourceCache.h>
+#include <SeResource/XMLFile.h>
+#include <SeResource/YAMLFile.h>
+#include <SeVFS/VirtualFileSystem.h>
+
+#include <cassert>
+#include <thread>
+
+using namespace Se;
+
+namespace
+{
+
+void WriteTextFile(const String& fileName, const String& text)
+{
+    File file(fileName, FILE_WRITE);
+    [[maybe_unused]] const unsigned written = file.Write(text.c_str(), text.length());
+    assert(written == text.length());
+}
+
+}
+
+void TestResourceBatch()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ResourceBatch\n"
+              "-------------------------------------------------------");
+
+    // Resource cache calls are accepted only from the main thread
+    Thread::SetMainThread();
+    ResourceCache::RegisterResource<JSONFile>(JSONFile::GetTypeStatic());
+    ResourceCache::RegisterResource<YAMLFile>(YAMLFile::GetTypeStatic());
+    ResourceCache::RegisterResource<XMLFile>(XMLFile::GetTypeStatic());
+
+    auto* workQueue = WorkQueue::Get();
+    const unsigned numCores = std::thread::hardware_concurrency();
+    if (workQueue->GetNumThreads() == 0 && numCores > 1)
+        workQueue->CreateThreads(numCores - 1);
+
+    // Small level documents of each text format
+    auto& fileSystem = FileSystem::Get();
+    const String dataDir = fileSystem.GetTemporaryDir() + "SeResourceBatchTest/";
+    fileSystem.RemoveDir(dataDir, true);
+    [[maybe_unused]] const bool created = fileSystem.CreateDir(dataDir);
+    assert(created);
+
+    const unsigned numDocuments = 10;
+    const unsigned numEntries = 20;
+    std::vector<ResourceRef> refs;
+    for (unsigned i = 0; i < numDocuments; ++i)
+    {
+        String json = cformat("{\"id\": %u, \"entries\": [", i);
+        String yaml = cformat("id: %u\nentries:\n", i);
+        String xml = cformat("<document id=\"%u\">\n", i);
+        for (unsigned j = 0; j < numEntries; ++j)
+        {
+            json += cformat("%s{\"name\": \"entry%u\", \"value\": %u.5}", j ? ", " : "", j, j);
+            yaml += cformat("  - name: entry%u\n    value: %u.5\n", j, j);
+            xml += cformat("    <entry name=\"entry%u\" value=\"%u.5\" />\n", j, j);
+        }
+        json += "]}";
+        xml += "</document>\n";
+
+        const String name = cformat("doc%u", i);
+        WriteTextFile(dataDir + name + ".json", json);
+        WriteTextFile(dataDir + name + ".yaml", yaml);
+        WriteTextFile(dataDir + name + ".xml", xml);
+        refs.emplace_back(JSONFile::GetTypeStatic(), name + ".json");
+        refs.emplace_back(YAMLFile::GetTypeStatic(), name + ".yaml");
+        refs.emplace_back(XMLFile::GetTypeStatic(), name + ".xml");
+    }
+
+    auto vfs = VirtualFileSystem::Get();
+    auto mountPoint = vfs->MountDir(dataDir);
+    auto& cache = ResourceCache::Get();
+
+    // One after another
+    unsigned numLoaded = 0;
+    for (const ResourceRef& ref : refs)
+        numLoaded += cache.GetResource(ref.type_, ref.name_) != nullptr;
+    assert(numLoaded == refs.size());
+    cache.ReleaseAllResources(true);
+
+    // Batched
+    numLoaded = cache.LoadResources(refs);
+    assert(numLoaded == refs.size());
+
+    [[maybe_unused]] auto* json = cache.GetExistingResource<JSONFile>("doc7.json");
+    [[maybe_unused]] auto* yaml = cache.GetExistingResource<YAMLFile>("doc7.yaml");
+    [[maybe_unused]] auto* xml = cache.GetExistingResource<XMLFile>("doc7.xml");
+    assert(json && json->GetRoot()["id"].GetUInt() == 7 && json->GetRoot()["entries"].Size() == numEntries);
+    assert(yaml && yaml->GetRoot()["entries"][7]["name"].GetString() == "entry7");
+    assert(xml && xml->GetRoot("document").GetUInt("id") == 7);
+
+    // Loaded resources are counted again, missing and broken ones are not stored
+    WriteTextFile(dataDir + "broken.json", "{\"id\": ");
+    const std::vector<ResourceRef> mixed{refs[0], ResourceRef("JSONFile", "broken.json"),
+        ResourceRef("JSONFile", "missing.json"), refs[0]};
+    numLoaded = cache.LoadResources(mixed, false);
+    assert(numLoaded == 1);
+    assert(!cache.GetExistingResource<JSONFile>("broken.json") && !cache.GetExistingResource<JSONFile>("missing.json"));
+
+    cache.ReleaseAllResources(true);
+    vfs->Unmount(mountPoint);
+    fileSystem.RemoveDir(dataDir, true);
+}
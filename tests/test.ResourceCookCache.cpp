@@ -0,0 +1,106 @@
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <Se/IO/VectorBuffer.h>
+#include <SeResource/Image.h>
+#include <SeResource/JSONFile.h>
+#include <SeResource/ResourceCookCache.h>
+
+#include <cassert>
+
+using namespace Se;
+
+const String json0 = R"({
+    "name": "cooked",
+    "count": -3,
+    "size": 4000000000,
+    "scale": 0.5,
+    "enabled": true,
+    "empty": null,
+    "items": [1, "two", {"three": 3}]
+})";
+
+void TestResourceCookCache()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ResourceCookCache\n"
+              "-------------------------------------------------------");
+
+    JSONFile source;
+    [[maybe_unused]] const bool parsed = source.FromString(json0);
+    assert(parsed);
+
+    // Value tree must survive the binary round trip unchanged
+    VectorBuffer cooked;
+    [[maybe_unused]] const bool written = WriteCookedValue(cooked, source.GetRoot());
+    assert(written);
+    cooked.Seek(0);
+    Value restored;
+    [[maybe_unused]] const bool read = ReadCookedValue(cooked, restored);
+    assert(read);
+    assert(Value::Compare(restored, source.GetRoot()));
+    assert(restored["count"].GetNumberType() == VALUE_NT_INT);
+    assert(restored["size"].GetUInt() == 4000000000u);
+
+    // Store and load through the on-disk cache
+    auto& fileSystem = FileSystem::Get();
+    const String cacheDir = fileSystem.GetTemporaryDir() + "SeCookCacheTest/";
+    fileSystem.RemoveDir(cacheDir, true);
+
+    ResourceCookCache cache;
+    cache.SetCacheDir(cacheDir);
+    assert(cache.IsEnabled());
+
+    const ResourceCookKey key{0x1234abcd5678ef90ull, 1000};
+    JSONFile target;
+    [[maybe_unused]] const bool missed = !cache.LoadCooked(target, key);
+    [[maybe_unused]] const bool stored = cache.StoreCooked(source, key);
+    [[maybe_unused]] const bool hit = cache.LoadCooked(target, key);
+    assert(missed && stored && hit);
+    assert(Value::Compare(target.GetRoot(), source.GetRoot()));
+    assert(cache.GetNumHits() == 1 && cache.GetNumMisses() == 1);
+
+    // Same hash with another size is another source
+    [[maybe_unused]] const bool sizeMissed = !cache.LoadCooked(target, ResourceCookKey{key.hash_, key.size_ + 1});
+    assert(sizeMissed && cache.GetNumMisses() == 2);
+
+    // A blob whose header does not match its file name is discarded
+    const ResourceCookKey otherKey{key.hash_ ^ 1, key.size_};
+    [[maybe_unused]] const bool copied = fileSystem.Copy(cache.GetCookedFileName(source.GetType(), key, source.GetCookVersion()),
+        cache.GetCookedFileName(source.GetType(), otherKey, source.GetCookVersion()));
+    assert(copied);
+    [[maybe_unused]] const bool headerMissed = !cache.LoadCooked(target, otherKey);
+    assert(headerMissed && cache.GetNumMisses() == 3);
+
+    // Mapped files, streams and split blocks give the same key, changing the content changes it
+    const String sourceName = cacheDir + "source.json";
+    {
+        File sourceFile(sourceName, FILE_WRITE);
+        sourceFile.WriteStringData(json0);
+    }
+    File sourceFile(sourceName);
+    [[maybe_unused]] const ResourceCookKey fileKey = cache.GetSourceKey(sourceFile);
+    assert(fileKey.IsValid() && fileKey.size_ == json0.length() && sourceFile.GetPosition() == 0);
+    assert(cache.GetSourceKey(sourceFile) == fileKey);
+    MemoryBuffer sourceBuffer(json0);
+    assert(cache.GetSourceKey(sourceBuffer) == fileKey);
+    [[maybe_unused]] const auto* sourceData = reinterpret_cast<const unsigned char*>(json0.data());
+    assert(HashCookSource(HashCookSource(0, sourceData, 64), sourceData + 64, json0.length() - 64) == fileKey.hash_);
+
+    String changed = json0;
+    changed[10] ^= 1;
+    MemoryBuffer changedBuffer(changed);
+    assert(cache.GetSourceKey(changedBuffer) != fileKey);
+    SE_LOG_PRINT("{}", cache.PrintStats());
+
+    // Only images stored as plain pixels are cooked
+    Image plainImage;
+    plainImage.SetName("Textures/Plain.png");
+    assert(plainImage.GetCookVersion() != 0);
+    Image compressedImage;
+    compressedImage.SetName("Textures/Compressed.dds");
+    assert(compressedImage.GetCookVersion() == 0);
+
+    fileSystem.RemoveDir(cacheDir, true);
+}
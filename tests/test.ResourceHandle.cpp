@@ -0,0 +1,67 @@
+#include <Se/Console.hpp>
+#include <SeResource/JSONFile.h>
+#include <SeResource/ResourceCache.h>
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <type_traits>
+
+using namespace Se;
+
+// A copy would share the slot and invalidate it on destruction while the original is alive
+static_assert(!std::is_copy_constructible_v<JSONFile> && !std::is_copy_assignable_v<JSONFile>);
+
+void TestResourceHandle()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ResourceHandle\n"
+              "-------------------------------------------------------");
+
+    ResourceHandle handle;
+    {
+        auto file = std::make_shared<JSONFile>();
+        handle = file->GetHandle();
+        assert(handle.IsValid());
+        assert(ResourceCache::GetResource(handle) == file.get());
+        assert(ResourceCache::GetResource<JSONFile>(handle) == file.get());
+    }
+
+    // Destroyed resource must not resolve, even when its slot is reused
+    assert(!ResourceCache::GetResource(handle));
+    auto other = std::make_shared<JSONFile>();
+    assert(other->GetHandle() != handle);
+    assert(!ResourceCache::GetResource(handle));
+    assert(ResourceCache::GetResource(other->GetHandle()) == other.get());
+
+    assert(!ResourceCache::GetResource(ResourceHandle{}));
+
+    // A stale handle never resolves to the next occupant of its slot while another thread reuses the slot
+    ResourceSlotTable table;
+    int first{}, second{};
+    auto* firstResource = reinterpret_cast<Resource*>(&first);
+    auto* secondResource = reinterpret_cast<Resource*>(&second);
+    std::atomic<unsigned> published{};
+    std::atomic<bool> done{};
+    std::thread writer([&]
+    {
+        for (unsigned i = 0; i < 2000000; ++i)
+        {
+            const ResourceHandle firstHandle = table.Acquire(firstResource);
+            published.store(firstHandle.generation_, std::memory_order_relaxed);
+            table.Release(firstHandle);
+            table.Release(table.Acquire(secondResource));
+        }
+        done = true;
+    });
+    [[maybe_unused]] unsigned numWrong = 0;
+    while (!done)
+    {
+        // Slot 0 is the only one ever used
+        const Resource* resolved = table.Get(ResourceHandle{0, published.load(std::memory_order_relaxed)});
+        if (resolved && resolved != firstResource)
+            ++numWrong;
+    }
+    writer.join();
+    assert(numWrong == 0 && table.GetNumUsed() == 0);
+}
@@ -0,0 +1,85 @@
+#include <Se/Console.hpp>
+#include <SeResource/ResourceLoadStats.h>
+
+#include <cassert>
+
+using namespace Se;
+
+namespace
+{
+
+ResourceLoadRecord MakeRecord(const String& type, unsigned index, long long endLoadUs, bool success = true)
+{
+    ResourceLoadRecord record;
+    record.type_ = type;
+    record.name_ = cformat("%s%u", type.c_str(), index);
+    record.queueWaitUs_ = 1000;
+    record.ioWaitUs_ = 50;
+    record.beginLoadUs_ = 150;
+    record.endLoadUs_ = endLoadUs;
+    record.bytes_ = 4096;
+    record.background_ = index % 2 == 0;
+    record.success_ = success;
+    return record;
+}
+
+}
+
+void TestResourceLoadStats()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ResourceLoadStats\n"
+              "-------------------------------------------------------");
+
+    // Power-of-two buckets starting at 100 us, the last one is unbounded
+    ResourceLoadHistogram histogram;
+    histogram.Add(-5);
+    histogram.Add(99);
+    histogram.Add(100);
+    histogram.Add(250);
+    histogram.Add(100LL << 20);
+    assert(histogram.count_ == 5 && histogram.buckets_[0] == 2 && histogram.buckets_[1] == 1 && histogram.buckets_[2] == 1);
+    assert(histogram.buckets_[ResourceLoadHistogram::NumBuckets - 1] == 1 && histogram.maxUs_ == 100LL << 20);
+    assert(ResourceLoadHistogram::GetBucketUpperBoundUs(ResourceLoadHistogram::NumBuckets - 1) == -1);
+
+    // Per-type aggregates
+    ResourceLoadStats stats;
+    assert(stats.GetKeepRecords() && stats.GetMaxRecords() == ResourceLoadStats::DefaultMaxRecords);
+    for (unsigned i = 0; i < 4; ++i)
+        stats.AddRecord(MakeRecord("Image", i, 400 * (i + 1)));
+    stats.AddRecord(MakeRecord("JSONFile", 0, 10, false));
+
+    const auto typeStats = stats.GetTypeStats();
+    [[maybe_unused]] const ResourceLoadTypeStats& images = typeStats.at("Image");
+    [[maybe_unused]] const ResourceLoadTypeStats& documents = typeStats.at("JSONFile");
+    assert(images.count_ == 4 && images.failed_ == 0 && images.bytes_ == 4 * 4096);
+    // Only background loads wait in the queue
+    assert(images.queueWait_.count_ == 2 && images.endLoad_.count_ == 4 && images.endLoad_.maxUs_ == 1600);
+    assert(documents.count_ == 1 && documents.failed_ == 1);
+    assert(stats.GetAverageEndLoadUs("Image") == 1000 && stats.GetAverageEndLoadUs("Missing") == 0);
+
+    [[maybe_unused]] const JSONValue json = stats.ToJSON();
+    assert(json.Get("types").Get("Image").Get("endLoad").Get("count").GetUInt() == 4);
+    assert(json.Get("resources").Size() == 5 && json.Get("resources")[4].Get("name").GetString() == "JSONFile0");
+
+    // Individual records are kept in a bounded ring, oldest dropped first
+    stats.SetMaxRecords(3);
+    std::vector<ResourceLoadRecord> records = stats.GetRecords();
+    assert(records.size() == 3 && records[0].name_ == "Image2" && records[2].name_ == "JSONFile0");
+    for (unsigned i = 4; i < 1000; ++i)
+        stats.AddRecord(MakeRecord("Image", i, 400));
+    records = stats.GetRecords();
+    assert(records.size() == 3 && records[0].name_ == "Image997" && records[2].name_ == "Image999");
+    // Aggregates still cover every load
+    assert(stats.GetTypeStats().at("Image").count_ == 1000);
+
+    stats.SetKeepRecords(false);
+    stats.Clear();
+    stats.AddRecord(MakeRecord("Image", 0, 400));
+    assert(stats.GetRecords().empty() && stats.GetTypeStats().at("Image").count_ == 1);
+
+    stats.SetEnabled(false);
+    stats.AddRecord(MakeRecord("Image", 1, 400));
+    assert(stats.GetTypeStats().at("Image").count_ == 1);
+    SE_LOG_PRINT("{}", stats.PrintStats());
+}
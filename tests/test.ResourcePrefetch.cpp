@@ -0,0 +1,142 @@
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <Se/IO/PackageFile.h>
+#include <Se/Thread.h>
+#include <Se/Timer.h>
+#include <SeResource/ResourceCache.h>
+#include <SeVFS/VirtualFileSystem.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <mutex>
+
+using namespace Se;
+
+namespace
+{
+
+/// Resource that records the order in which the background loader reads it.
+class PrefetchProbe : public Resource
+{
+public:
+    PrefetchProbe() : Resource(GetTypeStatic()) {}
+
+    static String GetTypeStatic() { return "PrefetchProbe"; }
+
+    bool BeginLoad(Deserializer& source) override
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        readOrder_.push_back(GetName());
+        return source.GetSize() > 0;
+    }
+
+    static std::mutex mutex_;
+    static std::vector<String> readOrder_;
+};
+
+std::mutex PrefetchProbe::mutex_;
+std::vector<String> PrefetchProbe::readOrder_;
+
+}
+
+void TestResourcePrefetch()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ResourcePrefetch\n"
+              "-------------------------------------------------------");
+
+    // Resource cache calls are accepted only from the main thread
+    Thread::SetMainThread();
+    // Initializes the high-resolution timer frequency, the per-frame finish budget is measured with it
+    Time::Get();
+    ResourceCache::RegisterResource<PrefetchProbe>(PrefetchProbe::GetTypeStatic());
+
+    // Probe files packed into one package, so reads can be ordered by offset
+    auto& fileSystem = FileSystem::Get();
+    const String dataDir = fileSystem.GetTemporaryDir() + "SeResourcePrefetchTest/";
+    const String packageName = fileSystem.GetTemporaryDir() + "SeResourcePrefetchTest.pak";
+    fileSystem.RemoveDir(dataDir, true);
+    fileSystem.Delete(packageName);
+    [[maybe_unused]] const bool created = fileSystem.CreateDir(dataDir);
+    assert(created);
+
+    const unsigned numProbes = 8;
+    for (unsigned i = 0; i < numProbes; ++i)
+    {
+        File file(dataDir + String(cformat("probe%u.txt", i)), FILE_WRITE);
+        const String text = cformat("probe %u", i);
+        file.Write(text.c_str(), text.length());
+    }
+    [[maybe_unused]] const bool packed = Tool::Pack(dataDir, packageName, false);
+    assert(packed);
+
+    auto vfs = VirtualFileSystem::Get();
+    auto mountPoint = vfs->MountPackageFile(packageName);
+    assert(mountPoint);
+    auto& cache = ResourceCache::Get();
+
+    // One probe is loaded up front and is counted without being read again
+    [[maybe_unused]] auto loaded = cache.GetResource(PrefetchProbe::GetTypeStatic(), "probe3.txt");
+    assert(loaded);
+    PrefetchProbe::readOrder_.clear();
+
+    // Request in reverse order with a duplicate, a missing file and an unknown type
+    std::vector<ResourceRef> refs;
+    for (unsigned i = numProbes; i-- > 0;)
+        refs.emplace_back(PrefetchProbe::GetTypeStatic(), cformat("probe%u.txt", i));
+    refs.emplace_back("PrefetchProbe", "probe5.txt");
+    refs.emplace_back("PrefetchProbe", "missing.txt");
+    refs.emplace_back("PrefetchUnknownType", "probe0.txt");
+
+    std::vector<ResourcePrefetchProgress> reports;
+    auto callback = [&reports](const ResourcePrefetchProgress& progress) { reports.push_back(progress); };
+    [[maybe_unused]] const unsigned numQueued = cache.PrefetchResources(refs, callback, false);
+    assert(numQueued == numProbes);
+
+    // Finish on simulated frames until the queue drains
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    unsigned frameNumber = 0;
+    while (cache.GetNumBackgroundLoadResources() && std::chrono::steady_clock::now() < deadline)
+    {
+        Time::onBeginFrame({++frameNumber, 0.016f});
+        Time::Sleep(1);
+    }
+
+    // Progress is reported once per finished resource and completes exactly once
+    assert(reports.size() == numProbes);
+    [[maybe_unused]] const ResourcePrefetchProgress& last = reports.back();
+    assert(last.IsComplete() && last.numTotal_ == numProbes + 2);
+    assert(last.numLoaded_ == numProbes && last.numFailed_ == 2);
+    for (unsigned i = 1; i < reports.size(); ++i)
+        assert(reports[i].GetNumFinished() == reports[i - 1].GetNumFinished() + 1 && !reports[i - 1].IsComplete());
+
+    // Reads followed the package offsets, not the request order
+    auto* package = dynamic_cast<PackageFile*>(mountPoint.get());
+    std::vector<String> expectedOrder;
+    for (unsigned i = 0; i < numProbes; ++i)
+    {
+        if (i != 3)
+            expectedOrder.push_back(cformat("probe%u.txt", i));
+    }
+    std::sort(expectedOrder.begin(), expectedOrder.end(), [package](const String& lhs, const String& rhs)
+        { return package->GetEntry(lhs)->offset_ < package->GetEntry(rhs)->offset_; });
+    assert(PrefetchProbe::readOrder_ == expectedOrder);
+    [[maybe_unused]] const bool allStored = std::all_of(expectedOrder.begin(), expectedOrder.end(),
+        [&cache](const String& name) { return cache.GetExistingResource(PrefetchProbe::GetTypeStatic(), name); });
+    assert(allStored);
+    assert(!cache.GetExistingResource(PrefetchProbe::GetTypeStatic(), "missing.txt"));
+
+    // Nothing left to load completes at once
+    reports.clear();
+    const std::vector<ResourceRef> loadedRefs(refs.begin(), refs.begin() + numProbes);
+    [[maybe_unused]] const unsigned numRequeued = cache.PrefetchResources(loadedRefs, callback);
+    assert(numRequeued == 0 && reports.size() == 1);
+    assert(reports[0].IsComplete() && reports[0].numTotal_ == numProbes && reports[0].numLoaded_ == numProbes);
+
+    cache.ReleaseResources(PrefetchProbe::GetTypeStatic(), String::EMPTY, true);
+    vfs->Unmount(mountPoint);
+    fileSystem.Delete(packageName);
+    fileSystem.RemoveDir(dataDir, true);
+}
@@ -0,0 +1,125 @@
+#include <Se/Console.hpp>
+#include <Se/ValueDocument.h>
+
+#include <cassert>
+
+using namespace Se;
+
+void TestValueDocument()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test ValueDocument\n"
+              "-------------------------------------------------------");
+
+    // Builder calls in document order
+    ValueDocument document;
+    [[maybe_unused]] bool built = document.StartObject();
+    built &= document.Key("name", 4) && document.String("config", 6);
+    built &= document.Key("size", 4) && document.Uint(3000000000u);
+    built &= document.Key("scale", 5) && document.Double(0.5);
+    built &= document.Key("list", 4) && document.StartArray();
+    built &= document.Int(-1) && document.Bool(true) && document.Null();
+    built &= document.StartObject() && document.Key("name", 4) && document.Int(7) && document.EndObject();
+    built &= document.EndArray();
+    built &= document.Key("size", 4) && document.Int(5);
+    assert(built);
+    // Values without a key and unbalanced ends are rejected
+    [[maybe_unused]] const bool missingKey = document.String("missing key", 11);
+    [[maybe_unused]] const bool unbalanced = document.EndArray();
+    assert(!missingKey && !unbalanced);
+    built = document.EndObject();
+    assert(built && document.IsComplete());
+    [[maybe_unused]] const bool afterComplete = document.Null();
+    assert(!afterComplete);
+
+    const ValueNode& root = document.GetRoot();
+    assert(root.IsObject() && root.Size() == 4 && document.GetNumKeys() == 4);
+    assert(root["name"].GetStringView() == "config" && root["name"].GetString() == "config");
+    // Later duplicate keys replace earlier ones
+    assert(root["size"].GetInt() == 5 && root["size"].GetNumberType() == VALUE_NT_INT);
+    assert(root["scale"].GetFloat() == 0.5f && !root.Contains("missing") && root["missing"].IsNull());
+    [[maybe_unused]] const ValueNode& list = root["list"];
+    assert(list.IsArray() && list.Size() == 4 && list[0].GetInt() == -1 && list[1].GetBool() && list[2].IsNull());
+    assert(list[3]["name"].GetInt() == 7 && list[4].IsNull());
+    // Members are sorted by key and keys are interned
+    std::vector<std::string_view> keys;
+    for (const ValueMember& member : root)
+        keys.push_back(member.key_);
+    assert(keys.size() == 4 && keys[0] == "list" && keys[1] == "name" && keys[3] == "size");
+    assert(root.begin()[1].key_.data() == list[3].begin()->key_.data());
+
+    // Round trip through Value
+    const Value value = document.ToValue();
+    assert(value.IsObject() && value.Get("list").Size() == 4 && value.Get("name").GetString() == "config");
+    ValueDocument copy;
+    copy.FromValue(value);
+    assert(copy.ToValue() == value);
+
+    // A document built record by record walks like the same heap Value tree
+    const unsigned numRecords = 100;
+    Value records(VALUE_ARRAY);
+    for (unsigned i = 0; i < numRecords; ++i)
+    {
+        Value record;
+        record["id"] = i;
+        record["name"] = cformat("record%u", i);
+        record["enabled"] = i % 3 != 0;
+        Value& position = record["position"];
+        position["x"] = i * 0.5;
+        position["y"] = 1.0;
+        position["z"] = -2.0;
+        Value& tags = record["tags"];
+        tags.Push("a");
+        tags.Push("b");
+        records.Push(std::move(record));
+    }
+
+    ValueDocument large;
+    large.StartArray();
+    for (unsigned i = 0; i < numRecords; ++i)
+    {
+        const String name = cformat("record%u", i);
+        large.StartObject();
+        large.Key("id", 2);
+        large.Uint(i);
+        large.Key("name", 4);
+        large.String(name.c_str(), static_cast<unsigned>(name.length()));
+        large.Key("enabled", 7);
+        large.Bool(i % 3 != 0);
+        large.Key("position", 8);
+        large.StartObject();
+        large.Key("x", 1);
+        large.Double(i * 0.5);
+        large.Key("y", 1);
+        large.Double(1.0);
+        large.Key("z", 1);
+        large.Double(-2.0);
+        large.EndObject();
+        large.Key("tags", 4);
+        large.StartArray();
+        large.String("a", 1);
+        large.String("b", 1);
+        large.EndArray();
+        large.EndObject();
+    }
+    built = large.EndArray();
+    assert(built && large.IsComplete());
+
+    double valueSum = 0.0;
+    for (const Value& record : records.GetArray())
+        valueSum += record.Get("position").Get("x").GetDouble() + record.Get("id").GetUInt() + record.Get("name").GetString().length();
+
+    double documentSum = 0.0;
+    const ValueNode& largeRoot = large.GetRoot();
+    for (unsigned i = 0; i < largeRoot.Size(); ++i)
+    {
+        const ValueNode& record = largeRoot[i];
+        documentSum += record["position"]["x"].GetDouble() + record["id"].GetUInt() + record["name"].GetStringView().length();
+    }
+
+    assert(valueSum == documentSum && large.GetNumKeys() == 8);
+    assert(large.ToValue() == records);
+
+    large.Clear();
+    assert(large.GetRoot().IsNull() && !large.IsComplete() && large.GetMemoryUse() == 0);
+}
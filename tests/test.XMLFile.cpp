@@ -0,0 +1,84 @@
+#include <Se/Console.hpp>
+#include <Se/IO/File.h>
+#include <Se/IO/FileSystem.h>
+#include <SeResource/XMLFile.h>
+#include <SeVFS/VirtualFileSystem.h>
+
+#include <cassert>
+
+using namespace Se;
+
+void TestXMLFile()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test XMLFile\n"
+              "-------------------------------------------------------");
+
+    // UI layout parsed in place
+    const unsigned numElements = 500;
+    String text = "<layout name=\"main\">\n";
+    for (unsigned i = 0; i < numElements; ++i)
+    {
+        text += cformat("    <element type=\"Button\" name=\"button%u\">"
+            "<attribute name=\"Text\" value=\"Item %u\" /><attribute name=\"Size\" value=\"%u 24\" /></element>\n", i, i, i % 300);
+    }
+    text += "</layout>\n";
+
+    XMLFile layout;
+    [[maybe_unused]] bool parsed = layout.FromString(text);
+    assert(parsed);
+
+    XMLElement root = layout.GetRoot("layout");
+    assert(root.NotNull() && root.GetAttribute("name") == "main");
+    assert(root.GetChild("element").GetAttribute("name") == "button0");
+    parsed = XMLFile().FromString("<layout><element></layout>");
+    assert(!parsed);
+
+    // Repeated queries share one compiled XPath query
+    unsigned numFound = 0;
+    for (XMLElement element = root.GetChild("element"); element; element = element.GetNext("element"))
+    {
+        XPathQuery query("attribute[@name='Text']");
+        numFound += element.SelectSinglePrepared(query).GetAttribute("value").starts_with("Item ");
+    }
+    for (XMLElement element = root.GetChild("element"); element; element = element.GetNext("element"))
+        numFound += element.SelectSingle("attribute[@name='Text']").GetAttribute("value").starts_with("Item ");
+    assert(numFound == 2 * numElements);
+
+    assert(XPathQuery::GetCached("element") == XPathQuery::GetCached("element"));
+    [[maybe_unused]] XPathResultSet buttons = root.Select("element[attribute[@name='Size' and @value='7 24']]");
+    assert(buttons.Size() == numElements / 300 + 1 && buttons[0].GetAttribute("name") == "button7");
+    assert(root.Select("element[").Empty());
+    XPathQuery::ClearCache();
+
+    // Patch file inheriting a layout
+    auto& fileSystem = FileSystem::Get();
+    auto vfs = VirtualFileSystem::Get();
+    auto mountPoint = vfs->MountDir("xmltest", fileSystem.GetTemporaryDir());
+    const String baseFileName = fileSystem.GetTemporaryDir() + "SeXMLFileTest.xml";
+    {
+        File file(baseFileName, FILE_WRITE);
+        const String base = "<layout><element name=\"a\" /><element name=\"b\" /></layout>";
+        [[maybe_unused]] const unsigned written = file.Write(base.c_str(), base.length());
+        assert(written == base.length());
+    }
+
+    XMLFile patched;
+    parsed = patched.FromString("<patch inherit=\"xmltest://SeXMLFileTest.xml\">"
+        "<add sel=\"/layout\"><element name=\"c\" /></add>"
+        "<remove sel=\"/layout/element[@name='a']\" />"
+        "<add sel=\"/layout/element[@name='b']\" type=\"@style\">Bold</add>"
+        "</patch>");
+    assert(parsed);
+    [[maybe_unused]] XMLElement patchedRoot = patched.GetRoot("layout");
+    assert(patchedRoot.GetChild("element").GetAttribute("name") == "b");
+    assert(patchedRoot.GetChild("element").GetAttribute("style") == "Bold");
+    assert(patchedRoot.GetChild("element").GetNext("element").GetAttribute("name") == "c");
+
+    XMLFile brokenPatch;
+    parsed = brokenPatch.FromString("<patch inherit=\"xmltest://SeXMLFileTestMissing.xml\" />");
+    assert(!parsed);
+
+    vfs->Unmount(mountPoint);
+    fileSystem.Delete(baseFileName);
+}
@@ -0,0 +1,119 @@
+#include <Se/Console.hpp>
+#include <Se/IO/MemoryBuffer.hpp>
+#include <Se/ValueDocument.h>
+#include <SeResource/YAMLFile.h>
+
+#include <cassert>
+
+using namespace Se;
+
+/// Counts events and sums numbers without keeping anything.
+class YAMLEventCounter : public YAMLEventHandler
+{
+public:
+    bool Null() override { ++numScalars_; return true; }
+    bool Bool(bool /*value*/) override { ++numScalars_; return true; }
+    bool Int(int value) override { ++numScalars_; sum_ += value; return true; }
+    bool Double(double value) override { ++numScalars_; sum_ += value; return true; }
+    bool String(std::string_view /*value*/) override { ++numScalars_; return true; }
+    bool StartMap() override { ++numContainers_; return true; }
+    bool Key(std::string_view key) override { ++numKeys_; return stopKey_.empty() || key != stopKey_; }
+    bool EndMap() override { return true; }
+    bool StartSeq() override { ++numContainers_; return true; }
+    bool EndSeq() override { return true; }
+
+    unsigned numScalars_{};
+    unsigned numContainers_{};
+    unsigned numKeys_{};
+    double sum_{};
+    std::string_view stopKey_;
+};
+
+void TestYAMLEvents()
+{
+    SE_LOG_PRINT("-------------------------------------------------------\n"
+              "Test YAMLEvents\n"
+              "-------------------------------------------------------");
+
+    const String text = R"(
+name: config
+count: 42
+big: 8048001347822831655
+scale: 0.1
+quoted: '17'
+enabled: true
+empty:
+tilde: ~
+list: [1, -2.5, +3, text, null]
+nested:
+  block: |
+    line
+  items:
+    - id: 1
+    - id: 2
+)";
+
+    MemoryBuffer buffer(text.c_str(), text.length());
+    YAMLFile file;
+    [[maybe_unused]] bool parsed = file.Load(buffer);
+    assert(parsed);
+    const Value& root = file.GetRoot();
+    assert(root.IsObject() && root.Size() == 10);
+    assert(root.Get("name").GetString() == "config" && root.Get("count").GetInt() == 42);
+    assert(root.Get("big").GetString() == "8048001347822831655");
+    assert(root.Get("scale").GetDouble() == 0.1);
+    assert(root.Get("quoted").GetString() == "17" && root.Get("enabled").GetBool());
+    assert(root.Get("empty").IsNull() && root.Get("tilde").IsNull());
+    // Sequence scalars have values too
+    [[maybe_unused]] const Value& list = root.Get("list");
+    assert(list.Size() == 5 && list[0U].GetInt() == 1 && list[1].GetDouble() == -2.5 && list[2].GetInt() == 3);
+    assert(list[3].GetString() == "text" && list[4].IsNull());
+    [[maybe_unused]] const Value& nested = root.Get("nested");
+    assert(nested.Get("block").GetString() == "line\n" && nested.Get("items")[1].Get("id").GetInt() == 2);
+
+    // Same content as a document and as events
+    buffer.Seek(0);
+    ValueDocument document;
+    parsed = YAMLFile::ParseDocument(buffer, document);
+    assert(parsed && document.ToValue() == root);
+
+    buffer.Seek(0);
+    YAMLEventCounter counter;
+    parsed = YAMLFile::Parse(buffer, counter);
+    assert(parsed);
+    assert(counter.numKeys_ == 14 && counter.numContainers_ == 6 && counter.numScalars_ == 16);
+    assert(counter.sum_ == 42 + 0.1 + 1 - 2.5 + 3 + 1 + 2);
+
+    // Handler stops the parse
+    buffer.Seek(0);
+    YAMLEventCounter stopper;
+    stopper.stopKey_ = "scale";
+    parsed = YAMLFile::Parse(buffer, stopper);
+    assert(!parsed && stopper.numKeys_ == 4);
+
+    // Larger file as a Value tree, a document and events
+    String largeText;
+    const unsigned numRecords = 200;
+    largeText.reserve(numRecords * 80);
+    largeText += "records:\n";
+    for (unsigned i = 0; i < numRecords; ++i)
+        largeText += cformat("  - id: %u\n    name: record%u\n    position: [%g, 1.5, -2]\n", i, i, i * 0.5);
+
+    MemoryBuffer largeBuffer(largeText.c_str(), largeText.length());
+    YAMLFile largeFile;
+    parsed = largeFile.Load(largeBuffer);
+    assert(parsed);
+    largeBuffer.Seek(0);
+    ValueDocument largeDocument;
+    parsed = YAMLFile::ParseDocument(largeBuffer, largeDocument);
+    assert(parsed);
+    largeBuffer.Seek(0);
+    YAMLEventCounter largeCounter;
+    parsed = YAMLFile::Parse(largeBuffer, largeCounter);
+    assert(parsed);
+
+    [[maybe_unused]] const Value& records = largeFile.GetRoot().Get("records");
+    assert(records.Size() == numRecords && records[numRecords - 1].Get("name").GetString() == cformat("record%u", numRecords - 1));
+    assert(largeDocument.GetRoot()["records"][numRecords - 1]["position"][0].GetDouble() == (numRecords - 1) * 0.5);
+    assert(largeCounter.numKeys_ == numRecords * 3 + 1);
+}